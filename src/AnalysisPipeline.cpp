@@ -0,0 +1,187 @@
+#include "AnalysisPipeline.h"
+#include "AtomArrays.h"
+#include "ElementTable.h"
+#include "Logger.h"
+#include "TrajectoryFile.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+// ─── Topology ─────────────────────────────────────────────────────────
+
+AnalysisTopology AnalysisTopology::fromAtomArrays(const AtomArrays& atoms) {
+    AnalysisTopology topology;
+    topology.atomicNumber = atoms.atomicNumber;
+    topology.mass = atoms.mass;
+    topology.charge = atoms.charge;
+    topology.bondOffsets = atoms.bondOffsets;
+    topology.bondNeighbors = atoms.bondNeighbors;
+    return topology;
+}
+
+AnalysisTopology AnalysisTopology::anonymous(size_t count) {
+    AnalysisTopology topology;
+    topology.atomicNumber.assign(count, 0);
+    topology.mass.assign(count, 1.0f);
+    topology.charge.assign(count, 0.0f);
+    return topology;
+}
+
+bool AnalysisTopology::loadXYZ(const std::string& path, AnalysisTopology& topology) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        LOG_ERROR("Failed to open topology file: " + path);
+        return false;
+    }
+    std::string line;
+    size_t count = 0;
+    if (!std::getline(file, line) || !(std::istringstream(line) >> count)) {
+        LOG_ERROR("Invalid XYZ header in " + path);
+        return false;
+    }
+    std::getline(file, line);  // comment
+
+    topology = anonymous(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string symbol;
+        if (!std::getline(file, line) || !(std::istringstream(line) >> symbol)) {
+            LOG_ERROR("XYZ file " + path + " ends after " + std::to_string(i) + " atoms");
+            return false;
+        }
+        int Z = ElementTable::atomicNumberFromSymbol(symbol);
+        topology.atomicNumber[i] = static_cast<uint8_t>(Z);
+        if (Z > 0) topology.mass[i] = static_cast<float>(ElementTable::getDefaultMassNumber(Z));
+    }
+    return true;
+}
+
+// ─── Pipeline ─────────────────────────────────────────────────────────
+
+AnalysisPipeline::AnalysisPipeline(size_t maxFramesInFlight)
+    : m_maxFramesInFlight(std::max<size_t>(1, maxFramesInFlight)) {}
+
+AnalysisPipeline::~AnalysisPipeline() {
+    finish();
+}
+
+void AnalysisPipeline::addStage(std::unique_ptr<AnalysisStage> stage) {
+    if (m_begun) {
+        LOG_WARNING(std::string("Analysis stage added after start ignored: ") + stage->getName());
+        return;
+    }
+    m_stages.push_back(std::move(stage));
+}
+
+void AnalysisPipeline::begin(AnalysisTopology topology) {
+    finish();
+    m_topology = std::move(topology);
+    m_lastStageTask.assign(m_stages.size(), nullptr);
+    m_nextFrameIndex = 0;
+    for (auto& stage : m_stages) {
+        stage->begin(m_topology);
+    }
+    m_begun = true;
+    m_finalized = false;
+}
+
+void AnalysisPipeline::pushFrame(TrajectoryFrame data) {
+    if (!m_begun) begin(AnalysisTopology::anonymous(data.size()));
+    if (data.size() != m_topology.size()) {
+        LOG_ERROR("Analysis skipped a frame with " + std::to_string(data.size()) +
+                    " atoms (topology has " + std::to_string(m_topology.size()) + ")");
+        return;
+    }
+
+    auto& scheduler = TaskScheduler::getInstance();
+    while (m_inFlight.size() >= m_maxFramesInFlight) {
+        scheduler.waitAll(m_inFlight.front());
+        m_inFlight.pop_front();
+    }
+
+    auto frame = std::make_shared<AnalysisFrame>();
+    frame->index = m_nextFrameIndex++;
+    m_finalized = false;
+    frame->data = std::move(data);
+
+    std::vector<TaskScheduler::TaskHandle> tasks;
+    tasks.reserve(m_stages.size());
+    for (size_t s = 0; s < m_stages.size(); ++s) {
+        AnalysisStage* stage = m_stages[s].get();
+        std::vector<TaskScheduler::TaskHandle> dependencies;
+        if (stage->isStateful()) dependencies.push_back(m_lastStageTask[s]);
+
+        // The frame is freed when the last of its stage tasks drops its reference
+        auto task = scheduler.submit([stage, frame]() { stage->processFrame(*frame); }, dependencies);
+        m_lastStageTask[s] = task;
+        tasks.push_back(std::move(task));
+    }
+    m_inFlight.push_back(std::move(tasks));
+}
+
+void AnalysisPipeline::finish() {
+    auto& scheduler = TaskScheduler::getInstance();
+    while (!m_inFlight.empty()) {
+        scheduler.waitAll(m_inFlight.front());
+        m_inFlight.pop_front();
+    }
+}
+
+bool AnalysisPipeline::processFile(const std::string& path, size_t readAhead) {
+    auto reader = std::make_shared<TrajectoryReader>();
+    if (!reader->open(path)) {
+        LOG_ERROR(reader->getError());
+        return false;
+    }
+
+    struct PendingRead {
+        TaskScheduler::TaskHandle task;
+        std::shared_ptr<TrajectoryFrame> frame;
+        std::shared_ptr<bool> ok;
+    };
+    auto& scheduler = TaskScheduler::getInstance();
+    std::deque<PendingRead> reads;
+    TaskScheduler::TaskHandle lastRead;
+
+    // Reads are chained on the I/O lane because frames decode against their predecessors
+    auto issueRead = [&]() {
+        PendingRead read{nullptr, std::make_shared<TrajectoryFrame>(), std::make_shared<bool>(false)};
+        auto frame = read.frame;
+        auto ok = read.ok;
+        read.task = scheduler.submitIO([reader, frame, ok]() {
+            *ok = reader->getError().empty() && reader->readFrame(*frame);
+        }, {lastRead});
+        lastRead = read.task;
+        reads.push_back(std::move(read));
+    };
+
+    for (size_t i = 0; i < std::max<size_t>(1, readAhead); ++i) issueRead();
+    while (!reads.empty()) {
+        PendingRead read = std::move(reads.front());
+        reads.pop_front();
+        scheduler.wait(read.task);
+        if (!*read.ok) break;
+        issueRead();
+        pushFrame(std::move(*read.frame));
+    }
+    scheduler.wait(lastRead);
+    finish();
+
+    if (!reader->getError().empty()) {
+        LOG_ERROR("Trajectory " + path + ": " + reader->getError());
+        return false;
+    }
+    return true;
+}
+
+void AnalysisPipeline::writeResults(std::ostream& out) {
+    finish();
+    if (!m_finalized) {
+        for (auto& stage : m_stages) stage->finalize();
+        m_finalized = true;
+    }
+    out << "# Atomica analysis: " << m_nextFrameIndex << " frames, " << m_topology.size() << " atoms\n";
+    for (const auto& stage : m_stages) {
+        out << "\n# [" << stage->getName() << "]\n";
+        stage->writeResults(out);
+    }
+}
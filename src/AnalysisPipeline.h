@@ -0,0 +1,217 @@
+#ifndef ANALYSIS_PIPELINE_H
+#define ANALYSIS_PIPELINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "TaskScheduler.h"
+#include "TrajectoryCodec.h"
+
+class AtomArrays;
+
+/**
+ * @brief Per-atom data that does not change between frames.
+ */
+struct AnalysisTopology {
+    std::vector<uint8_t>  atomicNumber;   ///< 0 if unknown
+    std::vector<float>    mass;           ///< amu
+    std::vector<float>    charge;         ///< Elementary charges
+    std::vector<uint32_t> bondOffsets;    ///< CSR row offsets (size + 1 entries, or empty if no bonds are known)
+    std::vector<uint32_t> bondNeighbors;
+
+    size_t size() const { return atomicNumber.size(); }
+
+    /**
+     * @brief Copies the topology columns of a simulation snapshot.
+     *
+     * @param atoms The snapshot.
+     * @return The topology.
+     */
+    static AnalysisTopology fromAtomArrays(const AtomArrays& atoms);
+
+    /**
+     * @brief Builds a topology of unknown, neutral, unit-mass atoms.
+     *
+     * @param count The atom count.
+     * @return The topology.
+     */
+    static AnalysisTopology anonymous(size_t count);
+
+    /**
+     * @brief Reads element types from an XYZ file (positions are ignored).
+     *
+     * @param path The XYZ file.
+     * @param topology Receives the topology; atoms are neutral with their default mass.
+     * @return True on success.
+     */
+    static bool loadXYZ(const std::string& path, AnalysisTopology& topology);
+};
+
+/**
+ * @brief One frame flowing through the pipeline.
+ */
+struct AnalysisFrame {
+    size_t index = 0;       ///< Position of the frame in the stream
+    TrajectoryFrame data;
+};
+
+/**
+ * @brief One analysis in the pipeline.
+ *
+ * Stateless stages see each frame independently; processFrame() may be
+ * called for several frames at once from different threads and in any
+ * order, so they merge per-frame results under their own lock. Stateful
+ * stages (anything that compares a frame with earlier ones) are called one
+ * frame at a time, in stream order. Either kind may parallelize within a
+ * frame using the TaskScheduler.
+ */
+class AnalysisStage {
+public:
+    virtual ~AnalysisStage() = default;
+
+    virtual const char* getName() const = 0;
+    virtual bool isStateful() const = 0;
+
+    /**
+     * @brief Called once before the first frame.
+     *
+     * @param topology The atom topology; it outlives the stage's use of it.
+     */
+    virtual void begin(const AnalysisTopology& topology) = 0;
+
+    /**
+     * @brief Analyses one frame.
+     *
+     * @param frame The frame; only valid for the duration of the call.
+     */
+    virtual void processFrame(const AnalysisFrame& frame) = 0;
+
+    /**
+     * @brief Called once after the last frame, for work that needs every frame.
+     */
+    virtual void finalize() {}
+
+    /**
+     * @brief Writes the accumulated results as whitespace-separated columns.
+     *
+     * @param out The output stream.
+     */
+    virtual void writeResults(std::ostream& out) const = 0;
+};
+
+/**
+ * @brief Streams trajectory frames through a chain of analysis stages.
+ *
+ * Each pushed frame becomes one task per stage. Tasks of stateless stages
+ * depend on nothing, so different frames are analysed concurrently; tasks of
+ * a stateful stage depend on that stage's task for the previous frame. A
+ * frame is released once all its stage tasks have run, and at most
+ * maxFramesInFlight frames are held at a time, which bounds memory however
+ * long the trajectory is.
+ *
+ * The same pipeline is fed either inline by the simulation (pushFrame) or
+ * from a trajectory file (processFile), where the next frames are read and
+ * decoded on the I/O lane while the current ones are being analysed.
+ */
+class AnalysisPipeline {
+public:
+    /**
+     * @brief Constructs an empty pipeline.
+     *
+     * @param maxFramesInFlight Frames held in memory at most.
+     */
+    explicit AnalysisPipeline(size_t maxFramesInFlight = 4);
+
+    /**
+     * @brief Waits for in-flight frames.
+     */
+    ~AnalysisPipeline();
+
+    /**
+     * @brief Appends a stage; only allowed before begin().
+     *
+     * @param stage The stage.
+     */
+    void addStage(std::unique_ptr<AnalysisStage> stage);
+
+    bool hasStages() const { return !m_stages.empty(); }
+    bool hasBegun() const { return m_begun; }
+
+    /**
+     * @brief Sets the topology and prepares the stages for frames.
+     *
+     * @param topology The atom topology.
+     */
+    void begin(AnalysisTopology topology);
+
+    /**
+     * @brief Queues a frame for analysis, waiting first if the pipeline is full.
+     *
+     * @param frame The frame (moved from). Frames whose atom count does not
+     *              match the topology are skipped and logged.
+     */
+    void pushFrame(TrajectoryFrame frame);
+
+    /**
+     * @brief Waits until every queued frame has been analysed.
+     */
+    void finish();
+
+    /**
+     * @brief Runs the pipeline over a trajectory file.
+     *
+     * If begin() has not been called, an anonymous topology sized from the
+     * first frame is used.
+     *
+     * @param path The trajectory file written by TrajectoryWriter.
+     * @param readAhead Frames read and decoded ahead of the analysis.
+     * @return True if the whole file was read without error.
+     */
+    bool processFile(const std::string& path, size_t readAhead = 2);
+
+    /**
+     * @brief Finishes the stream and writes every stage's results, one section per stage.
+     *
+     * The first call after the last frame waits for in-flight frames and
+     * finalizes the stages.
+     *
+     * @param out The output stream.
+     */
+    void writeResults(std::ostream& out);
+
+    size_t getFramesProcessed() const { return m_nextFrameIndex; }
+    const AnalysisTopology& getTopology() const { return m_topology; }
+
+private:
+    std::vector<std::unique_ptr<AnalysisStage>> m_stages;
+    std::vector<TaskScheduler::TaskHandle> m_lastStageTask;  ///< Per stage: the task for the latest frame
+    std::deque<std::vector<TaskScheduler::TaskHandle>> m_inFlight;
+    AnalysisTopology m_topology;
+    size_t m_maxFramesInFlight;
+    size_t m_nextFrameIndex = 0;
+    bool m_begun = false;
+    bool m_finalized = false;
+};
+
+/**
+ * @brief Creates a built-in stage by name, with parameters from the ConfigManager.
+ *
+ * @param name One of "rdf", "msd", "hbonds", "energy", "sasa", "rmsd".
+ * @return The stage, or nullptr for an unknown name.
+ */
+std::unique_ptr<AnalysisStage> createAnalysisStage(const std::string& name);
+
+/**
+ * @brief Adds stages from a comma-separated list of names.
+ *
+ * @param pipeline The pipeline to add to.
+ * @param names For example "rdf,msd".
+ * @return False if a name was not recognized (the others are still added).
+ */
+bool addAnalysisStages(AnalysisPipeline& pipeline, const std::string& names);
+
+#endif // ANALYSIS_PIPELINE_H
@@ -0,0 +1,469 @@
+#include "AnalysisStages.h"
+#include "CellGrid.h"
+#include "ConfigManager.h"
+#include "Logger.h"
+#include "SelectionQuery.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace {
+const double PI = 3.14159265358979323846;
+// Atoms per parallelFor chunk in the pair loops
+const size_t PAIR_GRAIN = 2048;
+
+inline glm::vec3 positionOf(const TrajectoryFrame& frame, size_t i) {
+    return glm::vec3(frame.x[i], frame.y[i], frame.z[i]);
+}
+
+inline bool isElectronegative(int Z) {
+    return Z == 7 || Z == 8 || Z == 9;
+}
+}
+
+// ─── RDF ──────────────────────────────────────────────────────────────
+
+RdfStage::RdfStage(float cutoff, int bins)
+    : m_cutoff(cutoff > 0.0f ? cutoff : 10.0f), m_bins(std::max(1, bins)) {}
+
+void RdfStage::begin(const AnalysisTopology&) {
+    m_histogram.assign(m_bins, 0.0);
+    m_normalization = 0.0;
+}
+
+void RdfStage::processFrame(const AnalysisFrame& frame) {
+    const TrajectoryFrame& f = frame.data;
+    size_t count = f.size();
+    if (count < 2) return;
+
+    CellGrid grid;
+    grid.build(f.x.data(), f.y.data(), f.z.data(), count, m_cutoff);
+
+    std::vector<double> histogram(m_bins, 0.0);
+    std::mutex histogramMutex;
+    const float cutoff2 = m_cutoff * m_cutoff;
+    const float binScale = m_bins / m_cutoff;
+
+    TaskScheduler::getInstance().parallelFor(0, count, [&](size_t begin, size_t end) {
+        std::vector<uint64_t> local(m_bins, 0);
+        for (size_t i = begin; i < end; ++i) {
+            glm::vec3 p = positionOf(f, i);
+            grid.forEachCandidate(p, m_cutoff, [&](uint32_t j) {
+                if (j <= i) return;  // each pair once
+                glm::vec3 d = positionOf(f, j) - p;
+                float r2 = glm::dot(d, d);
+                if (r2 < cutoff2) {
+                    int bin = std::min(m_bins - 1, static_cast<int>(std::sqrt(r2) * binScale));
+                    ++local[bin];
+                }
+            });
+        }
+        std::lock_guard<std::mutex> lock(histogramMutex);
+        for (int b = 0; b < m_bins; ++b) histogram[b] += static_cast<double>(local[b]);
+    }, PAIR_GRAIN);
+
+    glm::vec3 lo = positionOf(f, 0), hi = lo;
+    for (size_t i = 1; i < count; ++i) {
+        lo = glm::min(lo, positionOf(f, i));
+        hi = glm::max(hi, positionOf(f, i));
+    }
+    glm::vec3 extent = glm::max(hi - lo, glm::vec3(m_cutoff));
+    double density = count / (double(extent.x) * extent.y * extent.z);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int b = 0; b < m_bins; ++b) m_histogram[b] += histogram[b];
+    m_normalization += 0.5 * count * density;
+}
+
+void RdfStage::writeResults(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    out << "# r g(r)\n";
+    double width = m_cutoff / m_bins;
+    for (int b = 0; b < m_bins; ++b) {
+        double r0 = b * width, r1 = r0 + width;
+        double shell = 4.0 / 3.0 * PI * (r1 * r1 * r1 - r0 * r0 * r0);
+        double g = m_normalization > 0.0 ? m_histogram[b] / (m_normalization * shell) : 0.0;
+        out << (r0 + 0.5 * width) << ' ' << g << '\n';
+    }
+}
+
+// ─── MSD ──────────────────────────────────────────────────────────────
+
+void MsdStage::begin(const AnalysisTopology&) {
+    m_reference = TrajectoryFrame();
+    m_rows.clear();
+}
+
+void MsdStage::processFrame(const AnalysisFrame& frame) {
+    const TrajectoryFrame& f = frame.data;
+    if (m_reference.size() == 0) {
+        m_reference = f;
+    }
+    size_t count = f.size();
+    if (count == 0) return;
+
+    std::mutex sumMutex;
+    double sum = 0.0;
+    TaskScheduler::getInstance().parallelFor(0, count, [&](size_t begin, size_t end) {
+        double local = 0.0;
+        for (size_t i = begin; i < end; ++i) {
+            glm::vec3 d = positionOf(f, i) - positionOf(m_reference, i);
+            local += glm::dot(d, d);
+        }
+        std::lock_guard<std::mutex> lock(sumMutex);
+        sum += local;
+    }, 16384);
+
+    m_rows.emplace_back(f.time - m_reference.time, sum / count);
+}
+
+void MsdStage::writeResults(std::ostream& out) const {
+    out << "# lag msd\n";
+    for (const auto& row : m_rows) {
+        out << row.first << ' ' << row.second << '\n';
+    }
+}
+
+// ─── Hydrogen bonds ───────────────────────────────────────────────────
+
+HydrogenBondStage::HydrogenBondStage(float maxDistance, float minAngleDegrees, float covalentCutoff)
+    : m_maxDistance(maxDistance),
+      m_minCosine(static_cast<float>(std::cos(minAngleDegrees * PI / 180.0))),
+      m_covalentCutoff(covalentCutoff) {}
+
+void HydrogenBondStage::begin(const AnalysisTopology& topology) {
+    m_topology = &topology;
+    m_hydrogens.clear();
+    m_electronegative.clear();
+    m_counts.clear();
+    for (size_t i = 0; i < topology.size(); ++i) {
+        if (topology.atomicNumber[i] == 1) m_hydrogens.push_back(static_cast<uint32_t>(i));
+        if (isElectronegative(topology.atomicNumber[i])) m_electronegative.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+void HydrogenBondStage::processFrame(const AnalysisFrame& frame) {
+    const TrajectoryFrame& f = frame.data;
+    const AnalysisTopology& topology = *m_topology;
+    const bool hasBonds = topology.bondOffsets.size() == topology.size() + 1;
+
+    CellGrid grid;
+    grid.build(f.x.data(), f.y.data(), f.z.data(), m_electronegative,
+               std::max(m_maxDistance, m_covalentCutoff));
+
+    const float maxDistance2 = m_maxDistance * m_maxDistance;
+    const float covalent2 = m_covalentCutoff * m_covalentCutoff;
+    std::mutex countMutex;
+    size_t total = 0;
+
+    TaskScheduler::getInstance().parallelFor(0, m_hydrogens.size(), [&](size_t begin, size_t end) {
+        size_t local = 0;
+        for (size_t k = begin; k < end; ++k) {
+            uint32_t h = m_hydrogens[k];
+            glm::vec3 ph = positionOf(f, h);
+
+            // Donor: a bonded N/O/F, else the nearest one within covalent range
+            int64_t donor = -1;
+            if (hasBonds) {
+                for (uint32_t b = topology.bondOffsets[h]; b < topology.bondOffsets[h + 1]; ++b) {
+                    uint32_t n = topology.bondNeighbors[b];
+                    if (isElectronegative(topology.atomicNumber[n])) { donor = n; break; }
+                }
+            }
+            if (donor < 0) {
+                float best = covalent2;
+                grid.forEachCandidate(ph, m_covalentCutoff, [&](uint32_t j) {
+                    glm::vec3 d = positionOf(f, j) - ph;
+                    float r2 = glm::dot(d, d);
+                    if (r2 < best) { best = r2; donor = j; }
+                });
+            }
+            if (donor < 0) continue;
+
+            glm::vec3 hd = glm::normalize(positionOf(f, static_cast<size_t>(donor)) - ph);
+            grid.forEachCandidate(ph, m_maxDistance, [&](uint32_t a) {
+                if (a == donor) return;
+                glm::vec3 ha = positionOf(f, a) - ph;
+                float r2 = glm::dot(ha, ha);
+                if (r2 >= maxDistance2 || r2 <= 0.0f) return;
+                // Angle D-H···A at the hydrogen; 180° is a linear bond
+                float cosine = glm::dot(hd, ha) / std::sqrt(r2);
+                if (cosine <= m_minCosine) ++local;
+            });
+        }
+        std::lock_guard<std::mutex> lock(countMutex);
+        total += local;
+    }, 1024);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counts[frame.index] = {f.time, total};
+}
+
+void HydrogenBondStage::writeResults(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    out << "# time hbonds\n";
+    for (const auto& entry : m_counts) {
+        out << entry.second.first << ' ' << entry.second.second << '\n';
+    }
+}
+
+// ─── Energy ───────────────────────────────────────────────────────────
+
+EnergyStage::EnergyStage(float cutoff)
+    : m_cutoff(cutoff > 0.0f ? cutoff : 12.0f) {}
+
+void EnergyStage::begin(const AnalysisTopology& topology) {
+    m_topology = &topology;
+    m_charged.clear();
+    for (size_t i = 0; i < topology.size(); ++i) {
+        if (topology.charge[i] != 0.0f) m_charged.push_back(static_cast<uint32_t>(i));
+    }
+    m_previous = TrajectoryFrame();
+    m_hasPrevious = false;
+    m_rows.clear();
+}
+
+void EnergyStage::processFrame(const AnalysisFrame& frame) {
+    const TrajectoryFrame& f = frame.data;
+    const AnalysisTopology& topology = *m_topology;
+    auto& scheduler = TaskScheduler::getInstance();
+
+    double dt = m_hasPrevious ? f.time - m_previous.time : 0.0;
+    if (dt <= 0.0) {
+        m_previous = f;
+        m_hasPrevious = true;
+        return;
+    }
+
+    std::mutex sumMutex;
+    double kinetic = 0.0;
+    scheduler.parallelFor(0, f.size(), [&](size_t begin, size_t end) {
+        double local = 0.0;
+        for (size_t i = begin; i < end; ++i) {
+            glm::vec3 v = (positionOf(f, i) - positionOf(m_previous, i)) / static_cast<float>(dt);
+            local += 0.5 * topology.mass[i] * glm::dot(v, v);
+        }
+        std::lock_guard<std::mutex> lock(sumMutex);
+        kinetic += local;
+    }, 16384);
+
+    double coulomb = 0.0;
+    if (m_charged.size() > 1) {
+        CellGrid grid;
+        grid.build(f.x.data(), f.y.data(), f.z.data(), m_charged, m_cutoff);
+        const float cutoff2 = m_cutoff * m_cutoff;
+        scheduler.parallelFor(0, m_charged.size(), [&](size_t begin, size_t end) {
+            double local = 0.0;
+            for (size_t k = begin; k < end; ++k) {
+                uint32_t i = m_charged[k];
+                glm::vec3 p = positionOf(f, i);
+                grid.forEachCandidate(p, m_cutoff, [&](uint32_t j) {
+                    if (j <= i) return;
+                    glm::vec3 d = positionOf(f, j) - p;
+                    float r2 = glm::dot(d, d);
+                    if (r2 < cutoff2 && r2 > 0.0f) {
+                        local += topology.charge[i] * topology.charge[j] / std::sqrt(r2);
+                    }
+                });
+            }
+            std::lock_guard<std::mutex> lock(sumMutex);
+            coulomb += local;
+        }, PAIR_GRAIN);
+    }
+
+    m_rows.push_back({f.time, kinetic, coulomb});
+    m_previous = f;
+}
+
+void EnergyStage::writeResults(std::ostream& out) const {
+    out << "# time kinetic coulomb total\n";
+    for (const auto& row : m_rows) {
+        out << row.time << ' ' << row.kinetic << ' ' << row.coulomb << ' ' << (row.kinetic + row.coulomb) << '\n';
+    }
+}
+
+// ─── Surface area ─────────────────────────────────────────────────────
+
+SasaStage::SasaStage(int pointsPerAtom, float probeRadius)
+    : m_surfaceArea(pointsPerAtom, probeRadius) {}
+
+void SasaStage::begin(const AnalysisTopology& topology) {
+    m_topology = &topology;
+    m_totals.clear();
+    m_atomSums.assign(topology.size(), 0.0);
+}
+
+void SasaStage::processFrame(const AnalysisFrame& frame) {
+    const TrajectoryFrame& f = frame.data;
+    std::vector<float> areas;
+    double total = m_surfaceArea.compute(f.x.data(), f.y.data(), f.z.data(), m_topology->atomicNumber.data(),
+                                         f.size(), areas);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_totals[frame.index] = {f.time, total};
+    for (size_t i = 0; i < areas.size() && i < m_atomSums.size(); ++i) m_atomSums[i] += areas[i];
+}
+
+void SasaStage::writeResults(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    out << "# time sasa\n";
+    for (const auto& entry : m_totals) {
+        out << entry.second.first << ' ' << entry.second.second << '\n';
+    }
+    out << "# atom mean_sasa\n";
+    double frames = std::max<size_t>(1, m_totals.size());
+    for (size_t i = 0; i < m_atomSums.size(); ++i) {
+        out << i << ' ' << m_atomSums[i] / frames << '\n';
+    }
+}
+
+// ─── RMSD clustering ──────────────────────────────────────────────────
+
+RmsdStage::RmsdStage(const std::string& selection, int stride, int maxFrames, float clusterCutoff)
+    : m_selectionText(selection.empty() ? "all" : selection),
+      m_stride(static_cast<size_t>(std::max(1, stride))),
+      m_maxFrames(static_cast<size_t>(std::max(2, maxFrames))),
+      m_clusterCutoff(clusterCutoff) {}
+
+void RmsdStage::begin(const AnalysisTopology& topology) {
+    m_topology = &topology;
+    m_atoms.clear();
+    m_resolved = false;
+    m_conformations.clear();
+    m_times.clear();
+    m_rmsdToFirst.clear();
+    m_clusters.clear();
+    m_centers.clear();
+    m_rmsf.clear();
+}
+
+void RmsdStage::processFrame(const AnalysisFrame& frame) {
+    if (frame.index % m_stride != 0 || m_conformations.size() >= m_maxFrames) return;
+    const TrajectoryFrame& f = frame.data;
+
+    if (!m_resolved) {
+        // Selection queries run on an AtomArrays snapshot of the first frame
+        AtomArrays atoms;
+        atoms.x = f.x;
+        atoms.y = f.y;
+        atoms.z = f.z;
+        atoms.vx.assign(f.size(), 0.0f);
+        atoms.vy.assign(f.size(), 0.0f);
+        atoms.vz.assign(f.size(), 0.0f);
+        atoms.atomicNumber = m_topology->atomicNumber;
+        atoms.mass = m_topology->mass;
+        atoms.charge = m_topology->charge;
+        atoms.molecule.assign(f.size(), -1);
+        atoms.bondOffsets = m_topology->bondOffsets;
+        atoms.bondNeighbors = m_topology->bondNeighbors;
+
+        SelectionQuery query;
+        if (query.compile(m_selectionText)) {
+            m_atoms = query.evaluate(atoms).toIndices();
+        } else {
+            LOG_ERROR("Invalid rmsd selection '" + m_selectionText + "': " + query.getError());
+        }
+        m_resolved = true;
+    }
+    if (m_atoms.size() < 3) return;
+
+    m_conformations.push_back(Conformation::fromAtoms(f.x.data(), f.y.data(), f.z.data(), m_atoms));
+    m_times.push_back(f.time);
+}
+
+void RmsdStage::finalize() {
+    if (m_conformations.size() < 2) return;
+
+    RmsdMatrix matrix;
+    matrix.compute(m_conformations);
+    m_clusters = matrix.clusterGromos(m_clusterCutoff, m_centers);
+
+    // Superpose copies onto the first frame for the fluctuations
+    std::vector<Conformation> aligned(m_conformations);
+    StructureAlignment::superpose(m_conformations.front(), aligned, &m_rmsdToFirst);
+
+    size_t atomCount = m_atoms.size();
+    std::vector<glm::dvec3> mean(atomCount, glm::dvec3(0.0));
+    for (const auto& c : aligned) {
+        for (size_t i = 0; i < atomCount; ++i) mean[i] += glm::dvec3(c.x[i], c.y[i], c.z[i]);
+    }
+    for (auto& m : mean) m /= static_cast<double>(aligned.size());
+    m_rmsf.assign(atomCount, 0.0);
+    for (const auto& c : aligned) {
+        for (size_t i = 0; i < atomCount; ++i) {
+            glm::dvec3 d = glm::dvec3(c.x[i], c.y[i], c.z[i]) - mean[i];
+            m_rmsf[i] += glm::dot(d, d);
+        }
+    }
+    for (auto& v : m_rmsf) v = std::sqrt(v / aligned.size());
+}
+
+void RmsdStage::writeResults(std::ostream& out) const {
+    out << "# " << m_atoms.size() << " atoms selected by '" << m_selectionText << "', "
+        << m_conformations.size() << " frames, " << m_centers.size() << " clusters at cutoff " << m_clusterCutoff << "\n";
+    out << "# time rmsd_to_first cluster\n";
+    for (size_t k = 0; k < m_rmsdToFirst.size(); ++k) {
+        out << m_times[k] << ' ' << m_rmsdToFirst[k] << ' ' << m_clusters[k] << '\n';
+    }
+    out << "# cluster size center_time\n";
+    for (size_t c = 0; c < m_centers.size(); ++c) {
+        size_t size = std::count(m_clusters.begin(), m_clusters.end(), static_cast<int>(c));
+        out << c << ' ' << size << ' ' << m_times[m_centers[c]] << '\n';
+    }
+    out << "# atom rmsf\n";
+    for (size_t i = 0; i < m_rmsf.size(); ++i) {
+        out << m_atoms[i] << ' ' << m_rmsf[i] << '\n';
+    }
+}
+
+// ─── Factory ──────────────────────────────────────────────────────────
+
+std::unique_ptr<AnalysisStage> createAnalysisStage(const std::string& name) {
+    auto& config = ConfigManager::getInstance();
+    if (name == "rdf") {
+        return std::make_unique<RdfStage>(config.getFloat("analysis_rdf_cutoff", 10.0f),
+                                          config.getInt("analysis_rdf_bins", 200));
+    }
+    if (name == "msd") {
+        return std::make_unique<MsdStage>();
+    }
+    if (name == "hbonds") {
+        return std::make_unique<HydrogenBondStage>(config.getFloat("analysis_hbond_distance", 2.5f),
+                                                   config.getFloat("analysis_hbond_angle", 120.0f),
+                                                   config.getFloat("analysis_hbond_covalent", 1.3f));
+    }
+    if (name == "energy") {
+        return std::make_unique<EnergyStage>(config.getFloat("analysis_energy_cutoff", 12.0f));
+    }
+    if (name == "sasa") {
+        return std::make_unique<SasaStage>(config.getInt("analysis_sasa_points", 96),
+                                           config.getFloat("analysis_sasa_probe", 1.4f));
+    }
+    if (name == "rmsd") {
+        return std::make_unique<RmsdStage>(config.getString("analysis_rmsd_selection", "all"),
+                                           config.getInt("analysis_rmsd_stride", 1),
+                                           config.getInt("analysis_rmsd_max_frames", 10000),
+                                           config.getFloat("analysis_rmsd_cluster_cutoff", 1.0f));
+    }
+    return nullptr;
+}
+
+bool addAnalysisStages(AnalysisPipeline& pipeline, const std::string& names) {
+    bool allKnown = true;
+    std::stringstream list(names);
+    std::string name;
+    while (std::getline(list, name, ',')) {
+        name.erase(0, name.find_first_not_of(" \t"));
+        name.erase(name.find_last_not_of(" \t") + 1);
+        if (name.empty()) continue;
+        auto stage = createAnalysisStage(name);
+        if (!stage) {
+            LOG_WARNING("Unknown analysis stage: " + name);
+            allKnown = false;
+            continue;
+        }
+        pipeline.addStage(std::move(stage));
+    }
+    return allKnown;
+}
@@ -0,0 +1,199 @@
+#ifndef ANALYSIS_STAGES_H
+#define ANALYSIS_STAGES_H
+
+#include <map>
+#include <mutex>
+#include <vector>
+#include "AnalysisPipeline.h"
+#include "StructureAlignment.h"
+#include "SurfaceArea.h"
+
+/**
+ * @brief Radial distribution function g(r) over all atom pairs.
+ *
+ * Stateless. Each frame is normalized by the ideal-gas pair density of its
+ * bounding box; the scenes are not periodic, so g(r) falls off at distances
+ * comparable to the system size.
+ */
+class RdfStage : public AnalysisStage {
+public:
+    /**
+     * @param cutoff Largest pair distance histogrammed.
+     * @param bins Number of histogram bins.
+     */
+    RdfStage(float cutoff, int bins);
+
+    const char* getName() const override { return "rdf"; }
+    bool isStateful() const override { return false; }
+    void begin(const AnalysisTopology& topology) override;
+    void processFrame(const AnalysisFrame& frame) override;
+    void writeResults(std::ostream& out) const override;
+
+private:
+    float m_cutoff;
+    int m_bins;
+    mutable std::mutex m_mutex;
+    std::vector<double> m_histogram;
+    double m_normalization = 0.0;  ///< Sum over frames of N·ρ/2
+};
+
+/**
+ * @brief Mean squared displacement from the first frame.
+ *
+ * Stateful: keeps the reference positions of the first frame it sees.
+ */
+class MsdStage : public AnalysisStage {
+public:
+    const char* getName() const override { return "msd"; }
+    bool isStateful() const override { return true; }
+    void begin(const AnalysisTopology& topology) override;
+    void processFrame(const AnalysisFrame& frame) override;
+    void writeResults(std::ostream& out) const override;
+
+private:
+    TrajectoryFrame m_reference;
+    std::vector<std::pair<double, double>> m_rows;  ///< (time, msd)
+};
+
+/**
+ * @brief Counts hydrogen bonds D-H···A between N, O and F atoms.
+ *
+ * Stateless. Donor hydrogens are taken from the topology's bonds, or, when
+ * a hydrogen has none, from the nearest N/O/F within the covalent cutoff.
+ */
+class HydrogenBondStage : public AnalysisStage {
+public:
+    /**
+     * @param maxDistance Largest H···A distance.
+     * @param minAngleDegrees Smallest D-H···A angle.
+     * @param covalentCutoff Largest D-H distance when bonds are inferred.
+     */
+    HydrogenBondStage(float maxDistance, float minAngleDegrees, float covalentCutoff);
+
+    const char* getName() const override { return "hbonds"; }
+    bool isStateful() const override { return false; }
+    void begin(const AnalysisTopology& topology) override;
+    void processFrame(const AnalysisFrame& frame) override;
+    void writeResults(std::ostream& out) const override;
+
+private:
+    float m_maxDistance;
+    float m_minCosine;  ///< cos(min angle); the D-H···A angle must be at least the minimum
+    float m_covalentCutoff;
+    const AnalysisTopology* m_topology = nullptr;
+    std::vector<uint32_t> m_hydrogens;
+    std::vector<uint32_t> m_electronegative;
+
+    mutable std::mutex m_mutex;
+    std::map<size_t, std::pair<double, size_t>> m_counts;  ///< Frame -> (time, count)
+};
+
+/**
+ * @brief Kinetic, Coulomb and total energy per frame.
+ *
+ * Stateful: velocities are finite differences against the previous frame,
+ * so rows start at the second frame. The Coulomb sum is cut off at a fixed
+ * distance and only visits charged atoms. Energies are in the trajectory's
+ * units: amu·length²/time² for kinetic and e²/length for Coulomb energy.
+ */
+class EnergyStage : public AnalysisStage {
+public:
+    /**
+     * @param cutoff Coulomb interaction cutoff distance.
+     */
+    explicit EnergyStage(float cutoff);
+
+    const char* getName() const override { return "energy"; }
+    bool isStateful() const override { return true; }
+    void begin(const AnalysisTopology& topology) override;
+    void processFrame(const AnalysisFrame& frame) override;
+    void writeResults(std::ostream& out) const override;
+
+private:
+    struct Row {
+        double time;
+        double kinetic;
+        double coulomb;
+    };
+
+    float m_cutoff;
+    const AnalysisTopology* m_topology = nullptr;
+    std::vector<uint32_t> m_charged;
+    TrajectoryFrame m_previous;
+    bool m_hasPrevious = false;
+    std::vector<Row> m_rows;
+};
+
+/**
+ * @brief Solvent-accessible surface area per frame.
+ *
+ * Stateless. Reports the total area of each frame and, at the end, the
+ * mean area of every atom over all frames.
+ */
+class SasaStage : public AnalysisStage {
+public:
+    /**
+     * @param pointsPerAtom Shrake–Rupley test points per atom.
+     * @param probeRadius Solvent probe radius.
+     */
+    SasaStage(int pointsPerAtom, float probeRadius);
+
+    const char* getName() const override { return "sasa"; }
+    bool isStateful() const override { return false; }
+    void begin(const AnalysisTopology& topology) override;
+    void processFrame(const AnalysisFrame& frame) override;
+    void writeResults(std::ostream& out) const override;
+
+private:
+    SurfaceArea m_surfaceArea;
+    const AnalysisTopology* m_topology = nullptr;
+
+    mutable std::mutex m_mutex;
+    std::map<size_t, std::pair<double, double>> m_totals;  ///< Frame -> (time, area)
+    std::vector<double> m_atomSums;
+};
+
+/**
+ * @brief Conformational clustering by all-vs-all RMSD.
+ *
+ * Stateful: collects the centered coordinates of the selected atoms from
+ * every stride-th frame (up to a frame limit), then on finalize computes the
+ * RMSD matrix, GROMOS clusters, and the per-atom fluctuation (RMSF) after
+ * superposing every frame onto the first.
+ */
+class RmsdStage : public AnalysisStage {
+public:
+    /**
+     * @param selection SelectionQuery text choosing the atoms, evaluated on the first frame.
+     * @param stride Keep every stride-th frame.
+     * @param maxFrames Stop collecting after this many frames.
+     * @param clusterCutoff RMSD cutoff for clustering.
+     */
+    RmsdStage(const std::string& selection, int stride, int maxFrames, float clusterCutoff);
+
+    const char* getName() const override { return "rmsd"; }
+    bool isStateful() const override { return true; }
+    void begin(const AnalysisTopology& topology) override;
+    void processFrame(const AnalysisFrame& frame) override;
+    void finalize() override;
+    void writeResults(std::ostream& out) const override;
+
+private:
+    std::string m_selectionText;
+    size_t m_stride;
+    size_t m_maxFrames;
+    float m_clusterCutoff;
+    const AnalysisTopology* m_topology = nullptr;
+
+    std::vector<uint32_t> m_atoms;  ///< Selected atom indices, resolved on the first frame
+    bool m_resolved = false;
+    std::vector<Conformation> m_conformations;
+    std::vector<double> m_times;
+
+    std::vector<double> m_rmsdToFirst;
+    std::vector<int> m_clusters;
+    std::vector<size_t> m_centers;
+    std::vector<double> m_rmsf;
+};
+
+#endif // ANALYSIS_STAGES_H
@@ -0,0 +1,112 @@
+#include "AtomArrays.h"
+#include "PhysicsEngine.h"
+#include "TaskScheduler.h"
+#include <unordered_map>
+
+void AtomArrays::resize(size_t count) {
+    x.resize(count);
+    y.resize(count);
+    z.resize(count);
+    vx.resize(count);
+    vy.resize(count);
+    vz.resize(count);
+    atomicNumber.resize(count);
+    mass.resize(count);
+    charge.resize(count);
+    molecule.resize(count, -1);
+    bondOffsets.resize(count + 1, 0);
+}
+
+void AtomArrays::gather(const PhysicsEngine& physicsEngine) {
+    const auto& atoms = physicsEngine.getAtoms();
+    size_t count = atoms.size();
+
+    // Bonds form and break inside existing molecules, so counts alone miss them
+    if (!m_hasTopology || count != m_topologyAtomCount ||
+        physicsEngine.getMolecules().size() != m_topologyMoleculeCount ||
+        topologyRevision(physicsEngine) != m_topologyRevision) {
+        gatherTopology(physicsEngine);
+    }
+
+    TaskScheduler::getInstance().parallelFor(0, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const glm::vec3& p = atoms[i]->getPosition();
+            const glm::vec3& v = atoms[i]->getNucleus()->getVelocity();
+            x[i] = p.x;
+            y[i] = p.y;
+            z[i] = p.z;
+            vx[i] = v.x;
+            vy[i] = v.y;
+            vz[i] = v.z;
+            charge[i] = static_cast<float>(atoms[i]->getAtomicNumber()) -
+                        static_cast<float>(atoms[i]->getElectrons().size());
+        }
+    }, 8192);
+}
+
+void AtomArrays::gatherTopology(const PhysicsEngine& physicsEngine) {
+    const auto& atoms = physicsEngine.getAtoms();
+    const auto& molecules = physicsEngine.getMolecules();
+    size_t count = atoms.size();
+
+    x.resize(count);
+    y.resize(count);
+    z.resize(count);
+    vx.resize(count);
+    vy.resize(count);
+    vz.resize(count);
+    atomicNumber.resize(count);
+    mass.resize(count);
+    charge.resize(count);
+    molecule.assign(count, -1);
+
+    std::unordered_map<const Atom*, uint32_t> indexOf;
+    indexOf.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        atomicNumber[i] = static_cast<uint8_t>(atoms[i]->getAtomicNumber());
+        mass[i] = static_cast<float>(atoms[i]->getMassNumber());
+        indexOf[atoms[i].get()] = static_cast<uint32_t>(i);
+    }
+
+    // Two passes over the bonds: count degrees, then fill the CSR rows
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    for (size_t m = 0; m < molecules.size(); ++m) {
+        for (const auto& atom : molecules[m]->getAtoms()) {
+            auto it = indexOf.find(atom.get());
+            if (it != indexOf.end()) molecule[it->second] = static_cast<int32_t>(m);
+        }
+        for (const auto& bond : molecules[m]->getBonds()) {
+            auto a = indexOf.find(bond->getAtom1().get());
+            auto b = indexOf.find(bond->getAtom2().get());
+            if (a != indexOf.end() && b != indexOf.end()) {
+                edges.emplace_back(a->second, b->second);
+            }
+        }
+    }
+
+    bondOffsets.assign(count + 1, 0);
+    for (const auto& edge : edges) {
+        ++bondOffsets[edge.first + 1];
+        ++bondOffsets[edge.second + 1];
+    }
+    for (size_t i = 0; i < count; ++i) {
+        bondOffsets[i + 1] += bondOffsets[i];
+    }
+    bondNeighbors.resize(bondOffsets[count]);
+    std::vector<uint32_t> cursor(bondOffsets.begin(), bondOffsets.end() - 1);
+    for (const auto& edge : edges) {
+        bondNeighbors[cursor[edge.first]++] = edge.second;
+        bondNeighbors[cursor[edge.second]++] = edge.first;
+    }
+
+    m_topologyAtomCount = count;
+    m_topologyMoleculeCount = molecules.size();
+    m_topologyRevision = topologyRevision(physicsEngine);
+    m_hasTopology = true;
+}
+
+unsigned AtomArrays::topologyRevision(const PhysicsEngine& physicsEngine) {
+    unsigned revision = 0;
+    for (const auto& molecule : physicsEngine.getMolecules()) revision += molecule->getRevision();
+    return revision;
+}
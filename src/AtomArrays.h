@@ -0,0 +1,65 @@
+#ifndef ATOM_ARRAYS_H
+#define ATOM_ARRAYS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class PhysicsEngine;
+
+/**
+ * @brief Structure-of-arrays snapshot of the atoms in a PhysicsEngine.
+ *
+ * Bulk consumers (selection queries, trajectory output, analysis) work on
+ * contiguous per-component arrays instead of chasing shared pointers, so
+ * their inner loops vectorize and stream through memory. Index i refers to
+ * the same atom as PhysicsEngine::getAtoms()[i].
+ */
+class AtomArrays {
+public:
+    std::vector<float> x, y, z;           ///< Positions
+    std::vector<float> vx, vy, vz;        ///< Velocities (of the nucleus)
+    std::vector<uint8_t> atomicNumber;
+    std::vector<float> mass;              ///< Mass number (amu)
+    std::vector<float> charge;            ///< Net charge in elementary charges
+    std::vector<int32_t> molecule;        ///< Molecule index, -1 for free atoms
+    std::vector<uint32_t> bondOffsets;    ///< CSR row offsets into bondNeighbors (size + 1 entries)
+    std::vector<uint32_t> bondNeighbors;  ///< Bonded atom indices
+
+    AtomArrays() = default;
+
+    /**
+     * @brief Copies the current engine state into the arrays.
+     *
+     * Positions, velocities and charges are refreshed on every call; element,
+     * molecule and bond topology only when the atom or molecule count changed.
+     *
+     * @param physicsEngine The engine to snapshot.
+     */
+    void gather(const PhysicsEngine& physicsEngine);
+
+    /**
+     * @brief Gets the number of atoms in the snapshot.
+     *
+     * @return The atom count.
+     */
+    size_t size() const { return x.size(); }
+
+    /**
+     * @brief Resizes every per-atom array, for building snapshots by hand.
+     *
+     * @param count The new atom count.
+     */
+    void resize(size_t count);
+
+private:
+    size_t m_topologyAtomCount = 0;
+    size_t m_topologyMoleculeCount = 0;
+    unsigned m_topologyRevision = 0;  ///< Sum of the molecules' revisions
+    bool m_hasTopology = false;
+
+    void gatherTopology(const PhysicsEngine& physicsEngine);
+    static unsigned topologyRevision(const PhysicsEngine& physicsEngine);
+};
+
+#endif // ATOM_ARRAYS_H
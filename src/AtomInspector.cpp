@@ -0,0 +1,205 @@
+#include "AtomInspector.h"
+#include "PhysicsEngine.h"
+#include "ElementTable.h"
+#include <imgui.h>
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+AtomInspector::~AtomInspector() {
+    if (m_job) {
+        TaskScheduler::getInstance().wait(m_job);
+    }
+}
+
+void AtomInspector::setFilter(std::vector<uint32_t> atomIndices) {
+    m_filter = std::move(atomIndices);
+    m_filterChanged = true;
+}
+
+double AtomInspector::liveSortKey(const Atom& atom, size_t index, Column column) {
+    switch (column) {
+        case Column::ELEMENT:  return atom.getAtomicNumber();
+        case Column::POSITION: return atom.getPosition().x;
+        case Column::VELOCITY: return glm::length(atom.getNucleus()->getVelocity());
+        case Column::CHARGE:   return atom.getAtomicNumber() - static_cast<int>(atom.getElectrons().size());
+        default:               return static_cast<double>(index);
+    }
+}
+
+void AtomInspector::requestRebuild(const PhysicsEngine& physicsEngine) {
+    const auto& atoms = physicsEngine.getAtoms();
+    size_t atomCount = atoms.size();
+    Column column = m_sortColumn;
+    bool ascending = m_sortAscending;
+    m_sortRequested = false;
+    m_filterChanged = false;
+
+    // Positions and velocities are written by the physics step on this
+    // thread's schedule, so live sort keys are snapshotted here (in parallel)
+    // and everything else runs on a worker from immutable copies
+    auto keys = std::make_shared<std::vector<double>>();
+    auto atomPointers = std::make_shared<std::vector<const Atom*>>(atomCount);
+    bool liveKey = column != Column::MOLECULE && column != Column::BONDS;
+    if (liveKey) keys->resize(atomCount);
+
+    TaskScheduler::getInstance().parallelFor(0, atomCount, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            (*atomPointers)[i] = atoms[i].get();
+            if (liveKey) (*keys)[i] = liveSortKey(*atoms[i], i, column);
+        }
+    }, 8192);
+
+    // Molecules change their atom and bond lists on this thread too, so their
+    // membership is flattened here and the worker only sees the copies
+    const auto& moleculeList = physicsEngine.getMolecules();
+    size_t moleculeCount = moleculeList.size();
+    auto members = std::make_shared<std::vector<std::pair<const Atom*, int32_t>>>();
+    auto bondEnds = std::make_shared<std::vector<const Atom*>>();
+    for (size_t m = 0; m < moleculeCount; ++m) {
+        for (const auto& atom : moleculeList[m]->getAtoms()) {
+            members->emplace_back(atom.get(), static_cast<int32_t>(m));
+        }
+        for (const auto& bond : moleculeList[m]->getBonds()) {
+            bondEnds->push_back(bond->getAtom1().get());
+            bondEnds->push_back(bond->getAtom2().get());
+        }
+    }
+    auto filter = std::make_shared<std::vector<uint32_t>>(m_filter);
+    auto result = std::make_shared<IndexData>();
+    m_pendingIndex = result;
+
+    m_job = TaskScheduler::getInstance().submit([=] {
+        result->atomCount = atomCount;
+        result->moleculeCount = moleculeCount;
+
+        std::unordered_map<const Atom*, uint32_t> indexOf;
+        indexOf.reserve(atomCount);
+        for (size_t i = 0; i < atomCount; ++i) {
+            indexOf[(*atomPointers)[i]] = static_cast<uint32_t>(i);
+        }
+
+        result->moleculeOf.assign(atomCount, -1);
+        result->bondCount.assign(atomCount, 0);
+        for (const auto& member : *members) {
+            auto it = indexOf.find(member.first);
+            if (it != indexOf.end()) result->moleculeOf[it->second] = member.second;
+        }
+        for (const Atom* end : *bondEnds) {
+            auto it = indexOf.find(end);
+            if (it != indexOf.end() && result->bondCount[it->second] < UINT16_MAX) {
+                ++result->bondCount[it->second];
+            }
+        }
+
+        if (!liveKey) {
+            keys->resize(atomCount);
+            for (size_t i = 0; i < atomCount; ++i) {
+                (*keys)[i] = column == Column::MOLECULE ? result->moleculeOf[i] : result->bondCount[i];
+            }
+        }
+
+        auto& order = result->order;
+        if (filter->empty()) {
+            order.resize(atomCount);
+            std::iota(order.begin(), order.end(), 0u);
+        } else {
+            order.reserve(filter->size());
+            for (uint32_t index : *filter) {
+                if (index < atomCount) order.push_back(index);
+            }
+        }
+
+        // Ties fall back to the atom index so the order is deterministic
+        const auto& k = *keys;
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            if (k[a] != k[b]) return ascending ? k[a] < k[b] : k[a] > k[b];
+            return a < b;
+        });
+    });
+}
+
+void AtomInspector::render(const PhysicsEngine& physicsEngine) {
+    const auto& atoms = physicsEngine.getAtoms();
+
+    if (m_job && m_job->isDone()) {
+        m_index = std::move(m_pendingIndex);
+        m_job.reset();
+    }
+    bool stale = !m_index ||
+                 m_index->atomCount != atoms.size() ||
+                 m_index->moleculeCount != physicsEngine.getMolecules().size();
+    if (!m_job && (stale || m_sortRequested || m_filterChanged)) {
+        requestRebuild(physicsEngine);
+    }
+
+    ImGui::Begin("Atom Inspector");
+    ImGui::Text("Atoms: %zu%s", atoms.size(), m_job ? "  (indexing...)" : "");
+    ImGui::SameLine();
+    if (ImGui::Button("Re-sort")) {
+        m_sortRequested = true;
+    }
+
+    const ImGuiTableFlags flags = ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollY |
+                                  ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter |
+                                  ImGuiTableFlags_BordersV | ImGuiTableFlags_Resizable;
+    if (ImGui::BeginTable("atoms", static_cast<int>(Column::COUNT), flags, ImGui::GetContentRegionAvail())) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("#",        ImGuiTableColumnFlags_DefaultSort, 0.0f, static_cast<ImGuiID>(Column::INDEX));
+        ImGui::TableSetupColumn("Element",  ImGuiTableColumnFlags_None, 0.0f, static_cast<ImGuiID>(Column::ELEMENT));
+        ImGui::TableSetupColumn("Position", ImGuiTableColumnFlags_None, 0.0f, static_cast<ImGuiID>(Column::POSITION));
+        ImGui::TableSetupColumn("Velocity", ImGuiTableColumnFlags_None, 0.0f, static_cast<ImGuiID>(Column::VELOCITY));
+        ImGui::TableSetupColumn("Charge",   ImGuiTableColumnFlags_None, 0.0f, static_cast<ImGuiID>(Column::CHARGE));
+        ImGui::TableSetupColumn("Molecule", ImGuiTableColumnFlags_None, 0.0f, static_cast<ImGuiID>(Column::MOLECULE));
+        ImGui::TableSetupColumn("Bonds",    ImGuiTableColumnFlags_None, 0.0f, static_cast<ImGuiID>(Column::BONDS));
+        ImGui::TableHeadersRow();
+
+        if (ImGuiTableSortSpecs* specs = ImGui::TableGetSortSpecs()) {
+            if (specs->SpecsDirty) {
+                if (specs->SpecsCount > 0) {
+                    m_sortColumn = static_cast<Column>(specs->Specs[0].ColumnUserID);
+                    m_sortAscending = specs->Specs[0].SortDirection == ImGuiSortDirection_Ascending;
+                    m_sortRequested = true;
+                }
+                specs->SpecsDirty = false;
+            }
+        }
+
+        // Until the first index is ready, list atoms in storage order
+        const IndexData* index = m_index.get();
+        size_t rowCount = index ? index->order.size() : atoms.size();
+
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(rowCount));
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                size_t i = index ? index->order[row] : static_cast<size_t>(row);
+                if (i >= atoms.size()) continue;
+                const Atom& atom = *atoms[i];
+                const glm::vec3& p = atom.getPosition();
+                const glm::vec3& v = atom.getNucleus()->getVelocity();
+                bool hasRelations = index && i < index->atomCount;
+
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::Text("%zu", i);
+                ImGui::TableSetColumnIndex(1);
+                ImGui::TextUnformatted(ElementTable::getSymbol(atom.getAtomicNumber()));
+                ImGui::TableSetColumnIndex(2);
+                ImGui::Text("%.3f, %.3f, %.3f", p.x, p.y, p.z);
+                ImGui::TableSetColumnIndex(3);
+                ImGui::Text("%.3g, %.3g, %.3g", v.x, v.y, v.z);
+                ImGui::TableSetColumnIndex(4);
+                ImGui::Text("%+d", atom.getAtomicNumber() - static_cast<int>(atom.getElectrons().size()));
+                ImGui::TableSetColumnIndex(5);
+                if (hasRelations && index->moleculeOf[i] >= 0) ImGui::Text("%d", index->moleculeOf[i]);
+                else ImGui::TextUnformatted("-");
+                ImGui::TableSetColumnIndex(6);
+                if (hasRelations) ImGui::Text("%u", static_cast<unsigned>(index->bondCount[i]));
+                else ImGui::TextUnformatted("-");
+            }
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
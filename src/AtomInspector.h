@@ -0,0 +1,88 @@
+#ifndef ATOM_INSPECTOR_H
+#define ATOM_INSPECTOR_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Atom.h"
+#include "Molecule.h"
+#include "TaskScheduler.h"
+
+class PhysicsEngine;
+
+/**
+ * @brief Per-atom table view that stays cheap for million-atom scenes.
+ *
+ * Only the rows that are on screen are submitted to ImGui (via
+ * ImGuiListClipper), and they read live atom state. Everything that scales
+ * with the atom count (molecule and bond lookups, sorting) is computed on a
+ * TaskScheduler worker over index arrays and swapped in when ready, so the
+ * per-frame cost is proportional to the visible rows only.
+ */
+class AtomInspector {
+public:
+    enum class Column {
+        INDEX = 0,
+        ELEMENT,
+        POSITION,
+        VELOCITY,
+        CHARGE,
+        MOLECULE,
+        BONDS,
+        COUNT
+    };
+
+    AtomInspector() = default;
+
+    /**
+     * @brief Waits for an in-flight background job before destruction.
+     */
+    ~AtomInspector();
+
+    /**
+     * @brief Draws the inspector window.
+     *
+     * @param physicsEngine The engine whose atoms are listed.
+     */
+    void render(const PhysicsEngine& physicsEngine);
+
+    /**
+     * @brief Restricts the table to a subset of atoms.
+     *
+     * @param atomIndices Atom indices to list; empty to list every atom.
+     */
+    void setFilter(std::vector<uint32_t> atomIndices);
+
+    /**
+     * @brief Checks whether a background index/sort job is in flight.
+     *
+     * @return True while the table is waiting for new results.
+     */
+    bool isIndexing() const { return m_job != nullptr; }
+
+private:
+    /// Results of a background job, swapped in as a whole
+    struct IndexData {
+        std::vector<uint32_t> order;       ///< Row -> atom index
+        std::vector<int32_t>  moleculeOf;  ///< Atom index -> molecule index, -1 if free
+        std::vector<uint16_t> bondCount;   ///< Atom index -> number of bonds
+        size_t atomCount = 0;
+        size_t moleculeCount = 0;
+    };
+
+    std::shared_ptr<IndexData> m_index;
+    std::shared_ptr<IndexData> m_pendingIndex;
+    TaskScheduler::TaskHandle m_job;
+
+    std::vector<uint32_t> m_filter;
+    bool m_filterChanged = false;
+
+    Column m_sortColumn = Column::INDEX;
+    bool m_sortAscending = true;
+    bool m_sortRequested = false;
+
+    void requestRebuild(const PhysicsEngine& physicsEngine);
+    static double liveSortKey(const Atom& atom, size_t index, Column column);
+};
+
+#endif // ATOM_INSPECTOR_H
@@ -1,7 +1,14 @@
 #include <iostream>
+#include <fstream>
 #include <memory>
 #include <vector>
 #include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <string>
+#include <thread>
 
 // OpenGL and windowing
 #include <GL/glew.h>
@@ -15,30 +22,80 @@
 #include "BondCalculator.h"
 #include "NuclearReactor.h"
 #include "OrbitalModel.h"
+#include "SceneLoader.h"
+#include "TaskScheduler.h"
+#include "FramePacer.h"
+#include "PlaybackController.h"
+#include "TrajectoryFile.h"
+#include "AnalysisPipeline.h"
+#include "SnapshotChannel.h"
 
 // Rendering
 #include "Renderer.h"
 #include "ImGuiManager.h"
+#include "GpuProfiler.h"
 
 // Utilities
 #include "Logger.h"
 #include "ConfigManager.h"
 #include "MathUtils.h"
 
+namespace {
+// Set by SIGINT/SIGTERM so a headless run shuts down cleanly and flushes its output
+std::atomic<bool> g_interrupted{false};
+
+void onInterrupt(int) {
+    g_interrupted.store(true);
+}
+}
+
 class SandboxSimulation {
 public:
-    SandboxSimulation();
+    /// Interactive runs physics and the GUI; Headless runs physics only; Viewer shows another process's snapshots
+    enum class Mode { Interactive, Headless, Viewer };
+
+    SandboxSimulation(Mode mode = Mode::Interactive, const std::string& liveViewName = "", long maxSteps = -1);
     ~SandboxSimulation();
     bool initialize();
     void run();
 
 private:
+    Mode m_mode = Mode::Interactive;
     GLFWwindow* m_window = nullptr;
     std::unique_ptr<Renderer> m_renderer;
     std::unique_ptr<ImGuiManager> m_imguiManager;
     std::unique_ptr<PhysicsEngine> m_physicsEngine;
+    SceneLoader m_sceneLoader;
+    FramePacer m_framePacer;
+    GpuProfiler m_gpuProfiler;
+    PlaybackController m_playback;
+    TrajectoryWriter m_trajectory;
+    AnalysisPipeline m_analysis;
+    bool m_analysisActive = false;
+    AtomArrays m_recordedAtoms;
+    int m_recordInterval = 10;
+    int m_stepsSinceRecordedFrame = 0;
+    double m_simulationTime = 0.0;
+    uint64_t m_totalSteps = 0;
+    long m_maxSteps = -1;
+
+    // Live view: the simulation publishes snapshots, a viewer process reads them in place
+    std::string m_liveViewName;
+    SnapshotPublisher m_publisher;
+    AtomArrays m_publishedAtoms;
+    int m_publishInterval = 1;
+    int m_stepsSincePublish = 0;
+    SnapshotSubscriber m_subscriber;
+    SnapshotView m_snapshot;
+    bool m_haveSnapshot = false;
+    uint64_t m_tornSnapshots = 0;
+    std::chrono::steady_clock::time_point m_lastAttachAttempt;
+    unsigned m_lastCameraRevision = 0;
+    float m_fixedTimeStep = 0.016f;
 
     bool m_running = false;
+    bool m_sceneReady = false;
+    std::chrono::high_resolution_clock::time_point m_startTime;
     int m_windowWidth = 1200;
     int m_windowHeight = 800;
 
@@ -47,11 +104,17 @@ private:
 
     bool initializeWindow();
     bool initializeOpenGL();
-    void setupScene();
-    void demonstrateH2OMolecule();
+    void setupScene(SceneData& scene);
+    void commitScene(SceneData& scene);
+    void demonstrateH2OMolecule(SceneData& scene);
     void demonstrateFission();
     void demonstrateElectronJump();
     void update(float deltaTime);
+    int  fastForward(float stepSize, float& simulatedTime);
+    void recordFrame(int steps);
+    void publishSnapshot(int steps);
+    void runHeadless();
+    void pollLiveView();
     void render(float deltaTime);
     void handleInput();
     void cleanup();
@@ -60,6 +123,8 @@ private:
     static void mouseCallback(GLFWwindow* window, double xpos, double ypos);
     static void scrollCallback(GLFWwindow* window, double xoffset, double yoffset);
     static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+    static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+    static void windowRefreshCallback(GLFWwindow* window);
 	
     float   m_lastPhotonWavelength = 0.0f;
     Band    m_lastPhotonBand       = Band::VISIBLE;
@@ -67,55 +132,177 @@ private:
     bool    m_justJumped            = false;
 };
 
-SandboxSimulation::SandboxSimulation() {}
+SandboxSimulation::SandboxSimulation(Mode mode, const std::string& liveViewName, long maxSteps)
+    : m_mode(mode), m_maxSteps(maxSteps), m_liveViewName(liveViewName) {}
 
 SandboxSimulation::~SandboxSimulation() {
     cleanup();
 }
 
 bool SandboxSimulation::initialize() {
+    m_startTime = std::chrono::high_resolution_clock::now();
+    ConfigManager::getInstance().loadFromFile("config/config.ini");
+
     Logger::getInstance().setLogLevel(Logger::Level::INFO);
     Logger::getInstance().setLogFile("simulation.log");
 
-    if (!initializeWindow()) return false;
-    if (!initializeOpenGL()) return false;
+    auto& config = ConfigManager::getInstance();
+    if (m_liveViewName.empty()) m_liveViewName = config.getString("live_view_name", "");
+
+    if (m_mode != Mode::Headless) {
+        if (!initializeWindow()) return false;
+        if (!initializeOpenGL()) return false;
+
+        m_renderer = std::make_unique<Renderer>(m_window);
+        if (!m_renderer->initialize()) return false;
+
+        m_imguiManager = std::make_unique<ImGuiManager>(m_window);
+        if (!m_imguiManager->initialize()) return false;
+        m_imguiManager->setFramePacer(&m_framePacer);
+        m_imguiManager->setPlaybackController(&m_playback);
+        if (m_gpuProfiler.initialize()) {
+            m_renderer->setGpuProfiler(&m_gpuProfiler);
+            m_imguiManager->setGpuProfiler(&m_gpuProfiler);
+        }
+        m_renderer->getCamera().setPosition(glm::vec3(0.0f, 0.0f, 10.0f));
+    }
 
-    m_renderer = std::make_unique<Renderer>(m_window);
-    if (!m_renderer->initialize()) return false;
+    if (m_mode == Mode::Viewer) {
+        // The viewer only draws what the simulation process publishes
+        if (m_liveViewName.empty()) {
+            LOG_ERROR("Viewer mode needs a live view name (--attach NAME or live_view_name)");
+            return false;
+        }
+        m_physicsEngine = std::make_unique<PhysicsEngine>();
+        m_playback.setIdleRenderingEnabled(true);
+        m_running = true;
+        return true;
+    }
 
-    m_imguiManager = std::make_unique<ImGuiManager>(m_window);
-    if (!m_imguiManager->initialize()) return false;
+    if (!m_liveViewName.empty()) {
+        size_t maxAtoms = static_cast<size_t>(std::max(1, config.getInt("live_view_max_atoms", 200000)));
+        size_t maxBonds = static_cast<size_t>(std::max(1, config.getInt("live_view_max_bonds", 400000)));
+        m_publishInterval = std::max(1, config.getInt("live_view_interval", 1));
+        if (m_publisher.create(m_liveViewName, maxAtoms, maxBonds)) {
+            LOG_INFO("Publishing live view '" + m_liveViewName + "'");
+        } else {
+            LOG_ERROR(m_publisher.getError());
+        }
+    }
+    m_playback.setIdleRenderingEnabled(ConfigManager::getInstance().getBool("idle_rendering", true));
+    m_playback.setPhysicsBudgetFraction(ConfigManager::getInstance().getFloat("fast_forward_budget_fraction", 0.75f));
+    m_fixedTimeStep = ConfigManager::getInstance().getFloat("time_step", m_fixedTimeStep);
 
     m_physicsEngine = std::make_unique<PhysicsEngine>();
 
-    setupScene();
+    m_recordInterval = std::max(1, ConfigManager::getInstance().getInt("trajectory_interval", m_recordInterval));
+    std::string trajectoryFile = ConfigManager::getInstance().getString("trajectory_file", "");
+    if (!trajectoryFile.empty()) {
+        m_trajectory.open(trajectoryFile,
+                          ConfigManager::getInstance().getFloat("trajectory_precision", 0.001f),
+                          ConfigManager::getInstance().getInt("trajectory_keyframe_interval", 100));
+    }
+    addAnalysisStages(m_analysis, ConfigManager::getInstance().getString("analysis_stages", ""));
+    m_analysisActive = m_analysis.hasStages();
+
+    // Scene construction runs in the background so the first frame (with a
+    // progress bar) is presented immediately, whatever the scene size
+    m_sceneLoader.start(
+        [this](SceneData& scene) { setupScene(scene); },
+        ConfigManager::getInstance().getString("scene_file", ""),
+        [this](SceneData& scene) { commitScene(scene); });
 
-    // make sure camera is a good distance
-    m_renderer->getCamera().setPosition(glm::vec3(0.0f, 0.0f, 10.0f));
     m_running = true;
 
     return true;
 }
 
 void SandboxSimulation::run() {
-    auto lastTime = std::chrono::high_resolution_clock::now();
+    // Longest step physics may take after a stall or an idle period
+    const float MAX_FRAME_DELTA = 0.1f;
+    // Upper bound on an idle wait, so background work is still picked up
+    const double IDLE_WAIT_TIMEOUT = 0.25;
+    const double LIVE_VIEW_POLL_INTERVAL = 0.004;
+
+    if (m_mode == Mode::Headless) {
+        runHeadless();
+        return;
+    }
+
+    bool firstFrame = true;
     while (m_running && !glfwWindowShouldClose(m_window)) {
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        float deltaTime = std::chrono::duration<float>(currentTime - lastTime).count();
-        lastTime = currentTime;
+        float frameTime = m_framePacer.beginFrame();
+        float deltaTime = std::min(frameTime, MAX_FRAME_DELTA);
+
+        TaskScheduler::getInstance().pumpMainThread();
 
         handleInput();
-        update(deltaTime);
+        if (m_mode == Mode::Viewer) pollLiveView();
+        float simulatedTime = 0.0f;
+        int steps = 0;
+        if (m_sceneReady) {
+            if (m_playback.consumeStepRequest()) {
+                update(m_fixedTimeStep);
+                simulatedTime = m_fixedTimeStep;
+                steps = 1;
+            } else if (!m_playback.isPaused()) {
+                if (m_playback.isFastForward()) {
+                    steps = fastForward(m_fixedTimeStep, simulatedTime);
+                } else {
+                    update(deltaTime);
+                    simulatedTime = deltaTime;
+                    steps = 1;
+                }
+            }
+            if (steps > 0) {
+                m_simulationTime += simulatedTime;
+                m_totalSteps += steps;
+                recordFrame(steps);
+                publishSnapshot(steps);
+                m_playback.markDirty();
+            }
+        }
+        m_playback.recordFrame(frameTime, simulatedTime, steps);
+
+        unsigned cameraRevision = m_renderer->getCamera().getRevision();
+        if (cameraRevision != m_lastCameraRevision || m_renderer->hasActiveAnimations() ||
+            m_sceneLoader.isLoading() || m_imguiManager->hasBackgroundWork()) {
+            m_lastCameraRevision = cameraRevision;
+            m_playback.markDirty();
+        }
+
+        if (!m_playback.needsRedraw()) {
+            // Nothing changed: block until input arrives instead of redrawing; an
+            // attached viewer wakes often enough to pick up new snapshots promptly
+            glfwWaitEventsTimeout(m_subscriber.isAttached() ? LIVE_VIEW_POLL_INTERVAL : IDLE_WAIT_TIMEOUT);
+            continue;
+        }
+
         render(deltaTime);
+        m_playback.frameRendered();
 
+        m_framePacer.beginPresent();
         glfwSwapBuffers(m_window);
+        m_framePacer.endPresent();
         glfwPollEvents();
+
+        if (firstFrame) {
+            float ms = std::chrono::duration<float, std::milli>(
+                std::chrono::high_resolution_clock::now() - m_startTime).count();
+            LOG_INFO("First frame presented after " + std::to_string(ms) + " ms");
+            firstFrame = false;
+        }
+
+        m_framePacer.waitForNextFrame();
     }
 }
 
 bool SandboxSimulation::initializeWindow() {
     if (!glfwInit()) return false;
 
+    m_windowWidth = ConfigManager::getInstance().getInt("window_width", m_windowWidth);
+    m_windowHeight = ConfigManager::getInstance().getInt("window_height", m_windowHeight);
+
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
@@ -131,11 +318,19 @@ bool SandboxSimulation::initializeWindow() {
     }
 
     glfwMakeContextCurrent(m_window);
+
+    auto& config = ConfigManager::getInstance();
+    bool vsync = config.getBool("vsync", true);
+    glfwSwapInterval(vsync ? 1 : 0);
+    const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+    m_framePacer.configure(vsync, config.getInt("max_fps", 60), mode ? mode->refreshRate : 0);
     glfwSetWindowUserPointer(m_window, this);
     glfwSetFramebufferSizeCallback(m_window, framebufferSizeCallback);
     glfwSetCursorPosCallback(m_window, mouseCallback);
     glfwSetScrollCallback(m_window, scrollCallback);
     glfwSetKeyCallback(m_window, keyCallback);
+    glfwSetMouseButtonCallback(m_window, mouseButtonCallback);
+    glfwSetWindowRefreshCallback(m_window, windowRefreshCallback);
     glfwSetInputMode(m_window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
     return true;
 }
@@ -146,16 +341,38 @@ bool SandboxSimulation::initializeOpenGL() {
     return err == GLEW_OK;
 }
 
-void SandboxSimulation::setupScene() {
-    demonstrateH2OMolecule();
+// Runs on a worker thread: only touches the SceneData it is given
+void SandboxSimulation::setupScene(SceneData& scene) {
+    demonstrateH2OMolecule(scene);
 
     auto carbon = std::make_shared<Atom>(6, 12, glm::vec3(3.0f, 0.0f, 0.0f));
     auto nitrogen = std::make_shared<Atom>(7, 14, glm::vec3(-3.0f, 0.0f, 0.0f));
-    m_physicsEngine->addAtom(carbon);
-    m_physicsEngine->addAtom(nitrogen);
+    scene.atoms.push_back(carbon);
+    scene.atoms.push_back(nitrogen);
 }
 
-void SandboxSimulation::demonstrateH2OMolecule() {
+// Runs on the main thread once every loading stage has finished
+void SandboxSimulation::commitScene(SceneData& scene) {
+    for (const auto& molecule : scene.molecules) {
+        m_physicsEngine->addMolecule(molecule);
+    }
+    for (const auto& atom : scene.atoms) {
+        m_physicsEngine->addAtom(atom);
+    }
+    if (m_renderer) {
+        for (const auto& label : scene.energyLabels) {
+            m_renderer->addEnergyLabel(label.position, label.energy, label.duration);
+        }
+    }
+    m_sceneReady = true;
+
+    float ms = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - m_startTime).count();
+    LOG_INFO("Scene ready with " + std::to_string(m_physicsEngine->getAtoms().size()) +
+             " atoms after " + std::to_string(ms) + " ms");
+}
+
+void SandboxSimulation::demonstrateH2OMolecule(SceneData& scene) {
     auto oxygen = std::make_shared<Atom>(8, 16, glm::vec3(0.0f, 0.0f, 0.0f));
     auto hydrogen1 = std::make_shared<Atom>(1, 1, glm::vec3(1.0f, 0.5f, 0.0f));
     auto hydrogen2 = std::make_shared<Atom>(1, 1, glm::vec3(-1.0f, 0.5f, 0.0f));
@@ -173,10 +390,10 @@ void SandboxSimulation::demonstrateH2OMolecule() {
     h2o->addBond(bond1);
     h2o->addBond(bond2);
 
-    m_physicsEngine->addMolecule(h2o);
+    scene.molecules.push_back(h2o);
 
-    m_renderer->addEnergyLabel(glm::vec3(0.5f, 0.25f, 0.0f), bond1->getEnergy(), 5.0f);
-    m_renderer->addEnergyLabel(glm::vec3(-0.5f, 0.25f, 0.0f), bond2->getEnergy(), 5.0f);
+    scene.energyLabels.push_back({glm::vec3(0.5f, 0.25f, 0.0f), bond1->getEnergy(), 5.0f});
+    scene.energyLabels.push_back({glm::vec3(-0.5f, 0.25f, 0.0f), bond2->getEnergy(), 5.0f});
 }
 
 void SandboxSimulation::demonstrateElectronJump() {
@@ -220,6 +437,9 @@ void SandboxSimulation::demonstrateElectronJump() {
 
         // tell renderer to draw wave
         m_renderer->triggerPhotonDisplay(wavelength, b, origin);
+
+        // and send the photon itself to the other atoms
+        m_physicsEngine->emitPhoton(atom->getPosition(), energyEv, atom);
     }
 }
 
@@ -227,16 +447,153 @@ void SandboxSimulation::update(float deltaTime) {
     m_physicsEngine->update(deltaTime);
 }
 
+// Runs fixed steps until the physics share of the frame budget is used up;
+// only the state after the last step gets rendered
+int SandboxSimulation::fastForward(float stepSize, float& simulatedTime) {
+    const int MAX_STEPS_PER_FRAME = 100000;
+
+    float budget = m_framePacer.getFrameBudget();
+    float physicsTime = (budget > 0.0f ? budget : 1.0f / 60.0f) * m_playback.getPhysicsBudgetFraction();
+    // Input and scene work already ate into this frame; never run past its deadline
+    if (budget > 0.0f) physicsTime = std::min(physicsTime, m_framePacer.getRemainingBudget());
+    auto deadline = std::chrono::steady_clock::now() +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<float>(physicsTime));
+
+    int steps = 0;
+    do {
+        m_physicsEngine->update(stepSize);
+        ++steps;
+    } while (steps < MAX_STEPS_PER_FRAME && std::chrono::steady_clock::now() < deadline);
+
+    simulatedTime = steps * stepSize;
+    return steps;
+}
+
+// Only the state after the last step of a frame is available, so with
+// fast-forward the recorded interval is at least trajectory_interval steps
+void SandboxSimulation::recordFrame(int steps) {
+    if (!m_trajectory.isOpen() && !m_analysisActive) return;
+    m_stepsSinceRecordedFrame += steps;
+    if (m_stepsSinceRecordedFrame < m_recordInterval) return;
+    m_stepsSinceRecordedFrame = 0;
+
+    m_recordedAtoms.gather(*m_physicsEngine);
+    m_trajectory.writeFrame(m_recordedAtoms, m_simulationTime);
+
+    if (m_analysisActive) {
+        if (!m_analysis.hasBegun()) {
+            m_analysis.begin(AnalysisTopology::fromAtomArrays(m_recordedAtoms));
+        } else if (m_recordedAtoms.size() != m_analysis.getTopology().size()) {
+            LOG_WARNING("Atom count changed; inline analysis stopped");
+            m_analysisActive = false;
+            return;
+        }
+        TrajectoryFrame frame;
+        frame.x = m_recordedAtoms.x;
+        frame.y = m_recordedAtoms.y;
+        frame.z = m_recordedAtoms.z;
+        frame.time = m_simulationTime;
+        m_analysis.pushFrame(std::move(frame));
+    }
+}
+
+void SandboxSimulation::publishSnapshot(int steps) {
+    if (!m_publisher.isOpen()) return;
+    m_stepsSincePublish += steps;
+    if (m_stepsSincePublish < m_publishInterval) return;
+    m_stepsSincePublish = 0;
+
+    m_publishedAtoms.gather(*m_physicsEngine);
+    m_publisher.publish(m_publishedAtoms, m_simulationTime, m_totalSteps);
+}
+
+// Steps physics as fast as it will go, with no window; viewers attach through the live view
+void SandboxSimulation::runHeadless() {
+    std::signal(SIGINT, onInterrupt);
+    std::signal(SIGTERM, onInterrupt);
+    LOG_INFO("Running headless" + (m_maxSteps >= 0 ? " for " + std::to_string(m_maxSteps) + " steps" : std::string()));
+
+    while (m_running && !g_interrupted.load()) {
+        TaskScheduler::getInstance().pumpMainThread();
+        if (!m_sceneReady) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+        if (m_maxSteps >= 0 && m_totalSteps >= static_cast<uint64_t>(m_maxSteps)) break;
+
+        update(m_fixedTimeStep);
+        m_simulationTime += m_fixedTimeStep;
+        ++m_totalSteps;
+        recordFrame(1);
+        publishSnapshot(1);
+    }
+    LOG_INFO("Headless run stopped after " + std::to_string(m_totalSteps) + " steps");
+}
+
+// Keeps the viewer attached while the live view is enabled and picks up new snapshots
+void SandboxSimulation::pollLiveView() {
+    const auto RETRY_INTERVAL = std::chrono::milliseconds(500);
+    bool wanted = m_imguiManager->isLiveViewEnabled();
+
+    if (m_subscriber.isAttached() && (!wanted || m_subscriber.isPublisherClosed())) {
+        if (wanted) LOG_INFO("Live view '" + m_liveViewName + "' closed by the simulation");
+        m_subscriber.detach();
+        m_haveSnapshot = false;
+        m_playback.markDirty();
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (wanted && !m_subscriber.isAttached() && now - m_lastAttachAttempt >= RETRY_INTERVAL) {
+        m_lastAttachAttempt = now;
+        if (m_subscriber.attach(m_liveViewName) && !m_subscriber.isPublisherClosed()) {
+            LOG_INFO("Attached to live view '" + m_liveViewName + "'");
+        } else {
+            m_subscriber.detach();
+        }
+    }
+
+    SnapshotView view;
+    if (m_subscriber.acquire(view) && (!m_haveSnapshot || view.frame != m_snapshot.frame)) {
+        m_snapshot = view;
+        m_haveSnapshot = true;
+        m_playback.markDirty();
+    }
+}
+
 void SandboxSimulation::render(float deltaTime) {
+    m_gpuProfiler.beginFrame();
     m_imguiManager->newFrame();
 
-    m_renderer->render(
-      m_physicsEngine->getAtoms(),
-      m_physicsEngine->getMolecules(),
-      deltaTime
-    );
-
-    m_imguiManager->render(*m_physicsEngine);
+    m_renderer->setHighlightSelection(m_imguiManager->getHighlightSelection());
+    m_renderer->setSurfaceColoring(m_imguiManager->getSurfaceColoring());
+    m_renderer->setIsosurfaces(m_imguiManager->getIsosurfaces());
+    if (m_mode == Mode::Viewer) {
+        // A snapshot overwritten mid-read is replaced by the newer one and drawn again
+        const int MAX_ATTEMPTS = 3;
+        bool drawn = false;
+        for (int attempt = 0; m_haveSnapshot && attempt < MAX_ATTEMPTS && !drawn; ++attempt) {
+            drawn = m_renderer->renderSnapshot(m_snapshot, deltaTime);
+            if (!drawn) {
+                ++m_tornSnapshots;
+                m_haveSnapshot = m_subscriber.acquire(m_snapshot);
+            }
+        }
+        if (!drawn) {
+            m_renderer->render({}, {}, deltaTime);
+        }
+        m_imguiManager->renderLiveView(m_liveViewName, m_subscriber.isAttached(),
+                                       m_haveSnapshot ? &m_snapshot : nullptr, m_tornSnapshots);
+    } else {
+        m_renderer->render(
+          m_physicsEngine->getAtoms(),
+          m_physicsEngine->getMolecules(),
+          deltaTime
+        );
+        m_imguiManager->render(*m_physicsEngine);
+    }
+    if (m_sceneLoader.isLoading()) {
+        m_imguiManager->renderLoadingProgress(m_sceneLoader.getProgress(), m_sceneLoader.getStatus());
+    }
 
     m_imguiManager->endFrame();
 }
@@ -247,7 +604,22 @@ void SandboxSimulation::handleInput() {
 }
 
 void SandboxSimulation::cleanup() {
+    m_publisher.close();
+    m_subscriber.detach();
+    m_trajectory.close();
+    if (m_analysis.hasBegun()) {
+        m_analysis.finish();
+        std::string path = ConfigManager::getInstance().getString("analysis_output", "analysis.txt");
+        std::ofstream out(path);
+        if (out.is_open()) {
+            m_analysis.writeResults(out);
+            LOG_INFO("Analysis results written to " + path);
+        } else {
+            LOG_ERROR("Failed to write analysis results to " + path);
+        }
+    }
     if (m_window) {
+        m_gpuProfiler.shutdown();
         glfwDestroyWindow(m_window);
         glfwTerminate();
     }
@@ -258,10 +630,12 @@ void SandboxSimulation::framebufferSizeCallback(GLFWwindow* window, int width, i
     app->m_windowWidth = width;
     app->m_windowHeight = height;
     app->m_renderer->onWindowResize(width, height);
+    app->m_playback.markDirty();
 }
 
 void SandboxSimulation::mouseCallback(GLFWwindow* window, double xpos, double ypos) {
     auto* app = static_cast<SandboxSimulation*>(glfwGetWindowUserPointer(window));
+    app->m_playback.markDirty();
     if (app->m_firstMouse) {
         app->m_lastX = static_cast<float>(xpos);
         app->m_lastY = static_cast<float>(ypos);
@@ -269,12 +643,53 @@ void SandboxSimulation::mouseCallback(GLFWwindow* window, double xpos, double yp
     }
 }
 
-void SandboxSimulation::scrollCallback(GLFWwindow* window, double xoffset, double yoffset) {}
+void SandboxSimulation::scrollCallback(GLFWwindow* window, double /*xoffset*/, double /*yoffset*/) {
+    auto* app = static_cast<SandboxSimulation*>(glfwGetWindowUserPointer(window));
+    app->m_playback.markDirty();
+}
+
+void SandboxSimulation::keyCallback(GLFWwindow* window, int key, int /*scancode*/, int action, int /*mods*/) {
+    auto* app = static_cast<SandboxSimulation*>(glfwGetWindowUserPointer(window));
+    app->m_playback.markDirty();
+    if (key == GLFW_KEY_SPACE && action == GLFW_PRESS &&
+        app->m_imguiManager && !app->m_imguiManager->isKeyboardCapturedByUI()) {
+        app->m_playback.togglePause();
+    }
+}
 
-void SandboxSimulation::keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {}
+void SandboxSimulation::mouseButtonCallback(GLFWwindow* window, int /*button*/, int /*action*/, int /*mods*/) {
+    auto* app = static_cast<SandboxSimulation*>(glfwGetWindowUserPointer(window));
+    app->m_playback.markDirty();
+}
+
+void SandboxSimulation::windowRefreshCallback(GLFWwindow* window) {
+    auto* app = static_cast<SandboxSimulation*>(glfwGetWindowUserPointer(window));
+    app->m_playback.markDirty();
+}
+
+int main(int argc, char** argv) {
+    // --headless [--steps N] runs the simulation without a window;
+    // --attach NAME opens a viewer on the live view NAME published by another process
+    SandboxSimulation::Mode mode = SandboxSimulation::Mode::Interactive;
+    std::string liveViewName;
+    long maxSteps = -1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            mode = SandboxSimulation::Mode::Headless;
+        } else if (std::strcmp(argv[i], "--attach") == 0 && i + 1 < argc) {
+            mode = SandboxSimulation::Mode::Viewer;
+            liveViewName = argv[++i];
+        } else if (std::strcmp(argv[i], "--live-view") == 0 && i + 1 < argc) {
+            liveViewName = argv[++i];
+        } else if (std::strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+            maxSteps = std::atol(argv[++i]);
+        } else {
+            std::cerr << "Usage: Atomica [--headless [--steps N]] [--live-view NAME] [--attach NAME]\n";
+            return -1;
+        }
+    }
 
-int main() {
-    SandboxSimulation app;
+    SandboxSimulation app(mode, liveViewName, maxSteps);
     if (!app.initialize()) return -1;
     app.run();
     return 0;
@@ -1,4 +1,5 @@
 #include "BondCalculator.h"
+#include <algorithm>
 #include <iostream>
 
 BondCalculator::BondCalculator() {
@@ -47,6 +48,16 @@ float BondCalculator::getBondEnergy(Bond::Type type) const {
     return 0.0f; 
 }
 
+float BondCalculator::estimateActivationEnergy(const std::vector<Bond::Type>& broken,
+                                               const std::vector<Bond::Type>& formed) const {
+    // Reaction energy: what it costs to break the old bonds minus what the new ones return
+    float reactionEnergy = 0.0f;
+    for (Bond::Type type : broken) reactionEnergy += getBondEnergy(type);
+    for (Bond::Type type : formed) reactionEnergy -= getBondEnergy(type);
+    float barrier = INTRINSIC_BARRIER_EV + TRANSFER_COEFFICIENT * reactionEnergy;
+    return std::max(0.0f, std::max(reactionEnergy, barrier));
+}
+
 std::string BondCalculator::bondTypeToString(Bond::Type type) const {
     switch (type) {
         case Bond::Type::SINGLE: return "SINGLE";
@@ -4,6 +4,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "Bond.h"
 #include "Atom.h"
 
@@ -37,7 +38,25 @@ public:
      */
     float getBondEnergy(Bond::Type type) const;
 
+    /**
+     * @brief Estimates the activation energy of a reaction from the bonds it changes.
+     *
+     * Uses the Evans–Polanyi relation Ea = E0 + α·ΔH, where ΔH is the energy
+     * of the bonds broken minus that of the bonds formed. The result is never
+     * below ΔH, since an endothermic step must at least supply its reaction
+     * energy, and never below zero.
+     *
+     * @param broken Bonds broken by the reaction.
+     * @param formed Bonds formed by the reaction.
+     * @return The activation energy in eV, for an Arrhenius rate constant.
+     */
+    float estimateActivationEnergy(const std::vector<Bond::Type>& broken, const std::vector<Bond::Type>& formed) const;
+
 private:
+    // Evans–Polanyi parameters: intrinsic barrier (eV) and transfer coefficient
+    static constexpr float INTRINSIC_BARRIER_EV = 0.5f;
+    static constexpr float TRANSFER_COEFFICIENT = 0.5f;
+
     // Tabulated bond energies (example values, will need realistic data)
     std::unordered_map<Bond::Type, float> m_bondEnergies;
 
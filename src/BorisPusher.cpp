@@ -0,0 +1,70 @@
+#include "BorisPusher.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define ATOMICA_BORIS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+void BorisPusher::push(const BorisBatch& batch, float velocityStep, float positionStep) {
+    const float h = 0.5f * velocityStep;
+    size_t i = 0;
+
+#ifdef ATOMICA_BORIS_SSE2
+    const __m128 half = _mm_set1_ps(h), step = _mm_set1_ps(positionStep);
+    const __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f);
+    for (; i + 4 <= batch.count; i += 4) {
+        __m128 ax = _mm_mul_ps(half, _mm_loadu_ps(batch.ax + i));
+        __m128 ay = _mm_mul_ps(half, _mm_loadu_ps(batch.ay + i));
+        __m128 az = _mm_mul_ps(half, _mm_loadu_ps(batch.az + i));
+        __m128 vx = _mm_add_ps(_mm_loadu_ps(batch.vx + i), ax);
+        __m128 vy = _mm_add_ps(_mm_loadu_ps(batch.vy + i), ay);
+        __m128 vz = _mm_add_ps(_mm_loadu_ps(batch.vz + i), az);
+
+        __m128 tx = _mm_mul_ps(half, _mm_loadu_ps(batch.wx + i));
+        __m128 ty = _mm_mul_ps(half, _mm_loadu_ps(batch.wy + i));
+        __m128 tz = _mm_mul_ps(half, _mm_loadu_ps(batch.wz + i));
+        __m128 t2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty)), _mm_mul_ps(tz, tz));
+        __m128 f = _mm_div_ps(two, _mm_add_ps(one, t2));
+        __m128 sx = _mm_mul_ps(f, tx), sy = _mm_mul_ps(f, ty), sz = _mm_mul_ps(f, tz);
+
+        // v' = v + v × t, then v += v' × s
+        __m128 px = _mm_add_ps(vx, _mm_sub_ps(_mm_mul_ps(vy, tz), _mm_mul_ps(vz, ty)));
+        __m128 py = _mm_add_ps(vy, _mm_sub_ps(_mm_mul_ps(vz, tx), _mm_mul_ps(vx, tz)));
+        __m128 pz = _mm_add_ps(vz, _mm_sub_ps(_mm_mul_ps(vx, ty), _mm_mul_ps(vy, tx)));
+        vx = _mm_add_ps(vx, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(py, sz), _mm_mul_ps(pz, sy)), ax));
+        vy = _mm_add_ps(vy, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(pz, sx), _mm_mul_ps(px, sz)), ay));
+        vz = _mm_add_ps(vz, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(px, sy), _mm_mul_ps(py, sx)), az));
+
+        _mm_storeu_ps(batch.vx + i, vx);
+        _mm_storeu_ps(batch.vy + i, vy);
+        _mm_storeu_ps(batch.vz + i, vz);
+        if (positionStep != 0.0f) {
+            _mm_storeu_ps(batch.x + i, _mm_add_ps(_mm_loadu_ps(batch.x + i), _mm_mul_ps(step, vx)));
+            _mm_storeu_ps(batch.y + i, _mm_add_ps(_mm_loadu_ps(batch.y + i), _mm_mul_ps(step, vy)));
+            _mm_storeu_ps(batch.z + i, _mm_add_ps(_mm_loadu_ps(batch.z + i), _mm_mul_ps(step, vz)));
+        }
+    }
+#endif
+
+    for (; i < batch.count; ++i) {
+        float ax = h * batch.ax[i], ay = h * batch.ay[i], az = h * batch.az[i];
+        float vx = batch.vx[i] + ax, vy = batch.vy[i] + ay, vz = batch.vz[i] + az;
+        float tx = h * batch.wx[i], ty = h * batch.wy[i], tz = h * batch.wz[i];
+        float f = 2.0f / (1.0f + tx * tx + ty * ty + tz * tz);
+        float sx = f * tx, sy = f * ty, sz = f * tz;
+        float px = vx + (vy * tz - vz * ty);
+        float py = vy + (vz * tx - vx * tz);
+        float pz = vz + (vx * ty - vy * tx);
+        vx += (py * sz - pz * sy) + ax;
+        vy += (pz * sx - px * sz) + ay;
+        vz += (px * sy - py * sx) + az;
+        batch.vx[i] = vx;
+        batch.vy[i] = vy;
+        batch.vz[i] = vz;
+        if (positionStep != 0.0f) {
+            batch.x[i] += positionStep * vx;
+            batch.y[i] += positionStep * vy;
+            batch.z[i] += positionStep * vz;
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#include "BrickDecomposition.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+const double SMOOTHING = 0.25;
+}
+
+void BrickDecomposition::reset() {
+    m_cellCount = 0;
+    m_brickCost.clear();
+    m_brickTime.clear();
+    m_groupStart.clear();
+    m_measured = false;
+    m_imbalance = 1.0;
+}
+
+void BrickDecomposition::layout(const CellGrid& grid, size_t groups) {
+    const size_t cellCount = grid.getCellCount();
+    const size_t wanted = std::max<size_t>(1, std::min(cellCount, groups * BRICKS_PER_GROUP));
+    if (cellCount == m_cellCount && !m_brickCost.empty() && getGroupCount() == groups) return;
+
+    // A new grid shape invalidates the timings; start from point counts instead
+    m_cellCount = cellCount;
+    m_cellsPerBrick = std::max<size_t>(1, (cellCount + wanted - 1) / wanted);
+    const size_t brickCount = std::max<size_t>(1, (cellCount + m_cellsPerBrick - 1) / m_cellsPerBrick);
+    const std::vector<uint32_t>& cellStart = grid.getCellStart();
+    m_brickCost.assign(brickCount, 0.0);
+    m_brickTime.assign(brickCount, 0.0);
+    for (size_t b = 0; b < brickCount && cellCount > 0; ++b) {
+        size_t first = b * m_cellsPerBrick;
+        size_t last = std::min(first + m_cellsPerBrick, cellCount);
+        m_brickCost[b] = cellStart[last] - cellStart[first];
+    }
+    m_measured = false;
+    m_groupStart.assign(groups + 1, 0);
+}
+
+void BrickDecomposition::assign(size_t groups) {
+    // Contiguous runs of bricks with equal cumulative cost
+    const size_t brickCount = m_brickCost.size();
+    double total = 0.0;
+    for (double cost : m_brickCost) total += cost;
+    m_groupStart[0] = 0;
+    double cumulative = 0.0;
+    size_t b = 0;
+    for (size_t g = 1; g < groups; ++g) {
+        double target = total * g / groups;
+        while (b < brickCount && cumulative + 0.5 * m_brickCost[b] < target) cumulative += m_brickCost[b++];
+        m_groupStart[g] = b;
+    }
+    m_groupStart[groups] = brickCount;
+}
+
+void BrickDecomposition::run(const CellGrid& grid, const std::function<void(size_t, size_t)>& body) {
+    TaskScheduler& scheduler = TaskScheduler::getInstance();
+    const size_t groups = scheduler.getWorkerCount() + 1;
+    layout(grid, groups);
+    assign(groups);
+
+    const std::vector<uint32_t>& cellStart = grid.getCellStart();
+    const size_t cellCount = m_cellCount;
+    std::vector<double> groupTime(groups, 0.0);
+    scheduler.parallelFor(0, groups, [&](size_t firstGroup, size_t lastGroup) {
+        for (size_t g = firstGroup; g < lastGroup; ++g) {
+            for (size_t b = m_groupStart[g]; b < m_groupStart[g + 1]; ++b) {
+                size_t firstCell = b * m_cellsPerBrick;
+                size_t lastCell = std::min(firstCell + m_cellsPerBrick, cellCount);
+                auto start = std::chrono::steady_clock::now();
+                if (cellCount > 0) body(cellStart[firstCell], cellStart[lastCell]);
+                m_brickTime[b] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                groupTime[g] += m_brickTime[b];
+            }
+        }
+    }, 1);
+
+    for (size_t b = 0; b < m_brickCost.size(); ++b) {
+        m_brickCost[b] = m_measured ? m_brickCost[b] + (m_brickTime[b] - m_brickCost[b]) * SMOOTHING
+                                    : m_brickTime[b];
+    }
+    m_measured = true;
+
+    double slowest = 0.0, sum = 0.0;
+    for (double t : groupTime) {
+        slowest = std::max(slowest, t);
+        sum += t;
+    }
+    m_imbalance = sum > 0.0 ? slowest / (sum / groups) : 1.0;
+}
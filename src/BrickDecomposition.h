@@ -0,0 +1,63 @@
+#ifndef BRICK_DECOMPOSITION_H
+#define BRICK_DECOMPOSITION_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "CellGrid.h"
+
+/**
+ * @brief Splits a cell grid into bricks owned by worker threads.
+ *
+ * Each brick is a run of consecutive cells of a CellGrid, and each worker
+ * group owns a contiguous run of bricks, so a group's atoms sit together in
+ * space. A neighbour loop gives every atom its full interaction list (both
+ * sides of each pair, including pairs across a brick boundary) and writes
+ * only that atom's own results. Nothing is shared between threads, so there
+ * are no per-thread force buffers, no atomics and no reduction pass.
+ *
+ * The cost of every brick is timed on each run. Before the next run the
+ * bricks are handed out again so each group gets an equal share of the
+ * smoothed cost. This keeps dense regions from stalling one thread.
+ */
+class BrickDecomposition {
+public:
+    /// Bricks per worker group, so ownership can shift in small steps
+    static constexpr size_t BRICKS_PER_GROUP = 8;
+
+    BrickDecomposition() = default;
+
+    /**
+     * @brief Runs a loop over every point of a grid, one task per worker group.
+     *
+     * @param grid The grid; its layout must not change during the call.
+     * @param body Called with a range [begin, end) of positions in
+     *             grid.getOrderedPoints(); it may write only to the points in that range.
+     */
+    void run(const CellGrid& grid, const std::function<void(size_t, size_t)>& body);
+
+    /**
+     * @brief Forgets measured costs, e.g. after the system changed completely.
+     */
+    void reset();
+
+    size_t getBrickCount() const { return m_brickCost.size(); }
+    size_t getGroupCount() const { return m_groupStart.empty() ? 0 : m_groupStart.size() - 1; }
+
+    /// Slowest group's time over the mean in the last run (1 is perfect balance)
+    double getImbalance() const { return m_imbalance; }
+
+private:
+    size_t m_cellCount = 0;
+    size_t m_cellsPerBrick = 1;
+    std::vector<double> m_brickCost;   ///< Smoothed seconds per brick
+    std::vector<double> m_brickTime;   ///< Seconds per brick in the last run
+    std::vector<size_t> m_groupStart;  ///< Group -> first brick (group count + 1 entries)
+    bool m_measured = false;
+    double m_imbalance = 1.0;
+
+    void layout(const CellGrid& grid, size_t groups);
+    void assign(size_t groups);
+};
+
+#endif // BRICK_DECOMPOSITION_H
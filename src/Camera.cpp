@@ -30,6 +30,7 @@ glm::mat4 Camera::getProjectionMatrix() const {
 
 void Camera::setAspectRatio(float aspectRatio) {
     m_aspectRatio = aspectRatio;
+    ++m_revision;
 }
 
 void Camera::processMouseMovement(float xOffset, float yOffset) {
@@ -56,5 +57,6 @@ void Camera::updateCameraPosition() {
     float z = m_radius * sin(m_phi) * sin(m_theta);
     
     m_position = m_target + glm::vec3(x, y, z);
+    ++m_revision;
 }
 
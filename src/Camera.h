@@ -42,7 +42,7 @@ public:
      * 
      * @param position The new camera position.
      */
-    void setPosition(const glm::vec3& position) { m_position = position; }
+    void setPosition(const glm::vec3& position) { m_position = position; ++m_revision; }
 
     /**
      * @brief Gets the camera position.
@@ -56,7 +56,7 @@ public:
      * 
      * @param target The new camera target.
      */
-    void setTarget(const glm::vec3& target) { m_target = target; }
+    void setTarget(const glm::vec3& target) { m_target = target; ++m_revision; }
 
     /**
      * @brief Gets the camera target.
@@ -65,6 +65,11 @@ public:
      */
     const glm::vec3& getTarget() const { return m_target; }
 
+    const glm::vec3& getUp() const { return m_up; }
+
+    /// Vertical field of view in degrees
+    float getFov() const { return m_fov; }
+
     /**
      * @brief Updates the projection matrix with new aspect ratio.
      * 
@@ -87,6 +92,13 @@ public:
      */
     void processMouseScroll(float yOffset);
 
+    /**
+     * @brief Gets a counter that changes whenever the view or projection changes.
+     * 
+     * @return The current revision number.
+     */
+    unsigned getRevision() const { return m_revision; }
+
 private:
     glm::vec3 m_position;
     glm::vec3 m_target;
@@ -106,6 +118,8 @@ private:
     float m_radius;
     float m_theta; // Azimuthal angle
     float m_phi;   // Polar angle
+
+    unsigned m_revision = 0;
     
     /**
      * @brief Updates the camera position based on spherical coordinates.
@@ -0,0 +1,87 @@
+#include "CellGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+namespace {
+// Upper bound on cells per point, so sparse scenes don't allocate huge grids
+const double MAX_CELLS_PER_POINT = 4.0;
+// Enlargements by 1.25 before giving up (1.25^400 spans float's range)
+const int MAX_CELL_GROWTH = 400;
+}
+
+void CellGrid::build(const float* x, const float* y, const float* z, size_t count, float cellSize) {
+    std::vector<uint32_t> indices(count);
+    for (size_t i = 0; i < count; ++i) indices[i] = static_cast<uint32_t>(i);
+    build(x, y, z, indices, cellSize);
+}
+
+void CellGrid::build(const float* x, const float* y, const float* z,
+                     const std::vector<uint32_t>& allIndices, float cellSize) {
+    m_points.clear();
+    m_cellStart.assign(1, 0);
+    m_dims[0] = m_dims[1] = m_dims[2] = 0;
+
+    // A diverged particle (inf or NaN) has no cell and would make the extent
+    // non-finite, so such points are left out of the grid
+    auto finite = [&](uint32_t i) { return std::isfinite(x[i]) && std::isfinite(y[i]) && std::isfinite(z[i]); };
+    std::vector<uint32_t> finiteIndices;
+    bool allFinite = std::all_of(allIndices.begin(), allIndices.end(), finite);
+    if (!allFinite) std::copy_if(allIndices.begin(), allIndices.end(), std::back_inserter(finiteIndices), finite);
+    const std::vector<uint32_t>& indices = allFinite ? allIndices : finiteIndices;
+    if (indices.empty()) return;
+
+    glm::vec3 lo(std::numeric_limits<float>::max());
+    glm::vec3 hi(-std::numeric_limits<float>::max());
+    for (uint32_t i : indices) {
+        glm::vec3 p(x[i], y[i], z[i]);
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+    glm::vec3 extent = hi - lo;
+
+    m_cellSize = cellSize > 0.0f ? cellSize : 1.0f;
+    double maxCells = std::max(1.0, MAX_CELLS_PER_POINT * indices.size());
+    bool fits = false;
+    for (int grow = 0; grow < MAX_CELL_GROWTH && !fits; ++grow) {
+        double cells = 1.0;
+        for (int a = 0; a < 3; ++a) cells *= std::floor(extent[a] / m_cellSize) + 1.0;
+        fits = cells <= maxCells;
+        if (!fits) m_cellSize *= 1.25f;
+    }
+    m_inverseCellSize = 1.0f / m_cellSize;
+    m_origin = lo;
+    for (int a = 0; a < 3; ++a) {
+        // Extents near float's range never fit; keep everything in one cell
+        m_dims[a] = fits ? static_cast<int>(std::floor(extent[a] * m_inverseCellSize)) + 1 : 1;
+    }
+
+    // Counting sort by cell
+    size_t cellCount = size_t(m_dims[0]) * m_dims[1] * m_dims[2];
+    std::vector<uint32_t> cellOfPoint(indices.size());
+    m_cellStart.assign(cellCount + 1, 0);
+    for (size_t k = 0; k < indices.size(); ++k) {
+        uint32_t i = indices[k];
+        cellOfPoint[k] = static_cast<uint32_t>(cellOf(glm::vec3(x[i], y[i], z[i])));
+        ++m_cellStart[cellOfPoint[k] + 1];
+    }
+    for (size_t c = 0; c < cellCount; ++c) {
+        m_cellStart[c + 1] += m_cellStart[c];
+    }
+    m_points.resize(indices.size());
+    std::vector<uint32_t> cursor(m_cellStart.begin(), m_cellStart.end() - 1);
+    for (size_t k = 0; k < indices.size(); ++k) {
+        m_points[cursor[cellOfPoint[k]]++] = indices[k];
+    }
+}
+
+size_t CellGrid::cellOf(const glm::vec3& p) const {
+    int c[3];
+    for (int a = 0; a < 3; ++a) {
+        // Compared in float first: casting NaN or an out-of-range value to int is undefined
+        float f = (p[a] - m_origin[a]) * m_inverseCellSize;
+        c[a] = f > 0.0f ? static_cast<int>(std::min(f, static_cast<float>(m_dims[a] - 1))) : 0;
+    }
+    return (size_t(c[2]) * m_dims[1] + c[1]) * m_dims[0] + c[0];
+}
@@ -0,0 +1,108 @@
+#ifndef CELL_GRID_H
+#define CELL_GRID_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * @brief Uniform grid of cells for fixed-radius neighbor searches.
+ *
+ * Points are bucketed with a counting sort into a compressed cell list, so a
+ * query only touches the cells overlapping its search sphere. Building is
+ * O(N); the grid is read-only afterwards and safe to query from many threads.
+ */
+class CellGrid {
+public:
+    CellGrid() = default;
+
+    /**
+     * @brief Buckets points into cells.
+     *
+     * The cell size is enlarged if needed to keep the cell count
+     * proportional to the point count.
+     *
+     * @param x Point x coordinates.
+     * @param y Point y coordinates.
+     * @param z Point z coordinates.
+     * @param count Number of points.
+     * @param cellSize Requested cell edge length (typically the search radius).
+     */
+    void build(const float* x, const float* y, const float* z, size_t count, float cellSize);
+
+    /**
+     * @brief Buckets a subset of points into cells.
+     *
+     * @param x Point x coordinates.
+     * @param y Point y coordinates.
+     * @param z Point z coordinates.
+     * @param indices The point indices to include.
+     * @param cellSize Requested cell edge length.
+     */
+    void build(const float* x, const float* y, const float* z, const std::vector<uint32_t>& indices, float cellSize);
+
+    /**
+     * @brief Calls fn(index) for every point in the cells overlapping a sphere.
+     *
+     * Candidates are not distance-checked; the callback does that.
+     *
+     * @param center The sphere center.
+     * @param radius The sphere radius.
+     * @param fn Callback taking a uint32_t point index.
+     */
+    template <typename Fn>
+    void forEachCandidate(const glm::vec3& center, float radius, Fn&& fn) const {
+        if (m_points.empty()) return;
+        int lo[3], hi[3];
+        for (int a = 0; a < 3; ++a) {
+            lo[a] = std::max(0, static_cast<int>(std::floor((center[a] - radius - m_origin[a]) * m_inverseCellSize)));
+            hi[a] = std::min(m_dims[a] - 1, static_cast<int>(std::floor((center[a] + radius - m_origin[a]) * m_inverseCellSize)));
+            if (lo[a] > hi[a]) return;
+        }
+        for (int cz = lo[2]; cz <= hi[2]; ++cz) {
+            for (int cy = lo[1]; cy <= hi[1]; ++cy) {
+                size_t row = (size_t(cz) * m_dims[1] + cy) * m_dims[0];
+                uint32_t begin = m_cellStart[row + lo[0]];
+                uint32_t end = m_cellStart[row + hi[0] + 1];
+                for (uint32_t k = begin; k < end; ++k) {
+                    fn(m_points[k]);
+                }
+            }
+        }
+    }
+
+    float getCellSize() const { return m_cellSize; }
+    size_t getCellCount() const { return m_cellStart.empty() ? 0 : m_cellStart.size() - 1; }
+
+    /**
+     * @brief Gets the point indices in cell order; neighbors in space are close in this list.
+     *
+     * @return The ordered point indices.
+     */
+    const std::vector<uint32_t>& getOrderedPoints() const { return m_points; }
+
+    /**
+     * @brief Gets where each cell's points start in getOrderedPoints().
+     *
+     * Cells are numbered x fastest, then y, then z; cell c holds entries
+     * [start[c], start[c + 1]).
+     *
+     * @return Cell count + 1 offsets.
+     */
+    const std::vector<uint32_t>& getCellStart() const { return m_cellStart; }
+
+private:
+    glm::vec3 m_origin = glm::vec3(0.0f);
+    float m_cellSize = 1.0f;
+    float m_inverseCellSize = 1.0f;
+    int m_dims[3] = {0, 0, 0};
+    std::vector<uint32_t> m_cellStart;  ///< Cell -> first entry in m_points (cell count + 1 entries)
+    std::vector<uint32_t> m_points;     ///< Point indices sorted by cell
+
+    size_t cellOf(const glm::vec3& p) const;
+};
+
+#endif // CELL_GRID_H
@@ -0,0 +1,333 @@
+#include "Communicator.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef ATOMICA_WITH_MPI
+#include <mpi.h>
+#endif
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool SerialCommunicator::exchange(int destination, const std::vector<char>& sendBuffer,
+                                  int source, std::vector<char>& receiveBuffer) {
+    // The only peer is ourselves
+    if (destination == 0 && source == 0) receiveBuffer = sendBuffer;
+    else receiveBuffer.clear();
+    return true;
+}
+
+// ─── Shared memory ──────────────────────────────────────────────────────────
+
+namespace {
+const uint32_t SEGMENT_MAGIC = 0x4D434D41;  // "AMCM"
+const size_t ALIGNMENT = 64;
+
+struct SegmentHeader {
+    uint32_t magic;
+    int32_t size;
+    alignas(ALIGNMENT) std::atomic<uint32_t> barrierCount;
+    alignas(ALIGNMENT) std::atomic<uint32_t> barrierSense;
+};
+
+/// Single-producer single-consumer byte ring; positions only ever increase
+struct RingHeader {
+    alignas(ALIGNMENT) std::atomic<uint64_t> head;  ///< Bytes written
+    alignas(ALIGNMENT) std::atomic<uint64_t> tail;  ///< Bytes read
+};
+
+size_t alignUp(size_t bytes) { return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; }
+
+const size_t HEADER_BYTES = alignUp(sizeof(SegmentHeader));
+const size_t RING_STRIDE = alignUp(sizeof(RingHeader)) + SharedMemoryCommunicator::RING_BYTES;
+
+size_t segmentBytes(int size) {
+    return HEADER_BYTES + size_t(size) * size * RING_STRIDE +
+           size_t(size) * SharedMemoryCommunicator::REDUCE_VALUES * sizeof(double);
+}
+
+std::string segmentPath(const std::string& name) {
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+RingHeader* ringAt(unsigned char* base, int size, int from, int to) {
+    return reinterpret_cast<RingHeader*>(base + HEADER_BYTES + (size_t(from) * size + to) * RING_STRIDE);
+}
+
+unsigned char* ringData(RingHeader* ring) {
+    return reinterpret_cast<unsigned char*>(ring) + alignUp(sizeof(RingHeader));
+}
+
+/// Copies up to count bytes into the ring; returns how many fit
+size_t pushBytes(RingHeader* ring, const char* data, size_t count) {
+    const size_t capacity = SharedMemoryCommunicator::RING_BYTES;
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    uint64_t tail = ring->tail.load(std::memory_order_acquire);
+    size_t n = std::min<size_t>(count, capacity - size_t(head - tail));
+    if (n == 0) return 0;
+    size_t offset = size_t(head % capacity);
+    size_t first = std::min(n, capacity - offset);
+    std::memcpy(ringData(ring) + offset, data, first);
+    std::memcpy(ringData(ring), data + first, n - first);
+    ring->head.store(head + n, std::memory_order_release);
+    return n;
+}
+
+/// Copies up to count bytes out of the ring; returns how many were available
+size_t popBytes(RingHeader* ring, char* data, size_t count) {
+    const size_t capacity = SharedMemoryCommunicator::RING_BYTES;
+    uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    uint64_t head = ring->head.load(std::memory_order_acquire);
+    size_t n = std::min<size_t>(count, size_t(head - tail));
+    if (n == 0) return 0;
+    size_t offset = size_t(tail % capacity);
+    size_t first = std::min(n, capacity - offset);
+    std::memcpy(data, ringData(ring) + offset, first);
+    std::memcpy(data + first, ringData(ring), n - first);
+    ring->tail.store(tail + n, std::memory_order_release);
+    return n;
+}
+}
+
+SharedMemoryCommunicator::~SharedMemoryCommunicator() {
+#ifndef _WIN32
+    if (m_base) munmap(m_base, m_mappedBytes);
+#endif
+}
+
+bool SharedMemoryCommunicator::create(const std::string& name, int size, std::string& error) {
+#ifdef _WIN32
+    (void)name;
+    (void)size;
+    error = "Shared-memory ranks are only supported on POSIX systems";
+    return false;
+#else
+    if (size < 1) {
+        error = "Rank count must be positive";
+        return false;
+    }
+    std::string path = segmentPath(name);
+    size_t bytes = segmentBytes(size);
+    shm_unlink(path.c_str());
+    int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        error = "Cannot create shared memory " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        error = "Cannot size shared memory " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        shm_unlink(path.c_str());
+        return false;
+    }
+    void* base = mmap(nullptr, HEADER_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        error = "Cannot map shared memory " + path + ": " + std::strerror(errno);
+        shm_unlink(path.c_str());
+        return false;
+    }
+    // Rings start zeroed, which is their empty state
+    auto* header = new (base) SegmentHeader();
+    header->size = size;
+    header->barrierCount.store(0, std::memory_order_relaxed);
+    header->barrierSense.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = SEGMENT_MAGIC;
+    munmap(base, HEADER_BYTES);
+    return true;
+#endif
+}
+
+void SharedMemoryCommunicator::remove(const std::string& name) {
+#ifndef _WIN32
+    shm_unlink(segmentPath(name).c_str());
+#else
+    (void)name;
+#endif
+}
+
+bool SharedMemoryCommunicator::attach(const std::string& name, int rank) {
+#ifdef _WIN32
+    (void)name;
+    (void)rank;
+    return false;
+#else
+    int fd = shm_open(segmentPath(name).c_str(), O_RDWR, 0);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(HEADER_BYTES)) {
+        ::close(fd);
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    void* base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) return false;
+
+    auto* header = static_cast<SegmentHeader*>(base);
+    if (header->magic != SEGMENT_MAGIC || header->size < 1 || rank < 0 || rank >= header->size ||
+        bytes < segmentBytes(header->size)) {
+        munmap(base, bytes);
+        return false;
+    }
+    m_base = static_cast<unsigned char*>(base);
+    m_mappedBytes = bytes;
+    m_rank = rank;
+    m_size = header->size;
+    m_barrierSense = 0;
+    return true;
+#endif
+}
+
+bool SharedMemoryCommunicator::exchange(int destination, const std::vector<char>& sendBuffer,
+                                        int source, std::vector<char>& receiveBuffer) {
+    receiveBuffer.clear();
+    if (!m_base) return false;
+    if (destination >= m_size || source >= m_size) return false;
+
+    // Length-prefixed frame; both directions advance in the same loop so a
+    // message larger than the ring streams while the peer drains it
+    uint64_t length = sendBuffer.size();
+    RingHeader* out = destination != NO_RANK ? ringAt(m_base, m_size, m_rank, destination) : nullptr;
+    RingHeader* in = source != NO_RANK ? ringAt(m_base, m_size, source, m_rank) : nullptr;
+    size_t sentHeader = out ? 0 : sizeof(length);
+    size_t sentPayload = out ? 0 : sendBuffer.size();
+    uint64_t incomingLength = 0;
+    size_t receivedHeader = in ? 0 : sizeof(incomingLength);
+    size_t receivedPayload = 0;
+
+    auto receiveDone = [&] {
+        return receivedHeader == sizeof(incomingLength) && receivedPayload == receiveBuffer.size();
+    };
+    while (sentHeader < sizeof(length) || sentPayload < sendBuffer.size() || !receiveDone()) {
+        size_t moved = 0;
+        if (sentHeader < sizeof(length)) {
+            size_t n = pushBytes(out, reinterpret_cast<const char*>(&length) + sentHeader, sizeof(length) - sentHeader);
+            sentHeader += n;
+            moved += n;
+        }
+        if (sentHeader == sizeof(length) && sentPayload < sendBuffer.size()) {
+            size_t n = pushBytes(out, sendBuffer.data() + sentPayload, sendBuffer.size() - sentPayload);
+            sentPayload += n;
+            moved += n;
+        }
+        if (receivedHeader < sizeof(incomingLength)) {
+            size_t n = popBytes(in, reinterpret_cast<char*>(&incomingLength) + receivedHeader,
+                                sizeof(incomingLength) - receivedHeader);
+            receivedHeader += n;
+            moved += n;
+            if (receivedHeader == sizeof(incomingLength)) receiveBuffer.resize(size_t(incomingLength));
+        }
+        if (receivedHeader == sizeof(incomingLength) && receivedPayload < receiveBuffer.size()) {
+            size_t n = popBytes(in, receiveBuffer.data() + receivedPayload, receiveBuffer.size() - receivedPayload);
+            receivedPayload += n;
+            moved += n;
+        }
+        if (moved == 0) std::this_thread::yield();
+    }
+    return true;
+}
+
+void SharedMemoryCommunicator::barrier() {
+    if (!m_base || m_size == 1) return;
+    // Sense-reversing: the last rank in flips the shared sense, releasing the rest
+    auto* header = reinterpret_cast<SegmentHeader*>(m_base);
+    m_barrierSense ^= 1u;
+    if (header->barrierCount.fetch_add(1, std::memory_order_acq_rel) == uint32_t(m_size - 1)) {
+        header->barrierCount.store(0, std::memory_order_relaxed);
+        header->barrierSense.store(m_barrierSense, std::memory_order_release);
+    } else {
+        while (header->barrierSense.load(std::memory_order_acquire) != m_barrierSense) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void SharedMemoryCommunicator::allReduceSum(double* values, size_t count) {
+    allReduce(values, count, false);
+}
+
+void SharedMemoryCommunicator::allReduceMax(double* values, size_t count) {
+    allReduce(values, count, true);
+}
+
+void SharedMemoryCommunicator::allReduce(double* values, size_t count, bool maximum) {
+    if (!m_base || m_size == 1) return;
+    auto* slots = reinterpret_cast<double*>(m_base + HEADER_BYTES + size_t(m_size) * m_size * RING_STRIDE);
+    for (size_t start = 0; start < count; start += REDUCE_VALUES) {
+        size_t n = std::min(REDUCE_VALUES, count - start);
+        std::memcpy(slots + size_t(m_rank) * REDUCE_VALUES, values + start, n * sizeof(double));
+        barrier();
+        // Every rank combines in rank order, so all see bit-identical results
+        for (size_t k = 0; k < n; ++k) {
+            double result = slots[k];
+            for (int r = 1; r < m_size; ++r) {
+                double v = slots[size_t(r) * REDUCE_VALUES + k];
+                result = maximum ? std::max(result, v) : result + v;
+            }
+            values[start + k] = result;
+        }
+        barrier();
+    }
+}
+
+// ─── MPI ────────────────────────────────────────────────────────────────────
+
+#ifdef ATOMICA_WITH_MPI
+MpiCommunicator::MpiCommunicator() {
+    MPI_Comm_rank(MPI_COMM_WORLD, &m_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &m_size);
+}
+
+bool MpiCommunicator::exchange(int destination, const std::vector<char>& sendBuffer,
+                               int source, std::vector<char>& receiveBuffer) {
+    const int TAG_LENGTH = 1, TAG_PAYLOAD = 2;
+    int to = destination == NO_RANK ? MPI_PROC_NULL : destination;
+    int from = source == NO_RANK ? MPI_PROC_NULL : source;
+    unsigned long long length = sendBuffer.size(), incoming = 0;
+    if (MPI_Sendrecv(&length, 1, MPI_UNSIGNED_LONG_LONG, to, TAG_LENGTH,
+                     &incoming, 1, MPI_UNSIGNED_LONG_LONG, from, TAG_LENGTH,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE) != MPI_SUCCESS) {
+        return false;
+    }
+    receiveBuffer.resize(from == MPI_PROC_NULL ? 0 : size_t(incoming));
+
+    // MPI counts are int, so large buffers go in chunks
+    const size_t CHUNK = size_t(1) << 30;
+    size_t sent = 0, received = 0;
+    while ((to != MPI_PROC_NULL && sent < sendBuffer.size()) || received < receiveBuffer.size()) {
+        int sendCount = to == MPI_PROC_NULL ? 0 : int(std::min(CHUNK, sendBuffer.size() - sent));
+        int receiveCount = int(std::min(CHUNK, receiveBuffer.size() - received));
+        if (MPI_Sendrecv(sendBuffer.data() + sent, sendCount, MPI_BYTE, sendCount ? to : MPI_PROC_NULL, TAG_PAYLOAD,
+                         receiveBuffer.data() + received, receiveCount, MPI_BYTE,
+                         receiveCount ? from : MPI_PROC_NULL, TAG_PAYLOAD,
+                         MPI_COMM_WORLD, MPI_STATUS_IGNORE) != MPI_SUCCESS) {
+            return false;
+        }
+        sent += sendCount;
+        received += receiveCount;
+    }
+    return true;
+}
+
+void MpiCommunicator::allReduceSum(double* values, size_t count) {
+    MPI_Allreduce(MPI_IN_PLACE, values, int(count), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+}
+
+void MpiCommunicator::allReduceMax(double* values, size_t count) {
+    MPI_Allreduce(MPI_IN_PLACE, values, int(count), MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+}
+
+void MpiCommunicator::barrier() {
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+#endif
@@ -0,0 +1,168 @@
+#ifndef COMMUNICATOR_H
+#define COMMUNICATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Message passing between the ranks of a multi-process run.
+ *
+ * The interface is the small subset of MPI that domain decomposition needs:
+ * pairwise exchange, reductions and a barrier. It is implemented over MPI
+ * when the build enables it (ATOMICA_WITH_MPI) and over shared memory for
+ * several processes on one machine, which needs no MPI installation and is
+ * how multi-rank runs are tested.
+ */
+class Communicator {
+public:
+    /// Passed as a peer to skip that half of an exchange (like MPI_PROC_NULL)
+    static constexpr int NO_RANK = -1;
+
+    virtual ~Communicator() = default;
+
+    virtual int getRank() const = 0;
+    virtual int getSize() const = 0;
+
+    /**
+     * @brief Sends a buffer to one rank while receiving one from another.
+     *
+     * Both halves progress together, so a ring of ranks each sending to the
+     * next cannot deadlock.
+     *
+     * @param destination Rank to send to, or NO_RANK.
+     * @param sendBuffer Bytes to send.
+     * @param source Rank to receive from, or NO_RANK.
+     * @param receiveBuffer Receives the bytes; cleared when source is NO_RANK.
+     * @return False if the transport failed.
+     */
+    virtual bool exchange(int destination, const std::vector<char>& sendBuffer,
+                          int source, std::vector<char>& receiveBuffer) = 0;
+
+    /**
+     * @brief Sums values element-wise across all ranks, in place.
+     *
+     * @param values The local values; receive the global sums.
+     * @param count Number of values.
+     */
+    virtual void allReduceSum(double* values, size_t count) = 0;
+
+    /**
+     * @brief Takes the element-wise maximum across all ranks, in place.
+     *
+     * @param values The local values; receive the global maxima.
+     * @param count Number of values.
+     */
+    virtual void allReduceMax(double* values, size_t count) = 0;
+
+    /**
+     * @brief Blocks until every rank has reached the barrier.
+     */
+    virtual void barrier() = 0;
+};
+
+/**
+ * @brief A single rank with nothing to talk to.
+ */
+class SerialCommunicator : public Communicator {
+public:
+    int getRank() const override { return 0; }
+    int getSize() const override { return 1; }
+    bool exchange(int destination, const std::vector<char>& sendBuffer,
+                  int source, std::vector<char>& receiveBuffer) override;
+    void allReduceSum(double*, size_t) override {}
+    void allReduceMax(double*, size_t) override {}
+    void barrier() override {}
+};
+
+/**
+ * @brief Ranks as processes on one machine, talking through a shared segment.
+ *
+ * Every ordered pair of ranks has a single-producer single-consumer byte
+ * ring; messages larger than a ring stream through it while exchange()
+ * alternates between sending and receiving. Reductions go through one
+ * slot per rank between two barriers. The launcher creates the segment
+ * with create() before starting the ranks, each of which calls attach().
+ * Only available on POSIX systems.
+ */
+class SharedMemoryCommunicator : public Communicator {
+public:
+    static constexpr size_t RING_BYTES = size_t(4) << 20;
+    static constexpr size_t REDUCE_VALUES = 4096;
+
+    SharedMemoryCommunicator() = default;
+    ~SharedMemoryCommunicator() override;
+    SharedMemoryCommunicator(const SharedMemoryCommunicator&) = delete;
+    SharedMemoryCommunicator& operator=(const SharedMemoryCommunicator&) = delete;
+
+    /**
+     * @brief Creates the shared segment for a run (called once, by the launcher).
+     *
+     * @param name Segment name.
+     * @param size Number of ranks.
+     * @param error Receives a message on failure.
+     * @return True on success.
+     */
+    static bool create(const std::string& name, int size, std::string& error);
+
+    /**
+     * @brief Removes the segment's name; mapped ranks are unaffected.
+     *
+     * @param name Segment name.
+     */
+    static void remove(const std::string& name);
+
+    /**
+     * @brief Joins the run as one rank.
+     *
+     * @param name Segment name given to create().
+     * @param rank This process's rank.
+     * @return False if the segment does not exist or the rank is out of range.
+     */
+    bool attach(const std::string& name, int rank);
+
+    int getRank() const override { return m_rank; }
+    int getSize() const override { return m_size; }
+    bool exchange(int destination, const std::vector<char>& sendBuffer,
+                  int source, std::vector<char>& receiveBuffer) override;
+    void allReduceSum(double* values, size_t count) override;
+    void allReduceMax(double* values, size_t count) override;
+    void barrier() override;
+
+private:
+    unsigned char* m_base = nullptr;
+    size_t m_mappedBytes = 0;
+    int m_rank = 0;
+    int m_size = 1;
+    uint32_t m_barrierSense = 0;
+
+    void allReduce(double* values, size_t count, bool maximum);
+};
+
+#ifdef ATOMICA_WITH_MPI
+/**
+ * @brief Ranks as MPI processes on MPI_COMM_WORLD.
+ *
+ * MPI must be initialized before construction and finalized after destruction.
+ */
+class MpiCommunicator : public Communicator {
+public:
+    MpiCommunicator();
+
+    int getRank() const override { return m_rank; }
+    int getSize() const override { return m_size; }
+    bool exchange(int destination, const std::vector<char>& sendBuffer,
+                  int source, std::vector<char>& receiveBuffer) override;
+    void allReduceSum(double* values, size_t count) override;
+    void allReduceMax(double* values, size_t count) override;
+    void barrier() override;
+
+private:
+    int m_rank = 0;
+    int m_size = 1;
+};
+#endif
+
+#endif // COMMUNICATOR_H
@@ -1,11 +1,39 @@
 #include "CoulombSolver.h"
+#include "TaskScheduler.h"
 
 // Coulomb's constant (k_e) in N·m²/C²
 const float COULOMB_CONSTANT = 8.9875e9f;
 
+// Below this count the half pair loop (Newton's third law) is cheaper than
+// spreading full rows over the workers
+const size_t PARALLEL_MIN_PARTICLES = 256;
+
 std::vector<glm::vec3> CoulombSolver::calculateForces(const std::vector<std::shared_ptr<Particle>>& particles) {
     std::vector<glm::vec3> forces(particles.size(), glm::vec3(0.0f));
 
+    if (particles.size() >= PARALLEL_MIN_PARTICLES) {
+        // Each row owns forces[i] and sums over all j, so chunks never write
+        // to the same element and no per-thread buffers or reduction are needed
+        TaskScheduler::getInstance().parallelFor(0, particles.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const glm::vec3& p_i = particles[i]->getPosition();
+                float q_i = particles[i]->getCharge();
+                glm::vec3 total(0.0f);
+                for (size_t j = 0; j < particles.size(); ++j) {
+                    glm::vec3 r_vec = p_i - particles[j]->getPosition();
+                    float distance = glm::length(r_vec);
+                    if (j == i || distance < 1e-9f) {
+                        continue;
+                    }
+                    float forceMagnitude = COULOMB_CONSTANT * (q_i * particles[j]->getCharge()) / (distance * distance);
+                    total += forceMagnitude * (r_vec / distance);
+                }
+                forces[i] = total;
+            }
+        }, 16);
+        return forces;
+    }
+
     for (size_t i = 0; i < particles.size(); ++i) {
         for (size_t j = i + 1; j < particles.size(); ++j) {
             // Calculate vector between particles
@@ -0,0 +1,148 @@
+#include "CoulombTree.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Nodes with at most this many charges are summed directly
+const uint32_t LEAF_SIZE = 16;
+// Coincident charges would otherwise split forever
+const int MAX_DEPTH = 24;
+}
+
+CoulombTree::CoulombTree(float theta, float softening)
+    : m_theta(theta), m_softening2(softening * softening) {}
+
+void CoulombTree::build(const std::vector<glm::vec3>& positions, const std::vector<float>& charges) {
+    m_nodes.clear();
+    m_positions = positions;
+    m_charges = charges;
+    size_t count = std::min(positions.size(), charges.size());
+    m_order.resize(count);
+    for (size_t i = 0; i < count; ++i) m_order[i] = static_cast<uint32_t>(i);
+    if (count == 0) return;
+
+    glm::vec3 lo = positions[0], hi = lo;
+    for (size_t i = 1; i < count; ++i) {
+        lo = glm::min(lo, positions[i]);
+        hi = glm::max(hi, positions[i]);
+    }
+    glm::vec3 extent = hi - lo;
+    float halfSize = 0.5f * std::max(std::max(extent.x, extent.y), std::max(extent.z, 1e-6f)) * 1.0001f;
+
+    m_nodes.reserve(2 * count / LEAF_SIZE + 1);
+    std::vector<uint32_t> scratch(count);
+    buildNode(0.5f * (lo + hi), halfSize, 0, static_cast<uint32_t>(count), 0, scratch);
+}
+
+int32_t CoulombTree::buildNode(const glm::vec3& center, float halfSize, uint32_t begin, uint32_t count,
+                               int depth, std::vector<uint32_t>& scratch) {
+    int32_t index = static_cast<int32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+    {
+        Node& node = m_nodes.back();
+        node.center = center;
+        node.halfSize = halfSize;
+        node.begin = begin;
+        node.count = count;
+        std::fill(node.children, node.children + 8, -1);
+
+        // Moments about the node center, straight from the node's charges
+        double q = 0.0;
+        glm::dvec3 p(0.0);
+        double m[6] = {0, 0, 0, 0, 0, 0};
+        for (uint32_t k = begin; k < begin + count; ++k) {
+            uint32_t i = m_order[k];
+            double qi = m_charges[i];
+            glm::dvec3 d = glm::dvec3(m_positions[i]) - glm::dvec3(center);
+            double r2 = glm::dot(d, d);
+            q += qi;
+            p += qi * d;
+            m[0] += qi * (3.0 * d.x * d.x - r2);
+            m[1] += qi * (3.0 * d.y * d.y - r2);
+            m[2] += qi * (3.0 * d.z * d.z - r2);
+            m[3] += qi * 3.0 * d.x * d.y;
+            m[4] += qi * 3.0 * d.x * d.z;
+            m[5] += qi * 3.0 * d.y * d.z;
+        }
+        node.charge = q;
+        node.dipole = p;
+        std::copy(m, m + 6, node.quadrupole);
+    }
+    if (count <= LEAF_SIZE || depth >= MAX_DEPTH) return index;
+
+    // Stable counting sort of the node's charges into octants
+    uint32_t octantCount[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    auto octantOf = [&](uint32_t i) {
+        const glm::vec3& p = m_positions[i];
+        return (p.x >= center.x ? 1 : 0) | (p.y >= center.y ? 2 : 0) | (p.z >= center.z ? 4 : 0);
+    };
+    for (uint32_t k = begin; k < begin + count; ++k) ++octantCount[octantOf(m_order[k])];
+    uint32_t octantStart[8];
+    uint32_t offset = begin;
+    for (int o = 0; o < 8; ++o) {
+        octantStart[o] = offset;
+        offset += octantCount[o];
+    }
+    uint32_t cursor[8];
+    std::copy(octantStart, octantStart + 8, cursor);
+    for (uint32_t k = begin; k < begin + count; ++k) {
+        uint32_t i = m_order[k];
+        scratch[cursor[octantOf(i)]++] = i;
+    }
+    std::copy(scratch.begin() + begin, scratch.begin() + begin + count, m_order.begin() + begin);
+
+    float childHalf = 0.5f * halfSize;
+    for (int o = 0; o < 8; ++o) {
+        if (octantCount[o] == 0) continue;
+        glm::vec3 childCenter = center + childHalf * glm::vec3((o & 1) ? 1.0f : -1.0f,
+                                                               (o & 2) ? 1.0f : -1.0f,
+                                                               (o & 4) ? 1.0f : -1.0f);
+        int32_t child = buildNode(childCenter, childHalf, octantStart[o], octantCount[o], depth + 1, scratch);
+        m_nodes[index].children[o] = child;  // m_nodes may have reallocated
+    }
+    return index;
+}
+
+double CoulombTree::potential(const glm::vec3& point) const {
+    if (m_nodes.empty()) return 0.0;
+    const double theta2 = double(m_theta) * m_theta;
+
+    double phi = 0.0;
+    int32_t stack[8 * MAX_DEPTH + 8];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = m_nodes[stack[--top]];
+        glm::dvec3 r = glm::dvec3(point) - glm::dvec3(node.center);
+        double r2 = glm::dot(r, r);
+        double size = 2.0 * node.halfSize;
+
+        if (size * size < theta2 * r2) {
+            double inv = 1.0 / std::sqrt(r2);
+            double inv3 = inv * inv * inv;
+            double inv5 = inv3 * inv * inv;
+            const double* m = node.quadrupole;
+            double rQr = m[0] * r.x * r.x + m[1] * r.y * r.y + m[2] * r.z * r.z
+                       + 2.0 * (m[3] * r.x * r.y + m[4] * r.x * r.z + m[5] * r.y * r.z);
+            phi += node.charge * inv + glm::dot(node.dipole, r) * inv3 + 0.5 * rQr * inv5;
+            continue;
+        }
+
+        bool leaf = true;
+        for (int o = 0; o < 8; ++o) {
+            if (node.children[o] >= 0) {
+                stack[top++] = node.children[o];
+                leaf = false;
+            }
+        }
+        if (!leaf) continue;
+
+        for (uint32_t k = node.begin; k < node.begin + node.count; ++k) {
+            uint32_t i = m_order[k];
+            glm::vec3 d = point - m_positions[i];
+            float d2 = glm::dot(d, d) + m_softening2;
+            if (d2 > 0.0f) phi += m_charges[i] / std::sqrt(double(d2));
+        }
+    }
+    return phi;
+}
@@ -0,0 +1,73 @@
+#ifndef COULOMB_TREE_H
+#define COULOMB_TREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * @brief Barnes–Hut octree for evaluating Coulomb potentials of point charges.
+ *
+ * Every node stores the monopole, dipole and traceless quadrupole moments of
+ * its charges about the node center. A query opens a node only when the node
+ * is large compared to its distance (size < θ·distance), so a potential costs
+ * O(log N) and building costs O(N log N). Charges at the leaves are summed
+ * directly with Plummer softening to keep potentials at the charges finite.
+ *
+ * Potentials are Σ q/r, in the caller's charge and length units; multiply by
+ * the Coulomb constant for physical units. The tree is read-only after
+ * build() and safe to query from many threads.
+ */
+class CoulombTree {
+public:
+    /**
+     * @param theta Opening angle; smaller is more accurate and slower.
+     * @param softening Plummer softening length for direct sums.
+     */
+    explicit CoulombTree(float theta = 0.5f, float softening = 0.0f);
+
+    /**
+     * @brief Builds the tree over a set of charges.
+     *
+     * @param positions Charge positions.
+     * @param charges Charge values (same size as positions).
+     */
+    void build(const std::vector<glm::vec3>& positions, const std::vector<float>& charges);
+
+    /**
+     * @brief Evaluates the potential at a point.
+     *
+     * @param point The evaluation point.
+     * @return Σ q/r over all charges.
+     */
+    double potential(const glm::vec3& point) const;
+
+    void setTheta(float theta) { m_theta = theta; }
+    void setSoftening(float softening) { m_softening2 = softening * softening; }
+    size_t getNodeCount() const { return m_nodes.size(); }
+
+private:
+    struct Node {
+        glm::vec3 center;
+        float halfSize;
+        double charge;
+        glm::dvec3 dipole;
+        double quadrupole[6];  ///< xx, yy, zz, xy, xz, yz
+        uint32_t begin;        ///< First entry in m_order
+        uint32_t count;
+        int32_t children[8];   ///< -1 where an octant is empty; all -1 for leaves
+    };
+
+    float m_theta;
+    float m_softening2;
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_order;  ///< Charge indices, each node's charges contiguous
+    std::vector<glm::vec3> m_positions;
+    std::vector<float> m_charges;
+
+    int32_t buildNode(const glm::vec3& center, float halfSize, uint32_t begin, uint32_t count,
+                      int depth, std::vector<uint32_t>& scratch);
+};
+
+#endif // COULOMB_TREE_H
@@ -0,0 +1,339 @@
+#include "DecayChain.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+
+namespace {
+// Decay constants closer than this (relative) make Bateman's denominators cancel
+const double DEGENERATE_SEPARATION = 1e-9;
+// Coefficients this much larger than the inventory lose too many digits to cancellation
+const double MAX_COEFFICIENT_GROWTH = 1e12;
+// Upper bound on path steps before Bateman gives way to the matrix exponential
+const size_t MAX_PATH_STEPS = 1000000;
+
+// Degree-13 Padé approximant of exp (Higham, SIAM J. Matrix Anal. Appl. 26, 2005)
+const double PADE[14] = {64764752532480000.0, 32382376266240000.0, 7771770303897600.0, 1187353796428800.0,
+                         129060195264000.0,   10559470521600.0,    670442572800.0,     33522128640.0,
+                         1323241920.0,        40840800.0,          960960.0,           16380.0,
+                         182.0,               1.0};
+// Largest 1-norm for which the degree-13 approximant is accurate to double precision
+const double PADE_THETA = 5.371920351148152;
+
+using Matrix = std::vector<double>;
+
+void multiply(const Matrix& a, const Matrix& b, Matrix& c, size_t n) {
+    c.assign(n * n, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t k = 0; k < n; ++k) {
+            double aik = a[i * n + k];
+            if (aik == 0.0) continue;
+            for (size_t j = 0; j < n; ++j) c[i * n + j] += aik * b[k * n + j];
+        }
+    }
+}
+
+/// Solves A X = B in place (B becomes X) by Gaussian elimination with partial pivoting
+void solveDense(Matrix& a, Matrix& b, size_t n) {
+    for (size_t k = 0; k < n; ++k) {
+        size_t pivot = k;
+        for (size_t i = k + 1; i < n; ++i) {
+            if (std::fabs(a[i * n + k]) > std::fabs(a[pivot * n + k])) pivot = i;
+        }
+        if (pivot != k) {
+            for (size_t j = 0; j < n; ++j) {
+                std::swap(a[k * n + j], a[pivot * n + j]);
+                std::swap(b[k * n + j], b[pivot * n + j]);
+            }
+        }
+        double inverse = 1.0 / a[k * n + k];
+        for (size_t i = k + 1; i < n; ++i) {
+            double factor = a[i * n + k] * inverse;
+            if (factor == 0.0) continue;
+            for (size_t j = k; j < n; ++j) a[i * n + j] -= factor * a[k * n + j];
+            for (size_t j = 0; j < n; ++j) b[i * n + j] -= factor * b[k * n + j];
+        }
+    }
+    for (size_t k = n; k-- > 0;) {
+        double inverse = 1.0 / a[k * n + k];
+        for (size_t j = 0; j < n; ++j) {
+            double sum = b[k * n + j];
+            for (size_t i = k + 1; i < n; ++i) sum -= a[k * n + i] * b[i * n + j];
+            b[k * n + j] = sum * inverse;
+        }
+    }
+}
+
+/// exp(A t) by scaling and squaring
+void exponential(const Matrix& a, size_t n, double t, Matrix& result) {
+    double norm = 0.0;
+    for (size_t j = 0; j < n; ++j) {
+        double column = 0.0;
+        for (size_t i = 0; i < n; ++i) column += std::fabs(a[i * n + j]);
+        norm = std::max(norm, column * t);
+    }
+    int squarings = norm > PADE_THETA ? static_cast<int>(std::ceil(std::log2(norm / PADE_THETA))) : 0;
+    double scale = std::ldexp(t, -squarings);
+
+    Matrix b(n * n), b2, b4, b6, work, u, v(n * n);
+    for (size_t k = 0; k < n * n; ++k) b[k] = a[k] * scale;
+    multiply(b, b, b2, n);
+    multiply(b2, b2, b4, n);
+    multiply(b2, b4, b6, n);
+
+    // U = B (B6 (c13 B6 + c11 B4 + c9 B2) + c7 B6 + c5 B4 + c3 B2 + c1 I)
+    // V =    B6 (c12 B6 + c10 B4 + c8 B2) + c6 B6 + c4 B4 + c2 B2 + c0 I
+    Matrix inner(n * n);
+    for (size_t k = 0; k < n * n; ++k) inner[k] = PADE[13] * b6[k] + PADE[11] * b4[k] + PADE[9] * b2[k];
+    multiply(b6, inner, work, n);
+    for (size_t k = 0; k < n * n; ++k) work[k] += PADE[7] * b6[k] + PADE[5] * b4[k] + PADE[3] * b2[k];
+    for (size_t i = 0; i < n; ++i) work[i * n + i] += PADE[1];
+    multiply(b, work, u, n);
+    for (size_t k = 0; k < n * n; ++k) inner[k] = PADE[12] * b6[k] + PADE[10] * b4[k] + PADE[8] * b2[k];
+    multiply(b6, inner, work, n);
+    for (size_t k = 0; k < n * n; ++k) v[k] = work[k] + PADE[6] * b6[k] + PADE[4] * b4[k] + PADE[2] * b2[k];
+    for (size_t i = 0; i < n; ++i) v[i * n + i] += PADE[0];
+
+    // Carry F = r - I = (V - U)⁻¹ 2U through the squarings as F <- 2F + F².
+    // The scaled exponential is I minus rates far below machine epsilon, and
+    // forming I + F before squaring would round those away.
+    Matrix denominator(n * n);
+    result.resize(n * n);
+    for (size_t k = 0; k < n * n; ++k) {
+        denominator[k] = v[k] - u[k];
+        result[k] = 2.0 * u[k];
+    }
+    solveDense(denominator, result, n);
+    for (int s = 0; s < squarings; ++s) {
+        multiply(result, result, work, n);
+        for (size_t k = 0; k < n * n; ++k) result[k] = 2.0 * result[k] + work[k];
+    }
+    for (size_t i = 0; i < n; ++i) result[i * n + i] += 1.0;
+}
+}
+
+uint32_t DecayChain::addNuclide(const std::string& name, double halfLife) {
+    int existing = findNuclide(name);
+    if (existing >= 0) return static_cast<uint32_t>(existing);
+    m_names.push_back(name);
+    m_decayConstants.push_back(halfLife > 0.0 && std::isfinite(halfLife) ? LN2 / halfLife : 0.0);
+    m_amounts.push_back(0.0);
+    return static_cast<uint32_t>(m_names.size() - 1);
+}
+
+int DecayChain::findNuclide(const std::string& name) const {
+    auto found = std::find(m_names.begin(), m_names.end(), name);
+    return found == m_names.end() ? -1 : static_cast<int>(found - m_names.begin());
+}
+
+bool DecayChain::addDecay(uint32_t parent, int daughter, double branchingRatio) {
+    if (parent >= m_names.size() || daughter >= static_cast<int>(m_names.size()) || m_decayConstants[parent] <= 0.0) {
+        return false;
+    }
+    // The parent's removal rate already counts every mode; only tracked daughters get a flow
+    if (daughter >= 0 && branchingRatio > 0.0) {
+        m_flows.push_back({parent, static_cast<uint32_t>(daughter), branchingRatio * m_decayConstants[parent]});
+    }
+    return true;
+}
+
+bool DecayChain::addTransmutation(uint32_t from, int to, double rate) {
+    if (from >= m_names.size() || to >= static_cast<int>(m_names.size()) || !(rate > 0.0)) return false;
+    m_decayConstants[from] += rate;
+    if (to >= 0) m_flows.push_back({from, static_cast<uint32_t>(to), rate});
+    return true;
+}
+
+bool DecayChain::hasFlow(uint32_t from, uint32_t to) const {
+    return std::any_of(m_flows.begin(), m_flows.end(),
+                       [&](const Flow& flow) { return flow.from == from && flow.to == to; });
+}
+
+void DecayChain::addUraniumSeries() {
+    const double MINUTE = 60.0, DAY = 86400.0, YEAR = SECONDS_PER_YEAR;
+    const struct { const char* name; double halfLife; } members[] = {
+        {"U-238", 4.468e9 * YEAR}, {"Th-234", 24.10 * DAY},   {"Pa-234m", 1.159 * MINUTE},
+        {"U-234", 2.455e5 * YEAR}, {"Th-230", 7.54e4 * YEAR}, {"Ra-226", 1600.0 * YEAR},
+        {"Rn-222", 3.8235 * DAY},  {"Po-218", 3.098 * MINUTE}, {"Pb-214", 26.8 * MINUTE},
+        {"Bi-214", 19.9 * MINUTE}, {"Po-214", 164.3e-6},       {"Pb-210", 22.2 * YEAR},
+        {"Bi-210", 5.012 * DAY},   {"Po-210", 138.376 * DAY},  {"Pb-206", 0.0},
+    };
+    uint32_t previous = 0;
+    for (size_t k = 0; k < sizeof(members) / sizeof(members[0]); ++k) {
+        uint32_t index = addNuclide(members[k].name, members[k].halfLife);
+        if (k > 0 && std::string(members[k - 1].name) != "Bi-214") addDecay(previous, static_cast<int>(index));
+        previous = index;
+    }
+    // Bismuth-214 branches to polonium-214 (β⁻) and thallium-210 (α), which rejoin at lead-210
+    uint32_t bismuth = static_cast<uint32_t>(findNuclide("Bi-214"));
+    uint32_t thallium = addNuclide("Tl-210", 1.30 * MINUTE);
+    addDecay(bismuth, findNuclide("Po-214"), 0.99979);
+    addDecay(bismuth, static_cast<int>(thallium), 0.00021);
+    addDecay(thallium, findNuclide("Pb-210"));
+}
+
+void DecayChain::clear() {
+    m_names.clear();
+    m_decayConstants.clear();
+    m_amounts.clear();
+    m_flows.clear();
+}
+
+double DecayChain::getActivity(uint32_t nuclide) const {
+    const double AVOGADRO = 6.02214076e23;
+    return m_decayConstants[nuclide] * m_amounts[nuclide] * AVOGADRO;
+}
+
+bool DecayChain::buildBateman(std::vector<std::vector<std::pair<double, double>>>& terms) const {
+    const size_t n = m_names.size();
+    std::vector<std::vector<const Flow*>> outgoing(n);
+    for (const Flow& flow : m_flows) outgoing[flow.from].push_back(&flow);
+
+    // Cycles have no Bateman solution
+    std::vector<int> state(n, 0);  // 0 unvisited, 1 on the stack, 2 done
+    std::function<bool(uint32_t)> acyclic = [&](uint32_t node) {
+        state[node] = 1;
+        for (const Flow* flow : outgoing[node]) {
+            if (state[flow->to] == 1) return false;
+            if (state[flow->to] == 0 && !acyclic(flow->to)) return false;
+        }
+        state[node] = 2;
+        return true;
+    };
+    for (uint32_t i = 0; i < n; ++i) {
+        if (state[i] == 0 && !acyclic(i)) return false;
+    }
+
+    // Walk every path from every nuclide present. At depth m the amount of the
+    // nuclide reached is Σ_j c_j e^(-λ_j t), with c_j = N0 Π r_i / Π_(k≠j) (λ_k - λ_j)
+    terms.assign(n, {});
+    double total = 0.0;
+    for (double amount : m_amounts) total += std::fabs(amount);
+    const double limit = MAX_COEFFICIENT_GROWTH * std::max(total, std::numeric_limits<double>::min());
+    std::vector<double> lambdas, coefficients;
+    size_t steps = 0;
+    bool ok = true;
+    std::function<void(uint32_t, double)> walk = [&](uint32_t node, double product) {
+        if (!ok) return;
+        size_t depth = lambdas.size();
+        for (size_t j = 0; j < depth; ++j) terms[node].emplace_back(lambdas[j], coefficients[j]);
+        for (const Flow* flow : outgoing[node]) {
+            if (++steps > MAX_PATH_STEPS) {
+                ok = false;
+                return;
+            }
+            double next = m_decayConstants[flow->to];
+            std::vector<double> saved = coefficients;
+            double newest = product * flow->rate;
+            for (size_t j = 0; j < depth; ++j) {
+                double separation = lambdas[j] - next;
+                if (std::fabs(separation) <= DEGENERATE_SEPARATION * std::max(lambdas[j], next)) {
+                    ok = false;
+                    return;
+                }
+                coefficients[j] *= flow->rate / (next - lambdas[j]);
+                newest /= separation;
+                if (std::fabs(coefficients[j]) > limit) ok = false;
+            }
+            if (std::fabs(newest) > limit) ok = false;
+            if (!ok) return;
+            lambdas.push_back(next);
+            coefficients.push_back(newest);
+            walk(flow->to, product * flow->rate);
+            lambdas.pop_back();
+            coefficients = std::move(saved);
+        }
+    };
+    for (uint32_t i = 0; i < n && ok; ++i) {
+        if (m_amounts[i] == 0.0) continue;
+        lambdas.assign(1, m_decayConstants[i]);
+        coefficients.assign(1, m_amounts[i]);
+        walk(i, m_amounts[i]);
+    }
+    if (!ok) return false;
+
+    // Paths that reach a nuclide through different routes share its exponentials
+    for (auto& list : terms) {
+        std::sort(list.begin(), list.end());
+        size_t kept = 0;
+        for (size_t k = 0; k < list.size(); ++k) {
+            if (kept > 0 && list[kept - 1].first == list[k].first) list[kept - 1].second += list[k].second;
+            else list[kept++] = list[k];
+        }
+        list.resize(kept);
+    }
+    return true;
+}
+
+void DecayChain::evaluateBateman(const std::vector<std::vector<std::pair<double, double>>>& terms,
+                                 const std::vector<double>& times, std::vector<double>& amounts) const {
+    const size_t n = m_names.size();
+    for (size_t k = 0; k < times.size(); ++k) {
+        for (size_t i = 0; i < n; ++i) {
+            double sum = 0.0;
+            for (const auto& term : terms[i]) sum += term.second * std::exp(-term.first * times[k]);
+            amounts[k * n + i] = std::max(0.0, sum);
+        }
+    }
+}
+
+void DecayChain::evaluateMatrix(const std::vector<double>& times, std::vector<double>& amounts) const {
+    const size_t n = m_names.size();
+    Matrix rates(n * n, 0.0);
+    for (size_t i = 0; i < n; ++i) rates[i * n + i] = -m_decayConstants[i];
+    for (const Flow& flow : m_flows) rates[size_t(flow.to) * n + flow.from] += flow.rate;
+
+    // March through the times in order; equal intervals reuse the exponential
+    std::vector<size_t> order(times.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return times[a] < times[b]; });
+    std::vector<double> current = m_amounts, next(n);
+    Matrix propagator;
+    double previous = 0.0, interval = -1.0;
+    for (size_t k : order) {
+        double step = times[k] - previous;
+        if (step > 0.0) {
+            if (step != interval) {
+                exponential(rates, n, step, propagator);
+                interval = step;
+            }
+            for (size_t i = 0; i < n; ++i) {
+                double sum = 0.0;
+                for (size_t j = 0; j < n; ++j) sum += propagator[i * n + j] * current[j];
+                next[i] = std::max(0.0, sum);
+            }
+            current.swap(next);
+            previous = times[k];
+        }
+        std::copy(current.begin(), current.end(), amounts.begin() + k * n);
+    }
+}
+
+bool DecayChain::evaluate(const std::vector<double>& times, std::vector<double>& amounts) {
+    for (double t : times) {
+        if (!(t >= 0.0)) return false;
+    }
+    amounts.assign(times.size() * m_names.size(), 0.0);
+    if (m_names.empty()) return true;
+
+    if (m_method != DecayMethod::MatrixExponential) {
+        std::vector<std::vector<std::pair<double, double>>> terms;
+        if (buildBateman(terms)) {
+            evaluateBateman(terms, times, amounts);
+            m_lastMethod = DecayMethod::Bateman;
+            return true;
+        }
+        if (m_method == DecayMethod::Bateman) return false;
+    }
+    evaluateMatrix(times, amounts);
+    m_lastMethod = DecayMethod::MatrixExponential;
+    return true;
+}
+
+bool DecayChain::evolve(double time) {
+    std::vector<double> amounts;
+    if (!evaluate({time}, amounts)) return false;
+    m_amounts = amounts;
+    return true;
+}
@@ -0,0 +1,284 @@
+#include "DomainDecomposition.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// id, position, velocity, mass, atomic number
+const size_t RECORD_BYTES = sizeof(uint64_t) + 7 * sizeof(float) + sizeof(uint8_t);
+
+void packAtom(const DomainParticles& p, size_t i, std::vector<char>& out) {
+    size_t offset = out.size();
+    out.resize(offset + RECORD_BYTES);
+    char* dst = out.data() + offset;
+    const float values[7] = {p.x[i], p.y[i], p.z[i], p.vx[i], p.vy[i], p.vz[i], p.mass[i]};
+    std::memcpy(dst, &p.id[i], sizeof(uint64_t));
+    std::memcpy(dst + sizeof(uint64_t), values, sizeof(values));
+    dst[sizeof(uint64_t) + sizeof(values)] = static_cast<char>(p.atomicNumber[i]);
+}
+
+void unpackAtoms(const std::vector<char>& in, DomainParticles& p) {
+    for (size_t offset = 0; offset + RECORD_BYTES <= in.size(); offset += RECORD_BYTES) {
+        const char* src = in.data() + offset;
+        uint64_t id;
+        float values[7];
+        std::memcpy(&id, src, sizeof(uint64_t));
+        std::memcpy(values, src + sizeof(uint64_t), sizeof(values));
+        p.id.push_back(id);
+        p.x.push_back(values[0]);
+        p.y.push_back(values[1]);
+        p.z.push_back(values[2]);
+        p.vx.push_back(values[3]);
+        p.vy.push_back(values[4]);
+        p.vz.push_back(values[5]);
+        p.mass.push_back(values[6]);
+        p.atomicNumber.push_back(static_cast<uint8_t>(src[sizeof(uint64_t) + sizeof(values)]));
+    }
+}
+
+float coordinate(const DomainParticles& p, size_t i, int axis) {
+    return axis == 0 ? p.x[i] : axis == 1 ? p.y[i] : p.z[i];
+}
+}
+
+// ─── DomainParticles ────────────────────────────────────────────────────────
+
+void DomainParticles::append(const DomainParticles& other, size_t i) {
+    id.push_back(other.id[i]);
+    x.push_back(other.x[i]);
+    y.push_back(other.y[i]);
+    z.push_back(other.z[i]);
+    vx.push_back(other.vx[i]);
+    vy.push_back(other.vy[i]);
+    vz.push_back(other.vz[i]);
+    mass.push_back(other.mass[i]);
+    atomicNumber.push_back(other.atomicNumber[i]);
+}
+
+void DomainParticles::dropHalos() {
+    resize(ownedCount);
+}
+
+void DomainParticles::resize(size_t count) {
+    id.resize(count);
+    x.resize(count);
+    y.resize(count);
+    z.resize(count);
+    vx.resize(count);
+    vy.resize(count);
+    vz.resize(count);
+    mass.resize(count);
+    atomicNumber.resize(count);
+    ownedCount = std::min(ownedCount, count);
+}
+
+// ─── DomainDecomposition ────────────────────────────────────────────────────
+
+DomainDecomposition::DomainDecomposition(Communicator& communicator)
+    : m_comm(communicator) {}
+
+bool DomainDecomposition::setup(const glm::vec3& boxLo, const glm::vec3& boxHi, float haloWidth,
+                                std::array<int, 3> grid) {
+    const int size = m_comm.getSize();
+    const glm::vec3 extent = boxHi - boxLo;
+    if (grid[0] <= 0 || grid[1] <= 0 || grid[2] <= 0) {
+        // Give each prime factor of the rank count to the axis with the widest subdomains
+        grid = {1, 1, 1};
+        int remaining = size;
+        std::vector<int> factors;
+        for (int f = 2; f * f <= remaining; ++f) {
+            while (remaining % f == 0) {
+                factors.push_back(f);
+                remaining /= f;
+            }
+        }
+        if (remaining > 1) factors.push_back(remaining);
+        std::sort(factors.rbegin(), factors.rend());
+        for (int f : factors) {
+            int axis = 0;
+            for (int a = 1; a < 3; ++a) {
+                if (extent[a] / grid[a] > extent[axis] / grid[axis]) axis = a;
+            }
+            grid[axis] *= f;
+        }
+    }
+    if (grid[0] * grid[1] * grid[2] != size) return false;
+    for (int a = 0; a < 3; ++a) {
+        if (grid[a] > 1 && extent[a] / grid[a] < haloWidth) return false;
+    }
+
+    m_boxLo = boxLo;
+    m_boxHi = boxHi;
+    m_haloWidth = haloWidth;
+    m_grid = grid;
+    const int rank = m_comm.getRank();
+    m_coords = {rank % grid[0], (rank / grid[0]) % grid[1], rank / (grid[0] * grid[1])};
+    for (int a = 0; a < 3; ++a) {
+        m_cuts[a].resize(grid[a] + 1);
+        for (int k = 0; k <= grid[a]; ++k) {
+            m_cuts[a][k] = boxLo[a] + extent[a] * k / grid[a];
+        }
+    }
+    return true;
+}
+
+int DomainDecomposition::rankAt(int cx, int cy, int cz) const {
+    return (cz * m_grid[1] + cy) * m_grid[0] + cx;
+}
+
+int DomainDecomposition::neighbor(int axis, int direction) const {
+    std::array<int, 3> c = m_coords;
+    c[axis] += direction;
+    if (c[axis] < 0 || c[axis] >= m_grid[axis]) return Communicator::NO_RANK;
+    return rankAt(c[0], c[1], c[2]);
+}
+
+int DomainDecomposition::cellAlong(int axis, float value) const {
+    // Interior cuts only: anything outside the box belongs to the outer cells
+    const std::vector<float>& cuts = m_cuts[axis];
+    return static_cast<int>(std::upper_bound(cuts.begin() + 1, cuts.end() - 1, value) - (cuts.begin() + 1));
+}
+
+int DomainDecomposition::ownerOf(const glm::vec3& p) const {
+    return rankAt(cellAlong(0, p.x), cellAlong(1, p.y), cellAlong(2, p.z));
+}
+
+glm::vec3 DomainDecomposition::getSubdomainLo() const {
+    return glm::vec3(m_cuts[0][m_coords[0]], m_cuts[1][m_coords[1]], m_cuts[2][m_coords[2]]);
+}
+
+glm::vec3 DomainDecomposition::getSubdomainHi() const {
+    return glm::vec3(m_cuts[0][m_coords[0] + 1], m_cuts[1][m_coords[1] + 1], m_cuts[2][m_coords[2] + 1]);
+}
+
+void DomainDecomposition::claim(const DomainParticles& all, DomainParticles& local) const {
+    local = DomainParticles();
+    const int rank = m_comm.getRank();
+    for (size_t i = 0; i < all.size(); ++i) {
+        if (ownerOf(all.position(i)) == rank) local.append(all, i);
+    }
+    local.ownedCount = local.size();
+}
+
+bool DomainDecomposition::shift(DomainParticles& local, int axis, bool halo) {
+    const int lower = neighbor(axis, -1);
+    const int upper = neighbor(axis, +1);
+    if (lower == Communicator::NO_RANK && upper == Communicator::NO_RANK) return true;
+
+    const int cell = m_coords[axis];
+    const float lo = m_cuts[axis][cell];
+    const float hi = m_cuts[axis][cell + 1];
+    std::vector<char> toLower, toUpper;
+
+    if (halo) {
+        // Everything held so far, including halos from earlier axes, so corners propagate
+        for (size_t i = 0; i < local.size(); ++i) {
+            float c = coordinate(local, i, axis);
+            if (lower != Communicator::NO_RANK && c < lo + m_haloWidth) packAtom(local, i, toLower);
+            if (upper != Communicator::NO_RANK && c >= hi - m_haloWidth) packAtom(local, i, toUpper);
+        }
+    } else {
+        // Owned atoms only; those that leave are compacted out in order
+        size_t kept = 0;
+        for (size_t i = 0; i < local.size(); ++i) {
+            int target = cellAlong(axis, coordinate(local, i, axis));
+            if (target < cell && lower != Communicator::NO_RANK) {
+                packAtom(local, i, toLower);
+            } else if (target > cell && upper != Communicator::NO_RANK) {
+                packAtom(local, i, toUpper);
+            } else {
+                if (kept != i) {
+                    local.id[kept] = local.id[i];
+                    local.x[kept] = local.x[i];
+                    local.y[kept] = local.y[i];
+                    local.z[kept] = local.z[i];
+                    local.vx[kept] = local.vx[i];
+                    local.vy[kept] = local.vy[i];
+                    local.vz[kept] = local.vz[i];
+                    local.mass[kept] = local.mass[i];
+                    local.atomicNumber[kept] = local.atomicNumber[i];
+                }
+                ++kept;
+            }
+        }
+        local.ownedCount = kept;
+        local.resize(kept);
+    }
+
+    m_bytesSent += toLower.size() + toUpper.size();
+    // Down then up: each rank sends one way while receiving from the other
+    if (!m_comm.exchange(lower, toLower, upper, m_receiveBuffer)) return false;
+    unpackAtoms(m_receiveBuffer, local);
+    if (!m_comm.exchange(upper, toUpper, lower, m_receiveBuffer)) return false;
+    unpackAtoms(m_receiveBuffer, local);
+    if (!halo) local.ownedCount = local.size();
+    return true;
+}
+
+bool DomainDecomposition::migrate(DomainParticles& local) {
+    local.dropHalos();
+    // An atom moves at most one cell per axis per pass; repeat until nothing moves anywhere
+    const int maxPasses = std::max({m_grid[0], m_grid[1], m_grid[2]});
+    for (int pass = 0; pass < maxPasses; ++pass) {
+        for (int a = 0; a < 3; ++a) {
+            if (!shift(local, a, false)) return false;
+        }
+        double misplaced = 0.0;
+        const int rank = m_comm.getRank();
+        for (size_t i = 0; i < local.size(); ++i) {
+            misplaced += ownerOf(local.position(i)) != rank;
+        }
+        m_comm.allReduceSum(&misplaced, 1);
+        if (misplaced == 0.0) break;
+    }
+    return true;
+}
+
+bool DomainDecomposition::exchangeHalos(DomainParticles& local) {
+    local.dropHalos();
+    for (int a = 0; a < 3; ++a) {
+        if (!shift(local, a, true)) return false;
+    }
+    return true;
+}
+
+bool DomainDecomposition::rebalance(DomainParticles& local, double cost) {
+    local.dropHalos();
+
+    // Spread this rank's cost over its atoms and project it onto each axis
+    std::vector<double> histogram(3 * HISTOGRAM_BINS, 0.0);
+    const double weight = local.size() > 0 ? cost / local.size() : 0.0;
+    const glm::vec3 extent = m_boxHi - m_boxLo;
+    for (size_t i = 0; i < local.size(); ++i) {
+        for (int a = 0; a < 3; ++a) {
+            float t = (coordinate(local, i, a) - m_boxLo[a]) / extent[a];
+            int bin = std::clamp(static_cast<int>(t * HISTOGRAM_BINS), 0, HISTOGRAM_BINS - 1);
+            histogram[a * HISTOGRAM_BINS + bin] += weight;
+        }
+    }
+    m_comm.allReduceSum(histogram.data(), histogram.size());
+
+    for (int a = 0; a < 3; ++a) {
+        const int g = m_grid[a];
+        if (g == 1) continue;
+        const double* bins = histogram.data() + a * HISTOGRAM_BINS;
+        double total = 0.0;
+        for (int b = 0; b < HISTOGRAM_BINS; ++b) total += bins[b];
+        if (total <= 0.0) continue;
+
+        // Cuts at equal cumulative cost, interpolated inside the bin
+        std::vector<float>& cuts = m_cuts[a];
+        const float binWidth = extent[a] / HISTOGRAM_BINS;
+        double cumulative = 0.0;
+        int b = 0;
+        for (int k = 1; k < g; ++k) {
+            double target = total * k / g;
+            while (b < HISTOGRAM_BINS - 1 && cumulative + bins[b] < target) cumulative += bins[b++];
+            double fraction = bins[b] > 0.0 ? std::clamp((target - cumulative) / bins[b], 0.0, 1.0) : 0.5;
+            cuts[k] = m_boxLo[a] + (b + static_cast<float>(fraction)) * binWidth;
+        }
+        // Subdomains narrower than the halo would need halos from beyond the neighbour
+        for (int k = 1; k < g; ++k) cuts[k] = std::max(cuts[k], cuts[k - 1] + m_haloWidth);
+        for (int k = g - 1; k >= 1; --k) cuts[k] = std::min(cuts[k], cuts[k + 1] - m_haloWidth);
+    }
+    return migrate(local);
+}
@@ -0,0 +1,157 @@
+#ifndef DOMAIN_DECOMPOSITION_H
+#define DOMAIN_DECOMPOSITION_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Communicator.h"
+
+/**
+ * @brief The particles held by one rank: its own atoms followed by halo copies.
+ *
+ * Indices below getOwnedCount() are owned by this rank and integrated here;
+ * the rest are read-only copies of neighbouring ranks' atoms near the
+ * subdomain boundary, refreshed by DomainDecomposition::exchangeHalos().
+ */
+struct DomainParticles {
+    std::vector<uint64_t> id;             ///< Global atom id, stable across migration
+    std::vector<float> x, y, z;
+    std::vector<float> vx, vy, vz;
+    std::vector<float> mass;
+    std::vector<uint8_t> atomicNumber;
+    size_t ownedCount = 0;
+
+    size_t size() const { return id.size(); }
+    size_t getOwnedCount() const { return ownedCount; }
+    glm::vec3 position(size_t i) const { return glm::vec3(x[i], y[i], z[i]); }
+
+    /**
+     * @brief Appends one atom copied from another store.
+     *
+     * @param other The source store.
+     * @param i Index in the source.
+     */
+    void append(const DomainParticles& other, size_t i);
+
+    /**
+     * @brief Drops the halo copies, keeping the owned atoms.
+     */
+    void dropHalos();
+
+    /**
+     * @brief Resizes every array.
+     *
+     * @param count The new atom count.
+     */
+    void resize(size_t count);
+};
+
+/**
+ * @brief Splits a simulation box across ranks and keeps atoms on their owners.
+ *
+ * The box is cut into a rectilinear grid of subdomains, one per rank, with
+ * the cuts along each axis shared by all ranks. Each step, atoms that left
+ * their subdomain migrate to the new owner, and atoms within the halo width
+ * of a cut are copied to the neighbour across it, so short-range forces on
+ * owned atoms can be computed locally. Both go axis by axis with the two
+ * face neighbours only; forwarding what arrived on earlier axes covers
+ * edge and corner neighbours in six messages instead of twenty-six.
+ *
+ * rebalance() moves the cuts so every slab of the grid carries the same
+ * measured cost: each rank spreads its compute time over its atoms,
+ * histograms that along each axis, and the histograms are summed across
+ * ranks before new cuts are placed at equal cumulative cost.
+ *
+ * The box is not periodic; atoms outside it belong to the outermost
+ * subdomains.
+ */
+class DomainDecomposition {
+public:
+    static constexpr int HISTOGRAM_BINS = 1024;
+
+    explicit DomainDecomposition(Communicator& communicator);
+
+    /**
+     * @brief Sets up an even grid over a box.
+     *
+     * @param boxLo Minimum corner.
+     * @param boxHi Maximum corner.
+     * @param haloWidth Interaction cutoff; subdomains are kept at least this wide.
+     * @param grid Ranks along each axis; zeros pick a grid that cuts the longest axes first.
+     * @return False if the grid does not match the rank count or the box is too small for it.
+     */
+    bool setup(const glm::vec3& boxLo, const glm::vec3& boxHi, float haloWidth,
+               std::array<int, 3> grid = {0, 0, 0});
+
+    /**
+     * @brief Keeps the atoms this rank owns out of a full list every rank was given.
+     *
+     * @param all Every atom.
+     * @param local Receives the owned atoms.
+     */
+    void claim(const DomainParticles& all, DomainParticles& local) const;
+
+    /**
+     * @brief Sends owned atoms that left the subdomain to their new owners.
+     *
+     * Halo copies are dropped first.
+     *
+     * @param local This rank's atoms.
+     * @return False if the transport failed.
+     */
+    bool migrate(DomainParticles& local);
+
+    /**
+     * @brief Appends copies of neighbours' atoms within the halo width.
+     *
+     * @param local This rank's atoms; existing halos are replaced.
+     * @return False if the transport failed.
+     */
+    bool exchangeHalos(DomainParticles& local);
+
+    /**
+     * @brief Moves the cuts so the measured cost is spread evenly, then migrates.
+     *
+     * @param local This rank's atoms.
+     * @param cost Time this rank spent on its atoms since the last rebalance.
+     * @return False if the transport failed.
+     */
+    bool rebalance(DomainParticles& local, double cost);
+
+    /**
+     * @brief Gets the rank that owns a position.
+     *
+     * @param p The position.
+     * @return The owning rank.
+     */
+    int ownerOf(const glm::vec3& p) const;
+
+    const std::array<int, 3>& getGrid() const { return m_grid; }
+    const std::array<int, 3>& getCoordinates() const { return m_coords; }
+    const std::vector<float>& getCuts(int axis) const { return m_cuts[axis]; }
+    glm::vec3 getSubdomainLo() const;
+    glm::vec3 getSubdomainHi() const;
+
+    /// Bytes sent by migrate() and exchangeHalos() since construction
+    uint64_t getBytesSent() const { return m_bytesSent; }
+
+private:
+    Communicator& m_comm;
+    glm::vec3 m_boxLo = glm::vec3(0.0f);
+    glm::vec3 m_boxHi = glm::vec3(1.0f);
+    float m_haloWidth = 0.0f;
+    std::array<int, 3> m_grid = {1, 1, 1};
+    std::array<int, 3> m_coords = {0, 0, 0};
+    std::array<std::vector<float>, 3> m_cuts;  ///< grid[a] + 1 cut positions per axis
+    uint64_t m_bytesSent = 0;
+    std::vector<char> m_receiveBuffer;
+
+    int rankAt(int cx, int cy, int cz) const;
+    int neighbor(int axis, int direction) const;
+    int cellAlong(int axis, float coordinate) const;
+    bool shift(DomainParticles& local, int axis, bool halo);
+};
+
+#endif // DOMAIN_DECOMPOSITION_H
@@ -0,0 +1,176 @@
+#include "ElectrostaticGrid.h"
+#include "CellGrid.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const double PI = 3.14159265358979323846;
+// Samples per block edge
+const int BLOCK = 8;
+// Beyond this fraction of dirty blocks a full pass is as cheap
+const float FULL_UPDATE_FRACTION = 0.5f;
+// Largest grid edge in samples, to bound memory when charges spread out
+const int MAX_DIM = 256;
+}
+
+ElectrostaticGrid::ElectrostaticGrid()
+    : m_tree(0.5f, 0.0f) {}
+
+void ElectrostaticGrid::setResolution(float spacing, float padding, float densityWidth) {
+    m_spacing = std::max(spacing, 1e-4f);
+    m_padding = std::max(padding, 0.0f);
+    m_densityWidth = std::max(densityWidth, 1e-4f);
+    m_needsFullUpdate = true;
+    m_potential.values.clear();
+}
+
+void ElectrostaticGrid::setUpdatePolicy(float tolerance, float radius, int fullRefreshInterval) {
+    m_tolerance = std::max(tolerance, 0.0f);
+    m_updateRadius = std::max(radius, 0.0f);
+    m_fullRefreshInterval = std::max(1, fullRefreshInterval);
+}
+
+bool ElectrostaticGrid::fitsGrid(const std::vector<glm::vec3>& positions) const {
+    if (m_potential.values.empty()) return false;
+    // Refit once a charge is inside the outer half of the padding
+    glm::vec3 lo = m_potential.origin + glm::vec3(0.5f * m_padding);
+    glm::vec3 hi = m_potential.position(m_potential.dims[0] - 1, m_potential.dims[1] - 1, m_potential.dims[2] - 1)
+                 - glm::vec3(0.5f * m_padding);
+    for (const auto& p : positions) {
+        if (glm::any(glm::lessThan(p, lo)) || glm::any(glm::greaterThan(p, hi))) return false;
+    }
+    return true;
+}
+
+void ElectrostaticGrid::fitGrid(const std::vector<glm::vec3>& positions) {
+    glm::vec3 lo(0.0f), hi(0.0f);
+    if (!positions.empty()) {
+        lo = hi = positions[0];
+        for (const auto& p : positions) {
+            lo = glm::min(lo, p);
+            hi = glm::max(hi, p);
+        }
+    }
+    lo -= glm::vec3(m_padding);
+    hi += glm::vec3(m_padding);
+
+    glm::vec3 extent = hi - lo;
+    float spacing = std::max(m_spacing, std::max(std::max(extent.x, extent.y), extent.z) / (MAX_DIM - 1));
+    int dims[3];
+    for (int a = 0; a < 3; ++a) {
+        dims[a] = std::max(2, static_cast<int>(std::ceil(extent[a] / spacing)) + 1);
+        m_blocks[a] = (dims[a] + BLOCK - 1) / BLOCK;
+    }
+    m_potential.resize(lo, spacing, dims[0], dims[1], dims[2]);
+    m_density.resize(lo, spacing, dims[0], dims[1], dims[2]);
+}
+
+void ElectrostaticGrid::markBlocks(const glm::vec3& center, float radius, std::vector<uint8_t>& dirty) const {
+    int lo[3], hi[3];
+    float blockSize = BLOCK * m_potential.spacing;
+    for (int a = 0; a < 3; ++a) {
+        lo[a] = std::max(0, static_cast<int>(std::floor((center[a] - radius - m_potential.origin[a]) / blockSize)));
+        hi[a] = std::min(m_blocks[a] - 1, static_cast<int>(std::floor((center[a] + radius - m_potential.origin[a]) / blockSize)));
+        if (lo[a] > hi[a]) return;
+    }
+    for (int z = lo[2]; z <= hi[2]; ++z) {
+        for (int y = lo[1]; y <= hi[1]; ++y) {
+            for (int x = lo[0]; x <= hi[0]; ++x) {
+                dirty[(size_t(z) * m_blocks[1] + y) * m_blocks[0] + x] = 1;
+            }
+        }
+    }
+}
+
+bool ElectrostaticGrid::update(const std::vector<glm::vec3>& positions, const std::vector<float>& charges,
+                               const std::vector<float>& electrons) {
+    m_blocksUpdated = 0;
+    bool full = m_needsFullUpdate || m_accounted.size() != positions.size() || !fitsGrid(positions);
+
+    std::vector<uint8_t> dirty;
+    if (!full) {
+        dirty.assign(getBlockCount(), 0);
+        const float tolerance2 = m_tolerance * m_tolerance;
+        // The density reaches three widths; the potential is re-evaluated out to the update radius
+        const float radius = std::max(m_updateRadius, 3.0f * m_densityWidth);
+        bool moved = false;
+        for (size_t i = 0; i < positions.size(); ++i) {
+            glm::vec3 d = positions[i] - m_accounted[i];
+            if (glm::dot(d, d) <= tolerance2) continue;
+            markBlocks(m_accounted[i], radius, dirty);
+            markBlocks(positions[i], radius, dirty);
+            m_accounted[i] = positions[i];
+            moved = true;
+        }
+        if (!moved) return false;
+        size_t dirtyCount = std::count(dirty.begin(), dirty.end(), 1);
+        full = dirtyCount > FULL_UPDATE_FRACTION * dirty.size() || ++m_updatesSinceRefresh >= m_fullRefreshInterval;
+    }
+
+    if (full) {
+        if (!fitsGrid(positions)) fitGrid(positions);
+        m_accounted = positions;
+        m_needsFullUpdate = false;
+        m_updatesSinceRefresh = 0;
+        dirty.assign(getBlockCount(), 1);
+    }
+
+    std::vector<uint32_t> blocks;
+    for (size_t b = 0; b < dirty.size(); ++b) {
+        if (dirty[b]) blocks.push_back(static_cast<uint32_t>(b));
+    }
+
+    m_tree.setSoftening(0.5f * m_potential.spacing);
+    m_tree.build(positions, charges);
+    evaluateBlocks(blocks, positions, electrons);
+    m_blocksUpdated = blocks.size();
+    ++m_version;
+    return true;
+}
+
+void ElectrostaticGrid::evaluateBlocks(const std::vector<uint32_t>& blocks, const std::vector<glm::vec3>& positions,
+                                       const std::vector<float>& electrons) {
+    // Density sources: only the charges that carry electrons
+    std::vector<uint32_t> carriers;
+    std::vector<float> x(positions.size()), y(positions.size()), z(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        x[i] = positions[i].x;
+        y[i] = positions[i].y;
+        z[i] = positions[i].z;
+        if (i < electrons.size() && electrons[i] != 0.0f) carriers.push_back(static_cast<uint32_t>(i));
+    }
+    const float cutoff = 3.0f * m_densityWidth;
+    const float cutoff2 = cutoff * cutoff;
+    const float inverseTwoWidth2 = 1.0f / (2.0f * m_densityWidth * m_densityWidth);
+    const float norm = static_cast<float>(std::pow(2.0 * PI * m_densityWidth * m_densityWidth, -1.5));
+    CellGrid grid;
+    grid.build(x.data(), y.data(), z.data(), carriers, cutoff);
+
+    const int* dims = m_potential.dims;
+    TaskScheduler::getInstance().parallelFor(0, blocks.size(), [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            uint32_t b = blocks[k];
+            int bx = static_cast<int>(b % m_blocks[0]);
+            int by = static_cast<int>((b / m_blocks[0]) % m_blocks[1]);
+            int bz = static_cast<int>(b / (size_t(m_blocks[0]) * m_blocks[1]));
+            for (int gz = bz * BLOCK; gz < std::min(dims[2], (bz + 1) * BLOCK); ++gz) {
+                for (int gy = by * BLOCK; gy < std::min(dims[1], (by + 1) * BLOCK); ++gy) {
+                    for (int gx = bx * BLOCK; gx < std::min(dims[0], (bx + 1) * BLOCK); ++gx) {
+                        glm::vec3 p = m_potential.position(gx, gy, gz);
+                        size_t index = m_potential.index(gx, gy, gz);
+                        m_potential.values[index] = static_cast<float>(m_tree.potential(p));
+
+                        float density = 0.0f;
+                        grid.forEachCandidate(p, cutoff, [&](uint32_t j) {
+                            glm::vec3 d = positions[j] - p;
+                            float r2 = glm::dot(d, d);
+                            if (r2 < cutoff2) density += electrons[j] * std::exp(-r2 * inverseTwoWidth2);
+                        });
+                        m_density.values[index] = density * norm;
+                    }
+                }
+            }
+        }
+    }, 4);
+}
@@ -0,0 +1,93 @@
+#ifndef ELECTROSTATIC_GRID_H
+#define ELECTROSTATIC_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "CoulombTree.h"
+#include "Isosurface.h"
+
+/**
+ * @brief Electrostatic potential and electron density sampled on a grid.
+ *
+ * The potential at each grid point comes from a CoulombTree, so a full
+ * evaluation costs O(G log N + N log N) rather than O(G·N). The density is a
+ * sum of Gaussians over the electron-carrying charges, cut off at three
+ * widths and gathered through a CellGrid.
+ *
+ * Updates are incremental. The grid is split into blocks of 8³ samples and
+ * each charge remembers where it was last accounted for; only blocks within
+ * the update radius of charges that moved more than the tolerance are
+ * re-evaluated. Blocks farther out keep a potential that is stale by at most
+ * q·δ/R² per moved charge, so the whole grid is refreshed every few updates
+ * and whenever the charges leave the grid's padding.
+ */
+class ElectrostaticGrid {
+public:
+    ElectrostaticGrid();
+
+    /**
+     * @brief Sets the sampling parameters; the next update is a full one.
+     *
+     * @param spacing Distance between samples.
+     * @param padding Margin around the charges' bounding box.
+     * @param densityWidth Gaussian width of each electron's density.
+     */
+    void setResolution(float spacing, float padding, float densityWidth);
+
+    /**
+     * @brief Sets the incremental update policy.
+     *
+     * @param tolerance Movement below which a charge is not re-accounted.
+     * @param radius Blocks within this distance of a moved charge are re-evaluated.
+     * @param fullRefreshInterval Incremental updates between full refreshes.
+     */
+    void setUpdatePolicy(float tolerance, float radius, int fullRefreshInterval);
+
+    /**
+     * @brief Brings the grids up to date with the charges.
+     *
+     * @param positions Charge positions.
+     * @param charges Charges, in elementary charges.
+     * @param electrons Electrons carried by each charge, for the density.
+     * @return True if any grid values changed.
+     */
+    bool update(const std::vector<glm::vec3>& positions, const std::vector<float>& charges,
+                const std::vector<float>& electrons);
+
+    /// Forces the next update to re-evaluate every block
+    void invalidate() { m_needsFullUpdate = true; }
+
+    const VolumeGrid& getPotential() const { return m_potential; }
+    const VolumeGrid& getDensity() const { return m_density; }
+    size_t getBlocksUpdated() const { return m_blocksUpdated; }
+    size_t getBlockCount() const { return size_t(m_blocks[0]) * m_blocks[1] * m_blocks[2]; }
+    uint64_t getVersion() const { return m_version; }
+
+private:
+    float m_spacing = 0.25f;
+    float m_padding = 3.0f;
+    float m_densityWidth = 0.5f;
+    float m_tolerance = 0.05f;
+    float m_updateRadius = 4.0f;
+    int m_fullRefreshInterval = 30;
+
+    CoulombTree m_tree;
+    VolumeGrid m_potential;
+    VolumeGrid m_density;
+    int m_blocks[3] = {0, 0, 0};
+    std::vector<glm::vec3> m_accounted;  ///< Per charge: position the grids reflect
+    bool m_needsFullUpdate = true;
+    int m_updatesSinceRefresh = 0;
+    size_t m_blocksUpdated = 0;
+    uint64_t m_version = 0;
+
+    bool fitsGrid(const std::vector<glm::vec3>& positions) const;
+    void fitGrid(const std::vector<glm::vec3>& positions);
+    void markBlocks(const glm::vec3& center, float radius, std::vector<uint8_t>& dirty) const;
+    void evaluateBlocks(const std::vector<uint32_t>& blocks, const std::vector<glm::vec3>& positions,
+                        const std::vector<float>& electrons);
+};
+
+#endif // ELECTROSTATIC_GRID_H
@@ -0,0 +1,94 @@
+#include "ElementTable.h"
+#include <cctype>
+
+namespace {
+struct ElementEntry {
+    const char* symbol;
+    int massNumber;
+    float vdwRadius;  ///< Ångström; Bondi (1964) with Mantina et al. (2009), 2.0 where neither lists one
+};
+
+// Indexed by atomic number; entry 0 is a placeholder
+const ElementEntry ELEMENTS[ElementTable::MAX_ATOMIC_NUMBER + 1] = {
+    {"?", 0, 0.00f},
+    {"H", 1, 1.20f}, {"He", 4, 1.40f}, {"Li", 7, 1.82f}, {"Be", 9, 1.53f},
+    {"B", 11, 1.92f}, {"C", 12, 1.70f}, {"N", 14, 1.55f}, {"O", 16, 1.52f},
+    {"F", 19, 1.47f}, {"Ne", 20, 1.54f}, {"Na", 23, 2.27f}, {"Mg", 24, 1.73f},
+    {"Al", 27, 1.84f}, {"Si", 28, 2.10f}, {"P", 31, 1.80f}, {"S", 32, 1.80f},
+    {"Cl", 35, 1.75f}, {"Ar", 40, 1.88f}, {"K", 39, 2.75f}, {"Ca", 40, 2.31f},
+    {"Sc", 45, 2.00f}, {"Ti", 48, 2.00f}, {"V", 51, 2.00f}, {"Cr", 52, 2.00f},
+    {"Mn", 55, 2.00f}, {"Fe", 56, 2.00f}, {"Co", 59, 2.00f}, {"Ni", 58, 1.63f},
+    {"Cu", 63, 1.40f}, {"Zn", 64, 1.39f}, {"Ga", 69, 1.87f}, {"Ge", 74, 2.11f},
+    {"As", 75, 1.85f}, {"Se", 80, 1.90f}, {"Br", 79, 1.85f}, {"Kr", 84, 2.02f},
+    {"Rb", 85, 3.03f}, {"Sr", 88, 2.49f}, {"Y", 89, 2.00f}, {"Zr", 90, 2.00f},
+    {"Nb", 93, 2.00f}, {"Mo", 98, 2.00f}, {"Tc", 98, 2.00f}, {"Ru", 102, 2.00f},
+    {"Rh", 103, 2.00f}, {"Pd", 106, 1.63f}, {"Ag", 107, 1.72f}, {"Cd", 114, 1.58f},
+    {"In", 115, 1.93f}, {"Sn", 120, 2.17f}, {"Sb", 121, 2.06f}, {"Te", 130, 2.06f},
+    {"I", 127, 1.98f}, {"Xe", 132, 2.16f}, {"Cs", 133, 3.43f}, {"Ba", 138, 2.68f},
+    {"La", 139, 2.00f}, {"Ce", 140, 2.00f}, {"Pr", 141, 2.00f}, {"Nd", 142, 2.00f},
+    {"Pm", 145, 2.00f}, {"Sm", 152, 2.00f}, {"Eu", 153, 2.00f}, {"Gd", 158, 2.00f},
+    {"Tb", 159, 2.00f}, {"Dy", 164, 2.00f}, {"Ho", 165, 2.00f}, {"Er", 166, 2.00f},
+    {"Tm", 169, 2.00f}, {"Yb", 174, 2.00f}, {"Lu", 175, 2.00f}, {"Hf", 180, 2.00f},
+    {"Ta", 181, 2.00f}, {"W", 184, 2.00f}, {"Re", 187, 2.00f}, {"Os", 192, 2.00f},
+    {"Ir", 193, 2.00f}, {"Pt", 195, 1.75f}, {"Au", 197, 1.66f}, {"Hg", 202, 1.55f},
+    {"Tl", 205, 1.96f}, {"Pb", 208, 2.02f}, {"Bi", 209, 2.07f}, {"Po", 209, 1.97f},
+    {"At", 210, 2.02f}, {"Rn", 222, 2.20f}, {"Fr", 223, 3.48f}, {"Ra", 226, 2.83f},
+    {"Ac", 227, 2.00f}, {"Th", 232, 2.00f}, {"Pa", 231, 2.00f}, {"U", 238, 1.86f}
+};
+}
+
+int ElementTable::atomicNumberFromSymbol(const std::string& symbol) {
+    if (symbol.empty() || symbol.size() > 2) return 0;
+
+    char first = static_cast<char>(std::toupper(static_cast<unsigned char>(symbol[0])));
+    char second = symbol.size() > 1
+        ? static_cast<char>(std::tolower(static_cast<unsigned char>(symbol[1])))
+        : '\0';
+
+    for (int Z = 1; Z <= MAX_ATOMIC_NUMBER; ++Z) {
+        const char* s = ELEMENTS[Z].symbol;
+        if (s[0] == first && s[1] == second) {
+            return Z;
+        }
+    }
+    return 0;
+}
+
+const char* ElementTable::getSymbol(int atomicNumber) {
+    if (atomicNumber < 1 || atomicNumber > MAX_ATOMIC_NUMBER) return ELEMENTS[0].symbol;
+    return ELEMENTS[atomicNumber].symbol;
+}
+
+int ElementTable::getDefaultMassNumber(int atomicNumber) {
+    if (atomicNumber < 1 || atomicNumber > MAX_ATOMIC_NUMBER) return 2 * atomicNumber;
+    return ELEMENTS[atomicNumber].massNumber;
+}
+
+float ElementTable::getVdwRadius(int atomicNumber) {
+    if (atomicNumber < 1 || atomicNumber > MAX_ATOMIC_NUMBER) return 2.0f;
+    return ELEMENTS[atomicNumber].vdwRadius;
+}
+
+glm::vec3 ElementTable::getDisplayColor(int atomicNumber) {
+    switch (atomicNumber) {
+    case 1:  return {1, 1, 1};
+    case 6:  return {0.2f, 0.2f, 0.2f};
+    case 7:  return {0, 0, 1};
+    case 8:  return {1, 0, 0};
+    case 15: return {1, 0.5f, 0};
+    case 16: return {1, 1, 0};
+    default: return {0.5f, 0.5f, 0.5f};
+    }
+}
+
+float ElementTable::getDisplayRadius(int atomicNumber) {
+    switch (atomicNumber) {
+    case 1:  return 0.3f; // Hydrogen
+    case 6:  return 0.5f; // Carbon
+    case 7:  return 0.45f; // Nitrogen
+    case 8:  return 0.4f; // Oxygen
+    case 15: return 0.55f; // Phosphorus
+    case 16: return 0.6f; // Sulfur
+    default: return 0.5f;
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef ELEMENT_TABLE_H
+#define ELEMENT_TABLE_H
+
+#include <string>
+#include <glm/glm.hpp>
+
+/**
+ * @brief Static per-element data shared by loaders, physics and rendering.
+ *
+ * Covers the naturally occurring elements up to uranium (Z = 1..92).
+ */
+class ElementTable {
+public:
+    static constexpr int MAX_ATOMIC_NUMBER = 92;
+
+    /**
+     * @brief Looks up an element by its chemical symbol (case-insensitive).
+     *
+     * @param symbol The element symbol, e.g. "C" or "Cl".
+     * @return The atomic number, or 0 if the symbol is unknown.
+     */
+    static int atomicNumberFromSymbol(const std::string& symbol);
+
+    /**
+     * @brief Gets the chemical symbol of an element.
+     *
+     * @param atomicNumber The atomic number (Z).
+     * @return The symbol, or "?" for out-of-range values.
+     */
+    static const char* getSymbol(int atomicNumber);
+
+    /**
+     * @brief Gets the mass number of the most abundant (or longest-lived) isotope.
+     *
+     * @param atomicNumber The atomic number (Z).
+     * @return The mass number, or 2·Z for out-of-range values.
+     */
+    static int getDefaultMassNumber(int atomicNumber);
+
+    /**
+     * @brief Gets the van der Waals radius of an element.
+     *
+     * @param atomicNumber The atomic number (Z).
+     * @return The radius in Ångström, or 2.0 for out-of-range values.
+     */
+    static float getVdwRadius(int atomicNumber);
+
+    /**
+     * @brief Gets the color atoms of an element are drawn with.
+     *
+     * @param atomicNumber The atomic number (Z).
+     * @return The linear RGB color.
+     */
+    static glm::vec3 getDisplayColor(int atomicNumber);
+
+    /**
+     * @brief Gets the radius atoms of an element are drawn with, in scene units.
+     *
+     * @param atomicNumber The atomic number (Z).
+     * @return The drawn radius.
+     */
+    static float getDisplayRadius(int atomicNumber);
+};
+
+#endif // ELEMENT_TABLE_H
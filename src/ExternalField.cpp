@@ -0,0 +1,143 @@
+#include "ExternalField.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 1 / (4π ε0) and μ0 / 4π
+const float COULOMB_CONSTANT = 8.9875517923e9f;
+const float MAGNETIC_CONSTANT = 1e-7f;
+
+/**
+ * Adds k (3 (m·r̂) r̂ - m) / r³ at every point; the dipole's own position gets nothing.
+ */
+void addDipoleField(const glm::vec3& position, const glm::vec3& moment, float k, size_t count, const float* x,
+                    const float* y, const float* z, float* fx, float* fy, float* fz) {
+    for (size_t i = 0; i < count; ++i) {
+        float rx = x[i] - position.x, ry = y[i] - position.y, rz = z[i] - position.z;
+        float r2 = rx * rx + ry * ry + rz * rz;
+        float inverse2 = r2 > 0.0f ? 1.0f / r2 : 0.0f;
+        float inverse3 = inverse2 * std::sqrt(inverse2);
+        float projection = 3.0f * (moment.x * rx + moment.y * ry + moment.z * rz) * inverse2;
+        fx[i] += k * inverse3 * (projection * rx - moment.x);
+        fy[i] += k * inverse3 * (projection * ry - moment.y);
+        fz[i] += k * inverse3 * (projection * rz - moment.z);
+    }
+}
+}
+
+void ExternalField::setUniform(const glm::vec3& electric, const glm::vec3& magnetic) {
+    m_uniformElectric = electric;
+    m_uniformMagnetic = magnetic;
+}
+
+void ExternalField::addElectricDipole(const glm::vec3& position, const glm::vec3& moment) {
+    m_electricDipoles.push_back({position, moment});
+}
+
+void ExternalField::addMagneticDipole(const glm::vec3& position, const glm::vec3& moment) {
+    m_magneticDipoles.push_back({position, moment});
+}
+
+void ExternalField::addQuadrupoleTrap(const glm::vec3& center, float voltage, float size) {
+    if (!(size > 0.0f)) return;
+    m_quadrupoles.push_back({center, voltage / (size * size)});
+}
+
+bool ExternalField::addSampledGrid(const glm::vec3& origin, const glm::vec3& spacing, int nx, int ny, int nz,
+                                   std::vector<glm::vec3> electric, std::vector<glm::vec3> magnetic) {
+    if (nx < 2 || ny < 2 || nz < 2 || !(spacing.x > 0.0f && spacing.y > 0.0f && spacing.z > 0.0f)) return false;
+    size_t nodes = size_t(nx) * ny * nz;
+    if ((!electric.empty() && electric.size() != nodes) || (!magnetic.empty() && magnetic.size() != nodes)) {
+        return false;
+    }
+    SampledGrid grid;
+    grid.origin = origin;
+    grid.inverseSpacing = 1.0f / spacing;
+    grid.n[0] = nx;
+    grid.n[1] = ny;
+    grid.n[2] = nz;
+    grid.electric = std::move(electric);
+    grid.magnetic = std::move(magnetic);
+    m_grids.push_back(std::move(grid));
+    return true;
+}
+
+void ExternalField::clear() {
+    m_uniformElectric = glm::vec3(0.0f);
+    m_uniformMagnetic = glm::vec3(0.0f);
+    m_electricDipoles.clear();
+    m_magneticDipoles.clear();
+    m_quadrupoles.clear();
+    m_grids.clear();
+}
+
+bool ExternalField::empty() const {
+    return m_uniformElectric == glm::vec3(0.0f) && m_uniformMagnetic == glm::vec3(0.0f) &&
+           m_electricDipoles.empty() && m_magneticDipoles.empty() && m_quadrupoles.empty() && m_grids.empty();
+}
+
+void ExternalField::evaluate(const glm::vec3& position, glm::vec3& electric, glm::vec3& magnetic) const {
+    evaluate(1, &position.x, &position.y, &position.z, &electric.x, &electric.y, &electric.z, &magnetic.x,
+             &magnetic.y, &magnetic.z);
+}
+
+void ExternalField::evaluate(size_t count, const float* x, const float* y, const float* z, float* ex, float* ey,
+                             float* ez, float* bx, float* by, float* bz) const {
+    std::fill_n(ex, count, m_uniformElectric.x);
+    std::fill_n(ey, count, m_uniformElectric.y);
+    std::fill_n(ez, count, m_uniformElectric.z);
+    std::fill_n(bx, count, m_uniformMagnetic.x);
+    std::fill_n(by, count, m_uniformMagnetic.y);
+    std::fill_n(bz, count, m_uniformMagnetic.z);
+
+    for (const Dipole& d : m_electricDipoles) {
+        addDipoleField(d.position, d.moment, COULOMB_CONSTANT, count, x, y, z, ex, ey, ez);
+    }
+    for (const Dipole& d : m_magneticDipoles) {
+        addDipoleField(d.position, d.moment, MAGNETIC_CONSTANT, count, x, y, z, bx, by, bz);
+    }
+    for (const Quadrupole& q : m_quadrupoles) {
+        for (size_t i = 0; i < count; ++i) {
+            ex[i] += q.strength * (x[i] - q.center.x);
+            ey[i] += q.strength * (y[i] - q.center.y);
+            ez[i] -= 2.0f * q.strength * (z[i] - q.center.z);
+        }
+    }
+
+    for (const SampledGrid& grid : m_grids) {
+        const size_t sy = grid.n[0], sz = size_t(grid.n[0]) * grid.n[1];
+        for (size_t i = 0; i < count; ++i) {
+            float u[3] = {(x[i] - grid.origin.x) * grid.inverseSpacing.x, (y[i] - grid.origin.y) * grid.inverseSpacing.y,
+                          (z[i] - grid.origin.z) * grid.inverseSpacing.z};
+            int cell[3];
+            float f[3];
+            bool inside = true;
+            for (int a = 0; a < 3; ++a) {
+                inside = inside && u[a] >= 0.0f && u[a] <= float(grid.n[a] - 1);
+                cell[a] = std::min(static_cast<int>(u[a]), grid.n[a] - 2);
+                f[a] = u[a] - cell[a];
+            }
+            if (!inside) continue;
+
+            size_t base = cell[2] * sz + cell[1] * sy + cell[0];
+            glm::vec3 e(0.0f), b(0.0f);
+            for (int c = 0; c < 2; ++c) {
+                for (int r = 0; r < 2; ++r) {
+                    float wzy = (c ? f[2] : 1.0f - f[2]) * (r ? f[1] : 1.0f - f[1]);
+                    size_t row = base + c * sz + r * sy;
+                    for (int a = 0; a < 2; ++a) {
+                        float w = wzy * (a ? f[0] : 1.0f - f[0]);
+                        if (!grid.electric.empty()) e += w * grid.electric[row + a];
+                        if (!grid.magnetic.empty()) b += w * grid.magnetic[row + a];
+                    }
+                }
+            }
+            ex[i] += e.x;
+            ey[i] += e.y;
+            ez[i] += e.z;
+            bx[i] += b.x;
+            by[i] += b.y;
+            bz[i] += b.z;
+        }
+    }
+}
@@ -0,0 +1,128 @@
+#ifndef EXTERNAL_FIELD_H
+#define EXTERNAL_FIELD_H
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * @brief Applied electric and magnetic fields, as a sum of sources (SI units).
+ *
+ * Sources are a uniform field, point electric and magnetic dipoles, a
+ * quadrupole trap potential, and fields sampled on a regular grid, such as
+ * a magnet's field map. Together they cover Penning traps (uniform B plus a
+ * quadrupole), magnetic bottles and mirrors (dipoles), and accelerator-like
+ * setups (sampled maps).
+ *
+ * The batch evaluate() loops over sources on the outside and particles on
+ * the inside, so each inner loop is a plain array pass.
+ */
+class ExternalField {
+public:
+    ExternalField() = default;
+
+    /**
+     * @brief Sets the uniform part of the field.
+     *
+     * @param electric Electric field in V/m.
+     * @param magnetic Magnetic field in T.
+     */
+    void setUniform(const glm::vec3& electric, const glm::vec3& magnetic);
+
+    /**
+     * @brief Adds a point electric dipole.
+     *
+     * @param position Dipole position in m.
+     * @param moment Dipole moment in C·m.
+     */
+    void addElectricDipole(const glm::vec3& position, const glm::vec3& moment);
+
+    /**
+     * @brief Adds a point magnetic dipole.
+     *
+     * @param position Dipole position in m.
+     * @param moment Dipole moment in A·m².
+     */
+    void addMagneticDipole(const glm::vec3& position, const glm::vec3& moment);
+
+    /**
+     * @brief Adds the electric field of an ideal quadrupole trap.
+     *
+     * The potential is φ = (V / 2d²)(2z² - x² - y²) about the centre, so
+     * E = (V / d²)(x, y, -2z): confining along z and defocusing radially
+     * for a positive charge with V > 0, as in a Penning trap.
+     *
+     * @param center The trap centre.
+     * @param voltage Electrode voltage V in volts.
+     * @param size Characteristic trap size d in m.
+     */
+    void addQuadrupoleTrap(const glm::vec3& center, float voltage, float size);
+
+    /**
+     * @brief Adds fields sampled at the nodes of a regular grid.
+     *
+     * Values are interpolated trilinearly; the grid contributes nothing
+     * outside its bounds.
+     *
+     * @param origin Position of node (0, 0, 0).
+     * @param spacing Node spacing along each axis.
+     * @param nx Nodes along x (at least 2).
+     * @param ny Nodes along y (at least 2).
+     * @param nz Nodes along z (at least 2).
+     * @param electric Electric field per node, x fastest; empty for none.
+     * @param magnetic Magnetic field per node, x fastest; empty for none.
+     * @return False if the sizes do not match.
+     */
+    bool addSampledGrid(const glm::vec3& origin, const glm::vec3& spacing, int nx, int ny, int nz,
+                        std::vector<glm::vec3> electric, std::vector<glm::vec3> magnetic);
+
+    /// Removes every source
+    void clear();
+
+    bool empty() const;
+
+    /**
+     * @brief Evaluates the total field at a point.
+     *
+     * @param position The point.
+     * @param electric Receives the electric field.
+     * @param magnetic Receives the magnetic field.
+     */
+    void evaluate(const glm::vec3& position, glm::vec3& electric, glm::vec3& magnetic) const;
+
+    /**
+     * @brief Evaluates the total field at many points.
+     *
+     * @param count Number of points.
+     * @param x Point x coordinates (and y, z likewise).
+     * @param ex Receives the electric field components (and ey, ez, bx, by, bz likewise).
+     */
+    void evaluate(size_t count, const float* x, const float* y, const float* z, float* ex, float* ey, float* ez,
+                  float* bx, float* by, float* bz) const;
+
+private:
+    struct Dipole {
+        glm::vec3 position;
+        glm::vec3 moment;
+    };
+    struct Quadrupole {
+        glm::vec3 center;
+        float strength;     ///< V / d²
+    };
+    struct SampledGrid {
+        glm::vec3 origin;
+        glm::vec3 inverseSpacing;
+        int n[3];
+        std::vector<glm::vec3> electric;
+        std::vector<glm::vec3> magnetic;
+    };
+
+    glm::vec3 m_uniformElectric = glm::vec3(0.0f);
+    glm::vec3 m_uniformMagnetic = glm::vec3(0.0f);
+    std::vector<Dipole> m_electricDipoles;
+    std::vector<Dipole> m_magneticDipoles;
+    std::vector<Quadrupole> m_quadrupoles;
+    std::vector<SampledGrid> m_grids;
+};
+
+#endif // EXTERNAL_FIELD_H
@@ -0,0 +1,119 @@
+#include "FFT3D.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const double PI = 3.14159265358979323846;
+
+// Lines along y and z are copied out this many at a time (consecutive x)
+const size_t LINE_GROUP = 16;
+
+bool isPowerOfTwo(int n) {
+    return n > 0 && (n & (n - 1)) == 0;
+}
+}
+
+bool FFT3D::setSize(int nx, int ny, int nz) {
+    if (!isPowerOfTwo(nx) || !isPowerOfTwo(ny) || !isPowerOfTwo(nz)) return false;
+    const int dims[3] = {nx, ny, nz};
+    for (int a = 0; a < 3; ++a) {
+        int n = dims[a];
+        m_dims[a] = n;
+        m_twiddles[a].resize(n / 2);
+        for (int k = 0; k < n / 2; ++k) {
+            double angle = -2.0 * PI * k / n;
+            m_twiddles[a][k] = Complex(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+        }
+        int bits = 0;
+        while ((1 << bits) < n) ++bits;
+        m_bitReverse[a].resize(n);
+        for (int i = 0; i < n; ++i) {
+            uint32_t r = 0;
+            for (int b = 0; b < bits; ++b) {
+                if (i & (1 << b)) r |= 1u << (bits - 1 - b);
+            }
+            m_bitReverse[a][i] = r;
+        }
+    }
+    return true;
+}
+
+void FFT3D::forward(std::vector<Complex>& data) const {
+    transform(data, false);
+}
+
+void FFT3D::inverse(std::vector<Complex>& data) const {
+    transform(data, true);
+    const float scale = 1.0f / static_cast<float>(getPointCount());
+    TaskScheduler::getInstance().parallelFor(0, data.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) data[i] *= scale;
+    }, 65536);
+}
+
+void FFT3D::transform(std::vector<Complex>& data, bool inverse) const {
+    for (int a = 0; a < 3; ++a) {
+        if (m_dims[a] > 1) transformAxis(data, a, inverse);
+    }
+}
+
+void FFT3D::transformLine(Complex* line, size_t stride, int axis, bool inverse) const {
+    const int n = m_dims[axis];
+    const std::vector<uint32_t>& reverse = m_bitReverse[axis];
+    const std::vector<Complex>& twiddles = m_twiddles[axis];
+    for (int i = 0; i < n; ++i) {
+        int j = static_cast<int>(reverse[i]);
+        if (i < j) std::swap(line[i * stride], line[j * stride]);
+    }
+    for (int length = 2; length <= n; length <<= 1) {
+        const int half = length / 2;
+        const int step = n / length;
+        for (int start = 0; start < n; start += length) {
+            for (int k = 0; k < half; ++k) {
+                Complex w = inverse ? std::conj(twiddles[k * step]) : twiddles[k * step];
+                Complex& even = line[(start + k) * stride];
+                Complex& odd = line[(start + k + half) * stride];
+                Complex t = w * odd;
+                odd = even - t;
+                even += t;
+            }
+        }
+    }
+}
+
+void FFT3D::transformAxis(std::vector<Complex>& data, int axis, bool inverse) const {
+    const size_t nx = m_dims[0], ny = m_dims[1], nz = m_dims[2];
+    const size_t n = m_dims[axis];
+    TaskScheduler& scheduler = TaskScheduler::getInstance();
+
+    if (axis == 0) {
+        // x lines are contiguous already
+        scheduler.parallelFor(0, ny * nz, [&](size_t begin, size_t end) {
+            for (size_t line = begin; line < end; ++line) transformLine(&data[line * nx], 1, 0, inverse);
+        }, std::max<size_t>(1, 4096 / nx));
+        return;
+    }
+
+    // A line along y or z is identified by (x, other); groups of consecutive x
+    // are gathered into a [n][LINE_GROUP] buffer so the copies are contiguous
+    const size_t stride = axis == 1 ? nx : nx * ny;
+    const size_t others = axis == 1 ? nz : ny;
+    const size_t otherStride = axis == 1 ? nx * ny : nx;
+    const size_t groupsPerRow = (nx + LINE_GROUP - 1) / LINE_GROUP;
+    scheduler.parallelFor(0, others * groupsPerRow, [&](size_t begin, size_t end) {
+        std::vector<Complex> buffer(n * LINE_GROUP);
+        for (size_t g = begin; g < end; ++g) {
+            size_t other = g / groupsPerRow;
+            size_t x0 = (g % groupsPerRow) * LINE_GROUP;
+            size_t width = std::min(LINE_GROUP, nx - x0);
+            size_t base = other * otherStride + x0;
+            for (size_t i = 0; i < n; ++i) {
+                std::copy_n(&data[base + i * stride], width, &buffer[i * LINE_GROUP]);
+            }
+            for (size_t l = 0; l < width; ++l) transformLine(&buffer[l], LINE_GROUP, axis, inverse);
+            for (size_t i = 0; i < n; ++i) {
+                std::copy_n(&buffer[i * LINE_GROUP], width, &data[base + i * stride]);
+            }
+        }
+    }, 1);
+}
@@ -0,0 +1,76 @@
+#ifndef FFT3D_H
+#define FFT3D_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief In-place complex FFT on a 3D grid with power-of-two sides.
+ *
+ * The transform is done one axis at a time: radix-2 on each line, with
+ * lines spread across the TaskScheduler workers. Lines along y and z are
+ * copied out in groups of neighbouring x, so every read and write touches
+ * whole cache lines. Twiddles and bit-reversal tables are computed once by
+ * setSize().
+ *
+ * Data is x fastest: index (z * ny + y) * nx + x. forward() uses e^(-ikx);
+ * inverse() uses e^(+ikx) and divides by the point count, so the two
+ * transforms undo each other.
+ */
+class FFT3D {
+public:
+    using Complex = std::complex<float>;
+
+    FFT3D() = default;
+
+    /**
+     * @brief Prepares tables for a grid size.
+     *
+     * @param nx Points along x.
+     * @param ny Points along y.
+     * @param nz Points along z.
+     * @return False unless every side is a power of two.
+     */
+    bool setSize(int nx, int ny, int nz);
+
+    /**
+     * @brief Transforms to frequency space.
+     *
+     * @param data nx * ny * nz values, transformed in place.
+     */
+    void forward(std::vector<Complex>& data) const;
+
+    /**
+     * @brief Transforms back to real space, normalized.
+     *
+     * @param data nx * ny * nz values, transformed in place.
+     */
+    void inverse(std::vector<Complex>& data) const;
+
+    int getSize(int axis) const { return m_dims[axis]; }
+    size_t getPointCount() const { return size_t(m_dims[0]) * m_dims[1] * m_dims[2]; }
+
+    /**
+     * @brief Gets the signed frequency index of a grid index, in (-n/2, n/2].
+     *
+     * @param axis The axis.
+     * @param index Grid index along the axis.
+     * @return The wave number in cycles per box.
+     */
+    int frequency(int axis, int index) const {
+        return index <= m_dims[axis] / 2 ? index : index - m_dims[axis];
+    }
+
+private:
+    int m_dims[3] = {0, 0, 0};
+    std::vector<Complex> m_twiddles[3];      ///< e^(-2πik/n) for k < n/2
+    std::vector<uint32_t> m_bitReverse[3];
+
+    void transform(std::vector<Complex>& data, bool inverse) const;
+    void transformAxis(std::vector<Complex>& data, int axis, bool inverse) const;
+    void transformLine(Complex* line, size_t stride, int axis, bool inverse) const;
+};
+
+#endif // FFT3D_H
@@ -0,0 +1,94 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <thread>
+
+namespace {
+float toSeconds(FramePacer::Clock::duration d) {
+    return std::chrono::duration<float>(d).count();
+}
+
+FramePacer::Clock::duration fromSeconds(float seconds) {
+    return std::chrono::duration_cast<FramePacer::Clock::duration>(std::chrono::duration<float>(seconds));
+}
+
+// Exponential moving average weight for the displayed timings
+const float SMOOTHING = 0.1f;
+}
+
+FramePacer::FramePacer()
+    : m_frameStart(Clock::now()),
+      m_deadline(m_frameStart),
+      m_presentStart(m_frameStart) {}
+
+void FramePacer::configure(bool vsync, int maxFps, int refreshRate) {
+    m_vsync = vsync;
+    m_pacedBySwap = vsync && refreshRate > 0 && (maxFps <= 0 || maxFps >= refreshRate);
+
+    if (m_pacedBySwap) {
+        m_targetFrameTime = 1.0f / static_cast<float>(refreshRate);
+    } else {
+        m_targetFrameTime = maxFps > 0 ? 1.0f / static_cast<float>(maxFps) : 0.0f;
+    }
+    m_started = false;
+}
+
+float FramePacer::beginFrame() {
+    Clock::time_point now = Clock::now();
+    float deltaTime = m_started ? toSeconds(now - m_frameStart) : 0.0f;
+    m_frameStart = now;
+
+    if (m_targetFrameTime > 0.0f) {
+        // Deadlines advance on a fixed grid so small wake-up jitter does not
+        // accumulate; after a long stall, restart the grid instead of
+        // rushing through catch-up frames
+        Clock::duration target = fromSeconds(m_targetFrameTime);
+        m_deadline = m_started ? m_deadline + target : now + target;
+        if (m_deadline < now) {
+            m_deadline = now + target;
+        }
+    }
+
+    if (m_started) {
+        m_frameTime += (deltaTime - m_frameTime) * SMOOTHING;
+    }
+    m_started = true;
+    return deltaTime;
+}
+
+void FramePacer::beginPresent() {
+    m_presentStart = Clock::now();
+}
+
+void FramePacer::endPresent() {
+    float latency = toSeconds(Clock::now() - m_presentStart);
+    m_presentLatency += (latency - m_presentLatency) * SMOOTHING;
+}
+
+void FramePacer::waitForNextFrame() {
+    if (m_targetFrameTime <= 0.0f || m_pacedBySwap) return;
+
+    Clock::time_point now = Clock::now();
+    float remaining = toSeconds(m_deadline - now);
+    if (remaining <= 0.0f) return;
+
+    // Sleep releases the core to the task workers; only the final margin,
+    // where the OS timer cannot be trusted, is spent spinning
+    if (remaining > m_spinMargin) {
+        float sleepTime = remaining - m_spinMargin;
+        std::this_thread::sleep_for(fromSeconds(sleepTime));
+
+        float overshoot = toSeconds(Clock::now() - now) - sleepTime;
+        float wanted = std::clamp(overshoot * 1.5f, 0.0005f, 0.004f);
+        // Grow the margin immediately after a late wake-up, shrink it slowly
+        m_spinMargin = wanted > m_spinMargin ? wanted : m_spinMargin * 0.95f + wanted * 0.05f;
+    }
+
+    while (Clock::now() < m_deadline) {
+        std::this_thread::yield();
+    }
+}
+
+float FramePacer::getRemainingBudget() const {
+    if (m_targetFrameTime <= 0.0f) return 0.0f;
+    return std::max(0.0f, toSeconds(m_deadline - Clock::now()));
+}
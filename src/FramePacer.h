@@ -0,0 +1,109 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <chrono>
+
+/**
+ * @brief Holds the frame loop to a target frame time without burning a core.
+ *
+ * The pacer sleeps for most of the remaining frame and spins only for the
+ * last stretch, sized from the measured oversleep of the OS timer. It also
+ * measures how long presentation (buffer swap) blocks, and exposes the frame
+ * budget so other systems can size their per-frame work to what is left.
+ */
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Constructs a new FramePacer with no frame cap.
+     */
+    FramePacer();
+
+    /**
+     * @brief Sets the pacing targets.
+     *
+     * When vsync is on and the cap is at or above the display refresh rate,
+     * the blocking swap already paces the loop and the pacer does not wait.
+     *
+     * @param vsync Whether buffer swaps are synchronized to the display.
+     * @param maxFps Frame rate cap; 0 or negative disables the cap.
+     * @param refreshRate Display refresh rate in Hz, or 0 if unknown.
+     */
+    void configure(bool vsync, int maxFps, int refreshRate = 0);
+
+    /**
+     * @brief Marks the start of a frame.
+     *
+     * @return Seconds elapsed since the previous frame started.
+     */
+    float beginFrame();
+
+    /**
+     * @brief Marks the start of buffer presentation.
+     */
+    void beginPresent();
+
+    /**
+     * @brief Marks the end of buffer presentation.
+     */
+    void endPresent();
+
+    /**
+     * @brief Waits until the next frame is due, sleeping first and spinning last.
+     */
+    void waitForNextFrame();
+
+    /**
+     * @brief Gets the target frame time.
+     *
+     * @return Seconds per frame, or 0 when neither a cap nor vsync applies.
+     */
+    float getFrameBudget() const { return m_targetFrameTime; }
+
+    /**
+     * @brief Gets the time left until the current frame's deadline.
+     *
+     * @return Seconds remaining (0 when past the deadline or uncapped).
+     */
+    float getRemainingBudget() const;
+
+    /**
+     * @brief Gets the smoothed time spent blocked in buffer presentation.
+     *
+     * @return Present latency in seconds.
+     */
+    float getPresentLatency() const { return m_presentLatency; }
+
+    /**
+     * @brief Gets the smoothed frame time.
+     *
+     * @return Seconds per frame.
+     */
+    float getFrameTime() const { return m_frameTime; }
+
+    /**
+     * @brief Checks whether buffer swaps are synchronized to the display.
+     *
+     * @return True when vsync is on.
+     */
+    bool isVsyncEnabled() const { return m_vsync; }
+
+private:
+    bool m_vsync = false;
+    bool m_pacedBySwap = false;
+    float m_targetFrameTime = 0.0f;
+
+    Clock::time_point m_frameStart;
+    Clock::time_point m_deadline;
+    Clock::time_point m_presentStart;
+    bool m_started = false;
+
+    float m_frameTime = 0.0f;
+    float m_presentLatency = 0.0f;
+
+    // Safety margin left for spinning, tracked from observed sleep overshoot
+    float m_spinMargin = 0.002f;
+};
+
+#endif // FRAME_PACER_H
@@ -0,0 +1,152 @@
+#include "GpuProfiler.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+// Exponential moving average weight for the displayed timings
+const float SMOOTHING = 0.1f;
+
+double toMicroseconds(std::chrono::steady_clock::duration d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+}
+
+bool GpuProfiler::initialize() {
+    m_available = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    if (!m_available) {
+        LOG_WARNING("GL timer queries unavailable, GPU pass timings disabled");
+        return false;
+    }
+    for (Slot& slot : m_slots) {
+        glGenQueries(MAX_PASSES, slot.queries);
+        slot.count = 0;
+    }
+    m_current = -1;
+    m_origin = Clock::now();
+    return true;
+}
+
+void GpuProfiler::shutdown() {
+    if (!m_available) return;
+    if (m_passOpen) endPass();
+    for (Slot& slot : m_slots) {
+        glDeleteQueries(MAX_PASSES, slot.queries);
+        std::fill(std::begin(slot.queries), std::end(slot.queries), 0u);
+        slot.count = 0;
+    }
+    m_available = false;
+}
+
+void GpuProfiler::beginFrame() {
+    if (!m_available) return;
+    if (m_passOpen) endPass();
+
+    Clock::time_point now = Clock::now();
+    if (m_current >= 0) {
+        const Slot& previous = m_slots[m_current];
+        m_trace.push_back({previous.frame, -1, toMicroseconds(previous.start - m_origin),
+                           toMicroseconds(now - previous.start)});
+    }
+
+    // The slot about to be reused was issued LATENCY frames ago
+    m_current = (m_current + 1) % LATENCY;
+    Slot& slot = m_slots[m_current];
+    if (slot.count > 0) collect(slot);
+    slot.count = 0;
+    slot.frame = m_frame++;
+    slot.start = now;
+
+    while (!m_trace.empty() && m_trace.front().frame + HISTORY < slot.frame) {
+        m_trace.pop_front();
+    }
+}
+
+bool GpuProfiler::beginPass(const char* name) {
+    if (!m_available || m_passOpen || m_current < 0) return false;
+    Slot& slot = m_slots[m_current];
+    if (slot.count >= MAX_PASSES) return false;
+
+    slot.passes[slot.count] = findPass(name);
+    glBeginQuery(GL_TIME_ELAPSED, slot.queries[slot.count]);
+    ++slot.count;
+    m_passOpen = true;
+    return true;
+}
+
+void GpuProfiler::endPass() {
+    if (!m_passOpen) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    m_passOpen = false;
+}
+
+void GpuProfiler::reset() {
+    for (PassStats& stats : m_stats) {
+        stats.lastMs = stats.averageMs = stats.maxMs = 0.0f;
+    }
+    m_frameMs = 0.0f;
+    m_droppedFrames = 0;
+    m_trace.clear();
+}
+
+int GpuProfiler::findPass(const char* name) {
+    for (size_t i = 0; i < m_stats.size(); ++i) {
+        if (std::strcmp(m_stats[i].name.c_str(), name) == 0) return static_cast<int>(i);
+    }
+    PassStats stats;
+    stats.name = name;
+    m_stats.push_back(stats);
+    return static_cast<int>(m_stats.size() - 1);
+}
+
+void GpuProfiler::collect(Slot& slot) {
+    // Queries finish in issue order, so the last one being ready means all are
+    GLint available = 0;
+    glGetQueryObjectiv(slot.queries[slot.count - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        ++m_droppedFrames;
+        return;
+    }
+
+    double offsetUs = toMicroseconds(slot.start - m_origin);
+    float frameMs = 0.0f;
+    for (int k = 0; k < slot.count; ++k) {
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(slot.queries[k], GL_QUERY_RESULT, &elapsedNs);
+        float ms = static_cast<float>(elapsedNs * 1e-6);
+        PassStats& stats = m_stats[slot.passes[k]];
+        stats.lastMs = ms;
+        stats.averageMs = stats.averageMs > 0.0f ? stats.averageMs + (ms - stats.averageMs) * SMOOTHING : ms;
+        stats.maxMs = std::max(stats.maxMs, ms);
+        frameMs += ms;
+
+        m_trace.push_back({slot.frame, slot.passes[k], offsetUs, elapsedNs * 1e-3});
+        offsetUs += elapsedNs * 1e-3;
+    }
+    m_frameMs = m_frameMs > 0.0f ? m_frameMs + (frameMs - m_frameMs) * SMOOTHING : frameMs;
+}
+
+bool GpuProfiler::exportTrace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        LOG_ERROR("Failed to write GPU trace to " + path);
+        return false;
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"traceEvents\":[\n";
+    out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU frames\"}},\n";
+    out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU passes\"}}";
+    for (const TraceEvent& event : m_trace) {
+        const char* name = event.pass < 0 ? "frame" : m_stats[event.pass].name.c_str();
+        out << ",\n{\"name\":\"" << name << "\",\"cat\":\"" << (event.pass < 0 ? "cpu" : "gpu")
+            << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << (event.pass < 0 ? 1 : 2)
+            << ",\"ts\":" << event.startUs << ",\"dur\":" << event.durationUs
+            << ",\"args\":{\"frame\":" << event.frame << "}}";
+    }
+    out << "\n]}\n";
+    LOG_INFO("GPU trace written to " + path);
+    return static_cast<bool>(out);
+}
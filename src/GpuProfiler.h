@@ -0,0 +1,156 @@
+#ifndef GPU_PROFILER_H
+#define GPU_PROFILER_H
+
+#ifndef GLEW_STATIC
+#define GLEW_STATIC
+#endif
+
+#include <GL/glew.h>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Measures how long each render pass takes on the GPU.
+ *
+ * Passes are bracketed with GL_TIME_ELAPSED queries. Queries are kept in a
+ * ring of LATENCY frames and read back LATENCY frames after they were issued,
+ * only if the driver reports them available, so reading results never stalls
+ * the pipeline; a frame whose results are still pending is dropped instead.
+ * Elapsed-time queries cannot nest, so a pass begun while another is open is
+ * ignored. The last HISTORY frames are kept for trace export.
+ */
+class GpuProfiler {
+public:
+    static constexpr int LATENCY = 4;
+    static constexpr int MAX_PASSES = 16;
+    static constexpr size_t HISTORY = 600;
+
+    /**
+     * @brief Smoothed timings of one named pass.
+     */
+    struct PassStats {
+        std::string name;
+        float lastMs = 0.0f;
+        float averageMs = 0.0f;
+        float maxMs = 0.0f;
+    };
+
+    /**
+     * @brief Brackets a pass for the lifetime of the object.
+     */
+    class Scope {
+    public:
+        Scope(GpuProfiler* profiler, const char* name)
+            : m_profiler(profiler && profiler->beginPass(name) ? profiler : nullptr) {}
+        ~Scope() { if (m_profiler) m_profiler->endPass(); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        GpuProfiler* m_profiler;
+    };
+
+    GpuProfiler() = default;
+    ~GpuProfiler() = default;
+
+    /**
+     * @brief Creates the query objects; needs a current GL context.
+     *
+     * @return False if timer queries are not supported, in which case every
+     *         other call is a no-op.
+     */
+    bool initialize();
+
+    /**
+     * @brief Deletes the query objects; call before the GL context goes away.
+     */
+    void shutdown();
+
+    /**
+     * @brief Starts a frame: collects the results of the frame LATENCY frames ago.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Opens a timed pass.
+     *
+     * @param name Pass name; the same name accumulates into the same statistics.
+     * @return True if the pass is being timed and endPass() must follow.
+     */
+    bool beginPass(const char* name);
+
+    /**
+     * @brief Closes the pass opened by beginPass().
+     */
+    void endPass();
+
+    bool isAvailable() const { return m_available; }
+    const std::vector<PassStats>& getStats() const { return m_stats; }
+
+    /**
+     * @brief Gets the smoothed sum of all passes in a frame.
+     *
+     * @return GPU milliseconds per frame.
+     */
+    float getFrameTime() const { return m_frameMs; }
+
+    /**
+     * @brief Gets the number of frames whose results were not ready in time.
+     *
+     * @return Dropped frame count since the last reset.
+     */
+    uint64_t getDroppedFrames() const { return m_droppedFrames; }
+
+    /**
+     * @brief Clears the statistics and the trace history.
+     */
+    void reset();
+
+    /**
+     * @brief Writes the recorded frames in Chrome trace event format.
+     *
+     * Elapsed-time queries give durations only, so passes are laid out back to
+     * back from the CPU start of their frame, next to a track of CPU frames.
+     *
+     * @param path The output JSON file.
+     * @return True on success.
+     */
+    bool exportTrace(const std::string& path) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Slot {
+        GLuint queries[MAX_PASSES] = {};
+        int passes[MAX_PASSES] = {};
+        int count = 0;
+        uint64_t frame = 0;
+        Clock::time_point start;
+    };
+
+    struct TraceEvent {
+        uint64_t frame;
+        int pass;             ///< -1 for the CPU frame itself
+        double startUs;
+        double durationUs;
+    };
+
+    bool m_available = false;
+    Slot m_slots[LATENCY];
+    int m_current = -1;
+    bool m_passOpen = false;
+    uint64_t m_frame = 0;
+    uint64_t m_droppedFrames = 0;
+    Clock::time_point m_origin = Clock::now();
+    std::vector<PassStats> m_stats;
+    float m_frameMs = 0.0f;
+    std::deque<TraceEvent> m_trace;
+
+    int findPass(const char* name);
+    void collect(Slot& slot);
+};
+
+#endif // GPU_PROFILER_H
@@ -1,7 +1,12 @@
 #include "ImGuiManager.h"
+#include "ConfigManager.h"
 #include <imgui.h>
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_opengl3.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
 #include <glm/gtc/type_ptr.hpp>  // for glm::value_ptr if needed
 
@@ -32,6 +37,27 @@ bool ImGuiManager::initialize() {
         std::cerr << "ImGui_ImplOpenGL3_Init failed\n";
         return false;
     }
+    auto& config = ConfigManager::getInstance();
+    m_gridSpacing = config.getFloat("esp_grid_spacing", 0.25f);
+    m_electrostatics.setResolution(m_gridSpacing, config.getFloat("esp_grid_padding", 3.0f),
+                                   config.getFloat("esp_density_width", 0.5f));
+    m_electrostatics.setUpdatePolicy(config.getFloat("esp_update_tolerance", 0.05f),
+                                     config.getFloat("esp_update_radius", 4.0f),
+                                     config.getInt("esp_full_refresh_interval", 30));
+    m_isosurfaces.resize(4);
+    m_isosurfaces[0].color = glm::vec3(0.9f, 0.2f, 0.15f);
+    m_isosurfaces[1].color = glm::vec3(0.15f, 0.3f, 0.9f);
+    m_isosurfaces[2].color = glm::vec3(0.85f, 0.85f, 0.8f);
+    m_isosurfaces[3].color = glm::vec3(0.3f, 0.85f, 0.55f);
+    m_isosurfaces[0].alpha = m_isosurfaces[1].alpha = 0.5f;
+    m_isosurfaces[2].alpha = 0.3f;
+    m_isosurfaces[3].alpha = 0.4f;
+    m_quantumGridSize = config.getInt("tdse_grid_size", m_quantumGridSize);
+    m_quantumBoxSize = config.getFloat("tdse_box_size", m_quantumBoxSize);
+    m_quantumTimeStep = config.getFloat("tdse_time_step", m_quantumTimeStep);
+    m_quantumStepsPerFrame = config.getInt("tdse_steps_per_frame", m_quantumStepsPerFrame);
+    m_traceFile = config.getString("gpu_trace_file", m_traceFile);
+
     std::cout << "ImGui initialized successfully\n";
     return true;
 }
@@ -48,6 +74,14 @@ void ImGuiManager::render(PhysicsEngine& physicsEngine) {
     renderNuclearControls(physicsEngine);
     renderOrbitalControls(physicsEngine);
     renderSimulationInfo(physicsEngine);
+    renderPlaybackControls();
+    renderSelectionPanel(physicsEngine);
+    renderSurfacePanel(physicsEngine);
+    renderElectrostaticsPanel(physicsEngine);
+    renderQuantumPanel(physicsEngine);
+    renderKineticsPanel(physicsEngine);
+    renderProfilerPanel();
+    m_atomInspector.render(physicsEngine);
 }
 
 void ImGuiManager::endFrame() {
@@ -59,17 +93,36 @@ void ImGuiManager::endFrame() {
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    {
+        GpuProfiler::Scope pass(m_gpuProfiler, "imgui");
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    }
 
     // Restore depth-test for subsequent 3D
     glDisable(GL_BLEND);
     glEnable(GL_DEPTH_TEST);
 }
 
+void ImGuiManager::renderLoadingProgress(float progress, const std::string& status) {
+    ImGuiIO& io = ImGui::GetIO();
+    ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.5f),
+                            ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+    ImGui::SetNextWindowSize(ImVec2(360, 0));
+    ImGui::Begin("Loading", nullptr,
+                 ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoCollapse);
+    ImGui::TextUnformatted(status.c_str());
+    ImGui::ProgressBar(progress, ImVec2(-1.0f, 0.0f));
+    ImGui::End();
+}
+
 bool ImGuiManager::isMouseOverUI() const {
     return ImGui::GetIO().WantCaptureMouse;
 }
 
+bool ImGuiManager::isKeyboardCapturedByUI() const {
+    return ImGui::GetIO().WantCaptureKeyboard;
+}
+
 // — UI panels below —
 
 void ImGuiManager::renderAtomPalette(PhysicsEngine& physicsEngine) {
@@ -184,6 +237,8 @@ void ImGuiManager::renderOrbitalControls(PhysicsEngine& physicsEngine) {
                 elecs[0], atoms[0], m_targetOrbital
             );
             std::cout<<"ΔE: "<<dE<<" eV\n";
+            // An emitting jump sends its photon to the other atoms
+            if (dE < 0.0f) physicsEngine.emitPhoton(atoms[0]->getPosition(), -dE, atoms[0]);
         }
     }
     ImGui::End();
@@ -195,11 +250,433 @@ void ImGuiManager::renderSimulationInfo(PhysicsEngine& physicsEngine) {
     auto& M = physicsEngine.getMolecules();
     ImGui::Text("Atoms: %zu", A.size());
     ImGui::Text("Molecules: %zu", M.size());
+    const PhotonTransportStats& photons = physicsEngine.getPhotonTotals();
+    ImGui::Text("Photons absorbed: %zu, escaped: %zu", photons.absorbed, photons.escaped);
+    ImGui::Text("Excited electrons: %zu", physicsEngine.getExcitedElectronCount());
+    if (m_framePacer) {
+        ImGui::Separator();
+        float frameTime = m_framePacer->getFrameTime();
+        ImGui::Text("Frame: %.2f ms (%.0f FPS)", frameTime * 1000.0f,
+                    frameTime > 0.0f ? 1.0f / frameTime : 0.0f);
+        ImGui::Text("Budget: %.2f ms%s", m_framePacer->getFrameBudget() * 1000.0f,
+                    m_framePacer->isVsyncEnabled() ? " (vsync)" : "");
+        ImGui::Text("Present latency: %.2f ms", m_framePacer->getPresentLatency() * 1000.0f);
+    }
     ImGui::Separator();
     ImGui::Text("Use mouse & scroll to navigate");
     ImGui::End();
 }
 
+void ImGuiManager::renderLiveView(const std::string& name, bool attached, const SnapshotView* view,
+                                  uint64_t tornSnapshots) {
+    ImGui::Begin("Live View");
+    ImGui::Text("Segment: %s", name.c_str());
+    if (!m_liveViewEnabled) {
+        ImGui::TextUnformatted("Detached");
+    } else if (!attached) {
+        ImGui::TextUnformatted("Waiting for the simulation...");
+    } else if (!view) {
+        ImGui::TextUnformatted("Attached, no snapshot yet");
+    } else {
+        ImGui::Text("Snapshot %llu, step %llu", static_cast<unsigned long long>(view->frame),
+                    static_cast<unsigned long long>(view->step));
+        ImGui::Text("Time: %.4f", view->time);
+        ImGui::Text("Atoms: %zu  Bonds: %zu", view->atomCount, view->bondCount);
+        ImGui::Text("Kinetic energy: %.6g", view->kineticEnergy);
+        ImGui::Text("Torn reads redrawn: %llu", static_cast<unsigned long long>(tornSnapshots));
+    }
+    if (ImGui::Button(m_liveViewEnabled ? "Detach" : "Attach")) {
+        m_liveViewEnabled = !m_liveViewEnabled;
+    }
+    ImGui::End();
+    renderProfilerPanel();
+}
+
+void ImGuiManager::renderPlaybackControls() {
+    if (!m_playback) return;
+
+    ImGui::Begin("Playback");
+    if (ImGui::Button(m_playback->isPaused() ? "Resume" : "Pause")) {
+        m_playback->togglePause();
+    }
+    ImGui::SameLine();
+    ImGui::TextUnformatted(m_playback->isPaused() ? "Paused (Space)" : "Running (Space)");
+
+    ImGui::BeginDisabled(!m_playback->isPaused());
+    if (ImGui::Button("Step")) {
+        m_playback->requestStep();
+    }
+    ImGui::EndDisabled();
+
+    bool fastForward = m_playback->isFastForward();
+    if (ImGui::Checkbox("Fast-forward", &fastForward)) {
+        m_playback->setFastForward(fastForward);
+    }
+    float fraction = m_playback->getPhysicsBudgetFraction();
+    if (ImGui::SliderFloat("Physics budget", &fraction, 0.05f, 0.95f, "%.2f of frame")) {
+        m_playback->setPhysicsBudgetFraction(fraction);
+    }
+    ImGui::Text("Speed: %.3gx real time", m_playback->getSimulationRate());
+    ImGui::Text("Steps last frame: %d", m_playback->getStepsLastFrame());
+
+    bool idle = m_playback->isIdleRenderingEnabled();
+    if (ImGui::Checkbox("Redraw only on change when paused", &idle)) {
+        m_playback->setIdleRenderingEnabled(idle);
+    }
+    ImGui::End();
+}
+
+void ImGuiManager::renderSelectionPanel(PhysicsEngine& physicsEngine) {
+    ImGui::Begin("Selection");
+    bool apply = ImGui::InputText("Query", m_queryText, sizeof(m_queryText),
+                                  ImGuiInputTextFlags_EnterReturnsTrue);
+    ImGui::SameLine();
+    apply |= ImGui::Button("Apply");
+    ImGui::TextDisabled("e.g. element O H and sphere 0 0 0 5");
+
+    if (ImGui::Checkbox("Highlight", &m_highlightSelection) && m_playback) {
+        m_playback->markDirty();
+    }
+    ImGui::SameLine();
+    if (ImGui::Checkbox("Filter inspector", &m_filterInspector)) {
+        m_atomInspector.setFilter(m_filterInspector ? m_selection.toIndices() : std::vector<uint32_t>());
+    }
+
+    if (apply) {
+        applySelection(physicsEngine);
+    }
+
+    if (!m_selectionQuery.getError().empty()) {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", m_selectionQuery.getError().c_str());
+    } else if (m_selectionQuery.isValid()) {
+        ImGui::Text("Selected: %zu of %zu atoms (%.2f ms)", m_selection.count(), m_selection.size(), m_selectionTimeMs);
+    }
+    ImGui::End();
+}
+
+void ImGuiManager::applySelection(PhysicsEngine& physicsEngine) {
+    if (!m_selectionQuery.compile(m_queryText)) {
+        m_selection = Selection();
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    m_atomArrays.gather(physicsEngine);
+    m_selection = m_selectionQuery.evaluate(m_atomArrays);
+    m_selectionTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (m_filterInspector) {
+        m_atomInspector.setFilter(m_selection.toIndices());
+    }
+    if (m_playback) {
+        m_playback->markDirty();
+    }
+}
+
+void ImGuiManager::renderSurfacePanel(PhysicsEngine& physicsEngine) {
+    ImGui::Begin("Surface Area");
+    if (ImGui::SliderFloat("Probe radius", &m_probeRadius, 0.0f, 3.0f, "%.2f")) {
+        m_surfaceArea = SurfaceArea(static_cast<int>(m_surfaceArea.getPointsPerAtom()), m_probeRadius);
+    }
+    bool compute = ImGui::Button("Compute");
+    ImGui::SameLine();
+    ImGui::Checkbox("Every frame", &m_liveSurface);
+    if (ImGui::Checkbox("Color by exposure", &m_colorBySurface) && m_playback) {
+        m_playback->markDirty();
+    }
+
+    if (compute || m_liveSurface || (m_colorBySurface && m_surfaceExposure.empty())) {
+        computeSurfaceArea(physicsEngine);
+    }
+    if (!m_surfaceAreas.empty()) {
+        ImGui::Text("SASA: %.1f A^2 over %zu atoms (%.2f ms)", m_totalSurfaceArea, m_surfaceAreas.size(), m_surfaceTimeMs);
+    }
+    ImGui::End();
+}
+
+void ImGuiManager::computeSurfaceArea(PhysicsEngine& physicsEngine) {
+    auto start = std::chrono::steady_clock::now();
+    m_atomArrays.gather(physicsEngine);
+    m_totalSurfaceArea = m_surfaceArea.compute(m_atomArrays.x.data(), m_atomArrays.y.data(), m_atomArrays.z.data(),
+                                               m_atomArrays.atomicNumber.data(), m_atomArrays.size(),
+                                               m_surfaceAreas, &m_surfaceExposure);
+    m_surfaceTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (m_colorBySurface && m_playback) {
+        m_playback->markDirty();
+    }
+}
+
+void ImGuiManager::renderProfilerPanel() {
+    if (!m_gpuProfiler) return;
+
+    ImGui::Begin("GPU Profiler");
+    if (!m_gpuProfiler->isAvailable()) {
+        ImGui::TextUnformatted("Timer queries not supported");
+        ImGui::End();
+        return;
+    }
+    ImGui::Text("GPU frame: %.3f ms", m_gpuProfiler->getFrameTime());
+    if (m_framePacer) {
+        ImGui::SameLine();
+        ImGui::Text("(CPU frame %.2f ms)", m_framePacer->getFrameTime() * 1000.0f);
+    }
+    ImGui::Text("Results %d frames behind, %llu dropped", GpuProfiler::LATENCY,
+                static_cast<unsigned long long>(m_gpuProfiler->getDroppedFrames()));
+    ImGui::Separator();
+    ImGui::Columns(4, "passes");
+    ImGui::TextUnformatted("Pass");  ImGui::NextColumn();
+    ImGui::TextUnformatted("Last");  ImGui::NextColumn();
+    ImGui::TextUnformatted("Avg");   ImGui::NextColumn();
+    ImGui::TextUnformatted("Max");   ImGui::NextColumn();
+    for (const auto& stats : m_gpuProfiler->getStats()) {
+        ImGui::TextUnformatted(stats.name.c_str());   ImGui::NextColumn();
+        ImGui::Text("%.3f", stats.lastMs);            ImGui::NextColumn();
+        ImGui::Text("%.3f", stats.averageMs);         ImGui::NextColumn();
+        ImGui::Text("%.3f", stats.maxMs);             ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+    ImGui::Separator();
+    if (ImGui::Button("Reset")) m_gpuProfiler->reset();
+    ImGui::SameLine();
+    if (ImGui::Button("Export trace")) m_gpuProfiler->exportTrace(m_traceFile);
+    ImGui::SameLine();
+    ImGui::TextUnformatted(m_traceFile.c_str());
+    ImGui::End();
+}
+
+void ImGuiManager::renderElectrostaticsPanel(PhysicsEngine& physicsEngine) {
+    ImGui::Begin("Electrostatics");
+    bool extract = ImGui::Checkbox("Potential surfaces", &m_showPotentialSurfaces);
+    ImGui::SameLine();
+    extract |= ImGui::Checkbox("Density surface", &m_showDensitySurface);
+    extract |= ImGui::SliderFloat("Potential level (e/length)", &m_potentialIsovalue, 0.01f, 5.0f, "%.3f",
+                                  ImGuiSliderFlags_Logarithmic);
+    extract |= ImGui::SliderFloat("Density level", &m_densityIsovalue, 0.001f, 1.0f, "%.3f",
+                                  ImGuiSliderFlags_Logarithmic);
+    if (ImGui::SliderFloat("Grid spacing", &m_gridSpacing, 0.05f, 2.0f, "%.2f")) {
+        auto& config = ConfigManager::getInstance();
+        m_electrostatics.setResolution(m_gridSpacing, config.getFloat("esp_grid_padding", 3.0f),
+                                       config.getFloat("esp_density_width", 0.5f));
+    }
+    ImGui::Checkbox("Follow simulation", &m_liveElectrostatics);
+
+    bool visible = m_showPotentialSurfaces || m_showDensitySurface;
+    if (visible && (m_liveElectrostatics || extract || m_electrostatics.getVersion() == 0)) {
+        updateElectrostatics(physicsEngine, extract);
+    }
+    if (m_electrostatics.getVersion() > 0) {
+        const VolumeGrid& grid = m_electrostatics.getPotential();
+        ImGui::Text("Grid %dx%dx%d, %zu/%zu blocks updated (%.1f ms)", grid.dims[0], grid.dims[1], grid.dims[2],
+                    m_electrostatics.getBlocksUpdated(), m_electrostatics.getBlockCount(), m_electrostaticsTimeMs);
+    }
+    ImGui::End();
+}
+
+void ImGuiManager::updateElectrostatics(PhysicsEngine& physicsEngine, bool extractAll) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Point charges in elementary charges: nuclei carry +Z, electrons -1
+    std::vector<glm::vec3> positions;
+    std::vector<float> charges, electrons;
+    for (const auto& atom : physicsEngine.getAtoms()) {
+        positions.push_back(atom->getNucleus()->getPosition());
+        charges.push_back(static_cast<float>(atom->getNucleus()->getAtomicNumber()));
+        electrons.push_back(0.0f);
+        for (const auto& electron : atom->getElectrons()) {
+            positions.push_back(electron->getPosition());
+            charges.push_back(-1.0f);
+            electrons.push_back(1.0f);
+        }
+    }
+
+    bool changed = m_electrostatics.update(positions, charges, electrons);
+    if (changed || extractAll) {
+        if (m_showPotentialSurfaces) {
+            Isosurface::extract(m_electrostatics.getPotential(), m_potentialIsovalue, m_isosurfaces[0]);
+            Isosurface::extract(m_electrostatics.getPotential(), -m_potentialIsovalue, m_isosurfaces[1], true);
+        }
+        if (m_showDensitySurface) {
+            Isosurface::extract(m_electrostatics.getDensity(), m_densityIsovalue, m_isosurfaces[2]);
+        }
+        // Hidden surfaces draw nothing
+        for (size_t k = 0; k < 3; ++k) {
+            bool shown = k < 2 ? m_showPotentialSurfaces : m_showDensitySurface;
+            if (!shown && !m_isosurfaces[k].vertices.empty()) {
+                m_isosurfaces[k].vertices.clear();
+                ++m_isosurfaces[k].version;
+            }
+        }
+        if (m_playback) {
+            m_playback->markDirty();
+        }
+    }
+    m_electrostaticsTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void ImGuiManager::resetQuantum(PhysicsEngine& physicsEngine) {
+    const auto& atoms = physicsEngine.getAtoms();
+    int atomicNumber = atoms.empty() ? 1 : atoms[0]->getAtomicNumber();
+    if (atomicNumber != m_quantum.getAtomicNumber()) m_quantum.setNucleus(atomicNumber);
+    if (!m_quantum.configure(m_quantumGridSize, m_quantumBoxSize, m_quantumTimeStep)) {
+        std::cerr << "Quantum dynamics: grid size must be a power of two\n";
+        return;
+    }
+    m_quantum.setInitialState(m_quantumState[0], m_quantumState[1], m_quantumState[2]);
+    m_quantum.setLaser(m_laserPulse);
+    m_quantumLevels.clear();
+}
+
+void ImGuiManager::renderKineticsPanel(PhysicsEngine& physicsEngine) {
+    ImGui::Begin("Reaction Kinetics");
+    ReactionNetwork& network = physicsEngine.getReactionNetwork();
+    ImGui::SliderFloat("H2 (mol/L)", &m_initialHydrogen, 1e-6f, 1.0f, "%.2e", ImGuiSliderFlags_Logarithmic);
+    ImGui::SliderFloat("O2 (mol/L)", &m_initialOxygen, 1e-6f, 1.0f, "%.2e", ImGuiSliderFlags_Logarithmic);
+    if (ImGui::Button("Load H2/O2 mechanism")) {
+        physicsEngine.loadHydrogenOxygenKinetics(m_initialHydrogen, m_initialOxygen);
+    }
+    if (network.getSpeciesCount() == 0) {
+        ImGui::TextUnformatted("No mechanism loaded");
+        ImGui::End();
+        return;
+    }
+    ImGui::SameLine();
+    bool run = physicsEngine.isKineticsEnabled();
+    if (ImGui::Checkbox("Run", &run)) physicsEngine.setKineticsEnabled(run);
+    m_kineticsTemperature = static_cast<float>(network.getTemperature());
+    if (ImGui::SliderFloat("Temperature (K)", &m_kineticsTemperature, 300.0f, 5000.0f, "%.0f")) {
+        network.setTemperature(m_kineticsTemperature);
+    }
+    if (ImGui::Button("Advance 1 s")) {
+        auto start = std::chrono::steady_clock::now();
+        network.integrate(1.0);
+        m_kineticsTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    ImGui::SameLine();
+    ImGui::Text("%.2f ms", m_kineticsTimeMs);
+
+    ImGui::Text("%zu species, %zu reactions; %zu steps (%zu rejected), h = %.2e s", network.getSpeciesCount(),
+                network.getReactionCount(), network.getAcceptedSteps(), network.getRejectedSteps(),
+                network.getStepSize());
+    ImGui::Text("Jacobian %zu non-zeros, LU %zu", network.getJacobianNonZeros(), network.getFactorNonZeros());
+
+    // Concentrations on a log scale from 1e-12 mol/L up to the largest one
+    const std::vector<double>& concentrations = network.getConcentrations();
+    double peak = *std::max_element(concentrations.begin(), concentrations.end());
+    double decades = peak > 0.0 ? std::max(1.0, std::log10(peak) + 12.0) : 1.0;
+    for (uint32_t s = 0; s < network.getSpeciesCount() && s < 64; ++s) {
+        double c = concentrations[s];
+        float level = c > 0.0 ? static_cast<float>(std::clamp((std::log10(c) + 12.0) / decades, 0.0, 1.0)) : 0.0f;
+        char label[48];
+        std::snprintf(label, sizeof(label), "%.3e", c);
+        ImGui::ProgressBar(level, ImVec2(160.0f, 0.0f), label);
+        ImGui::SameLine();
+        ImGui::TextUnformatted(network.getSpeciesName(s).c_str());
+    }
+    ImGui::End();
+}
+
+void ImGuiManager::renderQuantumPanel(PhysicsEngine& physicsEngine) {
+    ImGui::Begin("Quantum Dynamics");
+    const auto& atoms = physicsEngine.getAtoms();
+    ImGui::Text("One electron around %s (Z = %d)", atoms.empty() ? "H" : getElementName(atoms[0]->getAtomicNumber()).c_str(),
+                atoms.empty() ? 1 : atoms[0]->getAtomicNumber());
+
+    const char* gridSizes[] = {"32", "64", "128"};
+    int gridIndex = m_quantumGridSize >= 128 ? 2 : m_quantumGridSize >= 64 ? 1 : 0;
+    bool reset = ImGui::Combo("Grid", &gridIndex, gridSizes, IM_ARRAYSIZE(gridSizes));
+    m_quantumGridSize = 32 << gridIndex;
+    reset |= ImGui::SliderFloat("Box (Bohr)", &m_quantumBoxSize, 8.0f, 128.0f, "%.1f");
+    reset |= ImGui::SliderFloat("Time step (a.u.)", &m_quantumTimeStep, 0.005f, 0.2f, "%.3f");
+    reset |= ImGui::InputInt3("Initial n, l, m", m_quantumState);
+    m_quantumState[0] = std::clamp(m_quantumState[0], 1, QuantumDynamics::MAX_PRINCIPAL);
+    m_quantumState[1] = std::clamp(m_quantumState[1], 0, m_quantumState[0] - 1);
+    m_quantumState[2] = std::clamp(m_quantumState[2], -m_quantumState[1], m_quantumState[1]);
+
+    bool laser = ImGui::SliderFloat("Laser field (a.u.)", &m_laserPulse.amplitude, 0.0f, 0.1f, "%.4f");
+    laser |= ImGui::SliderFloat("Laser frequency (a.u.)", &m_laserPulse.frequency, 0.05f, 1.0f, "%.3f");
+    laser |= ImGui::SliderFloat("Laser cycles", &m_laserPulse.cycles, 1.0f, 40.0f, "%.1f");
+    if (laser) m_quantum.setLaser(m_laserPulse);
+
+    reset |= ImGui::Button("Reset");
+    if (reset || !m_quantum.isConfigured()) resetQuantum(physicsEngine);
+    ImGui::SameLine();
+    ImGui::Checkbox("Run", &m_runQuantum);
+    ImGui::SameLine();
+    bool extract = ImGui::Checkbox("Show density", &m_showWavefunction);
+    ImGui::SliderInt("Steps per frame", &m_quantumStepsPerFrame, 1, 50);
+    extract |= ImGui::SliderFloat("Density level", &m_wavefunctionIsovalue, 1e-5f, 0.1f, "%.5f",
+                                  ImGuiSliderFlags_Logarithmic);
+
+    if (m_quantum.isConfigured() && m_runQuantum) {
+        auto start = std::chrono::steady_clock::now();
+        m_quantum.step(m_quantumStepsPerFrame);
+        m_quantumTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        extract = true;
+    }
+    if (extract && m_quantum.isConfigured()) {
+        if (m_showWavefunction) {
+            VolumeGrid density;
+            glm::vec3 center = atoms.empty() ? glm::vec3(0.0f) : atoms[0]->getNucleus()->getPosition();
+            m_quantum.getDensity(density, center, QuantumDynamics::BOHR_RADIUS_ANGSTROM);
+            Isosurface::extract(density, m_wavefunctionIsovalue, m_isosurfaces[3]);
+        } else if (!m_isosurfaces[3].vertices.empty()) {
+            m_isosurfaces[3].vertices.clear();
+            ++m_isosurfaces[3].version;
+        }
+        if (m_playback) {
+            m_playback->markDirty();
+        }
+    }
+
+    if (m_quantum.isConfigured()) {
+        glm::vec3 field = m_quantum.laserField(m_quantum.getTime());
+        ImGui::Text("t = %.2f a.u. (%.2f fs), E = %.4f a.u., norm %.4f, %.1f ms/frame", m_quantum.getTime(),
+                    m_quantum.getTime() * 2.4188843e-2, glm::length(field), m_quantum.computeNorm(), m_quantumTimeMs);
+
+        // Populations summed over l and m for each shell; the rest is ionized or absorbed.
+        // Projecting costs about as much as a step, so it is refreshed every few frames while running.
+        bool stale = m_quantumLevels.empty() || m_quantumLevelsTime != m_quantum.getTime();
+        if (stale && (!m_runQuantum || ++m_quantumFrames % 10 == 0)) {
+            m_quantumLevels = m_quantum.computeTransitionProbabilities();
+            m_quantumLevelsTime = m_quantum.getTime();
+        }
+        double shells[QuantumDynamics::MAX_PRINCIPAL + 1] = {};
+        double bound = 0.0;
+        for (const QuantumLevel& level : m_quantumLevels) {
+            shells[level.n] += level.probability;
+            bound += level.probability;
+        }
+        for (int n = 1; n <= QuantumDynamics::MAX_PRINCIPAL; ++n) {
+            char label[32];
+            std::snprintf(label, sizeof(label), "n=%d  %.4f", n, shells[n]);
+            ImGui::ProgressBar(static_cast<float>(shells[n]), ImVec2(-1.0f, 0.0f), label);
+        }
+        ImGui::Text("Other (higher levels, ionized, absorbed): %.4f", std::max(0.0, 1.0 - bound));
+
+        // xz plane through the nucleus as a heat map, log scaled
+        int size = m_quantum.getSize();
+        m_quantum.getDensitySlice(1, size / 2, m_quantumSlice);
+        float peak = *std::max_element(m_quantumSlice.begin(), m_quantumSlice.end());
+        const int pixels = std::min(size, 64);
+        const int stride = size / pixels;
+        const float cell = 3.0f;
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        for (int v = 0; v < pixels; ++v) {
+            for (int u = 0; u < pixels; ++u) {
+                float value = m_quantumSlice[size_t(v * stride) * size + u * stride];
+                float level = peak > 0.0f ? std::clamp(1.0f + std::log10(value / peak + 1e-12f) / 6.0f, 0.0f, 1.0f) : 0.0f;
+                ImU32 color = ImGui::ColorConvertFloat4ToU32(ImVec4(level, level * level, 0.3f * (1.0f - level), 1.0f));
+                // z up, x to the right
+                ImVec2 lo(origin.x + u * cell, origin.y + (pixels - 1 - v) * cell);
+                drawList->AddRectFilled(lo, ImVec2(lo.x + cell, lo.y + cell), color);
+            }
+        }
+        ImGui::Dummy(ImVec2(pixels * cell, pixels * cell));
+    }
+    ImGui::End();
+}
+
 std::string ImGuiManager::getElementName(int atomicNumber) const {
     static const char* names[] = {
         "", "Hydrogen","Helium","Lithium","Beryllium","Boron",
@@ -4,9 +4,20 @@
 #include <GLFW/glfw3.h>
 #include <memory>
 #include <vector>
+#include <string>
 #include "Atom.h"
 #include "Molecule.h"
 #include "PhysicsEngine.h"
+#include "FramePacer.h"
+#include "PlaybackController.h"
+#include "AtomInspector.h"
+#include "AtomArrays.h"
+#include "SelectionQuery.h"
+#include "SurfaceArea.h"
+#include "ElectrostaticGrid.h"
+#include "QuantumDynamics.h"
+#include "GpuProfiler.h"
+#include "SnapshotChannel.h"
 
 class ImGuiManager {
 public:
@@ -17,10 +28,85 @@ public:
     void newFrame();
     void render(PhysicsEngine& physicsEngine);
     void endFrame();
+    void renderLoadingProgress(float progress, const std::string& status);
+    /// Viewer-mode panel in place of the simulation controls; view is nullptr until a snapshot arrives
+    void renderLiveView(const std::string& name, bool attached, const SnapshotView* view, uint64_t tornSnapshots);
+    bool isLiveViewEnabled() const { return m_liveViewEnabled; }
     bool isMouseOverUI() const;
+    bool isKeyboardCapturedByUI() const;
+    bool hasBackgroundWork() const { return m_atomInspector.isIndexing(); }
+    void setFramePacer(const FramePacer* framePacer) { m_framePacer = framePacer; }
+    void setPlaybackController(PlaybackController* playback) { m_playback = playback; }
+    void setGpuProfiler(GpuProfiler* profiler) { m_gpuProfiler = profiler; }
+    const Selection* getHighlightSelection() const { return m_highlightSelection ? &m_selection : nullptr; }
+    const std::vector<IsosurfaceMesh>* getIsosurfaces() const {
+        return (m_showPotentialSurfaces || m_showDensitySurface || m_showWavefunction) ? &m_isosurfaces : nullptr;
+    }
+    const std::vector<float>* getSurfaceColoring() const {
+        return m_colorBySurface && !m_surfaceExposure.empty() ? &m_surfaceExposure : nullptr;
+    }
 
 private:
     GLFWwindow* m_window;
+    const FramePacer* m_framePacer = nullptr;
+    PlaybackController* m_playback = nullptr;
+    GpuProfiler* m_gpuProfiler = nullptr;
+    std::string m_traceFile = "gpu_trace.json";
+    bool m_liveViewEnabled = true;
+    AtomInspector m_atomInspector;
+
+    // Selection query state
+    AtomArrays     m_atomArrays;
+    SelectionQuery m_selectionQuery;
+    Selection      m_selection;
+    char           m_queryText[256]        = "all";
+    bool           m_filterInspector       = false;
+    bool           m_highlightSelection    = true;
+    double         m_selectionTimeMs       = 0.0;
+
+    // Solvent-accessible surface state
+    SurfaceArea        m_surfaceArea;
+    float              m_probeRadius         = 1.4f;
+    std::vector<float> m_surfaceAreas;
+    std::vector<float> m_surfaceExposure;
+    double             m_totalSurfaceArea    = 0.0;
+    double             m_surfaceTimeMs       = 0.0;
+    bool               m_liveSurface         = false;
+    bool               m_colorBySurface      = false;
+
+    // Isosurfaces: +potential, -potential, density, then the quantum dynamics wavefunction
+    ElectrostaticGrid           m_electrostatics;
+    std::vector<IsosurfaceMesh> m_isosurfaces;
+    float                       m_gridSpacing            = 0.25f;
+    float                       m_potentialIsovalue      = 0.5f;
+    float                       m_densityIsovalue        = 0.05f;
+    bool                        m_showPotentialSurfaces  = false;
+    bool                        m_showDensitySurface     = false;
+    bool                        m_liveElectrostatics     = true;
+    double                      m_electrostaticsTimeMs   = 0.0;
+
+    // Single-electron wavefunction around the first atom's nucleus
+    QuantumDynamics    m_quantum;
+    LaserPulse         m_laserPulse;
+    std::vector<float> m_quantumSlice;
+    std::vector<QuantumLevel> m_quantumLevels;
+    double             m_quantumLevelsTime    = -1.0;
+    int                m_quantumFrames        = 0;
+    int                m_quantumGridSize      = 64;
+    float              m_quantumBoxSize       = 32.0f;
+    float              m_quantumTimeStep      = 0.05f;
+    int                m_quantumStepsPerFrame = 1;
+    int                m_quantumState[3]      = {1, 0, 0};
+    float              m_wavefunctionIsovalue = 1e-3f;
+    bool               m_runQuantum           = false;
+    bool               m_showWavefunction     = false;
+    double             m_quantumTimeMs        = 0.0;
+
+    // Bulk reaction kinetics
+    float  m_kineticsTemperature = 3000.0f;
+    float  m_initialHydrogen     = 2e-3f;
+    float  m_initialOxygen       = 1e-3f;
+    double m_kineticsTimeMs      = 0.0;
 
     // UI state
     int   m_selectedAtomicNumber   = 1;
@@ -39,6 +125,17 @@ private:
     void renderNuclearControls(PhysicsEngine& physicsEngine);
     void renderOrbitalControls(PhysicsEngine& physicsEngine);
     void renderSimulationInfo(PhysicsEngine& physicsEngine);
+    void renderPlaybackControls();
+    void renderSelectionPanel(PhysicsEngine& physicsEngine);
+    void applySelection(PhysicsEngine& physicsEngine);
+    void renderSurfacePanel(PhysicsEngine& physicsEngine);
+    void computeSurfaceArea(PhysicsEngine& physicsEngine);
+    void renderElectrostaticsPanel(PhysicsEngine& physicsEngine);
+    void renderProfilerPanel();
+    void updateElectrostatics(PhysicsEngine& physicsEngine, bool extractAll);
+    void renderQuantumPanel(PhysicsEngine& physicsEngine);
+    void resetQuantum(PhysicsEngine& physicsEngine);
+    void renderKineticsPanel(PhysicsEngine& physicsEngine);
 
     std::string getElementName(int atomicNumber) const;
 };
@@ -0,0 +1,110 @@
+#include "Isosurface.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Cell corners are numbered x + 2y + 4z; each tetrahedron walks 0 -> 7 along cell edges
+const int TETRAHEDRA[6][4] = {
+    {0, 1, 3, 7}, {0, 2, 3, 7}, {0, 2, 6, 7},
+    {0, 4, 6, 7}, {0, 4, 5, 7}, {0, 1, 5, 7}
+};
+
+struct Corner {
+    glm::vec3 position;
+    glm::vec3 gradient;
+    float value;
+};
+
+glm::vec3 gradientAt(const VolumeGrid& grid, int x, int y, int z) {
+    // Central differences, one-sided at the borders
+    auto axis = [&](int c, int n, auto sample) {
+        int lo = std::max(c - 1, 0), hi = std::min(c + 1, n - 1);
+        return hi > lo ? (sample(hi) - sample(lo)) / ((hi - lo) * grid.spacing) : 0.0f;
+    };
+    return glm::vec3(axis(x, grid.dims[0], [&](int v) { return grid.at(v, y, z); }),
+                     axis(y, grid.dims[1], [&](int v) { return grid.at(x, v, z); }),
+                     axis(z, grid.dims[2], [&](int v) { return grid.at(x, y, v); }));
+}
+
+void emitVertex(std::vector<float>& out, const Corner& a, const Corner& b, float isovalue, float normalSign) {
+    float t = (isovalue - a.value) / (b.value - a.value);
+    glm::vec3 p = glm::mix(a.position, b.position, t);
+    glm::vec3 g = glm::mix(a.gradient, b.gradient, t);
+    float length = glm::length(g);
+    glm::vec3 n = length > 0.0f ? normalSign * g / length : glm::vec3(0.0f, 0.0f, 1.0f);
+    out.insert(out.end(), {p.x, p.y, p.z, n.x, n.y, n.z});
+}
+
+void triangulateTetrahedron(const Corner* c[4], float isovalue, float normalSign, std::vector<float>& out) {
+    int inside[4], outside[4];
+    int insideCount = 0, outsideCount = 0;
+    for (int k = 0; k < 4; ++k) {
+        if (c[k]->value > isovalue) inside[insideCount++] = k;
+        else                        outside[outsideCount++] = k;
+    }
+    if (insideCount == 0 || insideCount == 4) return;
+
+    if (insideCount == 1 || insideCount == 3) {
+        // One vertex on its own side: a single triangle around it
+        const Corner* lone = insideCount == 1 ? c[inside[0]] : c[outside[0]];
+        const int* others = insideCount == 1 ? outside : inside;
+        for (int k = 0; k < 3; ++k) emitVertex(out, *lone, *c[others[k]], isovalue, normalSign);
+        return;
+    }
+
+    // Two on each side: the four crossed edges form a quad
+    const Corner& a0 = *c[inside[0]];
+    const Corner& a1 = *c[inside[1]];
+    const Corner& b0 = *c[outside[0]];
+    const Corner& b1 = *c[outside[1]];
+    emitVertex(out, a0, b0, isovalue, normalSign);
+    emitVertex(out, a0, b1, isovalue, normalSign);
+    emitVertex(out, a1, b1, isovalue, normalSign);
+    emitVertex(out, a0, b0, isovalue, normalSign);
+    emitVertex(out, a1, b1, isovalue, normalSign);
+    emitVertex(out, a1, b0, isovalue, normalSign);
+}
+}
+
+void Isosurface::extract(const VolumeGrid& grid, float isovalue, IsosurfaceMesh& mesh, bool enclosesBelow) {
+    // Outward is down the gradient when the enclosed values are above the isovalue
+    const float normalSign = enclosesBelow ? 1.0f : -1.0f;
+    mesh.vertices.clear();
+    ++mesh.version;
+    const int nx = grid.dims[0], ny = grid.dims[1], nz = grid.dims[2];
+    if (nx < 2 || ny < 2 || nz < 2 || grid.values.size() != size_t(nx) * ny * nz) return;
+
+    std::vector<std::vector<float>> slices(nz - 1);
+    TaskScheduler::getInstance().parallelFor(0, slices.size(), [&](size_t begin, size_t end) {
+        for (size_t zs = begin; zs < end; ++zs) {
+            int z = static_cast<int>(zs);
+            std::vector<float>& out = slices[zs];
+            for (int y = 0; y < ny - 1; ++y) {
+                for (int x = 0; x < nx - 1; ++x) {
+                    // Skip cells entirely on one side before touching gradients
+                    int above = 0;
+                    for (int k = 0; k < 8; ++k) {
+                        above += grid.at(x + (k & 1), y + ((k >> 1) & 1), z + (k >> 2)) > isovalue;
+                    }
+                    if (above == 0 || above == 8) continue;
+
+                    Corner corners[8];
+                    for (int k = 0; k < 8; ++k) {
+                        int cx = x + (k & 1), cy = y + ((k >> 1) & 1), cz = z + (k >> 2);
+                        corners[k] = {grid.position(cx, cy, cz), gradientAt(grid, cx, cy, cz), grid.at(cx, cy, cz)};
+                    }
+                    for (const auto& tet : TETRAHEDRA) {
+                        const Corner* c[4] = {&corners[tet[0]], &corners[tet[1]], &corners[tet[2]], &corners[tet[3]]};
+                        triangulateTetrahedron(c, isovalue, normalSign, out);
+                    }
+                }
+            }
+        }
+    }, 1);
+
+    size_t total = 0;
+    for (const auto& slice : slices) total += slice.size();
+    mesh.vertices.reserve(total);
+    for (const auto& slice : slices) mesh.vertices.insert(mesh.vertices.end(), slice.begin(), slice.end());
+}
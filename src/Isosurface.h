@@ -0,0 +1,78 @@
+#ifndef ISOSURFACE_H
+#define ISOSURFACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * @brief Scalar samples on a regular 3D grid, x fastest.
+ */
+struct VolumeGrid {
+    glm::vec3 origin = glm::vec3(0.0f);
+    float spacing = 1.0f;
+    int dims[3] = {0, 0, 0};
+    std::vector<float> values;
+
+    size_t size() const { return values.size(); }
+    size_t index(int x, int y, int z) const { return (size_t(z) * dims[1] + y) * dims[0] + x; }
+    float at(int x, int y, int z) const { return values[index(x, y, z)]; }
+    glm::vec3 position(int x, int y, int z) const { return origin + spacing * glm::vec3(x, y, z); }
+
+    /**
+     * @brief Resizes the grid and zeroes its values.
+     *
+     * @param gridOrigin Position of sample (0, 0, 0).
+     * @param gridSpacing Distance between samples.
+     * @param nx Samples along x.
+     * @param ny Samples along y.
+     * @param nz Samples along z.
+     */
+    void resize(const glm::vec3& gridOrigin, float gridSpacing, int nx, int ny, int nz) {
+        origin = gridOrigin;
+        spacing = gridSpacing;
+        dims[0] = nx;
+        dims[1] = ny;
+        dims[2] = nz;
+        values.assign(size_t(nx) * ny * nz, 0.0f);
+    }
+};
+
+/**
+ * @brief Triangle soup of an isosurface, ready for upload as a vertex buffer.
+ */
+struct IsosurfaceMesh {
+    std::vector<float> vertices;  ///< Interleaved position and normal, three vertices per triangle
+    glm::vec3 color = glm::vec3(1.0f);
+    float alpha = 1.0f;
+    uint64_t version = 0;         ///< Bumped whenever the vertices change
+
+    size_t getVertexCount() const { return vertices.size() / 6; }
+};
+
+/**
+ * @brief Extracts isosurfaces from volume grids.
+ *
+ * Uses marching tetrahedra: each grid cell is split into six tetrahedra
+ * around its main diagonal, which needs no case tables and produces no
+ * ambiguous faces. Normals are the interpolated field gradient, pointing
+ * out of the enclosed region. Slices of cells are triangulated in
+ * parallel on the TaskScheduler and concatenated in order, so the output is
+ * deterministic.
+ */
+class Isosurface {
+public:
+    /**
+     * @brief Triangulates the surface where the field equals an isovalue.
+     *
+     * @param grid The sampled field.
+     * @param isovalue The surface level.
+     * @param mesh Receives the triangles; its version is bumped.
+     * @param enclosesBelow True if the surface encloses values below the isovalue
+     *                      (e.g. negative potential), false for values above it.
+     */
+    static void extract(const VolumeGrid& grid, float isovalue, IsosurfaceMesh& mesh, bool enclosesBelow = false);
+};
+
+#endif // ISOSURFACE_H
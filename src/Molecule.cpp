@@ -2,8 +2,10 @@
 
 void Molecule::addAtom(std::shared_ptr<Atom> atom) {
     m_atoms.push_back(atom);
+    ++m_revision;
 }
 
 void Molecule::addBond(std::shared_ptr<Bond> bond) {
     m_bonds.push_back(bond);
+    ++m_revision;
 }
@@ -47,9 +47,17 @@ public:
      */
     const std::vector<std::shared_ptr<Bond>>& getBonds() const { return m_bonds; }
 
+    /**
+     * @brief Gets a counter that changes whenever atoms or bonds are added or removed.
+     *
+     * @return The topology revision.
+     */
+    unsigned getRevision() const { return m_revision; }
+
 private:
     std::vector<std::shared_ptr<Atom>> m_atoms;
     std::vector<std::shared_ptr<Bond>> m_bonds;
+    unsigned m_revision = 0;
 };
 
 #endif // MOLECULE_H
@@ -0,0 +1,202 @@
+#include "MultigridPoisson.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Sweeps on the coarsest grid, which has only a handful of unknowns
+const int COARSEST_SWEEPS = 32;
+}
+
+bool MultigridPoisson::configure(int nx, int ny, int nz, const glm::vec3& spacing) {
+    if (nx < 3 || ny < 3 || nz < 3) return false;
+    m_levels.clear();
+    Level level;
+    level.n[0] = nx;
+    level.n[1] = ny;
+    level.n[2] = nz;
+    level.h = spacing;
+    while (true) {
+        size_t points = size_t(level.n[0]) * level.n[1] * level.n[2];
+        level.phi.assign(points, 0.0f);
+        level.rhs.assign(points, 0.0f);
+        level.residual.assign(points, 0.0f);
+        m_levels.push_back(level);
+
+        bool coarsens = true;
+        for (int a = 0; a < 3; ++a) {
+            int intervals = level.n[a] - 1;
+            coarsens = coarsens && intervals % 2 == 0 && intervals / 2 >= 2;
+        }
+        if (!coarsens) break;
+        for (int a = 0; a < 3; ++a) level.n[a] = (level.n[a] - 1) / 2 + 1;
+        level.h *= 2.0f;
+    }
+    m_residual = 0.0;
+    return true;
+}
+
+void MultigridPoisson::resetGuess() {
+    if (m_levels.empty()) return;
+    Level& level = m_levels[0];
+    for (int z = 1; z < level.n[2] - 1; ++z) {
+        for (int y = 1; y < level.n[1] - 1; ++y) {
+            std::fill_n(&level.phi[index(level, 1, y, z)], level.n[0] - 2, 0.0f);
+        }
+    }
+}
+
+void MultigridPoisson::smooth(Level& level, int sweeps) {
+    const int nx = level.n[0], ny = level.n[1], nz = level.n[2];
+    const float cx = 1.0f / (level.h.x * level.h.x);
+    const float cy = 1.0f / (level.h.y * level.h.y);
+    const float cz = 1.0f / (level.h.z * level.h.z);
+    const float diagonal = 1.0f / (2.0f * (cx + cy + cz));
+    const size_t sy = nx, sz = size_t(nx) * ny;
+    float* phi = level.phi.data();
+    const float* rhs = level.rhs.data();
+
+    for (int sweep = 0; sweep < sweeps; ++sweep) {
+        for (int colour = 0; colour < 2; ++colour) {
+            // Nodes of one colour only read nodes of the other, so planes are independent
+            TaskScheduler::getInstance().parallelFor(1, nz - 1, [&](size_t firstZ, size_t lastZ) {
+                for (size_t z = firstZ; z < lastZ; ++z) {
+                    for (int y = 1; y < ny - 1; ++y) {
+                        int x0 = 1 + ((1 + y + static_cast<int>(z) + colour) & 1);
+                        size_t row = z * sz + y * sy;
+                        for (int x = x0; x < nx - 1; x += 2) {
+                            size_t i = row + x;
+                            phi[i] = diagonal * (cx * (phi[i - 1] + phi[i + 1]) + cy * (phi[i - sy] + phi[i + sy]) +
+                                                 cz * (phi[i - sz] + phi[i + sz]) - rhs[i]);
+                        }
+                    }
+                }
+            }, std::max(1, 32768 / (nx * ny)));
+        }
+    }
+}
+
+double MultigridPoisson::computeResidual(Level& level) {
+    const int nx = level.n[0], ny = level.n[1], nz = level.n[2];
+    const float cx = 1.0f / (level.h.x * level.h.x);
+    const float cy = 1.0f / (level.h.y * level.h.y);
+    const float cz = 1.0f / (level.h.z * level.h.z);
+    const size_t sy = nx, sz = size_t(nx) * ny;
+    const float* phi = level.phi.data();
+    const float* rhs = level.rhs.data();
+    float* residual = level.residual.data();
+
+    std::vector<double> planeSums(nz, 0.0);
+    TaskScheduler::getInstance().parallelFor(1, nz - 1, [&](size_t firstZ, size_t lastZ) {
+        for (size_t z = firstZ; z < lastZ; ++z) {
+            double sum = 0.0;
+            for (int y = 1; y < ny - 1; ++y) {
+                size_t row = z * sz + y * sy;
+                for (int x = 1; x < nx - 1; ++x) {
+                    size_t i = row + x;
+                    float laplacian = cx * (phi[i - 1] + phi[i + 1]) + cy * (phi[i - sy] + phi[i + sy]) +
+                                      cz * (phi[i - sz] + phi[i + sz]) - 2.0f * (cx + cy + cz) * phi[i];
+                    float r = rhs[i] - laplacian;
+                    residual[i] = r;
+                    sum += double(r) * r;
+                }
+            }
+            planeSums[z] = sum;
+        }
+    }, std::max(1, 32768 / (nx * ny)));
+
+    double sum = 0.0;
+    for (double s : planeSums) sum += s;
+    return std::sqrt(sum);
+}
+
+void MultigridPoisson::restrictResidual(const Level& fine, Level& coarse) {
+    // Full weighting: the tensor product of (1/4, 1/2, 1/4) around each coarse node
+    const float weights[3] = {0.25f, 0.5f, 0.25f};
+    std::fill(coarse.rhs.begin(), coarse.rhs.end(), 0.0f);
+    TaskScheduler::getInstance().parallelFor(1, coarse.n[2] - 1, [&](size_t firstZ, size_t lastZ) {
+        for (size_t Z = firstZ; Z < lastZ; ++Z) {
+            for (int Y = 1; Y < coarse.n[1] - 1; ++Y) {
+                for (int X = 1; X < coarse.n[0] - 1; ++X) {
+                    float sum = 0.0f;
+                    for (int dz = -1; dz <= 1; ++dz) {
+                        for (int dy = -1; dy <= 1; ++dy) {
+                            const float* row = &fine.residual[index(fine, 2 * X - 1, 2 * Y + dy, 2 * static_cast<int>(Z) + dz)];
+                            float w = weights[dz + 1] * weights[dy + 1];
+                            sum += w * (0.25f * row[0] + 0.5f * row[1] + 0.25f * row[2]);
+                        }
+                    }
+                    coarse.rhs[index(coarse, X, Y, static_cast<int>(Z))] = sum;
+                }
+            }
+        }
+    }, 1);
+}
+
+void MultigridPoisson::prolongAndCorrect(const Level& coarse, Level& fine) {
+    // Trilinear interpolation of the coarse correction onto the fine interior
+    TaskScheduler::getInstance().parallelFor(1, fine.n[2] - 1, [&](size_t firstZ, size_t lastZ) {
+        for (size_t z = firstZ; z < lastZ; ++z) {
+            int Z0 = static_cast<int>(z) / 2, Z1 = Z0 + (z & 1);
+            for (int y = 1; y < fine.n[1] - 1; ++y) {
+                int Y0 = y / 2, Y1 = Y0 + (y & 1);
+                float* out = &fine.phi[index(fine, 0, y, static_cast<int>(z))];
+                const float* c00 = &coarse.phi[index(coarse, 0, Y0, Z0)];
+                const float* c01 = &coarse.phi[index(coarse, 0, Y1, Z0)];
+                const float* c10 = &coarse.phi[index(coarse, 0, Y0, Z1)];
+                const float* c11 = &coarse.phi[index(coarse, 0, Y1, Z1)];
+                for (int x = 1; x < fine.n[0] - 1; ++x) {
+                    int X0 = x / 2, X1 = X0 + (x & 1);
+                    float sum = c00[X0] + c00[X1] + c01[X0] + c01[X1] + c10[X0] + c10[X1] + c11[X0] + c11[X1];
+                    out[x] += 0.125f * sum;
+                }
+            }
+        }
+    }, 1);
+}
+
+void MultigridPoisson::cycle(size_t depth) {
+    Level& level = m_levels[depth];
+    if (depth + 1 == m_levels.size()) {
+        smooth(level, COARSEST_SWEEPS);
+        return;
+    }
+    smooth(level, SMOOTHING_SWEEPS);
+    computeResidual(level);
+    Level& coarse = m_levels[depth + 1];
+    restrictResidual(level, coarse);
+    // The coarse grid solves for the error, which is zero on the faces
+    std::fill(coarse.phi.begin(), coarse.phi.end(), 0.0f);
+    cycle(depth + 1);
+    prolongAndCorrect(coarse, level);
+    smooth(level, SMOOTHING_SWEEPS);
+}
+
+int MultigridPoisson::solve(const std::vector<float>& rhs, float tolerance, int maxCycles) {
+    if (m_levels.empty()) return 0;
+    Level& finest = m_levels[0];
+    finest.rhs = rhs;
+    finest.rhs.resize(finest.phi.size(), 0.0f);
+
+    double rhsNorm = 0.0;
+    for (int z = 1; z < finest.n[2] - 1; ++z) {
+        for (int y = 1; y < finest.n[1] - 1; ++y) {
+            for (int x = 1; x < finest.n[0] - 1; ++x) {
+                double f = finest.rhs[index(finest, x, y, z)];
+                rhsNorm += f * f;
+            }
+        }
+    }
+    rhsNorm = std::sqrt(rhsNorm);
+    if (rhsNorm == 0.0) rhsNorm = 1.0;
+
+    // A warm start from the previous step may already be good enough
+    m_residual = computeResidual(finest) / rhsNorm;
+    int cycles = 0;
+    while (m_residual > tolerance && cycles < maxCycles) {
+        cycle(0);
+        ++cycles;
+        m_residual = computeResidual(finest) / rhsNorm;
+    }
+    return cycles;
+}
@@ -0,0 +1,104 @@
+#ifndef MULTIGRID_POISSON_H
+#define MULTIGRID_POISSON_H
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * @brief Geometric multigrid solver for ∇²φ = f on a box with fixed boundary values.
+ *
+ * The grid is vertex-centred: nodes on the faces hold the Dirichlet values
+ * and the interior is solved for. Each V-cycle smooths with red-black
+ * Gauss–Seidel, restricts the residual by full weighting to a grid with
+ * twice the spacing, recurses, and adds the trilinear interpolation of the
+ * coarse correction. This is repeated down to a grid with a few nodes per
+ * side. Red and black sweeps are independent within a colour, so every
+ * pass is spread over z planes on the TaskScheduler.
+ *
+ * solve() starts from whatever the interior holds, so calling it again after
+ * a small change in f (the next time step) converges in a cycle or two. It
+ * stops as soon as the residual falls below the tolerance.
+ */
+class MultigridPoisson {
+public:
+    /// Gauss–Seidel sweeps before and after each coarse correction
+    static constexpr int SMOOTHING_SWEEPS = 2;
+
+    MultigridPoisson() = default;
+
+    /**
+     * @brief Sets the grid; the potential is reset to zero.
+     *
+     * Coarsening continues while every side has an even number of intervals,
+     * so sides of 2^k + 1 nodes give the most levels.
+     *
+     * @param nx Nodes along x, including both faces (at least 3).
+     * @param ny Nodes along y.
+     * @param nz Nodes along z.
+     * @param spacing Node spacing along each axis.
+     * @return False if a side has fewer than 3 nodes.
+     */
+    bool configure(int nx, int ny, int nz, const glm::vec3& spacing);
+
+    /**
+     * @brief Sets the face nodes from a function of the node index.
+     *
+     * @param value Called as value(x, y, z) for every face node.
+     */
+    template <typename Fn>
+    void setBoundary(Fn&& value) {
+        Level& level = m_levels[0];
+        for (int z = 0; z < level.n[2]; ++z) {
+            for (int y = 0; y < level.n[1]; ++y) {
+                bool face = z == 0 || z == level.n[2] - 1 || y == 0 || y == level.n[1] - 1;
+                for (int x = 0; x < level.n[0]; ++x) {
+                    if (face || x == 0 || x == level.n[0] - 1) level.phi[index(level, x, y, z)] = value(x, y, z);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Runs V-cycles until the residual is small enough.
+     *
+     * @param rhs The right-hand side f at every node (face values are ignored).
+     * @param tolerance Target for |f - ∇²φ| / |f| over the interior.
+     * @param maxCycles Upper bound on V-cycles.
+     * @return The number of V-cycles run.
+     */
+    int solve(const std::vector<float>& rhs, float tolerance, int maxCycles);
+
+    /// Zeroes the interior so the next solve starts cold
+    void resetGuess();
+
+    const std::vector<float>& getPotential() const { return m_levels[0].phi; }
+    int getSize(int axis) const { return m_levels.empty() ? 0 : m_levels[0].n[axis]; }
+    size_t getLevelCount() const { return m_levels.size(); }
+
+    /// Relative residual after the last solve()
+    double getResidual() const { return m_residual; }
+
+private:
+    struct Level {
+        int n[3];
+        glm::vec3 h;
+        std::vector<float> phi;
+        std::vector<float> rhs;
+        std::vector<float> residual;
+    };
+
+    std::vector<Level> m_levels;
+    double m_residual = 0.0;
+
+    static size_t index(const Level& level, int x, int y, int z) {
+        return (size_t(z) * level.n[1] + y) * level.n[0] + x;
+    }
+    void smooth(Level& level, int sweeps);
+    double computeResidual(Level& level);
+    void restrictResidual(const Level& fine, Level& coarse);
+    void prolongAndCorrect(const Level& coarse, Level& fine);
+    void cycle(size_t depth);
+};
+
+#endif // MULTIGRID_POISSON_H
@@ -1,6 +1,8 @@
 #include "NuclearReactor.h"
+#include "DecayChain.h"
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 
 // Constants
 const float AMU_TO_KG = 1.660539e-27f; // Atomic mass unit to kilograms
@@ -117,3 +119,34 @@ float NuclearReactor::simulateFusion(std::shared_ptr<Nucleus> nucleus1, std::sha
 }
 
 
+
+double NuclearReactor::recordFissions(DecayChain& inventory, double moles) const {
+    const double MINUTE = 60.0, HOUR = 3600.0, DAY = 86400.0;
+
+    uint32_t uranium = inventory.addNuclide("U-235", 7.04e8 * DecayChain::SECONDS_PER_YEAR);
+
+    // Only the U-235 present can fission, and every fission books both products
+    moles = std::min(moles, inventory.getAmounts()[uranium]);
+    if (!(moles > 0.0)) return 0.0;
+    inventory.setAmount(uranium, inventory.getAmounts()[uranium] - moles);
+
+    // Each product and its β⁻ chain down to a stable isobar
+    const struct { const char* names[5]; double halfLives[5]; } chains[] = {
+        {{"Ba-141", "La-141", "Ce-141", "Pr-141", nullptr}, {18.27 * MINUTE, 3.92 * HOUR, 32.51 * DAY, 0.0, 0.0}},
+        {{"Kr-92", "Rb-92", "Sr-92", "Y-92", "Zr-92"}, {1.840, 4.492, 2.66 * HOUR, 3.54 * HOUR, 0.0}},
+    };
+    for (const auto& chain : chains) {
+        int previous = -1;
+        for (int k = 0; k < 5 && chain.names[k]; ++k) {
+            uint32_t index = inventory.addNuclide(chain.names[k], chain.halfLives[k]);
+            // Also links members that were in the inventory already but not chained
+            if (previous >= 0 && !inventory.hasFlow(static_cast<uint32_t>(previous), index)) {
+                inventory.addDecay(static_cast<uint32_t>(previous), static_cast<int>(index));
+            }
+            previous = static_cast<int>(index);
+        }
+        uint32_t product = static_cast<uint32_t>(inventory.findNuclide(chain.names[0]));
+        inventory.setAmount(product, inventory.getAmounts()[product] + moles);
+    }
+    return moles;
+}
@@ -6,6 +6,8 @@
 #include "Particle.h"
 #include "Atom.h"
 
+class DecayChain;
+
 /**
  * @brief Simulates nuclear fission and fusion events.
  * 
@@ -36,6 +38,20 @@ public:
      */
     float simulateFusion(std::shared_ptr<Nucleus> nucleus1, std::shared_ptr<Nucleus> nucleus2);
 
+    /**
+     * @brief Books bulk U-235 fissions into an isotope inventory.
+     *
+     * Uses the same split as simulateFission(): each fission consumes one
+     * U-235 and yields Ba-141 and Kr-92, whose decay chains (to Pr-141 and
+     * Zr-92) are added to the inventory if missing. No more U-235 fissions
+     * than the inventory holds.
+     *
+     * @param inventory The inventory to update.
+     * @param moles Moles of U-235 to fission.
+     * @return The moles actually fissioned.
+     */
+    double recordFissions(DecayChain& inventory, double moles) const;
+
 private:
     // Helper function to calculate binding energy per nucleon (simplified)
     float calculateBindingEnergyPerNucleon(int atomicNumber, int massNumber) const;
@@ -26,6 +26,43 @@ float OrbitalModel::calculateOrbitalEnergy(int atomicNumber,
               / float(orbitalLevel*orbitalLevel));
 }
 
+float OrbitalModel::calculateZeemanShift(int magneticQuantumNumber,
+                                         const glm::vec3& magneticField) const {
+    // ΔE = μ_B m_l |B|, with the quantization axis along B
+    return BOHR_MAGNETON_EV_PER_T * float(magneticQuantumNumber)
+           * glm::length(magneticField);
+}
+
+float OrbitalModel::calculateTransitionEnergy(int atomicNumber,
+                                              int lowerLevel,
+                                              int upperLevel) const {
+    return calculateOrbitalEnergy(atomicNumber, upperLevel)
+           - calculateOrbitalEnergy(atomicNumber, lowerLevel);
+}
+
+bool OrbitalModel::absorbPhoton(std::shared_ptr<Electron> electron,
+                                std::shared_ptr<Atom> atom,
+                                float photonEnergyEv,
+                                int newOrbitalLevel,
+                                float relativeTolerance,
+                                const glm::vec3& magneticField) {
+    if (!electron || !atom) return false;
+    int oldLevel = electron->getOrbitalLevel();
+    if (oldLevel <= 0 || newOrbitalLevel <= oldLevel) return false;
+
+    float deltaE = calculateTransitionEnergy(atom->getAtomicNumber(),
+                                             oldLevel, newOrbitalLevel);
+    // Normal Zeeman triplet: Δm_l = -1, 0, +1
+    for (int deltaM = -1; deltaM <= 1; ++deltaM) {
+        float component = deltaE + calculateZeemanShift(deltaM, magneticField);
+        if (std::abs(photonEnergyEv - component) <= relativeTolerance * component) {
+            electron->setOrbitalLevel(newOrbitalLevel);
+            return true;
+        }
+    }
+    return false;
+}
+
 float OrbitalModel::simulateElectronJump(
     std::shared_ptr<Electron> electron,
     std::shared_ptr<Atom> atom,
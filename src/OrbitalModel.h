@@ -2,6 +2,7 @@
 #define ORBITAL_MODEL_H
 
 #include <memory>
+#include <glm/glm.hpp>
 #include "Atom.h"
 #include "Particle.h"
 
@@ -38,9 +39,52 @@ public:
      */
     float simulateElectronJump(std::shared_ptr<Electron> electron, std::shared_ptr<Atom> atom, int newOrbitalLevel);
 
+    /**
+     * @brief Calculates the normal Zeeman shift of an orbital in a magnetic field.
+     *
+     * Each level splits into 2l + 1 sublevels shifted by μ_B·m_l·B; spin is
+     * not included. Pass Δm_l (-1, 0 or +1) for the shift of a transition's
+     * σ and π components. Sample B at the atom with ExternalField::evaluate().
+     *
+     * @param magneticQuantumNumber The magnetic quantum number m_l, or Δm_l of a transition.
+     * @param magneticField The field at the atom in T (its magnitude sets the splitting).
+     * @return The energy shift in eV.
+     */
+    float calculateZeemanShift(int magneticQuantumNumber, const glm::vec3& magneticField) const;
+
+    /**
+     * @brief Calculates the photon energy of a transition between two levels.
+     *
+     * @param atomicNumber The atomic number (Z) of the atom.
+     * @param lowerLevel The lower principal quantum number.
+     * @param upperLevel The upper principal quantum number.
+     * @return The energy in eV, positive when upperLevel > lowerLevel.
+     */
+    float calculateTransitionEnergy(int atomicNumber, int lowerLevel, int upperLevel) const;
+
+    /**
+     * @brief Excites an electron by absorbing a photon, if the photon is resonant.
+     *
+     * Unlike simulateElectronJump() this does not log, since photon transport
+     * absorbs many photons per step.
+     *
+     * @param electron The electron to excite; it must be in the lower level of the transition.
+     * @param atom The atom to which the electron belongs.
+     * @param photonEnergyEv The photon energy in eV.
+     * @param newOrbitalLevel The upper level of the transition.
+     * @param relativeTolerance How far off resonance the photon may be, relative to the transition energy.
+     * @param magneticField The field at the atom in T; the photon may match any Zeeman component.
+     * @return True if the electron was excited.
+     */
+    bool absorbPhoton(std::shared_ptr<Electron> electron, std::shared_ptr<Atom> atom, float photonEnergyEv,
+                      int newOrbitalLevel, float relativeTolerance,
+                      const glm::vec3& magneticField = glm::vec3(0.0f));
+
 private:
     // Rydberg constant in eV
     static constexpr float RYDBERG_CONSTANT_EV = 13.605693f;
+    // Bohr magneton in eV/T
+    static constexpr float BOHR_MAGNETON_EV_PER_T = 5.7883818e-5f;
 };
 
 /// Convert photon energy ΔE (eV) to wavelength in nanometers:
@@ -8,8 +8,7 @@ Particle::Particle(Type type, const glm::vec3& position, const glm::vec3& veloci
       m_charge(charge) {}
 
 void Particle::update(const glm::vec3& force, float deltaTime) {
-    // Basic Euler integration for now
-    // F = ma => a = F/m
+    // Semi-implicit Euler: F = ma => a = F/m, then move with the new velocity
     glm::vec3 acceleration = force / m_mass;
     m_velocity += acceleration * deltaTime;
     m_position += m_velocity * deltaTime;
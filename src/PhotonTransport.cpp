@@ -0,0 +1,234 @@
+#include "PhotonTransport.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+const double PI = 3.14159265358979323846;
+
+/// splitmix64: a full-period generator whose outputs are well mixed even for adjacent seeds
+uint64_t splitMix(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+/// Uniform in [0, 1)
+float uniform(uint64_t& state) {
+    return static_cast<float>(splitMix(state) >> 40) * (1.0f / 16777216.0f);
+}
+
+glm::vec3 isotropicDirection(uint64_t& state) {
+    float cosTheta = 2.0f * uniform(state) - 1.0f;
+    float sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
+    float phi = static_cast<float>(2.0 * PI) * uniform(state);
+    return glm::vec3(sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta);
+}
+
+/// Parametric range of a ray inside a box; empty if tEnter >= tExit
+void clipToBox(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& boxMin,
+               const glm::vec3& boxMax, float& tEnter, float& tExit) {
+    tEnter = 0.0f;
+    tExit = std::numeric_limits<float>::max();
+    for (int a = 0; a < 3; ++a) {
+        if (std::fabs(direction[a]) < 1e-12f) {
+            if (origin[a] < boxMin[a] || origin[a] > boxMax[a]) {
+                tExit = 0.0f;
+                return;
+            }
+            continue;
+        }
+        float inverse = 1.0f / direction[a];
+        float t0 = (boxMin[a] - origin[a]) * inverse;
+        float t1 = (boxMax[a] - origin[a]) * inverse;
+        if (t0 > t1) std::swap(t0, t1);
+        tEnter = std::max(tEnter, t0);
+        tExit = std::min(tExit, t1);
+    }
+}
+}
+
+void PhotonTransport::setAbsorbers(const float* x, const float* y, const float* z, size_t count) {
+    m_x.assign(x, x + count);
+    m_y.assign(y, y + count);
+    m_z.assign(z, z + count);
+    m_lines.clear();
+    m_groups.clear();
+}
+
+void PhotonTransport::setLines(std::vector<AbsorptionLine> lines) {
+    m_lines = std::move(lines);
+    m_lines.erase(std::remove_if(m_lines.begin(), m_lines.end(), [&](const AbsorptionLine& line) {
+        return line.absorber >= m_x.size() || !(line.energy > 0.0f);
+    }), m_lines.end());
+    std::sort(m_lines.begin(), m_lines.end(), [](const AbsorptionLine& a, const AbsorptionLine& b) {
+        return a.energy < b.energy;
+    });
+
+    // Consecutive lines within one width of the group's first line share a grid
+    m_groups.clear();
+    size_t begin = 0;
+    while (begin < m_lines.size()) {
+        size_t end = begin + 1;
+        float limit = m_lines[begin].energy * (1.0f + m_lineWidth);
+        while (end < m_lines.size() && m_lines[end].energy <= limit) ++end;
+
+        m_groups.emplace_back();
+        LineGroup& group = m_groups.back();
+        group.lowEnergy = m_lines[begin].energy;
+        group.highEnergy = m_lines[end - 1].energy;
+        group.begin = static_cast<uint32_t>(begin);
+        group.end = static_cast<uint32_t>(end);
+        size_t count = end - begin;
+        group.x.resize(count);
+        group.y.resize(count);
+        group.z.resize(count);
+        group.boxMin = glm::vec3(std::numeric_limits<float>::max());
+        group.boxMax = glm::vec3(-std::numeric_limits<float>::max());
+        for (size_t k = 0; k < count; ++k) {
+            uint32_t absorber = m_lines[begin + k].absorber;
+            glm::vec3 p(m_x[absorber], m_y[absorber], m_z[absorber]);
+            group.x[k] = p.x;
+            group.y[k] = p.y;
+            group.z[k] = p.z;
+            group.boxMin = glm::min(group.boxMin, p);
+            group.boxMax = glm::max(group.boxMax, p);
+        }
+        group.boxMin -= glm::vec3(m_radius);
+        group.boxMax += glm::vec3(m_radius);
+        group.grid.build(group.x.data(), group.y.data(), group.z.data(), count, 2.0f * m_radius);
+        begin = end;
+    }
+}
+
+void PhotonTransport::setCrossSectionRadius(float radius) {
+    if (radius > 0.0f) m_radius = radius;
+}
+
+void PhotonTransport::setLineWidth(float relativeWidth) {
+    if (relativeWidth > 0.0f) m_lineWidth = relativeWidth;
+}
+
+uint64_t PhotonTransport::nextRandom() {
+    return splitMix(m_random);
+}
+
+void PhotonTransport::emit(const glm::vec3& origin, float energy, uint32_t source, uint32_t scatterings) {
+    PhotonPacket packet;
+    packet.position = origin;
+    packet.direction = isotropicDirection(m_random);
+    packet.energy = energy;
+    packet.source = source;
+    packet.scatterings = scatterings;
+    m_packets.push_back(packet);
+}
+
+bool PhotonTransport::traceGroup(const LineGroup& group, const PhotonPacket& packet, float maxDistance,
+                                 uint64_t& state, std::vector<std::pair<float, uint32_t>>& hits,
+                                 float& distance, uint32_t& line) const {
+    float tEnter, tExit;
+    clipToBox(packet.position, packet.direction, group.boxMin, group.boxMax, tEnter, tExit);
+    tExit = std::min(tExit, maxDistance);
+    if (tEnter >= tExit) return false;
+
+    const float step = group.grid.getCellSize();
+    const float radiusSquared = m_radius * m_radius;
+    const float inverseWidth = 1.0f / m_lineWidth;
+    float span = (tExit - tEnter) / step;
+    if (!std::isfinite(span)) return false;
+    // Stepped by count: far from the origin t0 + step can round back to t0
+    const size_t steps = static_cast<size_t>(std::ceil(span));
+    for (size_t s = 0; s < steps; ++s) {
+        // Every disc centred on this stretch of the ray lies within the sphere around it
+        float t0 = tEnter + static_cast<float>(s) * step;
+        float t1 = s + 1 < steps ? std::min(tEnter + static_cast<float>(s + 1) * step, tExit) : tExit;
+        glm::vec3 middle = packet.position + packet.direction * (0.5f * (t0 + t1));
+        hits.clear();
+        group.grid.forEachCandidate(middle, 0.5f * (t1 - t0) + m_radius, [&](uint32_t k) {
+            if (m_lines[group.begin + k].absorber == packet.source) return;
+            glm::vec3 offset = glm::vec3(group.x[k], group.y[k], group.z[k]) - packet.position;
+            float along = glm::dot(offset, packet.direction);
+            if (along < t0 || along >= t1) return;
+            if (glm::dot(offset, offset) - along * along > radiusSquared) return;
+            hits.emplace_back(along, k);
+        });
+        std::sort(hits.begin(), hits.end());
+        for (const auto& hit : hits) {
+            const AbsorptionLine& candidate = m_lines[group.begin + hit.second];
+            float detuning = (packet.energy - candidate.energy) * inverseWidth / candidate.energy;
+            if (uniform(state) < candidate.strength * std::exp(-detuning * detuning)) {
+                distance = hit.first;
+                line = group.begin + hit.second;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+PhotonTransportStats PhotonTransport::propagate(std::vector<PhotonAbsorption>& absorptions,
+                                                std::vector<PhotonPacket>* escaped) {
+    absorptions.clear();
+    PhotonTransportStats stats;
+    const size_t count = m_packets.size();
+    if (count == 0) return stats;
+
+    // Per packet: the absorbing line (UINT32_MAX if it escaped) and the flight length
+    std::vector<uint32_t> absorbedBy(count, UINT32_MAX);
+    std::vector<float> flight(count, 0.0f);
+    const uint64_t batchSeed = nextRandom();
+    TaskScheduler::getInstance().parallelFor(0, count, [&](size_t begin, size_t end) {
+        std::vector<std::pair<float, uint32_t>> hits;
+        for (size_t i = begin; i < end; ++i) {
+            const PhotonPacket& packet = m_packets[i];
+            uint64_t state = batchSeed ^ (uint64_t(i) * 0xd1b54a32d192ed03ull);
+            float cutoff = PROFILE_CUTOFF * m_lineWidth * packet.energy;
+            auto first = std::lower_bound(m_groups.begin(), m_groups.end(), packet.energy - cutoff,
+                                          [](const LineGroup& group, float energy) {
+                                              return group.highEnergy < energy;
+                                          });
+            float nearest = std::numeric_limits<float>::max();
+            for (auto group = first; group != m_groups.end() && group->lowEnergy <= packet.energy + cutoff;
+                 ++group) {
+                float distance;
+                uint32_t line;
+                if (traceGroup(*group, packet, nearest, state, hits, distance, line)) {
+                    nearest = distance;
+                    absorbedBy[i] = line;
+                }
+            }
+            if (absorbedBy[i] != UINT32_MAX) {
+                flight[i] = nearest;
+            } else {
+                // Escaped packets are counted up to the last absorbing region they crossed
+                float tEnter, tExit;
+                for (auto group = first; group != m_groups.end() && group->lowEnergy <= packet.energy + cutoff;
+                     ++group) {
+                    clipToBox(packet.position, packet.direction, group->boxMin, group->boxMax, tEnter, tExit);
+                    if (tEnter < tExit) flight[i] = std::max(flight[i], tExit);
+                }
+            }
+        }
+    }, 64);
+
+    for (size_t i = 0; i < count; ++i) {
+        stats.pathLength += flight[i];
+        if (absorbedBy[i] == UINT32_MAX) {
+            ++stats.escaped;
+            if (escaped) escaped->push_back(m_packets[i]);
+            continue;
+        }
+        PhotonAbsorption absorption;
+        absorption.line = m_lines[absorbedBy[i]];
+        absorption.packet = m_packets[i];
+        absorption.packet.position = glm::vec3(m_x[absorption.line.absorber], m_y[absorption.line.absorber],
+                                               m_z[absorption.line.absorber]);
+        absorption.distance = flight[i];
+        absorptions.push_back(absorption);
+        ++stats.absorbed;
+    }
+    m_packets.clear();
+    return stats;
+}
@@ -0,0 +1,167 @@
+#ifndef PHOTON_TRANSPORT_H
+#define PHOTON_TRANSPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+#include "CellGrid.h"
+
+/**
+ * @brief A bundle of identical photons travelling in a straight line.
+ */
+struct PhotonPacket {
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 direction = glm::vec3(0.0f, 0.0f, 1.0f);  ///< Unit vector
+    float energy = 0.0f;           ///< Photon energy in eV
+    uint32_t source = UINT32_MAX;  ///< Emitting absorber, which cannot reabsorb the packet in flight
+    uint32_t scatterings = 0;      ///< Absorptions and re-emissions so far
+};
+
+/**
+ * @brief A transition an absorber can be excited through.
+ */
+struct AbsorptionLine {
+    float energy;         ///< Line centre in eV
+    uint32_t absorber;    ///< Index into the positions given to setAbsorbers()
+    uint16_t lowerLevel;
+    uint16_t upperLevel;
+    float strength = 1.0f;  ///< Peak absorption probability, below 1 for components of a split line
+};
+
+/**
+ * @brief Where a packet ended its flight on an absorber.
+ */
+struct PhotonAbsorption {
+    PhotonPacket packet;  ///< The packet, moved to the absorber
+    AbsorptionLine line;
+    float distance;       ///< Length of the flight
+};
+
+/**
+ * @brief Totals from one propagate() call.
+ */
+struct PhotonTransportStats {
+    size_t absorbed = 0;
+    size_t escaped = 0;
+    double pathLength = 0.0;  ///< Summed flight length of every packet
+};
+
+/**
+ * @brief Monte Carlo transport of photon packets between line absorbers.
+ *
+ * Each absorber is a disc of fixed radius facing the packet. A packet that
+ * crosses a disc is absorbed with the probability of the line profile at
+ * its energy, a Gaussian of relative width setLineWidth(). In a uniform gas
+ * this gives a mean free path of 1 / (n π r²) at line centre.
+ *
+ * Lines are kept in an index sorted by energy. Lines within one line
+ * width of each other form a group, and each group has its own CellGrid
+ * over its absorbers. A packet looks up the groups that overlap its
+ * energy, then marches through those groups' grids cell by cell along its
+ * ray until a line absorbs it or it leaves the group's bounding box.
+ * Absorbers that cannot absorb it are never visited. Packets are independent
+ * and traced in parallel, each with its own random stream. Results are
+ * therefore the same for any thread count.
+ *
+ * The transport only reports where packets ended. The caller decides what
+ * absorption does: excite the atom, re-emit, or both. Feeding absorptions
+ * back as new packets reproduces radiation trapping in optically thick gas.
+ */
+class PhotonTransport {
+public:
+    /// Line profiles are treated as zero beyond this many widths from the centre
+    static constexpr float PROFILE_CUTOFF = 3.0f;
+
+    PhotonTransport() = default;
+
+    /**
+     * @brief Sets the absorber positions; setLines() must follow.
+     *
+     * @param x Absorber x coordinates.
+     * @param y Absorber y coordinates.
+     * @param z Absorber z coordinates.
+     * @param count Number of absorbers.
+     */
+    void setAbsorbers(const float* x, const float* y, const float* z, size_t count);
+
+    /**
+     * @brief Builds the energy index and a spatial grid per line group.
+     *
+     * @param lines Every line of every absorber, in any order.
+     */
+    void setLines(std::vector<AbsorptionLine> lines);
+
+    /**
+     * @brief Sets the absorber cross-section as a disc radius (position units).
+     */
+    void setCrossSectionRadius(float radius);
+
+    /**
+     * @brief Sets the Gaussian line width relative to the line energy.
+     *
+     * Takes effect at the next setLines().
+     */
+    void setLineWidth(float relativeWidth);
+
+    /// Seeds the emission directions and the per-batch random streams
+    void setSeed(uint64_t seed) { m_random = seed; }
+
+    /**
+     * @brief Queues a packet in an isotropically random direction.
+     *
+     * @param origin Where the packet starts.
+     * @param energy Photon energy in eV.
+     * @param source Index of the emitting absorber, or UINT32_MAX.
+     * @param scatterings Scatterings the photon has already had.
+     */
+    void emit(const glm::vec3& origin, float energy, uint32_t source = UINT32_MAX, uint32_t scatterings = 0);
+
+    /// Queues a packet as given
+    void emit(const PhotonPacket& packet) { m_packets.push_back(packet); }
+
+    /**
+     * @brief Traces every queued packet to its absorption or escape, then clears the queue.
+     *
+     * @param absorptions Receives one entry per absorbed packet, in queue order.
+     * @param escaped If not null, receives the packets that left every absorbing region.
+     * @return Absorbed and escaped counts.
+     */
+    PhotonTransportStats propagate(std::vector<PhotonAbsorption>& absorptions,
+                                   std::vector<PhotonPacket>* escaped = nullptr);
+
+    size_t getPendingCount() const { return m_packets.size(); }
+    size_t getLineCount() const { return m_lines.size(); }
+    size_t getGroupCount() const { return m_groups.size(); }
+    float getCrossSectionRadius() const { return m_radius; }
+    float getLineWidth() const { return m_lineWidth; }
+
+private:
+    /// Lines that share a spatial grid: sorted-index entries [begin, end)
+    struct LineGroup {
+        float lowEnergy;
+        float highEnergy;
+        uint32_t begin;
+        uint32_t end;
+        std::vector<float> x, y, z;  ///< Absorber positions, per line of the group
+        glm::vec3 boxMin;            ///< Bounds of the discs
+        glm::vec3 boxMax;
+        CellGrid grid;
+    };
+
+    std::vector<float> m_x, m_y, m_z;
+    std::vector<AbsorptionLine> m_lines;  ///< Sorted by energy
+    std::vector<LineGroup> m_groups;      ///< Sorted by energy
+    std::vector<PhotonPacket> m_packets;
+    float m_radius = 0.5f;
+    float m_lineWidth = 1e-3f;
+    uint64_t m_random = 0x243f6a8885a308d3ull;
+
+    uint64_t nextRandom();
+    /// Distance to the absorbing line within a group, or false if the packet leaves it first
+    bool traceGroup(const LineGroup& group, const PhotonPacket& packet, float maxDistance, uint64_t& state,
+                    std::vector<std::pair<float, uint32_t>>& hits, float& distance, uint32_t& line) const;
+};
+
+#endif // PHOTON_TRANSPORT_H
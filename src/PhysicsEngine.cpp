@@ -1,8 +1,49 @@
 #include "PhysicsEngine.h"
+#include "ConfigManager.h"
+#include "BorisPusher.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
+#include <string>
+
+namespace {
+// Vacuum permittivity, consistent with CoulombSolver's Coulomb constant
+const float VACUUM_PERMITTIVITY = 8.8541878e-12f;
+
+/**
+ * Reads a "x,y,z" vector from the configuration; missing or malformed keys give zero.
+ */
+glm::vec3 getConfigVector(ConfigManager& config, const std::string& key) {
+    glm::vec3 value(0.0f);
+    std::string text = config.getString(key, "");
+    if (std::sscanf(text.c_str(), "%f,%f,%f", &value.x, &value.y, &value.z) != 3) return glm::vec3(0.0f);
+    return value;
+}
+}
 
 PhysicsEngine::PhysicsEngine() {
-    // Constructor, sub-modules are default constructed
+    // Sub-modules are default constructed; the Coulomb method comes from the configuration
+    auto& config = ConfigManager::getInstance();
+    m_usePlasmaSolver = config.getString("coulomb_solver_method", "direct") == "pic";
+    m_plasmaGridSize = config.getInt("plasma_grid_size", m_plasmaGridSize);
+    m_plasmaMinParticles = static_cast<size_t>(std::max(0, config.getInt("plasma_min_particles", 4096)));
+    // A cluster in vacuum has no periodic images; multigrid gives it open boundaries
+    m_plasmaSolver.setBoundary(config.getString("plasma_boundary", "isolated") == "periodic"
+                                   ? PlasmaBoundary::Periodic
+                                   : PlasmaBoundary::Isolated);
+    m_plasmaSolver.setMultigridTolerance(config.getFloat("plasma_tolerance", 1e-4f),
+                                         config.getInt("plasma_max_cycles", 20));
+    m_externalField.setUniform(getConfigVector(config, "external_electric_field"),
+                               getConfigVector(config, "external_magnetic_field"));
+    m_plasmaSolver.setExternalField(&m_externalField);
+    m_photonTransportEnabled = config.getBool("photon_transport", m_photonTransportEnabled);
+    m_photonTransport.setCrossSectionRadius(config.getFloat("photon_absorption_radius", 0.5f));
+    m_photonTransport.setLineWidth(config.getFloat("photon_line_width", 1e-3f));
+    m_photonDecayTime = std::max(1e-6f, config.getFloat("photon_decay_time", m_photonDecayTime));
+    m_photonMaxLevel = std::clamp(config.getInt("photon_max_level", m_photonMaxLevel), 2, 31);
+    m_reactionNetwork.setTemperature(config.getFloat("kinetics_temperature", 3000.0f));
+    m_kineticsTimeScale = config.getFloat("kinetics_time_scale", 1.0f);
 }
 
 void PhysicsEngine::addAtom(std::shared_ptr<Atom> atom) {
@@ -27,13 +68,79 @@ void PhysicsEngine::update(float deltaTime) {
         }
     }
 
-    // 2. Calculate Coulomb forces
-    std::vector<glm::vec3> forces = m_coulombSolver.calculateForces(allParticles);
-
-    // 3. Update particle positions and velocities
-    for (size_t i = 0; i < allParticles.size(); ++i) {
-        allParticles[i]->update(forces[i], deltaTime);
+    // 2. Calculate Coulomb forces (the grid solver returns nothing if its grid size is invalid)
+    std::vector<glm::vec3> forces;
+    if (m_usePlasmaSolver && allParticles.size() >= m_plasmaMinParticles) {
+        forces = m_plasmaSolver.computeForces(allParticles, m_plasmaGridSize, VACUUM_PERMITTIVITY);
     }
+    if (forces.size() != allParticles.size()) {
+        forces = m_coulombSolver.calculateForces(allParticles);
+    }
+
+    // 3. Update particle positions and velocities: Coulomb and applied electric forces
+    //    kick, applied magnetic fields rotate (Boris), in batches gathered into arrays
+    const bool external = !m_externalField.empty();
+    TaskScheduler::getInstance().parallelFor(0, allParticles.size(), [&](size_t begin, size_t end) {
+        const size_t CHUNK = BorisPusher::CHUNK;
+        float x[CHUNK], y[CHUNK], z[CHUNK], vx[CHUNK], vy[CHUNK], vz[CHUNK];
+        float ax[CHUNK], ay[CHUNK], az[CHUNK], wx[CHUNK], wy[CHUNK], wz[CHUNK];
+        for (size_t first = begin; first < end; first += CHUNK) {
+            const size_t count = std::min(CHUNK, end - first);
+            for (size_t k = 0; k < count; ++k) {
+                const Particle& particle = *allParticles[first + k];
+                x[k] = particle.getPosition().x;
+                y[k] = particle.getPosition().y;
+                z[k] = particle.getPosition().z;
+                vx[k] = particle.getVelocity().x;
+                vy[k] = particle.getVelocity().y;
+                vz[k] = particle.getVelocity().z;
+            }
+            if (external) {
+                m_externalField.evaluate(count, x, y, z, ax, ay, az, wx, wy, wz);
+            } else {
+                std::fill_n(ax, count, 0.0f);
+                std::fill_n(ay, count, 0.0f);
+                std::fill_n(az, count, 0.0f);
+                std::fill_n(wx, count, 0.0f);
+                std::fill_n(wy, count, 0.0f);
+                std::fill_n(wz, count, 0.0f);
+            }
+            for (size_t k = 0; k < count; ++k) {
+                const Particle& particle = *allParticles[first + k];
+                float inverseMass = 1.0f / particle.getMass();
+                float qm = particle.getCharge() * inverseMass;
+                const glm::vec3& f = forces[first + k];
+                ax[k] = f.x * inverseMass + qm * ax[k];
+                ay[k] = f.y * inverseMass + qm * ay[k];
+                az[k] = f.z * inverseMass + qm * az[k];
+                wx[k] *= qm;
+                wy[k] *= qm;
+                wz[k] *= qm;
+            }
+
+            BorisBatch batch;
+            batch.count = count;
+            batch.x = x;
+            batch.y = y;
+            batch.z = z;
+            batch.vx = vx;
+            batch.vy = vy;
+            batch.vz = vz;
+            batch.ax = ax;
+            batch.ay = ay;
+            batch.az = az;
+            batch.wx = wx;
+            batch.wy = wy;
+            batch.wz = wz;
+            BorisPusher::push(batch, deltaTime, deltaTime);
+
+            for (size_t k = 0; k < count; ++k) {
+                Particle& particle = *allParticles[first + k];
+                particle.setPosition(glm::vec3(x[k], y[k], z[k]));
+                particle.setVelocity(glm::vec3(vx[k], vy[k], vz[k]));
+            }
+        }
+    }, 1024);
 
     // 4. (TODO) Update bond energies (e.g., if atoms move too far apart, bond breaks)
     // This would involve iterating through m_bonds in m_molecules and checking distances.
@@ -43,9 +150,130 @@ void PhysicsEngine::update(float deltaTime) {
     // This would involve checking proximity of nuclei and energy thresholds.
     // For now, these are triggered explicitly in main.cpp for demonstration.
 
-    // 6. (TODO) Check for electron jumps
-    // This would involve checking for energy input/output or explicit triggers.
-    // For now, these are triggered explicitly in main.cpp for demonstration.
+    // 6. Electron transitions driven by photons: excited electrons decay and
+    //    emit, emitted photons excite resonant atoms elsewhere
+    if (m_photonTransportEnabled) {
+        updateRadiation(deltaTime);
+    }
+
+    // 7. Bulk chemistry: species concentrations under mass-action kinetics
+    if (m_kineticsEnabled && m_reactionNetwork.getSpeciesCount() > 0 &&
+        !m_reactionNetwork.integrate(deltaTime * m_kineticsTimeScale)) {
+        std::cerr << "Warning: reaction network step size collapsed; kinetics stopped" << std::endl;
+        m_kineticsEnabled = false;
+    }
+}
+
+void PhysicsEngine::loadHydrogenOxygenKinetics(double hydrogen, double oxygen) {
+    double temperature = m_reactionNetwork.getTemperature();
+    m_reactionNetwork.clear();
+    m_reactionNetwork.addHydrogenOxygenMechanism(m_bondCalculator);
+    m_reactionNetwork.setConcentration(static_cast<uint32_t>(m_reactionNetwork.findSpecies("H2")), hydrogen);
+    m_reactionNetwork.setConcentration(static_cast<uint32_t>(m_reactionNetwork.findSpecies("O2")), oxygen);
+    m_reactionNetwork.setTemperature(temperature);
+}
+
+void PhysicsEngine::emitPhoton(const glm::vec3& origin, float energyEv, const std::shared_ptr<Atom>& source) {
+    if (!m_photonTransportEnabled || !(energyEv > 0.0f)) return;
+    uint32_t sourceIndex = UINT32_MAX;
+    auto found = std::find(m_atoms.begin(), m_atoms.end(), source);
+    if (source && found != m_atoms.end()) sourceIndex = static_cast<uint32_t>(found - m_atoms.begin());
+    m_photonTransport.emit(origin, energyEv, sourceIndex);
+}
+
+void PhysicsEngine::updateRadiation(float deltaTime) {
+    // Applied magnetic fields split each line into the normal Zeeman triplet
+    const bool external = !m_externalField.empty();
+    auto magneticFieldAt = [&](const glm::vec3& position) {
+        glm::vec3 electric(0.0f), magnetic(0.0f);
+        if (external) m_externalField.evaluate(position, electric, magnetic);
+        return magnetic;
+    };
+
+    // Spontaneous emission back to the level the electron was excited from,
+    // through a random component of the triplet
+    std::uniform_int_distribution<int> component(-1, 1);
+    size_t kept = 0;
+    for (ExcitedElectron& excited : m_excitedElectrons) {
+        excited.timeLeft -= deltaTime;
+        if (excited.timeLeft > 0.0f) {
+            m_excitedElectrons[kept++] = excited;
+            continue;
+        }
+        int level = excited.electron->getOrbitalLevel();
+        if (level <= excited.lowerLevel) continue;
+        float energy = m_orbitalModel.calculateTransitionEnergy(excited.atom->getAtomicNumber(),
+                                                                excited.lowerLevel, level);
+        if (external) {
+            energy += m_orbitalModel.calculateZeemanShift(component(m_random),
+                                                          magneticFieldAt(excited.atom->getPosition()));
+        }
+        excited.electron->setOrbitalLevel(excited.lowerLevel);
+        bool sameAtom = excited.atomIndex < m_atoms.size() && m_atoms[excited.atomIndex] == excited.atom;
+        m_photonTransport.emit(excited.atom->getPosition(), energy, sameAtom ? excited.atomIndex : UINT32_MAX);
+    }
+    m_excitedElectrons.resize(kept);
+    if (m_photonTransport.getPendingCount() == 0) return;
+
+    // Every atom absorbs from each occupied level to every level above it; in
+    // a field, through three components of a third of the strength each
+    std::vector<float> x(m_atoms.size()), y(m_atoms.size()), z(m_atoms.size());
+    std::vector<glm::vec3> fields(m_atoms.size(), glm::vec3(0.0f));
+    std::vector<AbsorptionLine> lines;
+    for (size_t i = 0; i < m_atoms.size(); ++i) {
+        const Atom& atom = *m_atoms[i];
+        x[i] = atom.getPosition().x;
+        y[i] = atom.getPosition().y;
+        z[i] = atom.getPosition().z;
+        fields[i] = magneticFieldAt(atom.getPosition());
+        const bool split = glm::dot(fields[i], fields[i]) > 0.0f;
+        uint32_t occupied = 0;
+        for (const auto& electron : atom.getElectrons()) {
+            int level = electron->getOrbitalLevel();
+            if (level >= 1 && level < m_photonMaxLevel) occupied |= 1u << level;
+        }
+        for (int lower = 1; lower < m_photonMaxLevel; ++lower) {
+            if (!(occupied & (1u << lower))) continue;
+            for (int upper = lower + 1; upper <= m_photonMaxLevel; ++upper) {
+                float energy = m_orbitalModel.calculateTransitionEnergy(atom.getAtomicNumber(), lower, upper);
+                for (int deltaM = split ? -1 : 0; deltaM <= (split ? 1 : 0); ++deltaM) {
+                    lines.push_back({energy + m_orbitalModel.calculateZeemanShift(deltaM, fields[i]),
+                                     static_cast<uint32_t>(i), static_cast<uint16_t>(lower),
+                                     static_cast<uint16_t>(upper), split ? 1.0f / 3.0f : 1.0f});
+                }
+            }
+        }
+    }
+    m_photonTransport.setAbsorbers(x.data(), y.data(), z.data(), m_atoms.size());
+    m_photonTransport.setLines(std::move(lines));
+
+    PhotonTransportStats stats = m_photonTransport.propagate(m_photonAbsorptions);
+    m_photonTotals.absorbed += stats.absorbed;
+    m_photonTotals.escaped += stats.escaped;
+    m_photonTotals.pathLength += stats.pathLength;
+
+    const float tolerance = PhotonTransport::PROFILE_CUTOFF * m_photonTransport.getLineWidth();
+    std::exponential_distribution<float> lifetime(1.0f / m_photonDecayTime);
+    for (const PhotonAbsorption& absorption : m_photonAbsorptions) {
+        const auto& atom = m_atoms[absorption.line.absorber];
+        std::shared_ptr<Electron> electron;
+        for (const auto& candidate : atom->getElectrons()) {
+            if (candidate->getOrbitalLevel() == absorption.line.lowerLevel) {
+                electron = candidate;
+                break;
+            }
+        }
+        if (electron && m_orbitalModel.absorbPhoton(electron, atom, absorption.packet.energy,
+                                                    absorption.line.upperLevel, tolerance,
+                                                    fields[absorption.line.absorber])) {
+            m_excitedElectrons.push_back({atom, electron, absorption.line.absorber, absorption.line.lowerLevel,
+                                          lifetime(m_random)});
+        } else {
+            // An earlier photon in this batch already took the electron; scatter this one
+            m_photonTransport.emit(absorption.packet.position, absorption.packet.energy, absorption.line.absorber,
+                                   absorption.packet.scatterings + 1);
+        }
+    }
 }
 
 
@@ -3,11 +3,16 @@
 
 #include <vector>
 #include <memory>
+#include <random>
 #include "Particle.h"
 #include "Atom.h"
 #include "Molecule.h"
 #include "Bond.h"
 #include "CoulombSolver.h"
+#include "ExternalField.h"
+#include "PlasmaSolver.h"
+#include "PhotonTransport.h"
+#include "ReactionNetwork.h"
 #include "BondCalculator.h"
 #include "NuclearReactor.h"
 #include "OrbitalModel.h"
@@ -63,12 +68,112 @@ public:
      */
     const std::vector<std::shared_ptr<Molecule>>& getMolecules() const { return m_molecules; }
 
+    /**
+     * @brief Gets the applied electric and magnetic fields, for adding sources.
+     *
+     * Charged particles are advanced with the Boris scheme, so strong magnetic
+     * fields stay stable at the engine's time step.
+     *
+     * @return The external field sources.
+     */
+    ExternalField& getExternalField() { return m_externalField; }
+    const ExternalField& getExternalField() const { return m_externalField; }
+
+    /**
+     * @brief Emits a photon that travels to the atoms around it.
+     *
+     * The photon is traced at the next update(). An atom with a matching
+     * transition from an occupied level absorbs it, and the absorbing
+     * electron is excited through OrbitalModel. The electron then decays
+     * after a random lifetime and re-emits. In optically thick gas the
+     * photon is trapped this way for many absorptions before it escapes.
+     *
+     * @param origin Where the photon starts.
+     * @param energyEv Photon energy in eV.
+     * @param source The emitting atom, which does not reabsorb the photon; may be null.
+     */
+    void emitPhoton(const glm::vec3& origin, float energyEv, const std::shared_ptr<Atom>& source = nullptr);
+
+    /**
+     * @brief Gets the photon packets absorbed and escaped since the engine was created.
+     *
+     * @return The running totals.
+     */
+    const PhotonTransportStats& getPhotonTotals() const { return m_photonTotals; }
+
+    /**
+     * @brief Gets the number of electrons excited by absorbed photons that have not decayed yet.
+     *
+     * @return The excited electron count.
+     */
+    size_t getExcitedElectronCount() const { return m_excitedElectrons.size(); }
+
+    /**
+     * @brief Gets the bulk reaction network.
+     *
+     * For bulk chemistry, species concentrations evolve under mass-action
+     * kinetics instead of atoms being tracked one by one. While kinetics
+     * is enabled, update() advances the network by deltaTime times
+     * kinetics_time_scale.
+     *
+     * @return The reaction network.
+     */
+    ReactionNetwork& getReactionNetwork() { return m_reactionNetwork; }
+    const ReactionNetwork& getReactionNetwork() const { return m_reactionNetwork; }
+
+    void setKineticsEnabled(bool enabled) { m_kineticsEnabled = enabled; }
+    bool isKineticsEnabled() const { return m_kineticsEnabled; }
+
+    /**
+     * @brief Replaces the network with the hydrogen–oxygen mechanism.
+     *
+     * Activation energies come from this engine's bond energies.
+     *
+     * @param hydrogen Initial H2 concentration in mol/L.
+     * @param oxygen Initial O2 concentration in mol/L.
+     */
+    void loadHydrogenOxygenKinetics(double hydrogen, double oxygen);
+
 private:
     std::vector<std::shared_ptr<Atom>> m_atoms;
     std::vector<std::shared_ptr<Molecule>> m_molecules;
 
+    // Coulomb forces come from the particle-in-cell grid instead of all pairs
+    // ("coulomb_solver_method=pic") once there are enough particles to pay off
+    bool m_usePlasmaSolver = false;
+    int m_plasmaGridSize = 64;
+    size_t m_plasmaMinParticles = 4096;
+
+    // Applied fields, starting from the uniform ones in the configuration
+    ExternalField m_externalField;
+
+    // Radiative transfer between atoms; photons cross the scene within one update
+    struct ExcitedElectron {
+        std::shared_ptr<Atom> atom;
+        std::shared_ptr<Electron> electron;
+        uint32_t atomIndex;
+        int lowerLevel;
+        float timeLeft;
+    };
+    PhotonTransport m_photonTransport;
+    bool m_photonTransportEnabled = true;
+    int m_photonMaxLevel = 6;
+    float m_photonDecayTime = 0.1f;
+    std::vector<ExcitedElectron> m_excitedElectrons;
+    std::vector<PhotonAbsorption> m_photonAbsorptions;
+    PhotonTransportStats m_photonTotals;
+    std::mt19937 m_random;
+
+    void updateRadiation(float deltaTime);
+
+    // Bulk chemistry, off until a mechanism is loaded
+    ReactionNetwork m_reactionNetwork;
+    bool m_kineticsEnabled = false;
+    double m_kineticsTimeScale = 1.0;
+
     // Physics sub-modules
     CoulombSolver m_coulombSolver;
+    PlasmaSolver m_plasmaSolver;
     BondCalculator m_bondCalculator;
     NuclearReactor m_nuclearReactor;
     OrbitalModel m_orbitalModel;
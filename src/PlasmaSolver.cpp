@@ -0,0 +1,580 @@
+#include "PlasmaSolver.h"
+#include "BorisPusher.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+
+namespace {
+const double PI = 3.14159265358979323846;
+
+double seconds(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+}
+
+/**
+ * Cloud-in-cell stencil: the two grid indices and weights along each axis
+ * for a point, wrapped into a periodic grid or clamped into a bounded one.
+ */
+struct Stencil {
+    size_t index[3][2];
+    float weight[3][2];
+};
+
+inline void cicStencil(float x, float y, float z, const glm::vec3& lo, const glm::vec3& inverseCell,
+                       const int dims[3], bool periodic, Stencil& s) {
+    float u[3] = {(x - lo.x) * inverseCell.x, (y - lo.y) * inverseCell.y, (z - lo.z) * inverseCell.z};
+    for (int a = 0; a < 3; ++a) {
+        if (!periodic) u[a] = std::clamp(u[a], 0.0f, (dims[a] - 1) * 0.99999f);
+        float cell = std::floor(u[a]);
+        float f = u[a] - cell;
+        int i = static_cast<int>(cell);
+        if (i < 0 || i >= dims[a]) i = (i % dims[a] + dims[a]) % dims[a];
+        s.index[a][0] = i;
+        s.index[a][1] = i + 1 == dims[a] ? 0 : i + 1;
+        s.weight[a][0] = 1.0f - f;
+        s.weight[a][1] = f;
+    }
+}
+
+inline float wrap(float value, float lo, float size) {
+    float t = value - lo;
+    if (t < 0.0f || t >= size) t -= size * std::floor(t / size);
+    // Rounding can land exactly on the upper edge
+    return lo + (t >= size ? 0.0f : t);
+}
+}
+
+PlasmaSolver::PlasmaSolver() {}
+
+bool PlasmaSolver::configure(const glm::vec3& boxLo, const glm::vec3& boxSize, int nx, int ny, int nz,
+                             float epsilon0) {
+    const bool periodic = m_boundary == PlasmaBoundary::Periodic;
+    if (!m_fft.setSize(nx, ny, nz)) return false;
+    const int extra = periodic ? 0 : 1;
+    bool resized = !m_configured || m_boundary != m_configuredBoundary || nx + extra != m_dims[0] ||
+                   ny + extra != m_dims[1] || nz + extra != m_dims[2] || boxSize != m_boxSize ||
+                   epsilon0 != m_epsilon0;
+    m_boxLo = boxLo;
+    m_boxSize = boxSize;
+    m_dims[0] = nx + extra;
+    m_dims[1] = ny + extra;
+    m_dims[2] = nz + extra;
+    m_cellSize = boxSize / glm::vec3(nx, ny, nz);
+    m_epsilon0 = epsilon0;
+    m_stepsSinceSort = m_sortInterval;
+    if (!resized) return true;
+    m_configured = true;
+    m_configuredBoundary = m_boundary;
+
+    const size_t points = gridPointCount();
+    m_density.assign(points, 0.0f);
+    m_potential.assign(points, 0.0f);
+    m_fieldX.assign(points, 0.0f);
+    m_fieldY.assign(points, 0.0f);
+    m_fieldZ.assign(points, 0.0f);
+    m_privateDensity.clear();
+    m_slotUsed.clear();
+
+    // Centred differences, one-sided on the faces of a bounded grid
+    for (int a = 0; a < 3; ++a) {
+        int n = m_dims[a];
+        m_lower[a].resize(n);
+        m_upper[a].resize(n);
+        m_differenceScale[a].resize(n);
+        for (int i = 0; i < n; ++i) {
+            int lower = i - 1, upper = i + 1;
+            if (periodic) {
+                lower = (lower + n) % n;
+                upper %= n;
+            } else {
+                lower = std::max(lower, 0);
+                upper = std::min(upper, n - 1);
+            }
+            int distance = periodic ? 2 : upper - lower;
+            m_lower[a][i] = lower;
+            m_upper[a][i] = upper;
+            m_differenceScale[a][i] = -1.0f / (distance * m_cellSize[a]);
+        }
+    }
+
+    if (!periodic) {
+        m_spectrum.clear();
+        m_inverseLaplacian.clear();
+        m_rhs.assign(points, 0.0f);
+        return m_multigrid.configure(m_dims[0], m_dims[1], m_dims[2], m_cellSize);
+    }
+
+    // Eigenvalues of the 7-point Laplacian: K² = Σ (2 sin(π f / n) / h)²
+    m_spectrum.resize(points);
+    std::vector<float> k2[3];
+    for (int a = 0; a < 3; ++a) {
+        k2[a].resize(m_dims[a]);
+        for (int i = 0; i < m_dims[a]; ++i) {
+            double s = 2.0 * std::sin(PI * m_fft.frequency(a, i) / m_dims[a]) / m_cellSize[a];
+            k2[a][i] = static_cast<float>(s * s);
+        }
+    }
+    m_inverseLaplacian.resize(points);
+    for (int z = 0; z < nz; ++z) {
+        for (int y = 0; y < ny; ++y) {
+            for (int x = 0; x < nx; ++x) {
+                float sum = k2[0][x] + k2[1][y] + k2[2][z];
+                m_inverseLaplacian[(size_t(z) * ny + y) * nx + x] = sum > 0.0f ? 1.0f / (epsilon0 * sum) : 0.0f;
+            }
+        }
+    }
+    return true;
+}
+
+int PlasmaSolver::addSpecies(float charge, float mass, float weight) {
+    if (m_species.size() >= 256) return -1;
+    m_species.push_back({charge, mass, weight});
+    return static_cast<int>(m_species.size() - 1);
+}
+
+void PlasmaSolver::addParticle(int species, const glm::vec3& position, const glm::vec3& velocity) {
+    m_particles.x.push_back(position.x);
+    m_particles.y.push_back(position.y);
+    m_particles.z.push_back(position.z);
+    m_particles.vx.push_back(velocity.x);
+    m_particles.vy.push_back(velocity.y);
+    m_particles.vz.push_back(velocity.z);
+    m_particles.species.push_back(static_cast<uint8_t>(species));
+    m_staggered = false;
+    m_stepsSinceSort = m_sortInterval;
+}
+
+void PlasmaSolver::reserve(size_t count) {
+    for (auto* v : {&m_particles.x, &m_particles.y, &m_particles.z, &m_particles.vx, &m_particles.vy, &m_particles.vz}) {
+        v->reserve(count);
+    }
+    m_particles.species.reserve(count);
+}
+
+void PlasmaSolver::clearParticles() {
+    m_particles = PlasmaParticles();
+    m_sortScratch = PlasmaParticles();
+    m_staggered = false;
+}
+
+// ─── Sorting ────────────────────────────────────────────────────────────────
+
+void PlasmaSolver::sortByCell() {
+    const size_t count = m_particles.size();
+    const size_t points = gridPointCount();
+    const glm::vec3 inverseCell = 1.0f / m_cellSize;
+    const bool periodic = m_configuredBoundary == PlasmaBoundary::Periodic;
+    std::vector<uint32_t> keys(count);
+    TaskScheduler::getInstance().parallelFor(0, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Stencil s;
+            cicStencil(m_particles.x[i], m_particles.y[i], m_particles.z[i], m_boxLo, inverseCell, m_dims, periodic, s);
+            keys[i] = static_cast<uint32_t>((s.index[2][0] * m_dims[1] + s.index[1][0]) * m_dims[0] + s.index[0][0]);
+        }
+    }, TILE_PARTICLES);
+
+    // Counting sort; stable, so particles keep their relative order within a cell
+    m_cellCounts.assign(points + 1, 0);
+    for (uint32_t key : keys) ++m_cellCounts[key + 1];
+    for (size_t c = 0; c < points; ++c) m_cellCounts[c + 1] += m_cellCounts[c];
+    std::vector<uint32_t> destination(count);
+    for (size_t i = 0; i < count; ++i) destination[i] = m_cellCounts[keys[i]]++;
+
+    PlasmaParticles& out = m_sortScratch;
+    out.x.resize(count);
+    out.y.resize(count);
+    out.z.resize(count);
+    out.vx.resize(count);
+    out.vy.resize(count);
+    out.vz.resize(count);
+    out.species.resize(count);
+    TaskScheduler::getInstance().parallelFor(0, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            uint32_t d = destination[i];
+            out.x[d] = m_particles.x[i];
+            out.y[d] = m_particles.y[i];
+            out.z[d] = m_particles.z[i];
+            out.vx[d] = m_particles.vx[i];
+            out.vy[d] = m_particles.vy[i];
+            out.vz[d] = m_particles.vz[i];
+            out.species[d] = m_particles.species[i];
+        }
+    }, TILE_PARTICLES);
+    std::swap(m_particles, m_sortScratch);
+}
+
+// ─── Deposition and field solve ─────────────────────────────────────────────
+
+void PlasmaSolver::deposit() {
+    TaskScheduler& scheduler = TaskScheduler::getInstance();
+    const size_t points = gridPointCount();
+    const size_t slots = scheduler.getWorkerCount() + 1;
+    if (m_privateDensity.size() != slots) {
+        m_privateDensity.assign(slots, std::vector<float>(points, 0.0f));
+        m_slotUsed.assign(slots, 0);
+    }
+
+    const float inverseVolume = 1.0f / (m_cellSize.x * m_cellSize.y * m_cellSize.z);
+    std::vector<float> speciesCharge(m_species.size());
+    for (size_t s = 0; s < m_species.size(); ++s) {
+        speciesCharge[s] = m_species[s].charge * m_species[s].weight * inverseVolume;
+    }
+    const glm::vec3 inverseCell = 1.0f / m_cellSize;
+    const size_t nx = m_dims[0], nxy = size_t(m_dims[0]) * m_dims[1];
+    const bool periodic = m_configuredBoundary == PlasmaBoundary::Periodic;
+
+    scheduler.parallelFor(0, m_particles.size(), [&](size_t begin, size_t end) {
+        // Calling thread is slot 0, workers follow
+        size_t slot = static_cast<size_t>(scheduler.getCurrentWorkerIndex() + 1);
+        float* grid = m_privateDensity[slot].data();
+        m_slotUsed[slot] = 1;
+        for (size_t i = begin; i < end; ++i) {
+            Stencil s;
+            cicStencil(m_particles.x[i], m_particles.y[i], m_particles.z[i], m_boxLo, inverseCell, m_dims, periodic, s);
+            float q = speciesCharge[m_particles.species[i]];
+            for (int c = 0; c < 2; ++c) {
+                for (int b = 0; b < 2; ++b) {
+                    size_t row = s.index[2][c] * nxy + s.index[1][b] * nx;
+                    float w = q * s.weight[2][c] * s.weight[1][b];
+                    grid[row + s.index[0][0]] += w * s.weight[0][0];
+                    grid[row + s.index[0][1]] += w * s.weight[0][1];
+                }
+            }
+        }
+    }, TILE_PARTICLES);
+
+    // Sum the private grids and clear them for the next deposit
+    std::vector<float*> used;
+    for (size_t slot = 0; slot < slots; ++slot) {
+        if (m_slotUsed[slot]) used.push_back(m_privateDensity[slot].data());
+        m_slotUsed[slot] = 0;
+    }
+    scheduler.parallelFor(0, points, [&](size_t begin, size_t end) {
+        for (size_t g = begin; g < end; ++g) {
+            float sum = 0.0f;
+            for (float* grid : used) {
+                sum += grid[g];
+                grid[g] = 0.0f;
+            }
+            m_density[g] = sum;
+        }
+    }, 16384);
+}
+
+void PlasmaSolver::solve() {
+    if (m_configuredBoundary == PlasmaBoundary::Periodic) {
+        solvePeriodic();
+    } else {
+        solveIsolated();
+    }
+
+    // E = -∇φ by finite differences
+    const int nx = m_dims[0], ny = m_dims[1], nz = m_dims[2];
+    TaskScheduler::getInstance().parallelFor(0, size_t(ny) * nz, [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; ++row) {
+            int y = static_cast<int>(row % ny), z = static_cast<int>(row / ny);
+            size_t yMinus = (size_t(z) * ny + m_lower[1][y]) * nx;
+            size_t yPlus = (size_t(z) * ny + m_upper[1][y]) * nx;
+            size_t zMinus = (size_t(m_lower[2][z]) * ny + y) * nx;
+            size_t zPlus = (size_t(m_upper[2][z]) * ny + y) * nx;
+            float scaleY = m_differenceScale[1][y], scaleZ = m_differenceScale[2][z];
+            size_t base = row * nx;
+            for (int x = 0; x < nx; ++x) {
+                m_fieldX[base + x] = m_differenceScale[0][x] *
+                                     (m_potential[base + m_upper[0][x]] - m_potential[base + m_lower[0][x]]);
+                m_fieldY[base + x] = scaleY * (m_potential[yPlus + x] - m_potential[yMinus + x]);
+                m_fieldZ[base + x] = scaleZ * (m_potential[zPlus + x] - m_potential[zMinus + x]);
+            }
+        }
+    }, 16);
+}
+
+void PlasmaSolver::solvePeriodic() {
+    TaskScheduler& scheduler = TaskScheduler::getInstance();
+    const size_t points = gridPointCount();
+    scheduler.parallelFor(0, points, [&](size_t begin, size_t end) {
+        for (size_t g = begin; g < end; ++g) m_spectrum[g] = FFT3D::Complex(m_density[g], 0.0f);
+    }, 16384);
+    m_fft.forward(m_spectrum);
+    // -K² φ = -ρ / ε0; the k = 0 mode is the neutralizing background
+    scheduler.parallelFor(0, points, [&](size_t begin, size_t end) {
+        for (size_t g = begin; g < end; ++g) m_spectrum[g] *= m_inverseLaplacian[g];
+    }, 16384);
+    m_fft.inverse(m_spectrum);
+    scheduler.parallelFor(0, points, [&](size_t begin, size_t end) {
+        for (size_t g = begin; g < end; ++g) m_potential[g] = m_spectrum[g].real();
+    }, 16384);
+}
+
+void PlasmaSolver::solveIsolated() {
+    const int nx = m_dims[0], ny = m_dims[1], nz = m_dims[2];
+    const glm::vec3 center = m_boxLo + 0.5f * m_boxSize;
+    const double volume = double(m_cellSize.x) * m_cellSize.y * m_cellSize.z;
+
+    // Monopole, dipole and traceless quadrupole of the grid charge about the box centre
+    std::vector<std::array<double, 10>> planeMoments(nz);
+    TaskScheduler::getInstance().parallelFor(0, nz, [&](size_t firstZ, size_t lastZ) {
+        for (size_t z = firstZ; z < lastZ; ++z) {
+            std::array<double, 10> m{};
+            for (int y = 0; y < ny; ++y) {
+                for (int x = 0; x < nx; ++x) {
+                    double q = m_density[(z * ny + y) * nx + x] * volume;
+                    if (q == 0.0) continue;
+                    glm::dvec3 r = glm::dvec3(m_boxLo) + glm::dvec3(x, y, z) * glm::dvec3(m_cellSize) -
+                                   glm::dvec3(center);
+                    double r2 = glm::dot(r, r);
+                    m[0] += q;
+                    m[1] += q * r.x;
+                    m[2] += q * r.y;
+                    m[3] += q * r.z;
+                    m[4] += q * (3.0 * r.x * r.x - r2);
+                    m[5] += q * (3.0 * r.y * r.y - r2);
+                    m[6] += q * (3.0 * r.z * r.z - r2);
+                    m[7] += q * 3.0 * r.x * r.y;
+                    m[8] += q * 3.0 * r.x * r.z;
+                    m[9] += q * 3.0 * r.y * r.z;
+                }
+            }
+            planeMoments[z] = m;
+        }
+    }, 1);
+    std::array<double, 10> m{};
+    for (const auto& plane : planeMoments) {
+        for (int k = 0; k < 10; ++k) m[k] += plane[k];
+    }
+
+    const double coulomb = 1.0 / (4.0 * PI * m_epsilon0);
+    m_multigrid.setBoundary([&](int x, int y, int z) {
+        glm::dvec3 r = glm::dvec3(m_boxLo) + glm::dvec3(x, y, z) * glm::dvec3(m_cellSize) - glm::dvec3(center);
+        double r2 = glm::dot(r, r);
+        double inverse = 1.0 / std::sqrt(r2);
+        double inverse3 = inverse / r2;
+        double quadrupole = m[4] * r.x * r.x + m[5] * r.y * r.y + m[6] * r.z * r.z +
+                            2.0 * (m[7] * r.x * r.y + m[8] * r.x * r.z + m[9] * r.y * r.z);
+        return static_cast<float>(coulomb * (m[0] * inverse + (m[1] * r.x + m[2] * r.y + m[3] * r.z) * inverse3 +
+                                             0.5 * quadrupole * inverse3 / r2));
+    });
+
+    // ∇²φ = -ρ / ε0; the interior still holds the previous step's solution
+    const float scale = -1.0f / m_epsilon0;
+    const size_t points = gridPointCount();
+    TaskScheduler::getInstance().parallelFor(0, points, [&](size_t begin, size_t end) {
+        for (size_t g = begin; g < end; ++g) m_rhs[g] = scale * m_density[g];
+    }, 16384);
+    m_multigridCycles = m_multigrid.solve(m_rhs, m_tolerance, m_maxCycles);
+    m_potential = m_multigrid.getPotential();
+}
+
+void PlasmaSolver::computeFields() {
+    if (!m_configured) return;
+    auto start = std::chrono::steady_clock::now();
+    deposit();
+    m_timings.deposit = seconds(start);
+    start = std::chrono::steady_clock::now();
+    solve();
+    m_timings.solve = seconds(start);
+}
+
+glm::vec3 PlasmaSolver::sampleField(const glm::vec3& position) const {
+    if (!m_configured) return glm::vec3(0.0f);
+    Stencil s;
+    const bool periodic = m_configuredBoundary == PlasmaBoundary::Periodic;
+    cicStencil(position.x, position.y, position.z, m_boxLo, 1.0f / m_cellSize, m_dims, periodic, s);
+    const size_t nx = m_dims[0], nxy = size_t(m_dims[0]) * m_dims[1];
+    glm::vec3 field(0.0f);
+    for (int c = 0; c < 2; ++c) {
+        for (int b = 0; b < 2; ++b) {
+            for (int a = 0; a < 2; ++a) {
+                size_t g = s.index[2][c] * nxy + s.index[1][b] * nx + s.index[0][a];
+                float w = s.weight[2][c] * s.weight[1][b] * s.weight[0][a];
+                field += w * glm::vec3(m_fieldX[g], m_fieldY[g], m_fieldZ[g]);
+            }
+        }
+    }
+    return field;
+}
+
+// ─── Push ───────────────────────────────────────────────────────────────────
+
+void PlasmaSolver::push(float velocityStep, float positionStep) {
+    std::vector<float> chargeOverMass(m_species.size());
+    for (size_t s = 0; s < m_species.size(); ++s) chargeOverMass[s] = m_species[s].charge / m_species[s].mass;
+    const glm::vec3 inverseCell = 1.0f / m_cellSize;
+    const size_t nx = m_dims[0], nxy = size_t(m_dims[0]) * m_dims[1];
+    const bool periodic = m_configuredBoundary == PlasmaBoundary::Periodic;
+    const ExternalField* external = m_externalField && !m_externalField->empty() ? m_externalField : nullptr;
+
+    TaskScheduler::getInstance().parallelFor(0, m_particles.size(), [&](size_t begin, size_t end) {
+        PlasmaParticles& p = m_particles;
+        float ax[BorisPusher::CHUNK], ay[BorisPusher::CHUNK], az[BorisPusher::CHUNK];
+        float wx[BorisPusher::CHUNK], wy[BorisPusher::CHUNK], wz[BorisPusher::CHUNK];
+        for (size_t first = begin; first < end; first += BorisPusher::CHUNK) {
+            const size_t count = std::min(BorisPusher::CHUNK, end - first);
+            if (external) {
+                external->evaluate(count, &p.x[first], &p.y[first], &p.z[first], ax, ay, az, wx, wy, wz);
+            } else {
+                std::fill_n(ax, count, 0.0f);
+                std::fill_n(ay, count, 0.0f);
+                std::fill_n(az, count, 0.0f);
+                std::fill_n(wx, count, 0.0f);
+                std::fill_n(wy, count, 0.0f);
+                std::fill_n(wz, count, 0.0f);
+            }
+
+            // Gather the grid field and turn the fields into accelerations
+            for (size_t k = 0; k < count; ++k) {
+                size_t i = first + k;
+                Stencil s;
+                cicStencil(p.x[i], p.y[i], p.z[i], m_boxLo, inverseCell, m_dims, periodic, s);
+                glm::vec3 e(ax[k], ay[k], az[k]);
+                for (int c = 0; c < 2; ++c) {
+                    for (int b = 0; b < 2; ++b) {
+                        size_t row = s.index[2][c] * nxy + s.index[1][b] * nx;
+                        float wzy = s.weight[2][c] * s.weight[1][b];
+                        for (int a = 0; a < 2; ++a) {
+                            size_t g = row + s.index[0][a];
+                            float w = wzy * s.weight[0][a];
+                            e.x += w * m_fieldX[g];
+                            e.y += w * m_fieldY[g];
+                            e.z += w * m_fieldZ[g];
+                        }
+                    }
+                }
+                float qm = chargeOverMass[p.species[i]];
+                ax[k] = qm * e.x;
+                ay[k] = qm * e.y;
+                az[k] = qm * e.z;
+                wx[k] = qm * (wx[k] + m_magneticField.x);
+                wy[k] = qm * (wy[k] + m_magneticField.y);
+                wz[k] = qm * (wz[k] + m_magneticField.z);
+            }
+
+            BorisBatch batch;
+            batch.count = count;
+            batch.x = &p.x[first];
+            batch.y = &p.y[first];
+            batch.z = &p.z[first];
+            batch.vx = &p.vx[first];
+            batch.vy = &p.vy[first];
+            batch.vz = &p.vz[first];
+            batch.ax = ax;
+            batch.ay = ay;
+            batch.az = az;
+            batch.wx = wx;
+            batch.wy = wy;
+            batch.wz = wz;
+            BorisPusher::push(batch, velocityStep, positionStep);
+
+            if (periodic && positionStep != 0.0f) {
+                for (size_t i = first; i < first + count; ++i) {
+                    p.x[i] = wrap(p.x[i], m_boxLo.x, m_boxSize.x);
+                    p.y[i] = wrap(p.y[i], m_boxLo.y, m_boxSize.y);
+                    p.z[i] = wrap(p.z[i], m_boxLo.z, m_boxSize.z);
+                }
+            }
+        }
+    }, TILE_PARTICLES);
+}
+
+void PlasmaSolver::step(float dt) {
+    if (!m_configured) return;
+    auto start = std::chrono::steady_clock::now();
+    m_timings.sort = 0.0;
+    if (++m_stepsSinceSort >= m_sortInterval) {
+        sortByCell();
+        m_stepsSinceSort = 0;
+        m_timings.sort = seconds(start);
+    }
+    computeFields();
+    start = std::chrono::steady_clock::now();
+    if (!m_staggered) {
+        // Leapfrog needs v at t - dt/2: a backward half step without moving
+        push(-0.5f * dt, 0.0f);
+        m_staggered = true;
+    }
+    push(dt, dt);
+    m_timings.push = seconds(start);
+}
+
+// ─── Engine particles ───────────────────────────────────────────────────────
+
+std::vector<glm::vec3> PlasmaSolver::computeForces(const std::vector<std::shared_ptr<Particle>>& particles,
+                                                   int gridSize, float epsilon0) {
+    std::vector<glm::vec3> forces(particles.size(), glm::vec3(0.0f));
+    if (particles.empty()) return forces;
+
+    glm::vec3 lo(particles[0]->getPosition()), hi(lo);
+    for (const auto& particle : particles) {
+        lo = glm::min(lo, particle->getPosition());
+        hi = glm::max(hi, particle->getPosition());
+    }
+    glm::vec3 extent = hi - lo;
+    float side = std::max(std::max(extent.x, extent.y), extent.z);
+    if (!(side > 0.0f)) side = 1.0f;
+    glm::vec3 center = 0.5f * (lo + hi);
+    if (m_boundary == PlasmaBoundary::Periodic) {
+        // A margin of the particles' own size on each side
+        if (!configure(center - glm::vec3(1.5f * side), glm::vec3(3.0f * side), gridSize, gridSize, gridSize,
+                       epsilon0)) {
+            return {};
+        }
+    } else {
+        // Keep the box while the particles stay an eighth of it away from the faces and
+        // still fill a quarter of it, so the previous potential remains a good first guess
+        float boxSide = m_boxSize.x;
+        bool keep = m_configured && m_configuredBoundary == PlasmaBoundary::Isolated &&
+                    m_dims[0] == gridSize + 1 && epsilon0 == m_epsilon0 && side > 0.25f * boxSide &&
+                    glm::all(glm::greaterThanEqual(lo, m_boxLo + glm::vec3(0.125f * boxSide))) &&
+                    glm::all(glm::lessThanEqual(hi, m_boxLo + glm::vec3(0.875f * boxSide)));
+        if (!keep && !configure(center - glm::vec3(side), glm::vec3(2.0f * side), gridSize, gridSize, gridSize,
+                                epsilon0)) {
+            return {};
+        }
+    }
+
+    clearParticles();
+    m_species.clear();
+    reserve(particles.size());
+    for (const auto& particle : particles) {
+        int species = -1;
+        for (size_t s = 0; s < m_species.size(); ++s) {
+            if (m_species[s].charge == particle->getCharge() && m_species[s].mass == particle->getMass()) {
+                species = static_cast<int>(s);
+                break;
+            }
+        }
+        if (species < 0) species = addSpecies(particle->getCharge(), particle->getMass());
+        if (species < 0) return {};
+        addParticle(species, particle->getPosition(), glm::vec3(0.0f));
+    }
+    // Particles are reloaded on every call, so sorting them would not pay off
+    computeFields();
+
+    TaskScheduler::getInstance().parallelFor(0, particles.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            forces[i] = particles[i]->getCharge() * sampleField(particles[i]->getPosition());
+        }
+    }, 1024);
+    return forces;
+}
+
+// ─── Diagnostics ────────────────────────────────────────────────────────────
+
+double PlasmaSolver::getKineticEnergy() const {
+    double energy = 0.0;
+    for (size_t i = 0; i < m_particles.size(); ++i) {
+        const PlasmaSpecies& s = m_species[m_particles.species[i]];
+        double v2 = double(m_particles.vx[i]) * m_particles.vx[i] + double(m_particles.vy[i]) * m_particles.vy[i] +
+                    double(m_particles.vz[i]) * m_particles.vz[i];
+        energy += 0.5 * s.mass * s.weight * v2;
+    }
+    return energy;
+}
+
+double PlasmaSolver::getFieldEnergy() const {
+    double energy = 0.0;
+    for (size_t g = 0; g < m_density.size(); ++g) energy += double(m_density[g]) * m_potential[g];
+    return 0.5 * energy * m_cellSize.x * m_cellSize.y * m_cellSize.z;
+}
@@ -0,0 +1,241 @@
+#ifndef PLASMA_SOLVER_H
+#define PLASMA_SOLVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ExternalField.h"
+#include "FFT3D.h"
+#include "MultigridPoisson.h"
+#include "Particle.h"
+
+/**
+ * @brief A kind of macro-particle: charge and mass of one real particle, and how many it stands for.
+ */
+struct PlasmaSpecies {
+    float charge;
+    float mass;
+    float weight;   ///< Real particles per macro-particle
+};
+
+/**
+ * @brief How the field solve treats the edges of the box.
+ */
+enum class PlasmaBoundary {
+    Periodic,   ///< FFT solve; the box tiles space, with a neutralizing background
+    Isolated    ///< Multigrid solve; the potential on the faces comes from a multipole expansion
+};
+
+/**
+ * @brief Macro-particles as arrays, kept sorted by cell between sorts.
+ */
+struct PlasmaParticles {
+    std::vector<float> x, y, z;
+    std::vector<float> vx, vy, vz;
+    std::vector<uint8_t> species;
+
+    size_t size() const { return x.size(); }
+};
+
+/**
+ * @brief Time spent in each phase of the last step, in seconds.
+ */
+struct PlasmaTimings {
+    double sort = 0.0;
+    double deposit = 0.0;
+    double solve = 0.0;
+    double push = 0.0;
+};
+
+/**
+ * @brief Electrostatic particle-in-cell solver for large electron/ion populations.
+ *
+ * Charges are deposited onto a periodic grid with cloud-in-cell (trilinear)
+ * weights. Poisson's equation is solved by FFT, using the eigenvalues of the
+ * discrete Laplacian so the solve matches the finite-difference field
+ * E = -∇φ. The field is gathered back with the same weights, so a particle
+ * exerts no force on itself. Each step costs O(N + G log G) instead of O(N²).
+ *
+ * Particles are counting-sorted by cell every few steps and processed in
+ * tiles of consecutive particles, so each tile touches a compact patch of the
+ * grid. Deposition goes into one private grid per thread, which are summed
+ * afterwards. This costs one grid of memory per thread but needs no atomics.
+ * step() advances velocities with the BorisPusher in the self-consistent E
+ * plus an optional uniform B and ExternalField. Velocities are staggered
+ * half a step behind positions (leapfrog).
+ *
+ * With PlasmaBoundary::Periodic the grid is periodic with a neutralizing
+ * background. With PlasmaBoundary::Isolated the grid is bounded by the box
+ * faces. The potential there is set from the monopole, dipole and quadrupole
+ * moments of the deposited charge, and a MultigridPoisson solve fills the
+ * interior, warm-started from the previous step. Particles outside an
+ * isolated box deposit onto its faces and are not wrapped.
+ */
+class PlasmaSolver {
+public:
+    /// Particles per parallel task
+    static constexpr size_t TILE_PARTICLES = 4096;
+
+    PlasmaSolver();
+
+    /**
+     * @brief Sets the grid for the current boundary mode; particles are kept.
+     *
+     * An isolated grid has a node on every face, so it holds one more point
+     * per side than it has cells. Reconfiguring an isolated grid of the same
+     * shape and size only moves it and keeps the last potential as the next
+     * first guess.
+     *
+     * @param boxLo Minimum corner of the box.
+     * @param boxSize Box edge lengths.
+     * @param nx Grid cells along x (power of two).
+     * @param ny Grid cells along y (power of two).
+     * @param nz Grid cells along z (power of two).
+     * @param epsilon0 Vacuum permittivity in the caller's units.
+     * @return False if a side is not a power of two.
+     */
+    bool configure(const glm::vec3& boxLo, const glm::vec3& boxSize, int nx, int ny, int nz, float epsilon0);
+
+    /**
+     * @brief Registers a species.
+     *
+     * @return The species index for addParticle(), or -1 once 256 species exist.
+     */
+    int addSpecies(float charge, float mass, float weight = 1.0f);
+
+    /**
+     * @brief Adds a macro-particle; velocities are re-staggered on the next step.
+     */
+    void addParticle(int species, const glm::vec3& position, const glm::vec3& velocity);
+
+    void reserve(size_t count);
+    void clearParticles();
+
+    /**
+     * @brief Advances every particle by one time step.
+     *
+     * @param dt The time step.
+     */
+    void step(float dt);
+
+    /**
+     * @brief Deposits the charges and solves for the field without moving anything.
+     */
+    void computeFields();
+
+    /**
+     * @brief Interpolates the field at a point with the deposition weights.
+     *
+     * @param position The point.
+     * @return The electric field there.
+     */
+    glm::vec3 sampleField(const glm::vec3& position) const;
+
+    /**
+     * @brief Computes electrostatic forces on engine particles through the grid.
+     *
+     * The box is fitted around the particles with a margin on every side: the
+     * particles' own size for periodic grids, to keep the images far away, and
+     * half of it for isolated ones. An isolated box stays put while the
+     * particles fit, so the multigrid warm start stays valid. Each distinct
+     * charge and mass becomes a species.
+     *
+     * @param particles The particles.
+     * @param gridSize Grid cells per side (power of two).
+     * @param epsilon0 Vacuum permittivity in the engine's units.
+     * @return The force on each particle.
+     */
+    std::vector<glm::vec3> computeForces(const std::vector<std::shared_ptr<Particle>>& particles, int gridSize,
+                                         float epsilon0);
+
+    /**
+     * @brief Chooses the field solve; the next configure() applies it.
+     */
+    void setBoundary(PlasmaBoundary boundary) { m_boundary = boundary; }
+    PlasmaBoundary getBoundary() const { return m_boundary; }
+
+    /**
+     * @brief Sets when the isolated (multigrid) solve stops.
+     *
+     * @param tolerance Relative residual to reach.
+     * @param maxCycles Upper bound on V-cycles per solve.
+     */
+    void setMultigridTolerance(float tolerance, int maxCycles) {
+        m_tolerance = tolerance;
+        m_maxCycles = maxCycles;
+    }
+
+    /// V-cycles used by the last isolated solve
+    int getMultigridCycles() const { return m_multigridCycles; }
+
+    void setMagneticField(const glm::vec3& field) { m_magneticField = field; }
+
+    /**
+     * @brief Adds applied fields to the push; the solver does not own them.
+     *
+     * @param field The field sources, or nullptr for none.
+     */
+    void setExternalField(const ExternalField* field) { m_externalField = field; }
+    void setSortInterval(int steps) { m_sortInterval = steps > 0 ? steps : 1; }
+
+    const PlasmaParticles& getParticles() const { return m_particles; }
+    const std::vector<PlasmaSpecies>& getSpecies() const { return m_species; }
+    const std::vector<float>& getChargeDensity() const { return m_density; }
+    const std::vector<float>& getPotential() const { return m_potential; }
+    const PlasmaTimings& getTimings() const { return m_timings; }
+
+    /// Σ ½ m w v², with v half a step behind the positions
+    double getKineticEnergy() const;
+
+    /// ½ Σ ρ φ dV over the grid
+    double getFieldEnergy() const;
+
+private:
+    PlasmaBoundary m_boundary = PlasmaBoundary::Periodic;
+    PlasmaBoundary m_configuredBoundary = PlasmaBoundary::Periodic;
+    bool m_configured = false;
+    glm::vec3 m_boxLo = glm::vec3(0.0f);
+    glm::vec3 m_boxSize = glm::vec3(1.0f);
+    glm::vec3 m_cellSize = glm::vec3(1.0f);
+    int m_dims[3] = {0, 0, 0};     ///< Grid points; one more than the cells when isolated
+    float m_epsilon0 = 1.0f;
+    glm::vec3 m_magneticField = glm::vec3(0.0f);
+    const ExternalField* m_externalField = nullptr;
+
+    std::vector<PlasmaSpecies> m_species;
+    PlasmaParticles m_particles;
+    PlasmaParticles m_sortScratch;
+    bool m_staggered = false;
+    int m_sortInterval = 20;
+    int m_stepsSinceSort = 0;
+
+    FFT3D m_fft;
+    std::vector<std::vector<float>> m_privateDensity;  ///< One grid per thread slot
+    std::vector<float> m_density;
+    std::vector<float> m_potential;
+    std::vector<float> m_fieldX, m_fieldY, m_fieldZ;
+    std::vector<FFT3D::Complex> m_spectrum;
+    std::vector<float> m_inverseLaplacian;             ///< 1 / (ε0 K²) per mode, 0 for k = 0
+    std::vector<char> m_slotUsed;
+    std::vector<int> m_lower[3], m_upper[3];           ///< Difference neighbours per axis index
+    std::vector<float> m_differenceScale[3];           ///< -1 / (distance between them)
+    MultigridPoisson m_multigrid;
+    std::vector<float> m_rhs;
+    float m_tolerance = 1e-4f;
+    int m_maxCycles = 20;
+    int m_multigridCycles = 0;
+    std::vector<uint32_t> m_cellCounts;
+    PlasmaTimings m_timings;
+
+    size_t gridPointCount() const { return size_t(m_dims[0]) * m_dims[1] * m_dims[2]; }
+    void sortByCell();
+    void deposit();
+    void solve();
+    void solvePeriodic();
+    void solveIsolated();
+    void push(float velocityStep, float positionStep);
+};
+
+#endif // PLASMA_SOLVER_H
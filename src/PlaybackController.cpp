@@ -0,0 +1,34 @@
+#include "PlaybackController.h"
+#include <algorithm>
+
+void PlaybackController::setPaused(bool paused) {
+    m_paused = paused;
+    markDirty();
+}
+
+void PlaybackController::setIdleRenderingEnabled(bool enabled) {
+    m_idleRendering = enabled;
+    markDirty();
+}
+
+bool PlaybackController::consumeStepRequest() {
+    bool requested = m_stepRequested;
+    m_stepRequested = false;
+    return requested;
+}
+
+void PlaybackController::setPhysicsBudgetFraction(float fraction) {
+    m_physicsBudgetFraction = std::clamp(fraction, 0.05f, 0.95f);
+}
+
+void PlaybackController::recordFrame(float wallSeconds, float simulatedSeconds, int steps) {
+    m_stepsLastFrame = steps;
+    m_windowWallTime += wallSeconds;
+    m_windowSimulatedTime += simulatedSeconds;
+
+    if (m_windowWallTime >= RATE_WINDOW_SECONDS) {
+        m_simulationRate = m_windowSimulatedTime / m_windowWallTime;
+        m_windowWallTime = 0.0f;
+        m_windowSimulatedTime = 0.0f;
+    }
+}
@@ -0,0 +1,157 @@
+#ifndef PLAYBACK_CONTROLLER_H
+#define PLAYBACK_CONTROLLER_H
+
+/**
+ * @brief Tracks whether the simulation is running and whether a redraw is needed.
+ *
+ * Anything that changes what is on screen (a physics step, UI input, a
+ * camera move, an animation in progress) marks the view dirty. When the
+ * simulation is paused and nothing is dirty, the frame loop stops rendering
+ * and blocks on window events instead.
+ *
+ * In fast-forward mode the frame loop runs as many fixed physics steps as fit
+ * in a fraction of the frame budget and renders only the final state. The
+ * achieved simulated-time-per-wall-second ratio is measured here.
+ */
+class PlaybackController {
+public:
+    /**
+     * @brief Constructs a new PlaybackController in the running state.
+     */
+    PlaybackController() = default;
+
+    /**
+     * @brief Checks whether physics stepping is paused.
+     *
+     * @return True when paused.
+     */
+    bool isPaused() const { return m_paused; }
+
+    /**
+     * @brief Pauses or resumes physics stepping.
+     *
+     * @param paused True to pause.
+     */
+    void setPaused(bool paused);
+
+    /**
+     * @brief Toggles between paused and running.
+     */
+    void togglePause() { setPaused(!m_paused); }
+
+    /**
+     * @brief Checks whether idle frames are skipped while paused.
+     *
+     * @return True when redraw-on-demand is enabled.
+     */
+    bool isIdleRenderingEnabled() const { return m_idleRendering; }
+
+    /**
+     * @brief Enables or disables redraw-on-demand while paused.
+     *
+     * @param enabled True to stop rendering when nothing changes.
+     */
+    void setIdleRenderingEnabled(bool enabled);
+
+    /**
+     * @brief Requests a redraw.
+     *
+     * A few frames are scheduled rather than one, because the UI needs an
+     * extra frame or two to settle hover and layout after an input event.
+     */
+    void markDirty() { m_redrawFrames = REDRAW_FRAMES_PER_CHANGE; }
+
+    /**
+     * @brief Checks whether the next loop iteration has to render.
+     *
+     * @return True if running, if idle rendering is off, or if something is dirty.
+     */
+    bool needsRedraw() const { return !m_paused || !m_idleRendering || m_redrawFrames > 0; }
+
+    /**
+     * @brief Records that a frame was rendered, consuming one pending redraw.
+     */
+    void frameRendered() { if (m_redrawFrames > 0) --m_redrawFrames; }
+
+    /**
+     * @brief Requests a single physics step (used while paused).
+     */
+    void requestStep() { m_stepRequested = true; markDirty(); }
+
+    /**
+     * @brief Takes a pending single-step request.
+     *
+     * @return True if a step was requested since the last call.
+     */
+    bool consumeStepRequest();
+
+    /**
+     * @brief Checks whether fast-forward mode is on.
+     *
+     * @return True when multiple physics steps run per frame.
+     */
+    bool isFastForward() const { return m_fastForward; }
+
+    /**
+     * @brief Turns fast-forward mode on or off.
+     *
+     * @param enabled True to run multiple physics steps per frame.
+     */
+    void setFastForward(bool enabled) { m_fastForward = enabled; markDirty(); }
+
+    /**
+     * @brief Gets the share of the frame budget physics may use in fast-forward.
+     *
+     * @return Fraction in (0, 1).
+     */
+    float getPhysicsBudgetFraction() const { return m_physicsBudgetFraction; }
+
+    /**
+     * @brief Sets the share of the frame budget physics may use in fast-forward.
+     *
+     * @param fraction Fraction of the frame time, clamped to [0.05, 0.95].
+     */
+    void setPhysicsBudgetFraction(float fraction);
+
+    /**
+     * @brief Accumulates one frame's wall-clock and simulated time.
+     *
+     * @param wallSeconds Wall-clock duration of the frame.
+     * @param simulatedSeconds Simulated time advanced during the frame.
+     * @param steps Number of physics steps taken during the frame.
+     */
+    void recordFrame(float wallSeconds, float simulatedSeconds, int steps);
+
+    /**
+     * @brief Gets the measured simulated time per wall-clock second.
+     *
+     * @return The speed ratio, refreshed about twice per second.
+     */
+    float getSimulationRate() const { return m_simulationRate; }
+
+    /**
+     * @brief Gets the number of physics steps taken in the last frame.
+     *
+     * @return The step count.
+     */
+    int getStepsLastFrame() const { return m_stepsLastFrame; }
+
+private:
+    static constexpr int REDRAW_FRAMES_PER_CHANGE = 3;
+    static constexpr float RATE_WINDOW_SECONDS = 0.5f;
+
+    bool m_paused = false;
+    bool m_idleRendering = true;
+    int  m_redrawFrames = REDRAW_FRAMES_PER_CHANGE;
+
+    bool  m_stepRequested = false;
+    bool  m_fastForward = false;
+    float m_physicsBudgetFraction = 0.75f;
+
+    float m_windowWallTime = 0.0f;
+    float m_windowSimulatedTime = 0.0f;
+    float m_simulationRate = 0.0f;
+    int   m_stepsLastFrame = 0;
+};
+
+#endif // PLAYBACK_CONTROLLER_H
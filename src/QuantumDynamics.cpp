@@ -0,0 +1,372 @@
+#include "QuantumDynamics.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const double PI = 3.14159265358979323846;
+
+// (n, l, m) of the reference states, in the order computeTransitionProbabilities() reports them
+const int REFERENCE_STATES[QuantumDynamics::REFERENCE_STATE_COUNT][3] = {
+    {1, 0, 0},
+    {2, 0, 0}, {2, 1, -1}, {2, 1, 0}, {2, 1, 1},
+    {3, 0, 0}, {3, 1, -1}, {3, 1, 0}, {3, 1, 1},
+    {3, 2, -2}, {3, 2, -1}, {3, 2, 0}, {3, 2, 1}, {3, 2, 2},
+};
+
+using ComplexD = std::complex<double>;
+
+/**
+ * Unnormalized hydrogen-like states at a point, in REFERENCE_STATES order:
+ * the radial polynomial times e^(-Zr/n), times r^l Y_lm in Cartesian form.
+ */
+void referenceStates(double x, double y, double z, double charge, ComplexD states[]) {
+    const double r = std::sqrt(x * x + y * y + z * z), zr = charge * r;
+    // e^(-Zr/n) for n = 1, 2, 3 from a single exponential
+    const double e6 = std::exp(-zr / 6.0), e3 = e6 * e6, e2 = e3 * e6, e1 = e2 * e2;
+    const ComplexD plus(x, y), minus(x, -y);
+
+    states[0] = e1;
+    states[1] = (1.0 - zr / 2.0) * e2;
+    states[2] = e2 * minus;
+    states[3] = e2 * z;
+    states[4] = -e2 * plus;
+    states[5] = (1.0 - 2.0 * zr / 3.0 + 2.0 * zr * zr / 27.0) * e3;
+    const double p3 = (1.0 - zr / 6.0) * e3;
+    states[6] = p3 * minus;
+    states[7] = p3 * z;
+    states[8] = -p3 * plus;
+    states[9] = e3 * minus * minus;
+    states[10] = e3 * z * minus;
+    states[11] = e3 * (3.0 * z * z - r * r);
+    states[12] = -e3 * z * plus;
+    states[13] = e3 * plus * plus;
+}
+}
+
+bool QuantumDynamics::configure(int gridSize, float boxSize, float dt) {
+    if (!(boxSize > 0.0f) || !m_fft.setSize(gridSize, gridSize, gridSize)) return false;
+    m_size = gridSize;
+    m_boxSize = boxSize;
+    m_spacing = boxSize / gridSize;
+    m_dt = dt;
+
+    // The nucleus sits at the centre of the middle cell
+    m_coordinates.resize(gridSize);
+    for (int i = 0; i < gridSize; ++i) m_coordinates[i] = (i - 0.5f * gridSize + 0.5f) * m_spacing;
+
+    m_psi.assign(m_fft.getPointCount(), FFT3D::Complex(0.0f, 0.0f));
+    m_scratch.clear();
+    buildKinetic();
+    buildPotential();
+    setInitialState(1, 0, 0);
+    return true;
+}
+
+void QuantumDynamics::setNucleus(int atomicNumber) {
+    m_atomicNumber = std::max(1, atomicNumber);
+    if (!isConfigured()) return;
+    buildPotential();
+    setInitialState(1, 0, 0);
+}
+
+void QuantumDynamics::setAbsorbingWidth(float fraction) {
+    m_absorbingWidth = std::clamp(fraction, 0.0f, 0.5f);
+    if (isConfigured()) buildPotential();
+}
+
+void QuantumDynamics::buildKinetic() {
+    const int n = m_size;
+    std::vector<double> k2(n);
+    for (int i = 0; i < n; ++i) {
+        double k = 2.0 * PI * m_fft.frequency(0, i) / m_boxSize;
+        k2[i] = k * k;
+    }
+    m_kinetic.resize(m_psi.size());
+    TaskScheduler::getInstance().parallelFor(0, n, [&](size_t firstZ, size_t lastZ) {
+        for (size_t z = firstZ; z < lastZ; ++z) {
+            for (int y = 0; y < n; ++y) {
+                FFT3D::Complex* row = &m_kinetic[(z * n + y) * n];
+                for (int x = 0; x < n; ++x) {
+                    double phase = -0.5 * (k2[x] + k2[y] + k2[z]) * m_dt;
+                    row[x] = FFT3D::Complex(static_cast<float>(std::cos(phase)), static_cast<float>(std::sin(phase)));
+                }
+            }
+        }
+    }, 1);
+}
+
+void QuantumDynamics::buildPotential() {
+    const int n = m_size;
+    // cos^(1/8) mask over the outer layer, split evenly between the two half steps
+    std::vector<double> mask(n, 1.0);
+    const double width = m_absorbingWidth * m_boxSize;
+    if (width > 0.0) {
+        for (int i = 0; i < n; ++i) {
+            double depth = width - (0.5 * m_boxSize - std::fabs(m_coordinates[i]));
+            if (depth > 0.0) mask[i] = std::pow(std::cos(0.5 * PI * std::min(1.0, depth / width)), 0.0625);
+        }
+    }
+    m_potentialHalf.resize(m_psi.size());
+    const double charge = m_atomicNumber;
+    TaskScheduler::getInstance().parallelFor(0, n, [&](size_t firstZ, size_t lastZ) {
+        for (size_t z = firstZ; z < lastZ; ++z) {
+            for (int y = 0; y < n; ++y) {
+                FFT3D::Complex* row = &m_potentialHalf[(z * n + y) * n];
+                double yz2 = double(m_coordinates[y]) * m_coordinates[y] + double(m_coordinates[z]) * m_coordinates[z];
+                for (int x = 0; x < n; ++x) {
+                    double r = std::sqrt(yz2 + double(m_coordinates[x]) * m_coordinates[x]);
+                    double phase = 0.5 * charge / r * m_dt;
+                    double amplitude = mask[x] * mask[y] * mask[z];
+                    row[x] = FFT3D::Complex(static_cast<float>(amplitude * std::cos(phase)),
+                                            static_cast<float>(amplitude * std::sin(phase)));
+                }
+            }
+        }
+    }, 1);
+
+    // Reference state norms for the populations
+    project(nullptr, nullptr, m_referenceNorms);
+}
+
+bool QuantumDynamics::setInitialState(int n, int l, int m) {
+    if (!isConfigured() || n < 1 || n > MAX_PRINCIPAL || l < 0 || l >= n || std::abs(m) > l) return false;
+    int state = 0;
+    while (REFERENCE_STATES[state][0] != n || REFERENCE_STATES[state][1] != l || REFERENCE_STATES[state][2] != m) {
+        ++state;
+    }
+    const int size = m_size;
+    const double charge = m_atomicNumber;
+    const double scale = 1.0 / std::sqrt(m_referenceNorms[state]);
+    TaskScheduler::getInstance().parallelFor(0, size, [&](size_t firstZ, size_t lastZ) {
+        ComplexD states[REFERENCE_STATE_COUNT];
+        for (size_t z = firstZ; z < lastZ; ++z) {
+            for (int y = 0; y < size; ++y) {
+                for (int x = 0; x < size; ++x) {
+                    referenceStates(m_coordinates[x], m_coordinates[y], m_coordinates[z], charge, states);
+                    ComplexD value = scale * states[state];
+                    m_psi[(z * size + y) * size + x] =
+                        FFT3D::Complex(static_cast<float>(value.real()), static_cast<float>(value.imag()));
+                }
+            }
+        }
+    }, 1);
+    m_time = 0.0;
+    return true;
+}
+
+// ─── Propagation ────────────────────────────────────────────────────────────
+
+glm::vec3 QuantumDynamics::laserField(double time) const {
+    if (m_laser.amplitude == 0.0f || !(m_laser.frequency > 0.0f) || !(m_laser.cycles > 0.0f)) return glm::vec3(0.0f);
+    double duration = m_laser.cycles * 2.0 * PI / m_laser.frequency;
+    if (time < 0.0 || time > duration) return glm::vec3(0.0f);
+    double envelope = std::sin(PI * time / duration);
+    double field = m_laser.amplitude * envelope * envelope * std::sin(m_laser.frequency * time);
+    return static_cast<float>(field) * glm::normalize(m_laser.polarization);
+}
+
+void QuantumDynamics::applyPotentialHalf(double time) {
+    const int n = m_size;
+    glm::vec3 field = laserField(time);
+    const bool laser = field != glm::vec3(0.0f);
+
+    // e^(-i E·r dt/2) = Π over axes of e^(-i E_a r_a dt/2)
+    std::vector<FFT3D::Complex> phase[3];
+    if (laser) {
+        for (int a = 0; a < 3; ++a) {
+            phase[a].resize(n);
+            for (int i = 0; i < n; ++i) {
+                double angle = -0.5 * double(field[a]) * m_coordinates[i] * m_dt;
+                phase[a][i] = FFT3D::Complex(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+            }
+        }
+    }
+
+    TaskScheduler::getInstance().parallelFor(0, n, [&](size_t firstZ, size_t lastZ) {
+        for (size_t z = firstZ; z < lastZ; ++z) {
+            for (int y = 0; y < n; ++y) {
+                size_t row = (z * n + y) * n;
+                FFT3D::Complex* psi = &m_psi[row];
+                const FFT3D::Complex* potential = &m_potentialHalf[row];
+                if (laser) {
+                    FFT3D::Complex yz = phase[1][y] * phase[2][z];
+                    for (int x = 0; x < n; ++x) psi[x] *= potential[x] * (phase[0][x] * yz);
+                } else {
+                    for (int x = 0; x < n; ++x) psi[x] *= potential[x];
+                }
+            }
+        }
+    }, 1);
+}
+
+void QuantumDynamics::step(int count) {
+    if (!isConfigured()) return;
+    const size_t points = m_psi.size();
+    for (int s = 0; s < count; ++s) {
+        applyPotentialHalf(m_time);
+        m_fft.forward(m_psi);
+        TaskScheduler::getInstance().parallelFor(0, points, [&](size_t begin, size_t end) {
+            for (size_t g = begin; g < end; ++g) m_psi[g] *= m_kinetic[g];
+        }, 65536);
+        m_fft.inverse(m_psi);
+        m_time += m_dt;
+        applyPotentialHalf(m_time);
+    }
+}
+
+// ─── Observables ────────────────────────────────────────────────────────────
+
+double QuantumDynamics::computeNorm() const {
+    double sum = 0.0;
+    for (const FFT3D::Complex& value : m_psi) sum += std::norm(value);
+    return sum * double(m_spacing) * m_spacing * m_spacing;
+}
+
+glm::dvec3 QuantumDynamics::computeDipole() const {
+    const int n = m_size;
+    std::vector<glm::dvec3> planes(n, glm::dvec3(0.0));
+    TaskScheduler::getInstance().parallelFor(0, n, [&](size_t firstZ, size_t lastZ) {
+        for (size_t z = firstZ; z < lastZ; ++z) {
+            glm::dvec3 sum(0.0);
+            for (int y = 0; y < n; ++y) {
+                const FFT3D::Complex* psi = &m_psi[(z * n + y) * n];
+                double rowSum = 0.0, rowX = 0.0;
+                for (int x = 0; x < n; ++x) {
+                    double density = std::norm(psi[x]);
+                    rowSum += density;
+                    rowX += density * m_coordinates[x];
+                }
+                sum += glm::dvec3(rowX, rowSum * m_coordinates[y], rowSum * m_coordinates[z]);
+            }
+            planes[z] = sum;
+        }
+    }, 1);
+    glm::dvec3 dipole(0.0);
+    for (const glm::dvec3& plane : planes) dipole += plane;
+    return dipole * (double(m_spacing) * m_spacing * m_spacing);
+}
+
+double QuantumDynamics::computeEnergy() {
+    if (!isConfigured()) return 0.0;
+    const int n = m_size;
+    const double volume = double(m_spacing) * m_spacing * m_spacing;
+
+    // Kinetic: Σ k²/2 |ψ_k|², normalized by Parseval
+    m_scratch = m_psi;
+    m_fft.forward(m_scratch);
+    std::vector<double> k2(n);
+    for (int i = 0; i < n; ++i) {
+        double k = 2.0 * PI * m_fft.frequency(0, i) / m_boxSize;
+        k2[i] = k * k;
+    }
+    std::vector<double> kinetic(n, 0.0), spectral(n, 0.0), potential(n, 0.0);
+    const double charge = m_atomicNumber;
+    TaskScheduler::getInstance().parallelFor(0, n, [&](size_t firstZ, size_t lastZ) {
+        for (size_t z = firstZ; z < lastZ; ++z) {
+            for (int y = 0; y < n; ++y) {
+                size_t row = (z * n + y) * n;
+                double yz2 = double(m_coordinates[y]) * m_coordinates[y] + double(m_coordinates[z]) * m_coordinates[z];
+                for (int x = 0; x < n; ++x) {
+                    double weight = std::norm(m_scratch[row + x]);
+                    kinetic[z] += 0.5 * (k2[x] + k2[y] + k2[z]) * weight;
+                    spectral[z] += weight;
+                    double r = std::sqrt(yz2 + double(m_coordinates[x]) * m_coordinates[x]);
+                    potential[z] -= charge / r * std::norm(m_psi[row + x]);
+                }
+            }
+        }
+    }, 1);
+    double kineticSum = 0.0, spectralSum = 0.0, potentialSum = 0.0;
+    for (int z = 0; z < n; ++z) {
+        kineticSum += kinetic[z];
+        spectralSum += spectral[z];
+        potentialSum += potential[z];
+    }
+    double norm = computeNorm();
+    if (!(spectralSum > 0.0) || !(norm > 0.0)) return 0.0;
+    // Energy per unit norm, so absorption does not look like a change of energy
+    return kineticSum / spectralSum + potentialSum * volume / norm;
+}
+
+void QuantumDynamics::project(const FFT3D::Complex* psi, std::complex<double>* overlaps, double* norms) const {
+    const int n = m_size;
+    const int states = REFERENCE_STATE_COUNT;
+    std::vector<ComplexD> planeOverlaps(size_t(n) * states, ComplexD(0.0, 0.0));
+    std::vector<double> planeNorms(size_t(n) * states, 0.0);
+    const double charge = m_atomicNumber;
+    TaskScheduler::getInstance().parallelFor(0, n, [&](size_t firstZ, size_t lastZ) {
+        ComplexD reference[REFERENCE_STATE_COUNT];
+        for (size_t z = firstZ; z < lastZ; ++z) {
+            ComplexD* overlap = &planeOverlaps[z * states];
+            double* norm = &planeNorms[z * states];
+            for (int y = 0; y < n; ++y) {
+                for (int x = 0; x < n; ++x) {
+                    referenceStates(m_coordinates[x], m_coordinates[y], m_coordinates[z], charge, reference);
+                    if (norms) {
+                        for (int s = 0; s < states; ++s) norm[s] += std::norm(reference[s]);
+                    }
+                    if (psi) {
+                        const FFT3D::Complex value = psi[(z * n + y) * n + x];
+                        const double re = value.real(), im = value.imag();
+                        // conj(φ) ψ without the library's NaN-checking complex multiply
+                        for (int s = 0; s < states; ++s) {
+                            double a = reference[s].real(), b = reference[s].imag();
+                            overlap[s] += ComplexD(a * re + b * im, a * im - b * re);
+                        }
+                    }
+                }
+            }
+        }
+    }, 1);
+
+    const double volume = double(m_spacing) * m_spacing * m_spacing;
+    for (int s = 0; s < states; ++s) {
+        ComplexD overlapSum(0.0, 0.0);
+        double normSum = 0.0;
+        for (int z = 0; z < n; ++z) {
+            overlapSum += planeOverlaps[size_t(z) * states + s];
+            normSum += planeNorms[size_t(z) * states + s];
+        }
+        if (overlaps) overlaps[s] = overlapSum * volume;
+        if (norms) norms[s] = normSum * volume;
+    }
+}
+
+std::vector<QuantumLevel> QuantumDynamics::computeTransitionProbabilities() const {
+    std::vector<QuantumLevel> levels;
+    if (!isConfigured()) return levels;
+    ComplexD overlaps[REFERENCE_STATE_COUNT];
+    project(m_psi.data(), overlaps, nullptr);
+    for (int s = 0; s < REFERENCE_STATE_COUNT; ++s) {
+        double probability = m_referenceNorms[s] > 0.0 ? std::norm(overlaps[s]) / m_referenceNorms[s] : 0.0;
+        levels.push_back({REFERENCE_STATES[s][0], REFERENCE_STATES[s][1], REFERENCE_STATES[s][2], probability});
+    }
+    return levels;
+}
+
+// ─── Output ─────────────────────────────────────────────────────────────────
+
+void QuantumDynamics::getDensity(VolumeGrid& grid, const glm::vec3& center, float lengthScale) const {
+    if (!isConfigured()) return;
+    const float spacing = m_spacing * lengthScale;
+    grid.resize(center + glm::vec3(m_coordinates[0] * lengthScale), spacing, m_size, m_size, m_size);
+    TaskScheduler::getInstance().parallelFor(0, m_psi.size(), [&](size_t begin, size_t end) {
+        for (size_t g = begin; g < end; ++g) grid.values[g] = std::norm(m_psi[g]);
+    }, 65536);
+}
+
+void QuantumDynamics::getDensitySlice(int axis, int index, std::vector<float>& slice) const {
+    const int n = m_size;
+    slice.assign(size_t(n) * n, 0.0f);
+    if (!isConfigured() || axis < 0 || axis > 2 || index < 0 || index >= n) return;
+    for (int v = 0; v < n; ++v) {
+        for (int u = 0; u < n; ++u) {
+            size_t g;
+            if (axis == 0) g = (size_t(v) * n + u) * n + index;
+            else if (axis == 1) g = (size_t(v) * n + index) * n + u;
+            else g = (size_t(index) * n + v) * n + u;
+            slice[size_t(v) * n + u] = std::norm(m_psi[g]);
+        }
+    }
+}
@@ -0,0 +1,176 @@
+#ifndef QUANTUM_DYNAMICS_H
+#define QUANTUM_DYNAMICS_H
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+#include "FFT3D.h"
+#include "Isosurface.h"
+
+/**
+ * @brief A laser pulse in the dipole approximation (atomic units).
+ *
+ * E(t) = amplitude · sin²(π t / T) · sin(ω t) along the polarization, for
+ * 0 ≤ t ≤ T with T = cycles · 2π / ω, and zero afterwards.
+ */
+struct LaserPulse {
+    glm::vec3 polarization = glm::vec3(0.0f, 0.0f, 1.0f);
+    float amplitude = 0.0f;     ///< Peak field (1 a.u. = 5.14e11 V/m)
+    float frequency = 0.0f;     ///< Angular frequency ω (1 a.u. = 27.2 eV photon energy)
+    float cycles = 0.0f;
+};
+
+/**
+ * @brief Population of one hydrogen-like level (n, l, m).
+ */
+struct QuantumLevel {
+    int n;
+    int l;
+    int m;
+    double probability;
+};
+
+/**
+ * @brief Time-dependent Schrödinger solver for one electron around a nucleus.
+ *
+ * Where OrbitalModel treats an electron as an integer level with
+ * instantaneous jumps, this propagates its wavefunction on a cubic grid in
+ * atomic units (ħ = mₑ = e = 1, lengths in Bohr). The nucleus sits at the
+ * box centre, between grid points, so the Coulomb potential -Z / r is never
+ * singular. A laser couples in the length gauge, V = E(t)·r.
+ *
+ * Each step is a Strang split: half a potential step, then the kinetic
+ * step in momentum space (one forward and one inverse FFT3D), then another
+ * half potential step. The kinetic propagator e^(-i k² dt / 2) and the
+ * static half-step phase e^(-i V dt / 2) are cached per grid point.
+ * Absorption at the box edges is folded into the static phase. The laser
+ * phase e^(-i E·r dt / 2) factors per axis, so it needs only three short
+ * tables per step. All passes run over z planes on the TaskScheduler.
+ *
+ * Populations are projections onto the hydrogen-like states up to
+ * MAX_PRINCIPAL, normalized on the grid. They are evaluated on demand, so
+ * no reference states are stored. Whatever norm they do not account for
+ * has been ionized or absorbed.
+ */
+class QuantumDynamics {
+public:
+    /// Highest principal quantum number of the reference states
+    static constexpr int MAX_PRINCIPAL = 3;
+    static constexpr int REFERENCE_STATE_COUNT = 14;   ///< Σ n² for n ≤ MAX_PRINCIPAL
+    static constexpr float BOHR_RADIUS_ANGSTROM = 0.529177f;
+
+    QuantumDynamics() = default;
+
+    /**
+     * @brief Sets the grid and time step; the wavefunction is reset to 1s.
+     *
+     * @param gridSize Points per side (power of two).
+     * @param boxSize Box edge in Bohr.
+     * @param dt Time step in atomic units (1 a.u. = 24.2 as).
+     * @return False if the grid size is not a power of two.
+     */
+    bool configure(int gridSize, float boxSize, float dt);
+
+    /**
+     * @brief Sets the nuclear charge; the wavefunction is reset to 1s.
+     */
+    void setNucleus(int atomicNumber);
+
+    /**
+     * @brief Sets the width of the absorbing layer at the box edges.
+     *
+     * @param fraction Fraction of the box side on each face (0 disables).
+     */
+    void setAbsorbingWidth(float fraction);
+
+    void setLaser(const LaserPulse& pulse) { m_laser = pulse; }
+    const LaserPulse& getLaser() const { return m_laser; }
+
+    /**
+     * @brief Places the electron in a hydrogen-like state and restarts the clock.
+     *
+     * @return False unless 1 ≤ n ≤ MAX_PRINCIPAL, 0 ≤ l < n and |m| ≤ l.
+     */
+    bool setInitialState(int n, int l, int m);
+
+    /**
+     * @brief Advances the wavefunction.
+     *
+     * @param count Number of time steps.
+     */
+    void step(int count = 1);
+
+    /// Laser field at a time, in atomic units
+    glm::vec3 laserField(double time) const;
+
+    /// ∫|ψ|² over the grid
+    double computeNorm() const;
+
+    /// Expectation of the position relative to the nucleus
+    glm::dvec3 computeDipole() const;
+
+    /**
+     * @brief Expectation of the field-free Hamiltonian, in Hartree.
+     *
+     * Needs one extra FFT, so it is not computed every step.
+     */
+    double computeEnergy();
+
+    /**
+     * @brief Populations of every reference state, in order of n, l, m.
+     */
+    std::vector<QuantumLevel> computeTransitionProbabilities() const;
+
+    /**
+     * @brief Writes |ψ|² into a volume grid for isosurfaces.
+     *
+     * @param grid Receives the density; its spacing is the grid spacing times lengthScale.
+     * @param center Where the nucleus is, in the caller's units.
+     * @param lengthScale Caller's length units per Bohr.
+     */
+    void getDensity(VolumeGrid& grid, const glm::vec3& center, float lengthScale) const;
+
+    /**
+     * @brief Copies one plane of |ψ|².
+     *
+     * @param axis The axis normal to the plane.
+     * @param index The plane's grid index along that axis.
+     * @param slice Receives size × size values; the lower remaining axis is fastest.
+     */
+    void getDensitySlice(int axis, int index, std::vector<float>& slice) const;
+
+    bool isConfigured() const { return !m_psi.empty(); }
+    int getSize() const { return m_size; }
+    int getAtomicNumber() const { return m_atomicNumber; }
+    float getSpacing() const { return m_spacing; }
+    float getTimeStep() const { return m_dt; }
+    double getTime() const { return m_time; }
+    const std::vector<FFT3D::Complex>& getWavefunction() const { return m_psi; }
+
+private:
+    int m_size = 0;
+    float m_boxSize = 0.0f;
+    float m_spacing = 0.0f;
+    float m_dt = 0.05f;
+    int m_atomicNumber = 1;
+    float m_absorbingWidth = 0.1f;
+    double m_time = 0.0;
+    LaserPulse m_laser;
+
+    FFT3D m_fft;
+    std::vector<FFT3D::Complex> m_psi;
+    std::vector<FFT3D::Complex> m_kinetic;       ///< e^(-i k² dt / 2) per mode
+    std::vector<FFT3D::Complex> m_potentialHalf; ///< e^(-i V dt / 2) times the absorbing mask
+    std::vector<FFT3D::Complex> m_scratch;
+    std::vector<float> m_coordinates;            ///< Grid point coordinate along any axis
+    double m_referenceNorms[REFERENCE_STATE_COUNT] = {};  ///< Σ|φ|² dV per reference state
+
+    void buildKinetic();
+    void buildPotential();
+    void applyPotentialHalf(double time);
+    /// Accumulates <state|ψ> (or the state norms if psi is null) for every reference state
+    void project(const FFT3D::Complex* psi, std::complex<double>* overlaps, double* norms) const;
+};
+
+#endif // QUANTUM_DYNAMICS_H
@@ -0,0 +1,608 @@
+#include "RayTracer.h"
+#include "ElementTable.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <mutex>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define ATOMICA_RAYTRACER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+const float PI = 3.14159265358979f;
+const float INF = std::numeric_limits<float>::infinity();
+// SAH bins per split and the most primitives a leaf may hold
+const int SAH_BINS = 16;
+const uint32_t LEAF_SIZE = 4;
+// Primitive count above which SAH binning is spread over the workers
+const uint32_t PARALLEL_BINNING = 1u << 16;
+// Pixels per tile edge; even, so 2x2 packets never straddle tiles
+const int TILE = 32;
+// Traversal stack; the build caps SAH depth at 48 so the tree stays shallower than this
+const int STACK_SIZE = 128;
+
+struct Bounds {
+    glm::vec3 lo = glm::vec3(INF);
+    glm::vec3 hi = glm::vec3(-INF);
+
+    void grow(const glm::vec3& p) { lo = glm::min(lo, p); hi = glm::max(hi, p); }
+    void grow(const Bounds& b) { lo = glm::min(lo, b.lo); hi = glm::max(hi, b.hi); }
+    float area() const {
+        glm::vec3 e = hi - lo;
+        return e.x < 0.0f ? 0.0f : 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+    }
+};
+
+struct Bin {
+    Bounds bounds;
+    uint32_t count = 0;
+};
+
+/// Per-pixel random stream; hashing the pixel and sample keeps renders independent of tiling
+struct Random {
+    uint32_t state;
+
+    explicit Random(uint32_t seed) : state(seed * 0x9E3779B9u + 0x7F4A7C15u) { next(); }
+    uint32_t next() {
+        // PCG-style output hash of a Weyl sequence
+        state += 0x6D2B79F5u;
+        uint32_t z = state;
+        z = (z ^ (z >> 15)) * (z | 1u);
+        z ^= z + (z ^ (z >> 7)) * (z | 61u);
+        return z ^ (z >> 14);
+    }
+    float uniform() { return (next() >> 8) * (1.0f / 16777216.0f); }
+};
+
+void orthonormalBasis(const glm::vec3& n, glm::vec3& t, glm::vec3& b) {
+    // Duff et al., "Building an Orthonormal Basis, Revisited"
+    float sign = std::copysign(1.0f, n.z);
+    float a = -1.0f / (sign + n.z);
+    float c = n.x * n.y * a;
+    t = glm::vec3(1.0f + sign * n.x * n.x * a, sign * c, -sign * n.x);
+    b = glm::vec3(c, sign + n.y * n.y * a, -n.y);
+}
+
+inline float safeInverse(float d) {
+    return 1.0f / (std::fabs(d) > 1e-20f ? d : std::copysign(1e-20f, d));
+}
+
+bool intersectSphere(const glm::vec3& o, const glm::vec3& d, const glm::vec3& c, float r, float tMin, float& t) {
+    glm::vec3 oc = o - c;
+    float b = glm::dot(oc, d);
+    float h = b * b - (glm::dot(oc, oc) - r * r);
+    if (h < 0.0f) return false;
+    h = std::sqrt(h);
+    float t0 = -b - h;
+    if (t0 <= tMin) t0 = -b + h;
+    if (t0 <= tMin || t0 >= t) return false;
+    t = t0;
+    return true;
+}
+
+bool intersectCylinder(const glm::vec3& o, const glm::vec3& d, const glm::vec3& a, const glm::vec3& b, float r,
+                       float tMin, float& t) {
+    // Open cylinder body; the atoms at both ends cover the caps
+    glm::vec3 ba = b - a, oc = o - a;
+    float baba = glm::dot(ba, ba);
+    float bard = glm::dot(ba, d);
+    float baoc = glm::dot(ba, oc);
+    float k2 = baba - bard * bard;
+    if (k2 <= 1e-12f) return false;
+    float k1 = baba * glm::dot(oc, d) - baoc * bard;
+    float k0 = baba * glm::dot(oc, oc) - baoc * baoc - r * r * baba;
+    float h = k1 * k1 - k2 * k0;
+    if (h < 0.0f) return false;
+    h = std::sqrt(h);
+    for (float t0 : {(-k1 - h) / k2, (-k1 + h) / k2}) {
+        if (t0 <= tMin || t0 >= t) continue;
+        float y = baoc + t0 * bard;
+        if (y > 0.0f && y < baba) {
+            t = t0;
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+// ─── Scene ────────────────────────────────────────────────────────────
+
+void RayScene::addAtoms(const float* x, const float* y, const float* z, const uint8_t* atomicNumber, size_t count,
+                        float radiusScale) {
+    spheres.reserve(spheres.size() + count);
+    for (size_t i = 0; i < count; ++i) {
+        int Z = atomicNumber ? atomicNumber[i] : 0;
+        spheres.push_back({glm::vec3(x[i], y[i], z[i]), ElementTable::getDisplayRadius(Z) * radiusScale,
+                           ElementTable::getDisplayColor(Z)});
+    }
+}
+
+void RayScene::addBonds(const std::vector<uint32_t>& bondOffsets, const std::vector<uint32_t>& bondNeighbors,
+                        float radius, const glm::vec3& color) {
+    if (bondOffsets.empty()) return;
+    size_t atomCount = std::min(bondOffsets.size() - 1, spheres.size());
+    for (size_t i = 0; i < atomCount; ++i) {
+        for (uint32_t k = bondOffsets[i]; k < bondOffsets[i + 1]; ++k) {
+            uint32_t j = bondNeighbors[k];
+            if (j <= i || j >= spheres.size()) continue;  // each bond once
+            cylinders.push_back({spheres[i].center, spheres[j].center, radius, color});
+        }
+    }
+}
+
+bool RayScene::getBounds(glm::vec3& lo, glm::vec3& hi) const {
+    Bounds bounds;
+    for (const auto& s : spheres) {
+        bounds.grow(s.center - glm::vec3(s.radius));
+        bounds.grow(s.center + glm::vec3(s.radius));
+    }
+    for (const auto& c : cylinders) {
+        bounds.grow(glm::min(c.a, c.b) - glm::vec3(c.radius));
+        bounds.grow(glm::max(c.a, c.b) + glm::vec3(c.radius));
+    }
+    lo = bounds.lo;
+    hi = bounds.hi;
+    return !spheres.empty() || !cylinders.empty();
+}
+
+// ─── BVH ──────────────────────────────────────────────────────────────
+
+struct RayTracer::Hit {
+    float t = INF;
+    uint32_t primitive = 0;
+};
+
+/// Four rays traced together; lanes whose pixel is off the image start inactive
+struct RayTracer::Packet {
+    alignas(16) float ox[4], oy[4], oz[4];
+    alignas(16) float dx[4], dy[4], dz[4];
+    alignas(16) float ix[4], iy[4], iz[4];
+    alignas(16) float t[4];
+    uint32_t primitive[4];
+    int activeMask;
+};
+
+RayTracer::RayTracer() = default;
+
+void RayTracer::build(const RayScene& scene) {
+    m_nodes.clear();
+    m_primitives.clear();
+    m_primitives.reserve(scene.spheres.size() + scene.cylinders.size());
+    for (const auto& s : scene.spheres) {
+        m_primitives.push_back({s.center, s.radius, s.center, 0, s.color});
+    }
+    for (const auto& c : scene.cylinders) {
+        m_primitives.push_back({c.a, c.radius, c.b, 1, c.color});
+    }
+    uint32_t count = static_cast<uint32_t>(m_primitives.size());
+    if (count == 0) return;
+
+    std::vector<uint32_t> order(count);
+    std::vector<glm::vec3> boxLo(count), boxHi(count), centroids(count);
+    TaskScheduler::getInstance().parallelFor(0, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const Primitive& p = m_primitives[i];
+            order[i] = static_cast<uint32_t>(i);
+            boxLo[i] = glm::min(p.a, p.b) - glm::vec3(p.radius);
+            boxHi[i] = glm::max(p.a, p.b) + glm::vec3(p.radius);
+            centroids[i] = 0.5f * (boxLo[i] + boxHi[i]);
+        }
+    }, 16384);
+
+    m_nodes.reserve(2 * size_t(count));
+    m_nodes.emplace_back();
+    buildNode(0, order, boxLo, boxHi, centroids, 0, count, 0);
+
+    // Store primitives in leaf order so leaves read contiguous memory
+    std::vector<Primitive> sorted(count);
+    for (uint32_t k = 0; k < count; ++k) sorted[k] = m_primitives[order[k]];
+    m_primitives.swap(sorted);
+}
+
+void RayTracer::buildNode(uint32_t nodeIndex, std::vector<uint32_t>& order, const std::vector<glm::vec3>& boxLo,
+                          const std::vector<glm::vec3>& boxHi, const std::vector<glm::vec3>& centroids,
+                          uint32_t begin, uint32_t end, int depth) {
+    const uint32_t count = end - begin;
+    auto& scheduler = TaskScheduler::getInstance();
+    std::mutex mergeMutex;
+
+    // Node bounds and the bounds of the primitive centroids
+    Bounds bounds, centroidBounds;
+    auto boundRange = [&](size_t b, size_t e) {
+        Bounds local, localCentroids;
+        for (size_t k = b; k < e; ++k) {
+            uint32_t i = order[k];
+            local.lo = glm::min(local.lo, boxLo[i]);
+            local.hi = glm::max(local.hi, boxHi[i]);
+            localCentroids.grow(centroids[i]);
+        }
+        std::lock_guard<std::mutex> lock(mergeMutex);
+        bounds.grow(local);
+        centroidBounds.grow(localCentroids);
+    };
+    if (count >= PARALLEL_BINNING) scheduler.parallelFor(begin, end, boundRange, PARALLEL_BINNING / 4);
+    else boundRange(begin, end);
+
+    m_nodes[nodeIndex].lo = bounds.lo;
+    m_nodes[nodeIndex].hi = bounds.hi;
+    m_nodes[nodeIndex].start = begin;
+    m_nodes[nodeIndex].count = count;
+    if (count <= LEAF_SIZE) return;
+
+    glm::vec3 extent = centroidBounds.hi - centroidBounds.lo;
+    int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+    uint32_t mid = begin + count / 2;
+
+    if (extent[axis] > 0.0f && depth < 48) {
+        // Binned SAH: cost of each split plane between bins, against keeping a leaf
+        const float lo = centroidBounds.lo[axis];
+        const float scale = SAH_BINS * 0.9999f / extent[axis];
+        auto binOf = [&](uint32_t i) { return static_cast<int>((centroids[i][axis] - lo) * scale); };
+
+        Bin bins[SAH_BINS];
+        auto binRange = [&](size_t b, size_t e) {
+            Bin local[SAH_BINS];
+            for (size_t k = b; k < e; ++k) {
+                uint32_t i = order[k];
+                Bin& bin = local[binOf(i)];
+                ++bin.count;
+                bin.bounds.lo = glm::min(bin.bounds.lo, boxLo[i]);
+                bin.bounds.hi = glm::max(bin.bounds.hi, boxHi[i]);
+            }
+            std::lock_guard<std::mutex> lock(mergeMutex);
+            for (int k = 0; k < SAH_BINS; ++k) {
+                bins[k].count += local[k].count;
+                bins[k].bounds.grow(local[k].bounds);
+            }
+        };
+        if (count >= PARALLEL_BINNING) scheduler.parallelFor(begin, end, binRange, PARALLEL_BINNING / 4);
+        else binRange(begin, end);
+
+        float rightCost[SAH_BINS];
+        Bounds right;
+        uint32_t rightCount = 0;
+        for (int k = SAH_BINS - 1; k > 0; --k) {
+            right.grow(bins[k].bounds);
+            rightCount += bins[k].count;
+            rightCost[k] = right.area() * rightCount;
+        }
+        Bounds left;
+        uint32_t leftCount = 0;
+        float bestCost = INF;
+        int bestSplit = -1;
+        for (int k = 0; k < SAH_BINS - 1; ++k) {
+            left.grow(bins[k].bounds);
+            leftCount += bins[k].count;
+            float cost = left.area() * leftCount + rightCost[k + 1];
+            if (leftCount > 0 && leftCount < count && cost < bestCost) {
+                bestCost = cost;
+                bestSplit = k;
+            }
+        }
+
+        // Small nodes stay leaves when no split beats testing every primitive
+        if (count <= 4 * LEAF_SIZE && bestCost >= bounds.area() * count) return;
+        if (bestSplit >= 0) {
+            auto split = std::partition(order.begin() + begin, order.begin() + end,
+                                        [&](uint32_t i) { return binOf(i) <= bestSplit; });
+            mid = static_cast<uint32_t>(split - order.begin());
+        }
+    }
+    if (mid == begin || mid == end) mid = begin + count / 2;
+
+    uint32_t leftChild = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+    m_nodes.emplace_back();
+    m_nodes[nodeIndex].start = leftChild;
+    m_nodes[nodeIndex].count = 0;
+    buildNode(leftChild, order, boxLo, boxHi, centroids, begin, mid, depth + 1);
+    buildNode(leftChild + 1, order, boxLo, boxHi, centroids, mid, end, depth + 1);
+}
+
+// ─── Traversal ────────────────────────────────────────────────────────
+
+void RayTracer::tracePacket(Packet& packet) const {
+    if (m_nodes.empty()) return;
+    const float tMin = 1e-4f;
+    uint32_t stack[STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+
+#ifdef ATOMICA_RAYTRACER_SSE2
+    const __m128 ox = _mm_load_ps(packet.ox), oy = _mm_load_ps(packet.oy), oz = _mm_load_ps(packet.oz);
+    const __m128 dx = _mm_load_ps(packet.dx), dy = _mm_load_ps(packet.dy), dz = _mm_load_ps(packet.dz);
+    const __m128 ix = _mm_load_ps(packet.ix), iy = _mm_load_ps(packet.iy), iz = _mm_load_ps(packet.iz);
+    const __m128 zero = _mm_setzero_ps(), epsilon = _mm_set1_ps(tMin);
+    __m128 tHit = _mm_load_ps(packet.t);
+#endif
+
+    while (top > 0) {
+        const Node& node = m_nodes[stack[--top]];
+
+        // Which lanes enter the node's box before their current hit
+        int mask = 0;
+#ifdef ATOMICA_RAYTRACER_SSE2
+        __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.lo.x), ox), ix);
+        __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.hi.x), ox), ix);
+        __m128 tNear = _mm_min_ps(t0, t1), tFar = _mm_max_ps(t0, t1);
+        t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.lo.y), oy), iy);
+        t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.hi.y), oy), iy);
+        tNear = _mm_max_ps(tNear, _mm_min_ps(t0, t1));
+        tFar = _mm_min_ps(tFar, _mm_max_ps(t0, t1));
+        t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.lo.z), oz), iz);
+        t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.hi.z), oz), iz);
+        tNear = _mm_max_ps(_mm_max_ps(tNear, _mm_min_ps(t0, t1)), zero);
+        tFar = _mm_min_ps(tFar, _mm_max_ps(t0, t1));
+        mask = _mm_movemask_ps(_mm_and_ps(_mm_cmple_ps(tNear, tFar), _mm_cmplt_ps(tNear, tHit))) & packet.activeMask;
+#else
+        for (int l = 0; l < 4; ++l) {
+            if (!(packet.activeMask & (1 << l))) continue;
+            float tNear = 0.0f, tFar = packet.t[l];
+            const float o[3] = {packet.ox[l], packet.oy[l], packet.oz[l]};
+            const float inv[3] = {packet.ix[l], packet.iy[l], packet.iz[l]};
+            for (int a = 0; a < 3; ++a) {
+                float t0 = (node.lo[a] - o[a]) * inv[a], t1 = (node.hi[a] - o[a]) * inv[a];
+                tNear = std::max(tNear, std::min(t0, t1));
+                tFar = std::min(tFar, std::max(t0, t1));
+            }
+            if (tNear <= tFar) mask |= 1 << l;
+        }
+#endif
+        if (!mask) continue;
+
+        if (node.count == 0) {
+            // Visit the child nearer along the first active ray first
+            int lane = (mask & 1) ? 0 : (mask & 2) ? 1 : (mask & 4) ? 2 : 3;
+            glm::vec3 d(packet.dx[lane], packet.dy[lane], packet.dz[lane]);
+            const Node& left = m_nodes[node.start];
+            const Node& right = m_nodes[node.start + 1];
+            bool leftFirst = glm::dot((right.lo + right.hi) - (left.lo + left.hi), d) > 0.0f;
+            stack[top++] = leftFirst ? node.start + 1 : node.start;
+            stack[top++] = leftFirst ? node.start : node.start + 1;
+            continue;
+        }
+
+        for (uint32_t k = node.start; k < node.start + node.count; ++k) {
+            const Primitive& p = m_primitives[k];
+#ifdef ATOMICA_RAYTRACER_SSE2
+            if (p.kind == 0) {
+                // Sphere against all four rays at once
+                __m128 cx = _mm_sub_ps(ox, _mm_set1_ps(p.a.x));
+                __m128 cy = _mm_sub_ps(oy, _mm_set1_ps(p.a.y));
+                __m128 cz = _mm_sub_ps(oz, _mm_set1_ps(p.a.z));
+                __m128 b = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, dx), _mm_mul_ps(cy, dy)), _mm_mul_ps(cz, dz));
+                __m128 c = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, cx), _mm_mul_ps(cy, cy)), _mm_mul_ps(cz, cz)),
+                                      _mm_set1_ps(p.radius * p.radius));
+                __m128 h = _mm_sub_ps(_mm_mul_ps(b, b), c);
+                __m128 valid = _mm_cmpge_ps(h, zero);
+                __m128 root = _mm_sqrt_ps(_mm_max_ps(h, zero));
+                __m128 tNear = _mm_sub_ps(_mm_sub_ps(zero, b), root);
+                __m128 tFar = _mm_add_ps(_mm_sub_ps(zero, b), root);
+                __m128 nearOk = _mm_cmpgt_ps(tNear, epsilon);
+                __m128 t = _mm_or_ps(_mm_and_ps(nearOk, tNear), _mm_andnot_ps(nearOk, tFar));
+                valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpgt_ps(t, epsilon), _mm_cmplt_ps(t, tHit)));
+                int hits = _mm_movemask_ps(valid) & packet.activeMask;
+                if (!hits) continue;
+                tHit = _mm_or_ps(_mm_and_ps(valid, t), _mm_andnot_ps(valid, tHit));
+                for (int l = 0; l < 4; ++l) {
+                    if (hits & (1 << l)) packet.primitive[l] = k;
+                }
+                _mm_store_ps(packet.t, tHit);
+                continue;
+            }
+#endif
+            for (int l = 0; l < 4; ++l) {
+                if (!(mask & (1 << l))) continue;
+                glm::vec3 o(packet.ox[l], packet.oy[l], packet.oz[l]);
+                glm::vec3 d(packet.dx[l], packet.dy[l], packet.dz[l]);
+                bool hit = p.kind == 0 ? intersectSphere(o, d, p.a, p.radius, tMin, packet.t[l])
+                                       : intersectCylinder(o, d, p.a, p.b, p.radius, tMin, packet.t[l]);
+                if (hit) packet.primitive[l] = k;
+            }
+#ifdef ATOMICA_RAYTRACER_SSE2
+            tHit = _mm_load_ps(packet.t);
+#endif
+        }
+    }
+}
+
+bool RayTracer::occluded(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const {
+    if (m_nodes.empty()) return false;
+    const glm::vec3 inv(safeInverse(direction.x), safeInverse(direction.y), safeInverse(direction.z));
+    uint32_t stack[STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = m_nodes[stack[--top]];
+        glm::vec3 t0 = (node.lo - origin) * inv, t1 = (node.hi - origin) * inv;
+        glm::vec3 tNear = glm::min(t0, t1), tFar = glm::max(t0, t1);
+        float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+        float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+        if (enter > exit) continue;
+
+        if (node.count == 0) {
+            stack[top++] = node.start;
+            stack[top++] = node.start + 1;
+            continue;
+        }
+        for (uint32_t k = node.start; k < node.start + node.count; ++k) {
+            const Primitive& p = m_primitives[k];
+            float t = maxDistance;
+            bool hit = p.kind == 0 ? intersectSphere(origin, direction, p.a, p.radius, 1e-4f, t)
+                                   : intersectCylinder(origin, direction, p.a, p.b, p.radius, 1e-4f, t);
+            if (hit) return true;
+        }
+    }
+    return false;
+}
+
+// ─── Shading ──────────────────────────────────────────────────────────
+
+glm::vec3 RayTracer::shade(const glm::vec3& origin, const glm::vec3& direction, const Hit& hit,
+                           const RayTracerSettings& settings, const glm::vec3& lightDirection, uint32_t seed) const {
+    const Primitive& p = m_primitives[hit.primitive];
+    glm::vec3 point = origin + hit.t * direction;
+    glm::vec3 normal;
+    if (p.kind == 0) {
+        normal = (point - p.a) / p.radius;
+    } else {
+        glm::vec3 axis = p.b - p.a;
+        float y = glm::clamp(glm::dot(point - p.a, axis) / glm::dot(axis, axis), 0.0f, 1.0f);
+        normal = glm::normalize(point - (p.a + y * axis));
+    }
+    if (glm::dot(normal, direction) > 0.0f) normal = -normal;
+
+    // Secondary rays start just off the surface
+    glm::vec3 surface = point + normal * (1e-3f * p.radius);
+    glm::vec3 tangent, bitangent;
+    orthonormalBasis(normal, tangent, bitangent);
+    Random random(seed);
+
+    float ambientOcclusion = 1.0f;
+    if (settings.aoSamples > 0) {
+        int open = 0;
+        for (int s = 0; s < settings.aoSamples; ++s) {
+            // Cosine-weighted hemisphere
+            float u = random.uniform(), v = random.uniform();
+            float r = std::sqrt(u), phi = 2.0f * PI * v;
+            glm::vec3 d = r * std::cos(phi) * tangent + r * std::sin(phi) * bitangent
+                        + std::sqrt(std::max(0.0f, 1.0f - u)) * normal;
+            if (!occluded(surface, d, settings.aoDistance)) ++open;
+        }
+        ambientOcclusion = float(open) / settings.aoSamples;
+    }
+
+    float diffuse = glm::dot(normal, lightDirection);
+    float visibility = diffuse > 0.0f ? 1.0f : 0.0f;
+    if (diffuse > 0.0f && settings.shadowSamples > 0) {
+        glm::vec3 lt, lb;
+        orthonormalBasis(lightDirection, lt, lb);
+        float cosMax = std::cos(settings.lightAngle);
+        int lit = 0;
+        for (int s = 0; s < settings.shadowSamples; ++s) {
+            // Uniform over the cone the light subtends: soft shadow edges
+            float cosTheta = 1.0f - random.uniform() * (1.0f - cosMax);
+            float sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
+            float phi = 2.0f * PI * random.uniform();
+            glm::vec3 d = sinTheta * std::cos(phi) * lt + sinTheta * std::sin(phi) * lb + cosTheta * lightDirection;
+            if (!occluded(surface, d, INF)) ++lit;
+        }
+        visibility = float(lit) / settings.shadowSamples;
+    }
+
+    glm::vec3 halfway = glm::normalize(lightDirection - direction);
+    float specular = std::pow(std::max(glm::dot(normal, halfway), 0.0f), 48.0f);
+    return p.color * (settings.ambient * ambientOcclusion + (1.0f - settings.ambient) * std::max(diffuse, 0.0f) * visibility)
+         + glm::vec3(settings.specular * specular * visibility);
+}
+
+// ─── Rendering ────────────────────────────────────────────────────────
+
+void RayTracer::render(const Camera& camera, const RayTracerSettings& settings, std::vector<uint8_t>& rgb) const {
+    const int width = std::max(1, settings.width), height = std::max(1, settings.height);
+    const int samples = std::max(1, settings.samplesPerPixel);
+    rgb.assign(size_t(width) * height * 3, 0);
+
+    const glm::vec3 origin = camera.getPosition();
+    const glm::vec3 forward = glm::normalize(camera.getTarget() - origin);
+    const glm::vec3 right = glm::normalize(glm::cross(forward, camera.getUp()));
+    const glm::vec3 up = glm::cross(right, forward);
+    const float tanHalf = std::tan(0.5f * camera.getFov() * PI / 180.0f);
+    const float aspect = float(width) / height;
+    const glm::vec3 light = glm::normalize(settings.lightDirection);
+    const int strata = static_cast<int>(std::ceil(std::sqrt(float(samples))));
+
+    const int tilesX = (width + TILE - 1) / TILE, tilesY = (height + TILE - 1) / TILE;
+    TaskScheduler::getInstance().parallelFor(0, size_t(tilesX) * tilesY, [&](size_t begin, size_t end) {
+        for (size_t tile = begin; tile < end; ++tile) {
+            int x0 = static_cast<int>(tile % tilesX) * TILE, y0 = static_cast<int>(tile / tilesX) * TILE;
+            for (int py = y0; py < std::min(y0 + TILE, height); py += 2) {
+                for (int px = x0; px < std::min(x0 + TILE, width); px += 2) {
+                    glm::vec3 sum[4] = {glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(0.0f)};
+                    for (int s = 0; s < samples; ++s) {
+                        // One stratified jitter per pass, shared by the 2x2 packet
+                        Random jitter(uint32_t(py * width + px) * 977u + s);
+                        float jx = samples == 1 ? 0.5f : ((s % strata) + jitter.uniform()) / strata;
+                        float jy = samples == 1 ? 0.5f : ((s / strata) + jitter.uniform()) / strata;
+
+                        Packet packet;
+                        packet.activeMask = 0;
+                        for (int l = 0; l < 4; ++l) {
+                            int x = px + (l & 1), y = py + (l >> 1);
+                            if (x < width && y < height) packet.activeMask |= 1 << l;
+                            float sx = (2.0f * (x + jx) / width - 1.0f) * tanHalf * aspect;
+                            float sy = (1.0f - 2.0f * (y + jy) / height) * tanHalf;
+                            glm::vec3 d = glm::normalize(forward + sx * right + sy * up);
+                            packet.ox[l] = origin.x; packet.oy[l] = origin.y; packet.oz[l] = origin.z;
+                            packet.dx[l] = d.x; packet.dy[l] = d.y; packet.dz[l] = d.z;
+                            packet.ix[l] = safeInverse(d.x);
+                            packet.iy[l] = safeInverse(d.y);
+                            packet.iz[l] = safeInverse(d.z);
+                            packet.t[l] = INF;
+                            packet.primitive[l] = 0;
+                        }
+                        tracePacket(packet);
+
+                        for (int l = 0; l < 4; ++l) {
+                            if (!(packet.activeMask & (1 << l))) continue;
+                            if (packet.t[l] == INF) {
+                                sum[l] += settings.background;
+                                continue;
+                            }
+                            int x = px + (l & 1), y = py + (l >> 1);
+                            Hit hit;
+                            hit.t = packet.t[l];
+                            hit.primitive = packet.primitive[l];
+                            glm::vec3 d(packet.dx[l], packet.dy[l], packet.dz[l]);
+                            uint32_t seed = (uint32_t(y) * width + x) * uint32_t(samples) + s;
+                            sum[l] += shade(origin, d, hit, settings, light, seed);
+                        }
+                    }
+
+                    for (int l = 0; l < 4; ++l) {
+                        int x = px + (l & 1), y = py + (l >> 1);
+                        if (x >= width || y >= height) continue;
+                        glm::vec3 c = glm::clamp(sum[l] / float(samples), 0.0f, 1.0f);
+                        uint8_t* out = &rgb[(size_t(y) * width + x) * 3];
+                        for (int k = 0; k < 3; ++k) {
+                            out[k] = static_cast<uint8_t>(std::pow(c[k], 1.0f / 2.2f) * 255.0f + 0.5f);
+                        }
+                    }
+                }
+            }
+        }
+    }, 1);
+}
+
+bool RayTracer::writePPM(const std::string& path, int width, int height, const std::vector<uint8_t>& rgb) {
+    if (rgb.size() != size_t(width) * height * 3) return false;
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) return false;
+    out << "P6\n" << width << ' ' << height << "\n255\n";
+    out.write(reinterpret_cast<const char*>(rgb.data()), static_cast<std::streamsize>(rgb.size()));
+    return out.good();
+}
+
+Camera RayTracer::frameScene(const RayScene& scene, const glm::vec3& viewDirection, float fovDegrees, float aspect) {
+    glm::vec3 lo, hi;
+    if (!scene.getBounds(lo, hi)) {
+        lo = glm::vec3(-1.0f);
+        hi = glm::vec3(1.0f);
+    }
+    glm::vec3 center = 0.5f * (lo + hi);
+    float radius = 0.5f * glm::length(hi - lo);
+
+    // Fit the bounding sphere into the narrower of the two fields of view
+    float halfFov = 0.5f * fovDegrees * PI / 180.0f;
+    float halfNarrow = aspect < 1.0f ? std::atan(std::tan(halfFov) * aspect) : halfFov;
+    float distance = radius / std::sin(halfNarrow);
+
+    glm::vec3 direction = glm::length(viewDirection) > 0.0f ? glm::normalize(viewDirection) : glm::vec3(0, 0, 1);
+    glm::vec3 up = std::fabs(direction.y) > 0.99f ? glm::vec3(0, 0, 1) : glm::vec3(0, 1, 0);
+    return Camera(center + distance * direction, center, up);
+}
@@ -0,0 +1,170 @@
+#ifndef RAY_TRACER_H
+#define RAY_TRACER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Camera.h"
+
+/**
+ * @brief Spheres and cylinders to ray trace: atoms and bonds.
+ */
+struct RayScene {
+    struct Sphere {
+        glm::vec3 center;
+        float radius;
+        glm::vec3 color;
+    };
+
+    struct Cylinder {
+        glm::vec3 a, b;
+        float radius;
+        glm::vec3 color;
+    };
+
+    std::vector<Sphere> spheres;
+    std::vector<Cylinder> cylinders;
+
+    /**
+     * @brief Adds atoms with the renderer's element colors and radii.
+     *
+     * @param x Atom x coordinates.
+     * @param y Atom y coordinates.
+     * @param z Atom z coordinates.
+     * @param atomicNumber Atomic numbers.
+     * @param count Number of atoms.
+     * @param radiusScale Multiplier on the display radii.
+     */
+    void addAtoms(const float* x, const float* y, const float* z, const uint8_t* atomicNumber, size_t count,
+                  float radiusScale = 1.0f);
+
+    /**
+     * @brief Adds a cylinder per bond between atoms added by addAtoms().
+     *
+     * @param bondOffsets CSR row offsets (atom count + 1 entries).
+     * @param bondNeighbors Bonded atom indices; each bond is added once.
+     * @param radius Cylinder radius.
+     * @param color Cylinder color.
+     */
+    void addBonds(const std::vector<uint32_t>& bondOffsets, const std::vector<uint32_t>& bondNeighbors,
+                  float radius, const glm::vec3& color = glm::vec3(0.8f));
+
+    /**
+     * @brief Gets the bounding box of everything in the scene.
+     *
+     * @param lo Receives the minimum corner.
+     * @param hi Receives the maximum corner.
+     * @return False if the scene is empty.
+     */
+    bool getBounds(glm::vec3& lo, glm::vec3& hi) const;
+};
+
+/**
+ * @brief Quality and lighting settings for RayTracer::render().
+ */
+struct RayTracerSettings {
+    int width = 1920;
+    int height = 1080;
+    int samplesPerPixel = 1;       ///< Jittered primary samples per pixel
+    int aoSamples = 8;             ///< Ambient-occlusion rays per sample (0 disables AO)
+    float aoDistance = 2.0f;       ///< Occluders farther than this do not darken
+    int shadowSamples = 4;         ///< Shadow rays per sample (0 disables shadows)
+    glm::vec3 lightDirection = glm::vec3(0.4f, 0.8f, 0.6f);  ///< Toward the light
+    float lightAngle = 0.05f;      ///< Angular radius of the light in radians; 0 gives hard shadows
+    float ambient = 0.35f;
+    float specular = 0.25f;
+    glm::vec3 background = glm::vec3(1.0f);
+};
+
+/**
+ * @brief Multithreaded CPU ray tracer for atom and bond renders without a GPU.
+ *
+ * Primitives are indexed by a bounding volume hierarchy built with the
+ * binned surface area heuristic. Primary rays are traced in 2x2 packets with
+ * SSE, so each BVH node is tested against four coherent rays at once; shadow
+ * and ambient-occlusion rays are incoherent and traced one at a time as
+ * any-hit queries. The image is split into tiles rendered in parallel on
+ * the TaskScheduler. Random numbers are hashed from the pixel and sample
+ * index, so renders are deterministic regardless of thread count.
+ */
+class RayTracer {
+public:
+    RayTracer();
+
+    /**
+     * @brief Builds the BVH over a scene; the scene is copied.
+     *
+     * @param scene The spheres and cylinders.
+     */
+    void build(const RayScene& scene);
+
+    /**
+     * @brief Renders an image.
+     *
+     * @param camera The camera; its aspect ratio is taken from the settings.
+     * @param settings Resolution, sampling and lighting.
+     * @param rgb Receives width·height·3 sRGB bytes, top row first.
+     */
+    void render(const Camera& camera, const RayTracerSettings& settings, std::vector<uint8_t>& rgb) const;
+
+    /**
+     * @brief Writes an image as binary PPM.
+     *
+     * @param path The output file.
+     * @param width Image width.
+     * @param height Image height.
+     * @param rgb The pixels from render().
+     * @return True on success.
+     */
+    static bool writePPM(const std::string& path, int width, int height, const std::vector<uint8_t>& rgb);
+
+    /**
+     * @brief Places a camera so the whole scene is in view.
+     *
+     * @param scene The scene.
+     * @param viewDirection Direction from the scene center toward the camera.
+     * @param fovDegrees Vertical field of view the camera uses.
+     * @param aspect Image width over height.
+     * @return The camera.
+     */
+    static Camera frameScene(const RayScene& scene, const glm::vec3& viewDirection, float fovDegrees, float aspect);
+
+    size_t getPrimitiveCount() const { return m_primitives.size(); }
+    size_t getNodeCount() const { return m_nodes.size(); }
+
+private:
+    /// A sphere (b unused) or a cylinder from a to b, in BVH order
+    struct Primitive {
+        glm::vec3 a;
+        float radius;
+        glm::vec3 b;
+        uint32_t kind;  ///< 0 sphere, 1 cylinder
+        glm::vec3 color;
+    };
+
+    /// Internal nodes have count 0 and children at start and start + 1
+    struct Node {
+        glm::vec3 lo;
+        uint32_t start;
+        glm::vec3 hi;
+        uint32_t count;
+    };
+
+    struct Hit;
+    struct Packet;
+
+    std::vector<Primitive> m_primitives;
+    std::vector<Node> m_nodes;
+
+    void buildNode(uint32_t nodeIndex, std::vector<uint32_t>& order, const std::vector<glm::vec3>& boxLo,
+                   const std::vector<glm::vec3>& boxHi, const std::vector<glm::vec3>& centroids,
+                   uint32_t begin, uint32_t end, int depth);
+    void tracePacket(Packet& packet) const;
+    bool occluded(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const;
+    glm::vec3 shade(const glm::vec3& origin, const glm::vec3& direction, const Hit& hit,
+                    const RayTracerSettings& settings, const glm::vec3& lightDirection, uint32_t seed) const;
+};
+
+#endif // RAY_TRACER_H
@@ -0,0 +1,349 @@
+#include "ReactionNetwork.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+// ROS3 (Sandu et al., Atmos. Environ. 31, 1997): three stages, order 3, L-stable,
+// with an embedded order 2 solution for the error estimate
+const int STAGES = 3;
+const double GAMMA = 0.43586652150845899941601945119356;
+const double ROS_A[3] = {1.0, 1.0, 0.0};  ///< Lower triangle by rows: a21, a31, a32
+const double ROS_C[3] = {-1.0156171083877702091975600115545, 4.0759956452537699824805835358067,
+                         9.2076794298330791242156818474003};
+const double ROS_M[3] = {1.0, 6.1697947043828245592553615689730, -0.42772256543218573326238373806514};
+const double ROS_E[3] = {0.5, -2.9079558716805469821718236208017, 0.22354069897811569627360909276199};
+const bool ROS_NEW_F[3] = {true, true, false};
+const double ERROR_ORDER = 3.0;
+
+// Step size control
+const double SAFETY = 0.9;
+const double MIN_FACTOR = 0.2;
+const double MAX_FACTOR = 6.0;
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t");
+    if (begin == std::string::npos) return std::string();
+    size_t end = text.find_last_not_of(" \t");
+    return text.substr(begin, end - begin + 1);
+}
+}
+
+uint32_t ReactionNetwork::addSpecies(const std::string& name, double concentration) {
+    int existing = findSpecies(name);
+    if (existing >= 0) return static_cast<uint32_t>(existing);
+    m_names.push_back(name);
+    m_concentrations.push_back(concentration);
+    m_analyzed = false;
+    return static_cast<uint32_t>(m_names.size() - 1);
+}
+
+int ReactionNetwork::findSpecies(const std::string& name) const {
+    auto found = std::find(m_names.begin(), m_names.end(), name);
+    return found == m_names.end() ? -1 : static_cast<int>(found - m_names.begin());
+}
+
+uint32_t ReactionNetwork::addReaction(const std::vector<Term>& reactants, const std::vector<Term>& products,
+                                      double preExponential, double temperatureExponent,
+                                      double activationEnergy) {
+    if (m_reactantStart.empty()) m_reactantStart.push_back(0);
+    if (m_changeStart.empty()) m_changeStart.push_back(0);
+
+    // Repeated species become one term with the summed order
+    std::vector<Term> orders;
+    for (const Term& term : reactants) {
+        auto found = std::find_if(orders.begin(), orders.end(), [&](const Term& t) { return t.first == term.first; });
+        if (found != orders.end()) found->second += term.second;
+        else orders.push_back(term);
+    }
+    for (const Term& term : orders) {
+        m_reactantSpecies.push_back(term.first);
+        m_reactantOrders.push_back(term.second);
+    }
+    m_reactantStart.push_back(static_cast<uint32_t>(m_reactantSpecies.size()));
+
+    // Net change per species; catalysts cancel out
+    std::vector<Term> changes;
+    auto accumulate = [&](const Term& term, int sign) {
+        auto found = std::find_if(changes.begin(), changes.end(), [&](const Term& t) { return t.first == term.first; });
+        if (found != changes.end()) found->second += sign * term.second;
+        else changes.emplace_back(term.first, sign * term.second);
+    };
+    for (const Term& term : reactants) accumulate(term, -1);
+    for (const Term& term : products) accumulate(term, 1);
+    for (const Term& change : changes) {
+        if (change.second == 0) continue;
+        m_changeSpecies.push_back(change.first);
+        m_changeCoefficients.push_back(change.second);
+    }
+    m_changeStart.push_back(static_cast<uint32_t>(m_changeSpecies.size()));
+
+    m_preExponentials.push_back(preExponential);
+    m_temperatureExponents.push_back(temperatureExponent);
+    m_activationEnergies.push_back(activationEnergy);
+    m_rateConstants.push_back(0.0);
+    m_analyzed = false;
+    return static_cast<uint32_t>(m_rateConstants.size() - 1);
+}
+
+int ReactionNetwork::addReaction(const std::string& equation, double preExponential, double temperatureExponent,
+                                 double activationEnergy) {
+    size_t arrow = equation.find("->");
+    if (arrow == std::string::npos) return -1;
+    std::vector<Term> sides[2];
+    std::string texts[2] = {equation.substr(0, arrow), equation.substr(arrow + 2)};
+    for (int side = 0; side < 2; ++side) {
+        std::stringstream stream(texts[side]);
+        std::string part;
+        while (std::getline(stream, part, '+')) {
+            part = trim(part);
+            if (part.empty()) return -1;
+            int coefficient = 1;
+            size_t digits = 0;
+            while (digits < part.size() && std::isdigit(static_cast<unsigned char>(part[digits]))) ++digits;
+            if (digits > 0) {
+                coefficient = std::atoi(part.substr(0, digits).c_str());
+                part = trim(part.substr(digits));
+            }
+            if (part.empty() || coefficient <= 0) return -1;
+            sides[side].emplace_back(addSpecies(part), coefficient);
+        }
+        if (sides[side].empty()) return -1;
+    }
+    return static_cast<int>(addReaction(sides[0], sides[1], preExponential, temperatureExponent, activationEnergy));
+}
+
+int ReactionNetwork::addReaction(const std::string& equation, double preExponential, double temperatureExponent,
+                                 const std::vector<Bond::Type>& broken, const std::vector<Bond::Type>& formed,
+                                 const BondCalculator& bonds) {
+    return addReaction(equation, preExponential, temperatureExponent, bonds.estimateActivationEnergy(broken, formed));
+}
+
+void ReactionNetwork::addHydrogenOxygenMechanism(const BondCalculator& bonds) {
+    using T = Bond::Type;
+    // Collision-limited prefactors: ~1e13 /s for dissociation, ~1e11 L/(mol s) for two-body steps
+    const double UNIMOLECULAR = 1e13, BIMOLECULAR = 1e11;
+    addSpecies("H2");
+    addSpecies("O2");
+    // Initiation
+    addReaction("H2 -> 2 H", UNIMOLECULAR, 0.0, {T::SINGLE}, {}, bonds);
+    addReaction("O2 -> 2 O", UNIMOLECULAR, 0.0, {T::DOUBLE}, {}, bonds);
+    // Chain branching
+    addReaction("H + O2 -> OH + O", BIMOLECULAR, 0.0, {T::DOUBLE}, {T::SINGLE}, bonds);
+    addReaction("O + H2 -> OH + H", BIMOLECULAR, 0.0, {T::SINGLE}, {T::SINGLE}, bonds);
+    // Chain propagation
+    addReaction("OH + H2 -> H2O + H", BIMOLECULAR, 0.0, {T::SINGLE}, {T::SINGLE}, bonds);
+    addReaction("OH + OH -> H2O + O", BIMOLECULAR, 0.0, {T::SINGLE}, {T::SINGLE}, bonds);
+    // Recombination
+    addReaction("H + OH -> H2O", BIMOLECULAR, 0.0, {}, {T::SINGLE}, bonds);
+    addReaction("H + H -> H2", BIMOLECULAR, 0.0, {}, {T::SINGLE}, bonds);
+    addReaction("O + O -> O2", BIMOLECULAR, 0.0, {}, {T::DOUBLE}, bonds);
+    addReaction("H + O -> OH", BIMOLECULAR, 0.0, {}, {T::SINGLE}, bonds);
+}
+
+void ReactionNetwork::clear() {
+    m_names.clear();
+    m_concentrations.clear();
+    m_preExponentials.clear();
+    m_temperatureExponents.clear();
+    m_activationEnergies.clear();
+    m_rateConstants.clear();
+    m_reactantStart.clear();
+    m_reactantSpecies.clear();
+    m_reactantOrders.clear();
+    m_changeStart.clear();
+    m_changeSpecies.clear();
+    m_changeCoefficients.clear();
+    m_analyzed = false;
+    m_stepSize = 0.0;
+    m_acceptedSteps = 0;
+    m_rejectedSteps = 0;
+}
+
+void ReactionNetwork::setTemperature(double kelvin) {
+    if (kelvin > 0.0) m_temperature = kelvin;
+    updateRateConstants();
+}
+
+void ReactionNetwork::setTolerances(double relative, double absolute) {
+    if (relative > 0.0) m_relativeTolerance = relative;
+    if (absolute > 0.0) m_absoluteTolerance = absolute;
+}
+
+void ReactionNetwork::updateRateConstants() {
+    const double inverseThermal = 1.0 / (BOLTZMANN_EV_PER_K * m_temperature);
+    for (size_t r = 0; r < m_rateConstants.size(); ++r) {
+        m_rateConstants[r] = m_preExponentials[r] * std::pow(m_temperature, m_temperatureExponents[r]) *
+                             std::exp(-m_activationEnergies[r] * inverseThermal);
+    }
+}
+
+void ReactionNetwork::analyze() {
+    const size_t n = m_names.size();
+    const size_t reactions = m_rateConstants.size();
+    if (m_reactantStart.empty()) m_reactantStart.push_back(0);
+    if (m_changeStart.empty()) m_changeStart.push_back(0);
+
+    // dc_i/dt depends on c_j wherever j is a reactant of a reaction that changes i
+    std::vector<std::vector<uint32_t>> rows(n);
+    for (size_t i = 0; i < n; ++i) rows[i].push_back(static_cast<uint32_t>(i));
+    for (size_t r = 0; r < reactions; ++r) {
+        for (uint32_t t = m_reactantStart[r]; t < m_reactantStart[r + 1]; ++t) {
+            for (uint32_t c = m_changeStart[r]; c < m_changeStart[r + 1]; ++c) {
+                rows[m_changeSpecies[c]].push_back(m_reactantSpecies[t]);
+            }
+        }
+    }
+    std::vector<uint32_t> rowStart(n + 1, 0), columns;
+    for (size_t i = 0; i < n; ++i) {
+        std::sort(rows[i].begin(), rows[i].end());
+        rows[i].erase(std::unique(rows[i].begin(), rows[i].end()), rows[i].end());
+        columns.insert(columns.end(), rows[i].begin(), rows[i].end());
+        rowStart[i + 1] = static_cast<uint32_t>(columns.size());
+    }
+    m_lu.analyze(n, rowStart, columns);
+
+    m_scatterStart.assign(1, 0);
+    m_scatterSlots.clear();
+    m_scatterCoefficients.clear();
+    for (size_t r = 0; r < reactions; ++r) {
+        for (uint32_t t = m_reactantStart[r]; t < m_reactantStart[r + 1]; ++t) {
+            for (uint32_t c = m_changeStart[r]; c < m_changeStart[r + 1]; ++c) {
+                m_scatterSlots.push_back(static_cast<uint32_t>(m_lu.findEntry(m_changeSpecies[c],
+                                                                              m_reactantSpecies[t])));
+                m_scatterCoefficients.push_back(-m_changeCoefficients[c]);
+            }
+            m_scatterStart.push_back(static_cast<uint32_t>(m_scatterSlots.size()));
+        }
+    }
+    m_diagonalSlots.resize(n);
+    for (size_t i = 0; i < n; ++i) m_diagonalSlots[i] = static_cast<uint32_t>(m_lu.findDiagonal(uint32_t(i)));
+
+    m_rates.assign(reactions, 0.0);
+    m_stages.assign(STAGES * n, 0.0);
+    m_trial.assign(n, 0.0);
+    m_derivatives.assign(n, 0.0);
+    updateRateConstants();
+    m_analyzed = true;
+}
+
+void ReactionNetwork::computeDerivatives(const double* concentrations, double* derivatives) {
+    if (!m_analyzed) analyze();
+    std::fill(derivatives, derivatives + m_names.size(), 0.0);
+    for (size_t r = 0; r < m_rateConstants.size(); ++r) {
+        double rate = m_rateConstants[r];
+        for (uint32_t t = m_reactantStart[r]; t < m_reactantStart[r + 1]; ++t) {
+            double c = concentrations[m_reactantSpecies[t]];
+            for (int k = 0; k < m_reactantOrders[t]; ++k) rate *= c;
+        }
+        for (uint32_t c = m_changeStart[r]; c < m_changeStart[r + 1]; ++c) {
+            derivatives[m_changeSpecies[c]] += m_changeCoefficients[c] * rate;
+        }
+    }
+}
+
+void ReactionNetwork::assembleMatrix(const double* concentrations, double diagonal) {
+    std::vector<double>& values = m_lu.getValues();
+    std::fill(values.begin(), values.end(), 0.0);
+    for (size_t r = 0; r < m_rateConstants.size(); ++r) {
+        const uint32_t first = m_reactantStart[r], last = m_reactantStart[r + 1];
+        for (uint32_t t = first; t < last; ++t) {
+            // ∂rate/∂c_t = k · order · c_t^(order - 1) · Π over the other terms
+            int order = m_reactantOrders[t];
+            double partial = m_rateConstants[r] * order;
+            double c = concentrations[m_reactantSpecies[t]];
+            for (int k = 1; k < order; ++k) partial *= c;
+            for (uint32_t u = first; u < last; ++u) {
+                if (u == t) continue;
+                double other = concentrations[m_reactantSpecies[u]];
+                for (int k = 0; k < m_reactantOrders[u]; ++k) partial *= other;
+            }
+            for (uint32_t s = m_scatterStart[t]; s < m_scatterStart[t + 1]; ++s) {
+                values[m_scatterSlots[s]] += m_scatterCoefficients[s] * partial;
+            }
+        }
+    }
+    for (uint32_t slot : m_diagonalSlots) values[slot] += diagonal;
+}
+
+bool ReactionNetwork::integrate(double duration) {
+    if (!m_analyzed) analyze();
+    const size_t n = m_names.size();
+    if (n == 0 || duration <= 0.0) return true;
+
+    double* y = m_concentrations.data();
+    double* trial = m_trial.data();
+    double* f = m_derivatives.data();
+    double* k[STAGES];
+    for (int s = 0; s < STAGES; ++s) k[s] = m_stages.data() + s * n;
+
+    double h = m_stepSize > 0.0 ? m_stepSize : 1e-3 * duration;
+    double time = 0.0;
+    while (time < duration) {
+        bool last = h >= duration - time;
+        double step = last ? duration - time : h;
+        if (step < 1e-14 * duration) return false;
+
+        // One factorization of I / (γh) - J serves all stages
+        assembleMatrix(y, 1.0 / (GAMMA * step));
+        if (!m_lu.factor()) {
+            h = 0.5 * step;
+            ++m_rejectedSteps;
+            continue;
+        }
+        for (int s = 0; s < STAGES; ++s) {
+            if (s == 0) {
+                computeDerivatives(y, f);
+            } else if (ROS_NEW_F[s]) {
+                for (size_t i = 0; i < n; ++i) trial[i] = y[i];
+                for (int j = 0; j < s; ++j) {
+                    double a = ROS_A[s * (s - 1) / 2 + j];
+                    if (a == 0.0) continue;
+                    for (size_t i = 0; i < n; ++i) trial[i] += a * k[j][i];
+                }
+                computeDerivatives(trial, f);
+            }
+            for (size_t i = 0; i < n; ++i) k[s][i] = f[i];
+            for (int j = 0; j < s; ++j) {
+                double c = ROS_C[s * (s - 1) / 2 + j] / step;
+                for (size_t i = 0; i < n; ++i) k[s][i] += c * k[j][i];
+            }
+            m_lu.solve(k[s]);
+        }
+
+        // New solution into trial, weighted error against the embedded one
+        double error = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            double next = y[i], estimate = 0.0;
+            for (int s = 0; s < STAGES; ++s) {
+                next += ROS_M[s] * k[s][i];
+                estimate += ROS_E[s] * k[s][i];
+            }
+            trial[i] = next;
+            double scale = m_absoluteTolerance + m_relativeTolerance * std::max(std::fabs(y[i]), std::fabs(next));
+            error += (estimate / scale) * (estimate / scale);
+        }
+        error = std::sqrt(error / double(n));
+        if (!std::isfinite(error)) {
+            h = MIN_FACTOR * step;
+            ++m_rejectedSteps;
+            continue;
+        }
+        double factor = std::min(MAX_FACTOR, std::max(MIN_FACTOR, SAFETY * std::pow(std::max(error, 1e-10),
+                                                                                    -1.0 / ERROR_ORDER)));
+        if (error > 1.0) {
+            h = step * std::min(1.0, factor);
+            ++m_rejectedSteps;
+            continue;
+        }
+        for (size_t i = 0; i < n; ++i) y[i] = std::max(0.0, trial[i]);
+        time = last ? duration : time + step;
+        ++m_acceptedSteps;
+        // A final step shortened to hit the end says little about the next one
+        h = last && step < h ? h : step * factor;
+    }
+    m_stepSize = h;
+    return true;
+}
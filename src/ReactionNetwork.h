@@ -0,0 +1,186 @@
+#ifndef REACTION_NETWORK_H
+#define REACTION_NETWORK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "BondCalculator.h"
+#include "SparseLU.h"
+
+/**
+ * @brief Mass-action kinetics of bulk species concentrations.
+ *
+ * This is for bulk chemistry, where tracking individual atoms is not
+ * needed. Each reaction has an Arrhenius rate constant
+ * k = A T^b exp(-Ea / k_B T) and a rate k Π c_s^ν_s over its reactants.
+ * Concentrations are in mol/L, times in seconds. A is in matching units
+ * (1/s for one reactant, L/(mol·s) for two).
+ *
+ * Radical recombination runs many orders of magnitude faster than
+ * dissociation, so these systems are stiff. integrate() therefore uses the
+ * three-stage L-stable Rosenbrock method ROS3 with an embedded error
+ * estimate and adaptive steps. Each step needs one factorization of
+ * I / (γh) - J. The Jacobian is analytic. Every reactant term of every
+ * reaction has a precomputed list of the Jacobian slots it feeds, so
+ * assembly is a scatter. The slots sit directly in the SparseLU pattern,
+ * which is ordered and analyzed once when the network changes, and only
+ * refactored numerically per step.
+ */
+class ReactionNetwork {
+public:
+    /// Boltzmann constant in eV/K
+    static constexpr double BOLTZMANN_EV_PER_K = 8.617333262e-5;
+
+    /// One species in a reaction with its stoichiometric coefficient
+    using Term = std::pair<uint32_t, int>;
+
+    ReactionNetwork() = default;
+
+    /**
+     * @brief Adds a species, or finds it if the name is taken.
+     *
+     * @param name Species name, e.g. "H2O".
+     * @param concentration Initial concentration for a new species, in mol/L.
+     * @return The species index.
+     */
+    uint32_t addSpecies(const std::string& name, double concentration = 0.0);
+
+    /// Index of a species, or -1
+    int findSpecies(const std::string& name) const;
+
+    /**
+     * @brief Adds an irreversible reaction.
+     *
+     * @param reactants Species and orders; the rate is k Π c^order.
+     * @param products Species and coefficients produced.
+     * @param preExponential A in the Arrhenius form.
+     * @param temperatureExponent b in the Arrhenius form.
+     * @param activationEnergy Ea in eV.
+     * @return The reaction index.
+     */
+    uint32_t addReaction(const std::vector<Term>& reactants, const std::vector<Term>& products,
+                         double preExponential, double temperatureExponent, double activationEnergy);
+
+    /**
+     * @brief Adds a reaction written as an equation, e.g. "2 H2 + O2 -> 2 H2O".
+     *
+     * Species that do not exist yet are added with zero concentration.
+     *
+     * @return The reaction index, or -1 if the equation does not parse.
+     */
+    int addReaction(const std::string& equation, double preExponential, double temperatureExponent,
+                    double activationEnergy);
+
+    /**
+     * @brief Adds a reaction whose activation energy comes from bond energies.
+     *
+     * @param broken Bonds broken by the reaction.
+     * @param formed Bonds formed by the reaction.
+     * @param bonds Supplies the energies (see BondCalculator::estimateActivationEnergy()).
+     * @return The reaction index, or -1 if the equation does not parse.
+     */
+    int addReaction(const std::string& equation, double preExponential, double temperatureExponent,
+                    const std::vector<Bond::Type>& broken, const std::vector<Bond::Type>& formed,
+                    const BondCalculator& bonds);
+
+    /**
+     * @brief Builds a small hydrogen–oxygen combustion mechanism.
+     *
+     * Six species, H2, O2, H, O, OH and H2O, with dissociation, chain
+     * branching, chain propagation and recombination steps. Activation
+     * energies come from the bond energies in the calculator.
+     */
+    void addHydrogenOxygenMechanism(const BondCalculator& bonds);
+
+    /// Removes every species and reaction
+    void clear();
+
+    /**
+     * @brief Sets the temperature for every rate constant.
+     *
+     * @param kelvin Temperature in K.
+     */
+    void setTemperature(double kelvin);
+
+    /**
+     * @brief Sets the error tolerances of integrate().
+     *
+     * @param relative Relative tolerance per species.
+     * @param absolute Absolute tolerance in mol/L.
+     */
+    void setTolerances(double relative, double absolute);
+
+    void setConcentration(uint32_t species, double concentration) { m_concentrations[species] = concentration; }
+    const std::vector<double>& getConcentrations() const { return m_concentrations; }
+
+    /**
+     * @brief Advances the concentrations.
+     *
+     * Small negative concentrations left by a step are clipped to zero.
+     *
+     * @param duration Time to advance, in s.
+     * @return False if the step size collapsed; concentrations are left at the last accepted step.
+     */
+    bool integrate(double duration);
+
+    /**
+     * @brief Evaluates dc/dt.
+     *
+     * @param concentrations Species concentrations.
+     * @param derivatives Receives dc/dt for every species.
+     */
+    void computeDerivatives(const double* concentrations, double* derivatives);
+
+    size_t getSpeciesCount() const { return m_names.size(); }
+    size_t getReactionCount() const { return m_rateConstants.size(); }
+    const std::string& getSpeciesName(uint32_t species) const { return m_names[species]; }
+    double getRateConstant(uint32_t reaction) const { return m_rateConstants[reaction]; }
+    double getTemperature() const { return m_temperature; }
+
+    size_t getAcceptedSteps() const { return m_acceptedSteps; }
+    size_t getRejectedSteps() const { return m_rejectedSteps; }
+    double getStepSize() const { return m_stepSize; }
+    size_t getJacobianNonZeros() const { return m_lu.getMatrixNonZeros(); }
+    size_t getFactorNonZeros() const { return m_lu.getFactorNonZeros(); }
+
+private:
+    std::vector<std::string> m_names;
+    std::vector<double> m_concentrations;
+    double m_temperature = 300.0;
+    double m_relativeTolerance = 1e-4;
+    double m_absoluteTolerance = 1e-12;
+
+    // Per reaction, and flattened reactant and net-change lists (CSR by reaction)
+    std::vector<double> m_preExponentials, m_temperatureExponents, m_activationEnergies;
+    std::vector<double> m_rateConstants;
+    std::vector<uint32_t> m_reactantStart, m_reactantSpecies;
+    std::vector<int> m_reactantOrders;
+    std::vector<uint32_t> m_changeStart, m_changeSpecies;
+    std::vector<double> m_changeCoefficients;
+
+    // Jacobian scatter: reactant term t feeds slots [m_scatterStart[t], m_scatterStart[t + 1])
+    std::vector<uint32_t> m_scatterStart;
+    std::vector<uint32_t> m_scatterSlots;
+    std::vector<double> m_scatterCoefficients;
+    std::vector<uint32_t> m_diagonalSlots;
+    SparseLU m_lu;
+    bool m_analyzed = false;
+
+    // Integrator state and scratch
+    double m_stepSize = 0.0;
+    size_t m_acceptedSteps = 0;
+    size_t m_rejectedSteps = 0;
+    std::vector<double> m_rates;
+    std::vector<double> m_stages;
+    std::vector<double> m_trial;
+    std::vector<double> m_derivatives;
+
+    void updateRateConstants();
+    void analyze();
+    /// Writes I / (γh) - J at the given concentrations into the LU values
+    void assembleMatrix(const double* concentrations, double diagonal);
+};
+
+#endif // REACTION_NETWORK_H
@@ -1,12 +1,17 @@
 #include "Renderer.h"
+#include "ConfigManager.h"
+#include "ElementTable.h"
+#include "TaskScheduler.h"
 #include <iostream>
 #include <cmath>
 #include <vector>
 #include <algorithm>
+#include <random>
+#include <string>
 #include <glm/gtc/constants.hpp>
 
 // ──────────────────────────────────────────────────────────────────────
-// Sphere + line shader sources only
+// Sphere + line shader sources; both also write the normal/depth G-buffer
 
 static const char* vertexSrc = R"(
 #version 330 core
@@ -33,14 +38,18 @@ static const char* fragSrc = R"(
 in vec3 vNormal;
 in vec3 vPos;
 
+uniform mat4 view;
 uniform vec3 lightPos;
 uniform vec3 viewPos;
 uniform vec3 objectColor;
+uniform float objectAlpha;
 
-out vec4 FragColor;
+layout(location = 0) out vec4 FragColor;
+layout(location = 1) out vec4 NormalDepth;
 
 void main() {
     vec3 norm = normalize(vNormal);
+    NormalDepth = vec4(normalize(mat3(view) * norm), 1.0 / gl_FragCoord.w);
     vec3 lightDir = normalize(lightPos - vPos);
     float diff = max(dot(norm, lightDir), 0.0);
 
@@ -53,7 +62,7 @@ void main() {
     vec3 specular = spec * vec3(1.0);
 
     vec3 color = ambient + diffuse + specular;
-    FragColor = vec4(color, 1.0);
+    FragColor = vec4(color, objectAlpha);
 }
 )";
 
@@ -71,12 +80,127 @@ void main() {
 
 static const char* lineFrag = R"(
 #version 330 core
-out vec4 FragColor;
+layout(location = 0) out vec4 FragColor;
+layout(location = 1) out vec4 NormalDepth;
 
 uniform vec3 lineColor;
 
 void main() {
     FragColor = vec4(lineColor, 1.0);
+    NormalDepth = vec4(0.0, 0.0, 1.0, 1.0 / gl_FragCoord.w);
+}
+)";
+
+// ──────────────────────────────────────────────────────────────────────
+// Screen-space passes: one oversized triangle covering the viewport
+
+static const char* screenVert = R"(
+#version 330 core
+out vec2 vUV;
+
+void main() {
+    vUV = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(vUV * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+static const char* ssaoFrag = R"(
+#version 330 core
+in vec2 vUV;
+out vec4 FragColor;
+
+const int MAX_SAMPLES = 32;
+
+uniform sampler2D normalDepth;
+uniform sampler2D noise;
+uniform mat4 projection;
+uniform vec3 kernel[MAX_SAMPLES];
+uniform int sampleCount;
+uniform float radius;
+uniform float intensity;
+uniform vec2 noiseScale;
+
+// View-space position from linear depth; the projection diagonal holds the frustum slopes
+vec3 viewPosition(vec2 uv, float depth) {
+    vec2 ndc = uv * 2.0 - 1.0;
+    return vec3(ndc * depth / vec2(projection[0][0], projection[1][1]), -depth);
+}
+
+void main() {
+    vec4 center = texture(normalDepth, vUV);
+    if (center.w <= 0.0) {
+        FragColor = vec4(1.0, 0.0, 0.0, 1.0);
+        return;
+    }
+    vec3 position = viewPosition(vUV, center.w);
+    vec3 normal = normalize(center.xyz);
+
+    // Per-pixel rotation of the kernel from a tiled noise texture
+    vec3 randomVec = vec3(texture(noise, vUV * noiseScale).xy, 0.0);
+    vec3 tangent = normalize(randomVec - normal * dot(randomVec, normal));
+    mat3 tbn = mat3(tangent, cross(normal, tangent), normal);
+
+    float occlusion = 0.0;
+    for (int i = 0; i < MAX_SAMPLES; ++i) {
+        if (i >= sampleCount) break;
+        vec3 samplePos = position + tbn * kernel[i] * radius;
+        vec4 clip = projection * vec4(samplePos, 1.0);
+        vec2 sampleUV = clip.xy / clip.w * 0.5 + 0.5;
+        float sceneDepth = texture(normalDepth, sampleUV).w;
+        if (sceneDepth <= 0.0) continue;
+        // Ignore occluders far in front of the sample, e.g. a neighbour's silhouette
+        float range = smoothstep(0.0, 1.0, radius / abs(center.w - sceneDepth));
+        occlusion += (sceneDepth < -samplePos.z - 0.02 * radius ? 1.0 : 0.0) * range;
+    }
+    float ao = pow(clamp(1.0 - occlusion / float(sampleCount), 0.0, 1.0), intensity);
+    FragColor = vec4(ao, center.w, 0.0, 1.0);
+}
+)";
+
+static const char* compositeFrag = R"(
+#version 330 core
+in vec2 vUV;
+out vec4 FragColor;
+
+uniform sampler2D sceneColor;
+uniform sampler2D normalDepth;
+uniform sampler2D sceneDepth;
+uniform sampler2D occlusion;
+uniform int useOcclusion;
+uniform vec3 background;
+uniform float depthCue;
+uniform vec2 cueRange;
+
+// Joint bilateral upsample: bilinear weights, damped where the low-res depth disagrees
+float upsampleOcclusion(float depth) {
+    vec2 size = vec2(textureSize(occlusion, 0));
+    vec2 p = vUV * size - 0.5;
+    ivec2 base = ivec2(floor(p));
+    vec2 f = p - vec2(base);
+    float sum = 0.0, weight = 0.0;
+    for (int j = 0; j < 2; ++j) {
+        for (int i = 0; i < 2; ++i) {
+            ivec2 texel = clamp(base + ivec2(i, j), ivec2(0), ivec2(size) - 1);
+            vec2 s = texelFetch(occlusion, texel, 0).xy;
+            float bilinear = (i == 0 ? 1.0 - f.x : f.x) * (j == 0 ? 1.0 - f.y : f.y);
+            float w = bilinear * exp(-abs(s.y - depth) / (0.02 * depth)) + 1e-4 * bilinear;
+            sum += s.x * w;
+            weight += w;
+        }
+    }
+    return weight > 0.0 ? sum / weight : 1.0;
+}
+
+void main() {
+    vec4 color = texture(sceneColor, vUV);
+    float depth = texture(normalDepth, vUV).w;
+    gl_FragDepth = texture(sceneDepth, vUV).r;
+    if (depth > 0.0) {
+        if (useOcclusion != 0) color.rgb *= upsampleOcclusion(depth);
+        float fog = clamp((depth - cueRange.x) / max(cueRange.y - cueRange.x, 1e-4), 0.0, 1.0);
+        color.rgb = mix(color.rgb, background, fog * depthCue);
+    }
+    FragColor = vec4(color.rgb, 1.0);
 }
 )";
 // ──────────────────────────────────────────────────────────────────────
@@ -89,6 +213,13 @@ Renderer::Renderer(GLFWwindow* window)
 }
 
 Renderer::~Renderer() {
+    destroyScreenTargets();
+    if (m_noiseTexture) glDeleteTextures(1, &m_noiseTexture);
+    if (m_screenVAO) glDeleteVertexArrays(1, &m_screenVAO);
+    for (auto& buffer : m_isosurfaceBuffers) {
+        if (buffer.vbo) glDeleteBuffers(1, &buffer.vbo);
+        if (buffer.vao) glDeleteVertexArrays(1, &buffer.vao);
+    }
     if (m_lineVBO) glDeleteBuffers(1, &m_lineVBO);
     if (m_lineVAO) glDeleteVertexArrays(1, &m_lineVAO);
     if (m_sphereVBO) glDeleteBuffers(1, &m_sphereVBO);
@@ -129,40 +260,179 @@ bool Renderer::initialize() {
     if (!m_shaderManager.loadShader("sphere", vertexSrc, fragSrc)) return false;
     if (!m_shaderManager.loadShader("line", lineVert, lineFrag)) return false;
 
+    auto& config = ConfigManager::getInstance();
+    m_ssaoEnabled   = config.getBool("render_ssao", m_ssaoEnabled);
+    m_ssaoScale     = std::clamp(config.getFloat("render_ssao_scale", m_ssaoScale), 0.25f, 1.0f);
+    m_ssaoSamples   = std::clamp(config.getInt("render_ssao_samples", m_ssaoSamples), 1, 32);
+    m_ssaoRadius    = config.getFloat("render_ssao_radius", m_ssaoRadius);
+    m_ssaoIntensity = config.getFloat("render_ssao_intensity", m_ssaoIntensity);
+    m_depthCue      = std::clamp(config.getFloat("render_depth_cue", m_depthCue), 0.0f, 1.0f);
+
+    // Screen-space shading is optional: without it the scene is drawn straight to the window
+    if ((m_ssaoEnabled || m_depthCue > 0.0f) &&
+        m_shaderManager.loadShader("ssao", screenVert, ssaoFrag) &&
+        m_shaderManager.loadShader("composite", screenVert, compositeFrag)) {
+        glGenVertexArrays(1, &m_screenVAO);
+
+        // Hemisphere kernel, denser near the surface point
+        std::mt19937 rng(1234u);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        m_shaderManager.useShader("ssao");
+        for (int i = 0; i < 32; ++i) {
+            glm::vec3 v(unit(rng) * 2.0f - 1.0f, unit(rng) * 2.0f - 1.0f, unit(rng));
+            v = glm::normalize(v) * unit(rng);
+            float t = float(i) / 32.0f;
+            v *= 0.1f + 0.9f * t * t;
+            m_shaderManager.setUniformVec3("kernel[" + std::to_string(i) + "]", v);
+        }
+        m_shaderManager.setUniformInt("normalDepth", 0);
+        m_shaderManager.setUniformInt("noise", 1);
+
+        // 4x4 tiled rotations about the normal break up the kernel's banding
+        std::vector<float> noise(16 * 2);
+        for (float& value : noise) value = unit(rng) * 2.0f - 1.0f;
+        glGenTextures(1, &m_noiseTexture);
+        glBindTexture(GL_TEXTURE_2D, m_noiseTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, 4, 4, 0, GL_RG, GL_FLOAT, noise.data());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        m_shaderManager.useShader("composite");
+        m_shaderManager.setUniformInt("sceneColor", 0);
+        m_shaderManager.setUniformInt("normalDepth", 1);
+        m_shaderManager.setUniformInt("sceneDepth", 2);
+        m_shaderManager.setUniformInt("occlusion", 3);
+
+        if (!createScreenTargets()) {
+            std::cerr << "Renderer: screen-space shading unavailable, falling back to direct shading\n";
+            destroyScreenTargets();
+        }
+    }
+
     std::cout << "Renderer initialized successfully\n";
     return true;
 }
 
+template <typename AtomAt>
+void Renderer::buildAtomInstances(size_t count, const AtomAt& atomAt) {
+    m_atomInstances.resize(count);
+    const Selection* highlight =
+        (m_highlight && m_highlight->size() == count) ? m_highlight : nullptr;
+    const std::vector<float>* surface =
+        (m_surfaceColoring && m_surfaceColoring->size() == count) ? m_surfaceColoring : nullptr;
+    const glm::vec3 highlightColor(1.0f, 0.85f, 0.1f);
+    const glm::vec3 buriedColor(0.15f, 0.25f, 0.9f);
+    const glm::vec3 exposedColor(0.95f, 0.2f, 0.1f);
+    TaskScheduler::getInstance().parallelFor(0, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            glm::vec3 position;
+            int Z;
+            atomAt(i, position, Z);
+            float radius = getAtomRadius(Z);
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+            m_atomInstances[i].model = glm::scale(model, glm::vec3(radius));
+            m_atomInstances[i].color = surface
+                ? glm::mix(buriedColor, exposedColor, glm::clamp((*surface)[i], 0.0f, 1.0f))
+                : getAtomColor(Z);
+            if (highlight && highlight->test(i)) {
+                m_atomInstances[i].color = glm::mix(m_atomInstances[i].color, highlightColor, 0.6f);
+            }
+        }
+    }, 4096);
+}
+
 void Renderer::render(
     const std::vector<std::shared_ptr<Atom>>& atoms,
     const std::vector<std::shared_ptr<Molecule>>& molecules,
     float deltaTime)
 {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glViewport(0, 0, m_windowWidth, m_windowHeight);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    buildAtomInstances(atoms.size(), [&](size_t i, glm::vec3& position, int& Z) {
+        position = atoms[i]->getPosition();
+        Z = atoms[i]->getAtomicNumber();
+    });
+    drawFrame(&molecules, deltaTime);
+}
 
-    // Debug object lifetimes
-    std::cout << "Num Atoms: " << atoms.size()
-              << " Num Molecules: " << molecules.size() << std::endl;
+bool Renderer::renderSnapshot(const SnapshotView& view, float deltaTime) {
+    // Positions are read straight from shared memory, without a copy
+    buildAtomInstances(view.atomCount, [&](size_t i, glm::vec3& position, int& Z) {
+        position = glm::vec3(view.x[i], view.y[i], view.z[i]);
+        Z = view.atomicNumber[i];
+    });
+    m_bondVertices.clear();
+    m_bondVertices.reserve(view.bondCount * 6);
+    for (size_t k = 0; k < view.bondCount; ++k) {
+        uint32_t a = view.bonds[2 * k], b = view.bonds[2 * k + 1];
+        if (a >= view.atomCount || b >= view.atomCount) continue;
+        m_bondVertices.insert(m_bondVertices.end(), { view.x[a], view.y[a], view.z[a], view.x[b], view.y[b], view.z[b] });
+    }
+    // The publisher may have reused the slot while we read it; draw nothing torn
+    if (!view.isConsistent()) return false;
+
+    drawFrame(nullptr, deltaTime);
+    return true;
+}
 
-    for (auto& atom : atoms) {
-        std::cout << "Atom Z: " << atom->getAtomicNumber()
-                  << " Pos: " << atom->getPosition().x << ", "
-                  << atom->getPosition().y << ", "
-                  << atom->getPosition().z << std::endl;
-        renderAtom(atom);
+void Renderer::drawFrame(const std::vector<std::shared_ptr<Molecule>>* molecules, float deltaTime) {
+    // Opaque geometry goes to the G-buffer when screen-space shading is on
+    const bool screenSpace = m_targets.sceneFBO != 0;
+    if (screenSpace) {
+        const GLenum drawBuffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+        const GLfloat noSurface[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        glBindFramebuffer(GL_FRAMEBUFFER, m_targets.sceneFBO);
+        glDrawBuffers(2, drawBuffers);
+        glViewport(0, 0, m_targets.width, m_targets.height);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glClearBufferfv(GL_COLOR, 1, noSurface);
+        // The G-buffer alpha holds depth, so it must not be blended
+        glDisable(GL_BLEND);
+    } else {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, m_windowWidth, m_windowHeight);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     }
 
-    for (auto& mol : molecules) {
-        for (auto& bond : mol->getBonds()) {
-            auto A = bond->getAtom1();
-            auto B = bond->getAtom2();
-            std::cout << "Bond between: "
-                      << A->getAtomicNumber() << " and "
-                      << B->getAtomicNumber() << std::endl;
-            renderBond(bond);
+    m_shaderManager.useShader("sphere");
+    m_shaderManager.setUniformMat4("view",       m_camera.getViewMatrix());
+    m_shaderManager.setUniformMat4("projection", m_camera.getProjectionMatrix());
+    m_shaderManager.setUniformVec3("lightPos",   m_camera.getPosition() + glm::vec3(5.0f, 5.0f, 5.0f));
+    m_shaderManager.setUniformVec3("viewPos",    m_camera.getPosition());
+    m_shaderManager.setUniformFloat("objectAlpha", 1.0f);
+    {
+        GpuProfiler::Scope pass(m_gpuProfiler, "spheres");
+        glBindVertexArray(m_sphereVAO);
+        for (const auto& instance : m_atomInstances) {
+            renderAtom(instance);
         }
+        glBindVertexArray(0);
+    }
+
+    {
+        GpuProfiler::Scope pass(m_gpuProfiler, "bonds");
+        if (molecules) {
+            for (auto& mol : *molecules) {
+                for (auto& bond : mol->getBonds()) {
+                    renderBond(bond);
+                }
+            }
+        } else {
+            renderBondLines();
+        }
+    }
+
+    if (m_showPhoton) {
+        GpuProfiler::Scope pass(m_gpuProfiler, "photon");
+        displayPhoton();
+    }
+
+    if (screenSpace) renderScreenSpaceShading();
+
+    if (m_isosurfaces) {
+        GpuProfiler::Scope pass(m_gpuProfiler, "isosurfaces");
+        renderIsosurfaces();
     }
 
     renderEnergyLabels(deltaTime);
@@ -173,6 +443,10 @@ void Renderer::onWindowResize(int width, int height) {
     m_windowHeight = height;
     glViewport(0, 0, width, height);
     m_camera.setAspectRatio(float(width) / float(height));
+    if (m_targets.sceneFBO && width > 0 && height > 0) {
+        destroyScreenTargets();
+        if (!createScreenTargets()) destroyScreenTargets();
+    }
 }
 
 void Renderer::addEnergyLabel(const glm::vec3& position, float energy, float duration) {
@@ -185,27 +459,11 @@ void Renderer::addEnergyLabel(const glm::vec3& position, float energy, float dur
 }
 
 glm::vec3 Renderer::getAtomColor(int Z) const {
-    switch (Z) {
-    case 1:  return {1, 1, 1};
-    case 6:  return {0.2f, 0.2f, 0.2f};
-    case 7:  return {0, 0, 1};
-    case 8:  return {1, 0, 0};
-    case 15: return {1, 0.5f, 0};
-    case 16: return {1, 1, 0};
-    default: return {0.5f, 0.5f, 0.5f};
-    }
+    return ElementTable::getDisplayColor(Z);
 }
 
 float Renderer::getAtomRadius(int Z) const {
-    switch (Z) {
-    case 1:  return 0.3f; // Hydrogen
-    case 6:  return 0.5f; // Carbon
-    case 7:  return 0.45f; // Nitrogen
-    case 8:  return 0.4f; // Oxygen
-    case 15: return 0.55f; // Phosphorus
-    case 16: return 0.6f; // Sulfur
-    default: return 0.5f;
-    }
+    return ElementTable::getDisplayRadius(Z);
 }
 
 void Renderer::generateSphere(float radius, int sectorCount, int stackCount) {
@@ -240,7 +498,189 @@ void Renderer::generateSphere(float radius, int sectorCount, int stackCount) {
     }
 }
 
-void Renderer::renderAtom(std::shared_ptr<Atom> atom) { /* … */ }
+void Renderer::renderAtom(const AtomInstance& instance) {
+    // Shader, camera uniforms and sphere VAO are bound once per frame by render()
+    m_shaderManager.setUniformMat4("model",       instance.model);
+    m_shaderManager.setUniformVec3("objectColor", instance.color);
+    glDrawElements(GL_TRIANGLES, (GLsizei)m_sphereIndices.size(), GL_UNSIGNED_INT, 0);
+}
+void Renderer::renderIsosurfaces() {
+    if (!m_isosurfaces) return;
+    if (m_isosurfaceBuffers.size() < m_isosurfaces->size()) {
+        m_isosurfaceBuffers.resize(m_isosurfaces->size());
+    }
+
+    m_shaderManager.useShader("sphere");
+    m_shaderManager.setUniformMat4("model", glm::mat4(1.0f));
+    // Translucent: test against the atoms but do not occlude the surfaces behind.
+    // Other passes (and ImGui) change the blend state, so set it here and restore it after
+    GLboolean blendEnabled = glIsEnabled(GL_BLEND);
+    GLint blendSourceRgb = GL_ONE, blendDestinationRgb = GL_ZERO;
+    GLint blendSourceAlpha = GL_ONE, blendDestinationAlpha = GL_ZERO;
+    glGetIntegerv(GL_BLEND_SRC_RGB, &blendSourceRgb);
+    glGetIntegerv(GL_BLEND_DST_RGB, &blendDestinationRgb);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendSourceAlpha);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &blendDestinationAlpha);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_FALSE);
+    for (size_t k = 0; k < m_isosurfaces->size(); ++k) {
+        const IsosurfaceMesh& mesh = (*m_isosurfaces)[k];
+        IsosurfaceBuffer& buffer = m_isosurfaceBuffers[k];
+        if (!buffer.vao) {
+            glGenVertexArrays(1, &buffer.vao);
+            glGenBuffers(1, &buffer.vbo);
+            glBindVertexArray(buffer.vao);
+            glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+            glEnableVertexAttribArray(1);
+        }
+        if (buffer.version != mesh.version) {
+            glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+            glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(float), mesh.vertices.data(), GL_DYNAMIC_DRAW);
+            buffer.version = mesh.version;
+            buffer.vertexCount = static_cast<GLsizei>(mesh.getVertexCount());
+        }
+        if (buffer.vertexCount == 0) continue;
+
+        m_shaderManager.setUniformVec3("objectColor", mesh.color);
+        m_shaderManager.setUniformFloat("objectAlpha", mesh.alpha);
+        glBindVertexArray(buffer.vao);
+        glDrawArrays(GL_TRIANGLES, 0, buffer.vertexCount);
+    }
+    glBindVertexArray(0);
+    glDepthMask(GL_TRUE);
+    glBlendFuncSeparate(static_cast<GLenum>(blendSourceRgb), static_cast<GLenum>(blendDestinationRgb),
+                        static_cast<GLenum>(blendSourceAlpha), static_cast<GLenum>(blendDestinationAlpha));
+    if (!blendEnabled) glDisable(GL_BLEND);
+}
+
+bool Renderer::createScreenTargets() {
+    auto makeTexture = [](GLuint& texture, GLint internalFormat, int width, int height, GLenum format, GLenum type) {
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    };
+
+    m_targets.width = std::max(m_windowWidth, 1);
+    m_targets.height = std::max(m_windowHeight, 1);
+    makeTexture(m_targets.color, GL_RGBA8, m_targets.width, m_targets.height, GL_RGBA, GL_UNSIGNED_BYTE);
+    makeTexture(m_targets.normalDepth, GL_RGBA16F, m_targets.width, m_targets.height, GL_RGBA, GL_FLOAT);
+    makeTexture(m_targets.depth, GL_DEPTH_COMPONENT24, m_targets.width, m_targets.height,
+                GL_DEPTH_COMPONENT, GL_UNSIGNED_INT);
+    glGenFramebuffers(1, &m_targets.sceneFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_targets.sceneFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_targets.color, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, m_targets.normalDepth, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_targets.depth, 0);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+    // Occlusion is computed at reduced resolution, so its cost follows the pixel count alone
+    m_targets.aoWidth = std::max(1, int(m_targets.width * m_ssaoScale));
+    m_targets.aoHeight = std::max(1, int(m_targets.height * m_ssaoScale));
+    makeTexture(m_targets.ao, GL_RG16F, m_targets.aoWidth, m_targets.aoHeight, GL_RG, GL_FLOAT);
+    glGenFramebuffers(1, &m_targets.aoFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_targets.aoFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_targets.ao, 0);
+    complete = complete && glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return complete;
+}
+
+void Renderer::destroyScreenTargets() {
+    if (m_targets.aoFBO) glDeleteFramebuffers(1, &m_targets.aoFBO);
+    if (m_targets.sceneFBO) glDeleteFramebuffers(1, &m_targets.sceneFBO);
+    const GLuint textures[4] = { m_targets.color, m_targets.normalDepth, m_targets.depth, m_targets.ao };
+    for (GLuint texture : textures) {
+        if (texture) glDeleteTextures(1, &texture);
+    }
+    m_targets = ScreenTargets();
+}
+
+void Renderer::renderScreenSpaceShading() {
+    glDisable(GL_DEPTH_TEST);
+    glBindVertexArray(m_screenVAO);
+
+    if (m_ssaoEnabled) {
+        GpuProfiler::Scope pass(m_gpuProfiler, "ssao");
+        glBindFramebuffer(GL_FRAMEBUFFER, m_targets.aoFBO);
+        glViewport(0, 0, m_targets.aoWidth, m_targets.aoHeight);
+        m_shaderManager.useShader("ssao");
+        m_shaderManager.setUniformMat4("projection", m_camera.getProjectionMatrix());
+        m_shaderManager.setUniformInt("sampleCount", m_ssaoSamples);
+        m_shaderManager.setUniformFloat("radius", m_ssaoRadius);
+        m_shaderManager.setUniformFloat("intensity", m_ssaoIntensity);
+        m_shaderManager.setUniformVec2("noiseScale", glm::vec2(m_targets.aoWidth, m_targets.aoHeight) / 4.0f);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, m_targets.normalDepth);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, m_noiseTexture);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+
+    // Depth cue spans the atoms' own depth range, so it adapts as the camera zooms
+    glm::mat4 view = m_camera.getViewMatrix();
+    float nearest = 0.0f, farthest = 0.0f;
+    for (size_t i = 0; i < m_atomInstances.size(); ++i) {
+        const glm::mat4& model = m_atomInstances[i].model;
+        float depth = -(view * model[3]).z;
+        float radius = model[0][0];
+        nearest = i == 0 ? depth - radius : std::min(nearest, depth - radius);
+        farthest = i == 0 ? depth + radius : std::max(farthest, depth + radius);
+    }
+    GLfloat background[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, background);
+
+    // Composite into the window, carrying the scene depth along for the translucent passes
+    GpuProfiler::Scope pass(m_gpuProfiler, "composite");
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, m_windowWidth, m_windowHeight);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_ALWAYS);
+    glDisable(GL_BLEND);
+    m_shaderManager.useShader("composite");
+    m_shaderManager.setUniformInt("useOcclusion", m_ssaoEnabled ? 1 : 0);
+    m_shaderManager.setUniformVec3("background", glm::vec3(background[0], background[1], background[2]));
+    m_shaderManager.setUniformFloat("depthCue", m_depthCue);
+    m_shaderManager.setUniformVec2("cueRange", glm::vec2(nearest, farthest));
+    const GLuint inputs[4] = { m_targets.color, m_targets.normalDepth, m_targets.depth, m_targets.ao };
+    for (int unit = 0; unit < 4; ++unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, inputs[unit]);
+    }
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+
+    for (int unit = 3; unit >= 0; --unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    glBindVertexArray(0);
+    glEnable(GL_BLEND);
+    glDepthFunc(GL_LESS);
+}
+
+void Renderer::renderBondLines() {
+    if (m_bondVertices.empty()) return;
+    m_shaderManager.useShader("line");
+    m_shaderManager.setUniformMat4("view",       m_camera.getViewMatrix());
+    m_shaderManager.setUniformMat4("projection", m_camera.getProjectionMatrix());
+    m_shaderManager.setUniformVec3("lineColor",  glm::vec3(0.8f));
+    glBindBuffer(GL_ARRAY_BUFFER, m_lineVBO);
+    glBufferData(GL_ARRAY_BUFFER, m_bondVertices.size() * sizeof(float), m_bondVertices.data(), GL_STREAM_DRAW);
+    glBindVertexArray(m_lineVAO);
+    glDrawArrays(GL_LINES, 0, (GLsizei)(m_bondVertices.size() / 3));
+    glBindVertexArray(0);
+}
+
 void Renderer::renderBond(std::shared_ptr<Bond> bond) {
     m_shaderManager.useShader("line");
     float pts[6] = {
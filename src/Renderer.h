@@ -17,6 +17,10 @@
 #include "Atom.h"
 #include "Molecule.h"
 #include "Bond.h"
+#include "Selection.h"
+#include "Isosurface.h"
+#include "GpuProfiler.h"
+#include "SnapshotChannel.h"
 
 /**
  * @brief Handles all OpenGL rendering operations for the simulation.
@@ -34,10 +38,32 @@ public:
         float deltaTime
     );
 
+    /**
+     * @brief Renders a snapshot published by another process, reading it in place.
+     *
+     * @param view The snapshot from SnapshotSubscriber::acquire().
+     * @param deltaTime Seconds since the last frame.
+     * @return False if the snapshot was overwritten while being read; nothing is drawn.
+     */
+    bool renderSnapshot(const SnapshotView& view, float deltaTime);
+
     Camera& getCamera() { return m_camera; }
+    bool    hasActiveAnimations() const { return m_showPhoton || !m_energyLabels.empty(); }
     void    onWindowResize(int width, int height);
     void    addEnergyLabel(const glm::vec3& position, float energy, float duration = 3.0f);
 
+    /// Tint the selected atoms (nullptr to clear); the selection must outlive the next render()
+    void    setHighlightSelection(const Selection* selection) { m_highlight = selection; }
+
+    /// Color atoms by a per-atom value in [0, 1], buried blue to exposed red (nullptr for element colors)
+    void    setSurfaceColoring(const std::vector<float>* exposure) { m_surfaceColoring = exposure; }
+
+    /// Time each render pass on the GPU (nullptr to disable); the profiler must outlive the renderer
+    void    setGpuProfiler(GpuProfiler* profiler) { m_gpuProfiler = profiler; }
+
+    /// Draw translucent isosurface meshes over the atoms (nullptr for none); re-uploaded when their version changes
+    void    setIsosurfaces(const std::vector<IsosurfaceMesh>* meshes) { m_isosurfaces = meshes; }
+
     // Photon‐wave display API
     enum class Band { ULTRAVIOLET, VISIBLE, INFRARED };
     static constexpr int PHOTON_FADE_FRAMES = 60;
@@ -48,6 +74,30 @@ public:
                               const glm::vec3& origin);
 
 private:
+    struct AtomInstance {
+        glm::mat4 model;
+        glm::vec3 color;
+    };
+
+    struct IsosurfaceBuffer {
+        GLuint   vao = 0;
+        GLuint   vbo = 0;
+        uint64_t version = 0;
+        GLsizei  vertexCount = 0;
+    };
+
+    /// Offscreen targets for screen-space ambient occlusion and depth cueing
+    struct ScreenTargets {
+        GLuint sceneFBO = 0;
+        GLuint color = 0;       ///< Lit scene, RGBA8
+        GLuint normalDepth = 0; ///< View-space normal and linear depth (0 = background), RGBA16F
+        GLuint depth = 0;       ///< Depth texture, copied to the window by the composite pass
+        GLuint aoFBO = 0;
+        GLuint ao = 0;          ///< Occlusion and the depth it was computed at, RG16F, reduced size
+        int    width = 0, height = 0;
+        int    aoWidth = 0, aoHeight = 0;
+    };
+
     struct EnergyLabel {
         glm::vec3 position;
         float     energy;
@@ -70,7 +120,23 @@ private:
     GLuint m_lineVAO = 0,
            m_lineVBO = 0;
 
+    std::vector<AtomInstance>     m_atomInstances;
+    std::vector<float>            m_bondVertices;   ///< Line endpoints for snapshot bonds
+    const Selection*              m_highlight = nullptr;
+    const std::vector<float>*     m_surfaceColoring = nullptr;
+    const std::vector<IsosurfaceMesh>* m_isosurfaces = nullptr;
+    std::vector<IsosurfaceBuffer> m_isosurfaceBuffers;
+    GpuProfiler*                  m_gpuProfiler = nullptr;
     std::vector<EnergyLabel>      m_energyLabels;
+    ScreenTargets                 m_targets;
+    GLuint                        m_screenVAO    = 0;
+    GLuint                        m_noiseTexture = 0;
+    bool                          m_ssaoEnabled  = true;
+    float                         m_ssaoScale    = 0.5f;
+    int                           m_ssaoSamples  = 16;
+    float                         m_ssaoRadius   = 1.5f;
+    float                         m_ssaoIntensity = 1.5f;
+    float                         m_depthCue     = 0.6f;
     int                           m_windowWidth  = 800;
     int                           m_windowHeight = 600;
 
@@ -84,9 +150,17 @@ private:
 
     // Internal helpers
     void generateSphere(float radius, int sectorCount, int stackCount);
-    void renderAtom(std::shared_ptr<Atom> atom);
+    template <typename AtomAt>
+    void buildAtomInstances(size_t count, const AtomAt& atomAt);
+    void drawFrame(const std::vector<std::shared_ptr<Molecule>>* molecules, float deltaTime);
+    void renderBondLines();
+    void renderAtom(const AtomInstance& instance);
     void renderBond(std::shared_ptr<Bond> bond);
     void renderEnergyLabels(float deltaTime);
+    void renderIsosurfaces();
+    bool createScreenTargets();
+    void destroyScreenTargets();
+    void renderScreenSpaceShading();
     glm::vec3 getAtomColor(int atomicNumber) const;
     float     getAtomRadius(int atomicNumber) const;
 
@@ -0,0 +1,161 @@
+#include "SceneLoader.h"
+#include "ElementTable.h"
+#include "Logger.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+SceneLoader::~SceneLoader() {
+    if (m_finalTask) {
+        TaskScheduler::getInstance().wait(m_finalTask);
+    }
+}
+
+void SceneLoader::start(SceneBuilder builder, const std::string& structureFile, ReadyCallback onReady) {
+    auto& scheduler = TaskScheduler::getInstance();
+
+    m_loading = true;
+    m_progress = 0.0f;
+    setStatus("Building scene");
+
+    auto scene = std::make_shared<SceneData>();
+    auto fileAtoms = std::make_shared<std::vector<std::shared_ptr<Atom>>>();
+
+    // The builder and the file parser run concurrently, so they fill separate
+    // containers that are merged in the main-thread continuation
+    std::vector<TaskScheduler::TaskHandle> stages;
+    stages.push_back(scheduler.submit([scene, builder] {
+        if (builder) builder(*scene);
+    }));
+
+    if (!structureFile.empty()) {
+        auto buffer = std::make_shared<std::string>();
+
+        auto readTask = scheduler.submitIO([this, buffer, structureFile] {
+            setStatus("Reading " + structureFile);
+            std::ifstream file(structureFile, std::ios::binary);
+            if (!file.is_open()) {
+                LOG_ERROR("Failed to open structure file: " + structureFile);
+                return;
+            }
+            std::ostringstream contents;
+            contents << file.rdbuf();
+            *buffer = contents.str();
+        });
+
+        stages.push_back(scheduler.submit([this, buffer, fileAtoms, structureFile] {
+            if (buffer->empty()) return;
+            setStatus("Parsing " + structureFile);
+            if (!parseXYZ(*buffer, *fileAtoms, &m_progress)) {
+                LOG_ERROR("Failed to parse structure file: " + structureFile);
+            }
+            buffer->clear();
+            buffer->shrink_to_fit();
+        }, {readTask}));
+    }
+
+    m_finalTask = scheduler.continueOnMainThread([this, scene, fileAtoms, onReady] {
+        scene->atoms.insert(scene->atoms.end(), fileAtoms->begin(), fileAtoms->end());
+        setStatus("Ready");
+        m_progress = 1.0f;
+        if (onReady) onReady(*scene);
+        m_loading = false;
+    }, stages);
+}
+
+std::string SceneLoader::getStatus() const {
+    std::lock_guard<std::mutex> lock(m_statusMutex);
+    return m_status;
+}
+
+void SceneLoader::setStatus(const std::string& status) {
+    std::lock_guard<std::mutex> lock(m_statusMutex);
+    m_status = status;
+}
+
+bool SceneLoader::parseXYZ(const std::string& buffer,
+                           std::vector<std::shared_ptr<Atom>>& atoms,
+                           std::atomic<float>* progress) {
+    const char* data = buffer.data();
+    const char* end = data + buffer.size();
+
+    // Header: atom count, then a free-form comment line
+    char* afterCount = nullptr;
+    long count = std::strtol(data, &afterCount, 10);
+    if (afterCount == data || count <= 0) {
+        return false;
+    }
+
+    const char* cursor = static_cast<const char*>(std::memchr(afterCount, '\n', end - afterCount));
+    if (cursor) cursor = static_cast<const char*>(std::memchr(cursor + 1, '\n', end - cursor - 1));
+    if (!cursor) return false;
+    ++cursor;
+
+    // Index line starts serially (memchr is bandwidth-bound), then parse in parallel
+    std::vector<const char*> lineStarts;
+    lineStarts.reserve(static_cast<size_t>(count));
+    while (cursor < end && lineStarts.size() < static_cast<size_t>(count)) {
+        lineStarts.push_back(cursor);
+        const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        cursor = newline ? newline + 1 : end;
+    }
+    if (lineStarts.size() < static_cast<size_t>(count)) {
+        LOG_WARNING("XYZ header declares " + std::to_string(count) + " atoms but only " +
+                    std::to_string(lineStarts.size()) + " lines are present");
+    }
+
+    std::vector<std::shared_ptr<Atom>> parsed(lineStarts.size());
+    std::atomic<size_t> parsedLines{0};
+    std::atomic<size_t> skipped{0};
+
+    TaskScheduler::getInstance().parallelFor(0, lineStarts.size(), [&](size_t begin, size_t last) {
+        for (size_t i = begin; i < last; ++i) {
+            const char* p = lineStarts[i];
+            const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (!lineEnd) lineEnd = end;
+            while (p < lineEnd && (*p == ' ' || *p == '\t')) ++p;
+            const char* symbolStart = p;
+            while (p < lineEnd && *p != ' ' && *p != '\t' && *p != '\r') ++p;
+
+            int Z = ElementTable::atomicNumberFromSymbol(std::string(symbolStart, p));
+            if (Z == 0) {
+                skipped.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            // strtof would skip a newline and take a missing coordinate from the
+            // next record, so step over blanks here and only start it on a number
+            float coordinates[3];
+            bool valid = true;
+            for (int axis = 0; axis < 3 && valid; ++axis) {
+                while (p < lineEnd && (*p == ' ' || *p == '\t')) ++p;
+                char* next = nullptr;
+                if (p < lineEnd && *p != '\r') coordinates[axis] = std::strtof(p, &next);
+                valid = next && next != p && next <= lineEnd;
+                p = next;
+            }
+            if (!valid) {
+                skipped.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            parsed[i] = std::make_shared<Atom>(Z, ElementTable::getDefaultMassNumber(Z),
+                                               glm::vec3(coordinates[0], coordinates[1], coordinates[2]));
+        }
+        size_t done = parsedLines.fetch_add(last - begin, std::memory_order_relaxed) + (last - begin);
+        if (progress) {
+            progress->store(static_cast<float>(done) / static_cast<float>(lineStarts.size()),
+                            std::memory_order_relaxed);
+        }
+    }, 1024);
+
+    if (skipped > 0) {
+        LOG_WARNING("Skipped " + std::to_string(skipped.load()) + " XYZ records with unknown element symbols or missing coordinates");
+    }
+
+    atoms.reserve(atoms.size() + parsed.size());
+    for (auto& atom : parsed) {
+        if (atom) atoms.push_back(std::move(atom));
+    }
+    return !atoms.empty();
+}
@@ -0,0 +1,106 @@
+#ifndef SCENE_LOADER_H
+#define SCENE_LOADER_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Atom.h"
+#include "Molecule.h"
+#include "TaskScheduler.h"
+
+/**
+ * @brief Scene content built off the main thread, before it is handed to the engine.
+ */
+struct SceneData {
+    struct EnergyLabel {
+        glm::vec3 position;
+        float energy;
+        float duration;
+    };
+
+    std::vector<std::shared_ptr<Atom>> atoms;         ///< Free atoms (not part of a molecule)
+    std::vector<std::shared_ptr<Molecule>> molecules;
+    std::vector<EnergyLabel> energyLabels;
+};
+
+/**
+ * @brief Builds the startup scene in the background while the window stays responsive.
+ *
+ * Loading is expressed as a small task graph on the TaskScheduler: the file is
+ * read on the I/O lane, parsed in parallel on the compute workers, and the
+ * finished scene is handed to the frame loop through a main-thread
+ * continuation. Progress and status can be polled every frame for the UI.
+ */
+class SceneLoader {
+public:
+    using SceneBuilder = std::function<void(SceneData&)>;
+    using ReadyCallback = std::function<void(SceneData&)>;
+
+    SceneLoader() = default;
+
+    /**
+     * @brief Waits for in-flight loading tasks before destruction.
+     */
+    ~SceneLoader();
+
+    /**
+     * @brief Starts loading a scene in the background.
+     *
+     * @param builder Populates procedurally generated content (demo molecules, labels).
+     * @param structureFile Optional XYZ file to load in addition; empty to skip.
+     * @param onReady Called on the main thread (from TaskScheduler::pumpMainThread)
+     *                with the completed scene.
+     */
+    void start(SceneBuilder builder, const std::string& structureFile, ReadyCallback onReady);
+
+    /**
+     * @brief Checks whether a load is still in progress.
+     *
+     * @return True until the ready callback has run.
+     */
+    bool isLoading() const { return m_loading.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Gets the overall load progress.
+     *
+     * @return Progress in [0, 1].
+     */
+    float getProgress() const { return m_progress.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Gets a human-readable description of the current loading stage.
+     *
+     * @return The status text.
+     */
+    std::string getStatus() const;
+
+    /**
+     * @brief Parses the first frame of an XYZ structure file.
+     *
+     * Atom lines are parsed in parallel; unknown element symbols are skipped
+     * with a warning.
+     *
+     * @param buffer The complete file contents.
+     * @param atoms Receives the parsed atoms.
+     * @param progress Optional counter advanced from 0 to 1 while parsing.
+     * @return True if the header was valid and at least one atom was read.
+     */
+    static bool parseXYZ(const std::string& buffer,
+                         std::vector<std::shared_ptr<Atom>>& atoms,
+                         std::atomic<float>* progress = nullptr);
+
+private:
+    std::atomic<bool> m_loading{false};
+    std::atomic<float> m_progress{0.0f};
+    mutable std::mutex m_statusMutex;
+    std::string m_status;
+    TaskScheduler::TaskHandle m_finalTask;
+
+    void setStatus(const std::string& status);
+};
+
+#endif // SCENE_LOADER_H
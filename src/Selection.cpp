@@ -0,0 +1,62 @@
+#include "Selection.h"
+#include <algorithm>
+#include <bitset>
+
+Selection::Selection(size_t size, bool selected)
+    : m_size(size),
+      m_words((size + 63) / 64, selected ? ~uint64_t(0) : uint64_t(0)) {
+    clearTail();
+}
+
+void Selection::set(size_t index, bool selected) {
+    uint64_t bit = uint64_t(1) << (index & 63);
+    if (selected) m_words[index >> 6] |= bit;
+    else          m_words[index >> 6] &= ~bit;
+}
+
+size_t Selection::count() const {
+    size_t total = 0;
+    for (uint64_t word : m_words) {
+        total += std::bitset<64>(word).count();
+    }
+    return total;
+}
+
+std::vector<uint32_t> Selection::toIndices() const {
+    std::vector<uint32_t> indices;
+    indices.reserve(count());
+    for (size_t w = 0; w < m_words.size(); ++w) {
+        uint64_t word = m_words[w];
+        while (word) {
+            // Peel off the lowest set bit
+            uint64_t lowest = word & (~word + 1);
+            indices.push_back(static_cast<uint32_t>(w * 64 + std::bitset<64>(lowest - 1).count()));
+            word ^= lowest;
+        }
+    }
+    return indices;
+}
+
+Selection& Selection::operator&=(const Selection& other) {
+    size_t n = std::min(m_words.size(), other.m_words.size());
+    for (size_t i = 0; i < n; ++i) m_words[i] &= other.m_words[i];
+    for (size_t i = n; i < m_words.size(); ++i) m_words[i] = 0;
+    return *this;
+}
+
+Selection& Selection::operator|=(const Selection& other) {
+    size_t n = std::min(m_words.size(), other.m_words.size());
+    for (size_t i = 0; i < n; ++i) m_words[i] |= other.m_words[i];
+    return *this;
+}
+
+void Selection::invert() {
+    for (uint64_t& word : m_words) word = ~word;
+    clearTail();
+}
+
+void Selection::clearTail() {
+    if (m_size % 64 != 0 && !m_words.empty()) {
+        m_words.back() &= (uint64_t(1) << (m_size % 64)) - 1;
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef SELECTION_H
+#define SELECTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief A set of atom indices stored as a compact bitset.
+ *
+ * One bit per atom (10⁷ atoms fit in 1.25 MB); set operations work a 64-bit
+ * word at a time. Bits past size() in the last word are always zero.
+ */
+class Selection {
+public:
+    /**
+     * @brief Constructs an empty selection over zero atoms.
+     */
+    Selection() = default;
+
+    /**
+     * @brief Constructs a selection over a given number of atoms.
+     *
+     * @param size The number of atoms the selection covers.
+     * @param selected Whether every atom starts selected.
+     */
+    explicit Selection(size_t size, bool selected = false);
+
+    /**
+     * @brief Gets the number of atoms the selection covers.
+     *
+     * @return The atom count (selected or not).
+     */
+    size_t size() const { return m_size; }
+
+    /**
+     * @brief Checks whether an atom is selected.
+     *
+     * @param index The atom index.
+     * @return True if selected.
+     */
+    bool test(size_t index) const { return (m_words[index >> 6] >> (index & 63)) & 1u; }
+
+    /**
+     * @brief Selects or deselects an atom.
+     *
+     * @param index The atom index.
+     * @param selected True to select.
+     */
+    void set(size_t index, bool selected = true);
+
+    /**
+     * @brief Counts the selected atoms.
+     *
+     * @return The number of set bits.
+     */
+    size_t count() const;
+
+    /**
+     * @brief Lists the selected atom indices in ascending order.
+     *
+     * @return The indices.
+     */
+    std::vector<uint32_t> toIndices() const;
+
+    Selection& operator&=(const Selection& other);
+    Selection& operator|=(const Selection& other);
+
+    /**
+     * @brief Inverts the selection in place.
+     */
+    void invert();
+
+    /**
+     * @brief Gets the raw 64-bit words, atom i being bit (i % 64) of word i / 64.
+     *
+     * @return The word array.
+     */
+    std::vector<uint64_t>& words() { return m_words; }
+    const std::vector<uint64_t>& words() const { return m_words; }
+
+private:
+    size_t m_size = 0;
+    std::vector<uint64_t> m_words;
+
+    void clearTail();
+};
+
+#endif // SELECTION_H
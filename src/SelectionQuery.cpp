@@ -0,0 +1,470 @@
+#include "SelectionQuery.h"
+#include "ElementTable.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define ATOMICA_SELECTION_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// ─── Filter kernels ──────────────────────────────────────────────────
+
+namespace {
+// Words per scheduled chunk: 256 words = 16384 atoms
+const size_t WORDS_PER_CHUNK = 256;
+
+/**
+ * Builds a selection 64 atoms per word. vectorBits(i) returns the match
+ * bits of LANES consecutive atoms starting at i; scalarTest(i) handles the
+ * tail of each word.
+ */
+template <int LANES, typename VectorBits, typename ScalarTest>
+Selection filterWords(size_t count, VectorBits vectorBits, ScalarTest scalarTest) {
+    Selection selection(count);
+    auto& words = selection.words();
+    TaskScheduler::getInstance().parallelFor(0, words.size(), [&](size_t firstWord, size_t lastWord) {
+        for (size_t w = firstWord; w < lastWord; ++w) {
+            size_t base = w * 64;
+            size_t n = std::min<size_t>(64, count - base);
+            uint64_t bits = 0;
+            size_t j = 0;
+            for (; j + LANES <= n; j += LANES) {
+                bits |= static_cast<uint64_t>(vectorBits(base + j)) << j;
+            }
+            for (; j < n; ++j) {
+                bits |= static_cast<uint64_t>(scalarTest(base + j) ? 1 : 0) << j;
+            }
+            words[w] = bits;
+        }
+    }, WORDS_PER_CHUNK);
+    return selection;
+}
+
+#if ATOMICA_SELECTION_SSE2
+const int FLOAT_LANES = 4;
+const int BYTE_LANES = 16;
+#else
+const int FLOAT_LANES = 1;
+const int BYTE_LANES = 1;
+#endif
+}
+
+Selection SelectionQuery::selectElements(const AtomArrays& atoms, const std::vector<int>& atomicNumbers) {
+    const uint8_t* z = atoms.atomicNumber.data();
+    auto matches = [&](size_t i) {
+        return std::find(atomicNumbers.begin(), atomicNumbers.end(), z[i]) != atomicNumbers.end();
+    };
+#if ATOMICA_SELECTION_SSE2
+    return filterWords<BYTE_LANES>(atoms.size(), [&](size_t i) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(z + i));
+        __m128i hits = _mm_setzero_si128();
+        for (int Z : atomicNumbers) {
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(values, _mm_set1_epi8(static_cast<char>(Z))));
+        }
+        return static_cast<unsigned>(_mm_movemask_epi8(hits));
+    }, matches);
+#else
+    return filterWords<BYTE_LANES>(atoms.size(), [&](size_t i) { return matches(i) ? 1u : 0u; }, matches);
+#endif
+}
+
+Selection SelectionQuery::selectIndexRange(const AtomArrays& atoms, size_t first, size_t last) {
+    Selection selection(atoms.size());
+    last = std::min(last, atoms.size());
+    for (size_t i = first; i < last; ++i) {
+        selection.set(i);
+    }
+    return selection;
+}
+
+Selection SelectionQuery::selectBox(const AtomArrays& atoms, const glm::vec3& lo, const glm::vec3& hi) {
+    const float* x = atoms.x.data();
+    const float* y = atoms.y.data();
+    const float* z = atoms.z.data();
+    auto inside = [&](size_t i) {
+        return x[i] >= lo.x && x[i] <= hi.x && y[i] >= lo.y && y[i] <= hi.y && z[i] >= lo.z && z[i] <= hi.z;
+    };
+#if ATOMICA_SELECTION_SSE2
+    __m128 lox = _mm_set1_ps(lo.x), loy = _mm_set1_ps(lo.y), loz = _mm_set1_ps(lo.z);
+    __m128 hix = _mm_set1_ps(hi.x), hiy = _mm_set1_ps(hi.y), hiz = _mm_set1_ps(hi.z);
+    return filterWords<FLOAT_LANES>(atoms.size(), [&](size_t i) {
+        __m128 px = _mm_loadu_ps(x + i), py = _mm_loadu_ps(y + i), pz = _mm_loadu_ps(z + i);
+        __m128 m = _mm_and_ps(_mm_cmpge_ps(px, lox), _mm_cmple_ps(px, hix));
+        m = _mm_and_ps(m, _mm_and_ps(_mm_cmpge_ps(py, loy), _mm_cmple_ps(py, hiy)));
+        m = _mm_and_ps(m, _mm_and_ps(_mm_cmpge_ps(pz, loz), _mm_cmple_ps(pz, hiz)));
+        return static_cast<unsigned>(_mm_movemask_ps(m));
+    }, inside);
+#else
+    return filterWords<FLOAT_LANES>(atoms.size(), [&](size_t i) { return inside(i) ? 1u : 0u; }, inside);
+#endif
+}
+
+Selection SelectionQuery::selectSphere(const AtomArrays& atoms, const glm::vec3& center, float radius) {
+    const float* x = atoms.x.data();
+    const float* y = atoms.y.data();
+    const float* z = atoms.z.data();
+    float r2 = radius * radius;
+    auto inside = [&](size_t i) {
+        float dx = x[i] - center.x, dy = y[i] - center.y, dz = z[i] - center.z;
+        return dx * dx + dy * dy + dz * dz <= r2;
+    };
+#if ATOMICA_SELECTION_SSE2
+    __m128 cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y), cz = _mm_set1_ps(center.z);
+    __m128 vr2 = _mm_set1_ps(r2);
+    return filterWords<FLOAT_LANES>(atoms.size(), [&](size_t i) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), cx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), cy);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(z + i), cz);
+        __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        return static_cast<unsigned>(_mm_movemask_ps(_mm_cmple_ps(d2, vr2)));
+    }, inside);
+#else
+    return filterWords<FLOAT_LANES>(atoms.size(), [&](size_t i) { return inside(i) ? 1u : 0u; }, inside);
+#endif
+}
+
+Selection SelectionQuery::selectSlab(const AtomArrays& atoms, int axis, float low, float high) {
+    const float* c = axis == 0 ? atoms.x.data() : axis == 1 ? atoms.y.data() : atoms.z.data();
+    auto inside = [&](size_t i) { return c[i] >= low && c[i] <= high; };
+#if ATOMICA_SELECTION_SSE2
+    __m128 vlo = _mm_set1_ps(low), vhi = _mm_set1_ps(high);
+    return filterWords<FLOAT_LANES>(atoms.size(), [&](size_t i) {
+        __m128 v = _mm_loadu_ps(c + i);
+        return static_cast<unsigned>(_mm_movemask_ps(_mm_and_ps(_mm_cmpge_ps(v, vlo), _mm_cmple_ps(v, vhi))));
+    }, inside);
+#else
+    return filterWords<FLOAT_LANES>(atoms.size(), [&](size_t i) { return inside(i) ? 1u : 0u; }, inside);
+#endif
+}
+
+Selection SelectionQuery::selectMolecules(const AtomArrays& atoms, const std::vector<int>& moleculeIds) {
+    const int32_t* m = atoms.molecule.data();
+    auto matches = [&](size_t i) {
+        return std::find(moleculeIds.begin(), moleculeIds.end(), m[i]) != moleculeIds.end();
+    };
+#if ATOMICA_SELECTION_SSE2
+    return filterWords<FLOAT_LANES>(atoms.size(), [&](size_t i) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m + i));
+        __m128i hits = _mm_setzero_si128();
+        for (int id : moleculeIds) {
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi32(values, _mm_set1_epi32(id)));
+        }
+        return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(hits)));
+    }, matches);
+#else
+    return filterWords<FLOAT_LANES>(atoms.size(), [&](size_t i) { return matches(i) ? 1u : 0u; }, matches);
+#endif
+}
+
+Selection SelectionQuery::selectSpeed(const AtomArrays& atoms, float minSpeed, float maxSpeed) {
+    const float* vx = atoms.vx.data();
+    const float* vy = atoms.vy.data();
+    const float* vz = atoms.vz.data();
+    // Compare squared speeds to keep sqrt out of the loop
+    float lo2 = minSpeed > 0.0f ? minSpeed * minSpeed : 0.0f;
+    float hi2 = maxSpeed < std::sqrt(std::numeric_limits<float>::max())
+        ? maxSpeed * maxSpeed : std::numeric_limits<float>::max();
+    auto inside = [&](size_t i) {
+        float s2 = vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i];
+        return s2 >= lo2 && s2 <= hi2;
+    };
+#if ATOMICA_SELECTION_SSE2
+    __m128 vlo = _mm_set1_ps(lo2), vhi = _mm_set1_ps(hi2);
+    return filterWords<FLOAT_LANES>(atoms.size(), [&](size_t i) {
+        __m128 a = _mm_loadu_ps(vx + i), b = _mm_loadu_ps(vy + i), c = _mm_loadu_ps(vz + i);
+        __m128 s2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, a), _mm_mul_ps(b, b)), _mm_mul_ps(c, c));
+        return static_cast<unsigned>(_mm_movemask_ps(_mm_and_ps(_mm_cmpge_ps(s2, vlo), _mm_cmple_ps(s2, vhi))));
+    }, inside);
+#else
+    return filterWords<FLOAT_LANES>(atoms.size(), [&](size_t i) { return inside(i) ? 1u : 0u; }, inside);
+#endif
+}
+
+Selection SelectionQuery::selectBondedTo(const AtomArrays& atoms, const Selection& partners) {
+    Selection selection(atoms.size());
+    if (atoms.bondOffsets.size() != atoms.size() + 1) return selection;
+
+    auto& words = selection.words();
+    TaskScheduler::getInstance().parallelFor(0, words.size(), [&](size_t firstWord, size_t lastWord) {
+        for (size_t w = firstWord; w < lastWord; ++w) {
+            uint64_t bits = 0;
+            size_t end = std::min<size_t>(w * 64 + 64, atoms.size());
+            for (size_t i = w * 64; i < end; ++i) {
+                for (uint32_t k = atoms.bondOffsets[i]; k < atoms.bondOffsets[i + 1]; ++k) {
+                    if (partners.test(atoms.bondNeighbors[k])) {
+                        bits |= uint64_t(1) << (i - w * 64);
+                        break;
+                    }
+                }
+            }
+            words[w] = bits;
+        }
+    }, WORDS_PER_CHUNK);
+    return selection;
+}
+
+// ─── Query tree and parser ───────────────────────────────────────────
+
+struct SelectionQuery::Node {
+    enum class Kind { ALL, ELEMENT, INDEX, BOX, SPHERE, SLAB, MOLECULE, SPEED, BONDED, AND, OR, NOT };
+
+    Kind kind = Kind::ALL;
+    std::vector<float> values;
+    std::vector<int> ids;
+    std::vector<size_t> indices;  ///< Atom index bounds, exact beyond float's 2^24
+    std::vector<std::unique_ptr<Node>> children;
+};
+
+class SelectionQuery::Parser {
+public:
+    explicit Parser(const std::string& text) {
+        size_t i = 0;
+        while (i < text.size()) {
+            char c = text[i];
+            if (std::isspace(static_cast<unsigned char>(c))) { ++i; continue; }
+            if (c == '(' || c == ')' || c == '<' || c == '>') {
+                m_tokens.emplace_back(1, c);
+                ++i;
+                continue;
+            }
+            size_t start = i;
+            while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i])) &&
+                   text[i] != '(' && text[i] != ')' && text[i] != '<' && text[i] != '>') {
+                ++i;
+            }
+            m_tokens.push_back(text.substr(start, i - start));
+        }
+    }
+
+    std::unique_ptr<Node> parse(std::string& error) {
+        auto root = parseExpression();
+        if (root && m_position < m_tokens.size()) {
+            fail("unexpected '" + m_tokens[m_position] + "'");
+        }
+        if (!m_error.empty()) {
+            error = m_error;
+            return nullptr;
+        }
+        return root;
+    }
+
+private:
+    std::vector<std::string> m_tokens;
+    size_t m_position = 0;
+    std::string m_error;
+
+    bool atEnd() const { return m_position >= m_tokens.size(); }
+    const std::string& peek() const { static const std::string empty; return atEnd() ? empty : m_tokens[m_position]; }
+
+    static std::string lower(std::string s) {
+        std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return s;
+    }
+
+    bool accept(const char* keyword) {
+        if (!atEnd() && lower(peek()) == keyword) { ++m_position; return true; }
+        return false;
+    }
+
+    std::unique_ptr<Node> fail(const std::string& message) {
+        if (m_error.empty()) m_error = message;
+        return nullptr;
+    }
+
+    static bool toNumber(const std::string& token, float& value) {
+        char* end = nullptr;
+        value = std::strtof(token.c_str(), &end);
+        return !token.empty() && end == token.c_str() + token.size();
+    }
+
+    bool readNumbers(size_t count, std::vector<float>& values, const char* what) {
+        for (size_t i = 0; i < count; ++i) {
+            float v;
+            if (atEnd() || !toNumber(peek(), v)) {
+                fail(std::string(what) + " expects " + std::to_string(count) + " numbers");
+                return false;
+            }
+            values.push_back(v);
+            ++m_position;
+        }
+        return true;
+    }
+
+    bool readIndices(size_t count, std::vector<size_t>& indices, const char* what) {
+        for (size_t i = 0; i < count; ++i) {
+            const std::string& token = peek();
+            char* end = nullptr;
+            unsigned long long value = atEnd() || token[0] == '-' ? 0 : std::strtoull(token.c_str(), &end, 10);
+            if (!end || end != token.c_str() + token.size()) {
+                fail(std::string(what) + " expects " + std::to_string(count) + " non-negative integers");
+                return false;
+            }
+            indices.push_back(static_cast<size_t>(value));
+            ++m_position;
+        }
+        return true;
+    }
+
+    static std::unique_ptr<Node> makeBinary(Node::Kind kind, std::unique_ptr<Node> a, std::unique_ptr<Node> b) {
+        auto node = std::make_unique<Node>();
+        node->kind = kind;
+        node->children.push_back(std::move(a));
+        node->children.push_back(std::move(b));
+        return node;
+    }
+
+    std::unique_ptr<Node> parseExpression() {
+        auto left = parseTerm();
+        while (left && accept("or")) {
+            auto right = parseTerm();
+            if (!right) return nullptr;
+            left = makeBinary(Node::Kind::OR, std::move(left), std::move(right));
+        }
+        return left;
+    }
+
+    std::unique_ptr<Node> parseTerm() {
+        auto left = parseFactor();
+        while (left && accept("and")) {
+            auto right = parseFactor();
+            if (!right) return nullptr;
+            left = makeBinary(Node::Kind::AND, std::move(left), std::move(right));
+        }
+        return left;
+    }
+
+    std::unique_ptr<Node> parseFactor() {
+        if (atEnd()) return fail("unexpected end of query");
+
+        if (accept("not")) {
+            auto child = parseFactor();
+            if (!child) return nullptr;
+            auto node = std::make_unique<Node>();
+            node->kind = Node::Kind::NOT;
+            node->children.push_back(std::move(child));
+            return node;
+        }
+        if (accept("(")) {
+            auto inner = parseExpression();
+            if (!inner) return nullptr;
+            if (!accept(")")) return fail("missing ')'");
+            return inner;
+        }
+        return parsePredicate();
+    }
+
+    std::unique_ptr<Node> parsePredicate() {
+        auto node = std::make_unique<Node>();
+        std::string keyword = lower(peek());
+        ++m_position;
+
+        if (keyword == "all") {
+            node->kind = Node::Kind::ALL;
+        } else if (keyword == "element") {
+            node->kind = Node::Kind::ELEMENT;
+            while (!atEnd()) {
+                float number;
+                int Z = toNumber(peek(), number) ? static_cast<int>(number)
+                                                 : ElementTable::atomicNumberFromSymbol(peek());
+                if (Z <= 0 || Z > ElementTable::MAX_ATOMIC_NUMBER) break;
+                node->ids.push_back(Z);
+                ++m_position;
+            }
+            if (node->ids.empty()) return fail("element expects at least one symbol");
+        } else if (keyword == "index") {
+            node->kind = Node::Kind::INDEX;
+            if (!readIndices(2, node->indices, "index")) return nullptr;
+        } else if (keyword == "box") {
+            node->kind = Node::Kind::BOX;
+            if (!readNumbers(6, node->values, "box")) return nullptr;
+        } else if (keyword == "sphere") {
+            node->kind = Node::Kind::SPHERE;
+            if (!readNumbers(4, node->values, "sphere")) return nullptr;
+        } else if (keyword == "slab") {
+            node->kind = Node::Kind::SLAB;
+            std::string axis = lower(peek());
+            if (axis != "x" && axis != "y" && axis != "z") return fail("slab expects an axis (x, y or z)");
+            node->ids.push_back(axis[0] - 'x');
+            ++m_position;
+            if (!readNumbers(2, node->values, "slab")) return nullptr;
+        } else if (keyword == "molecule") {
+            node->kind = Node::Kind::MOLECULE;
+            float number;
+            while (!atEnd() && toNumber(peek(), number)) {
+                node->ids.push_back(static_cast<int>(number));
+                ++m_position;
+            }
+            if (node->ids.empty()) return fail("molecule expects at least one id");
+        } else if (keyword == "speed") {
+            node->kind = Node::Kind::SPEED;
+            if (accept("<")) {
+                node->values.push_back(0.0f);
+                if (!readNumbers(1, node->values, "speed <")) return nullptr;
+            } else if (accept(">")) {
+                if (!readNumbers(1, node->values, "speed >")) return nullptr;
+                node->values.push_back(std::numeric_limits<float>::max());
+            } else if (!readNumbers(2, node->values, "speed")) {
+                return nullptr;
+            }
+        } else if (keyword == "bonded") {
+            node->kind = Node::Kind::BONDED;
+            auto child = parseFactor();
+            if (!child) return nullptr;
+            node->children.push_back(std::move(child));
+        } else {
+            return fail("unknown predicate '" + keyword + "'");
+        }
+        return node;
+    }
+};
+
+SelectionQuery::SelectionQuery() = default;
+SelectionQuery::~SelectionQuery() = default;
+
+bool SelectionQuery::compile(const std::string& text) {
+    m_error.clear();
+    Parser parser(text);
+    m_root = parser.parse(m_error);
+    return m_root != nullptr;
+}
+
+Selection SelectionQuery::evaluate(const AtomArrays& atoms) const {
+    if (!m_root) return Selection(atoms.size());
+    return evaluateNode(*m_root, atoms);
+}
+
+Selection SelectionQuery::evaluateNode(const Node& node, const AtomArrays& atoms) {
+    const auto& v = node.values;
+    switch (node.kind) {
+        case Node::Kind::ALL:      return Selection(atoms.size(), true);
+        case Node::Kind::ELEMENT:  return selectElements(atoms, node.ids);
+        case Node::Kind::INDEX:    return selectIndexRange(atoms, node.indices[0], node.indices[1]);
+        case Node::Kind::BOX:      return selectBox(atoms, glm::vec3(v[0], v[1], v[2]), glm::vec3(v[3], v[4], v[5]));
+        case Node::Kind::SPHERE:   return selectSphere(atoms, glm::vec3(v[0], v[1], v[2]), v[3]);
+        case Node::Kind::SLAB:     return selectSlab(atoms, node.ids[0], v[0], v[1]);
+        case Node::Kind::MOLECULE: return selectMolecules(atoms, node.ids);
+        case Node::Kind::SPEED:    return selectSpeed(atoms, v[0], v[1]);
+        case Node::Kind::BONDED:   return selectBondedTo(atoms, evaluateNode(*node.children[0], atoms));
+        case Node::Kind::AND: {
+            Selection result = evaluateNode(*node.children[0], atoms);
+            result &= evaluateNode(*node.children[1], atoms);
+            return result;
+        }
+        case Node::Kind::OR: {
+            Selection result = evaluateNode(*node.children[0], atoms);
+            result |= evaluateNode(*node.children[1], atoms);
+            return result;
+        }
+        case Node::Kind::NOT: {
+            Selection result = evaluateNode(*node.children[0], atoms);
+            result.invert();
+            return result;
+        }
+    }
+    return Selection(atoms.size());
+}
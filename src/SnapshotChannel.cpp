@@ -0,0 +1,323 @@
+#include "SnapshotChannel.h"
+#include "AtomArrays.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory counters must be lock-free");
+
+namespace {
+const uint32_t MAGIC = 0x564C5441;  // "ATLV"
+const uint32_t LAYOUT_VERSION = 1;
+const size_t ALIGNMENT = 64;
+
+struct SegmentHeader {
+    uint32_t magic;
+    uint32_t layoutVersion;
+    uint64_t maxAtoms;
+    uint64_t maxBonds;
+    uint64_t slotBytes;
+    uint32_t slotCount;
+    uint32_t reserved;
+    std::atomic<uint64_t> published;  ///< Snapshots published; the latest is in slot (published - 1) % slotCount
+    std::atomic<uint32_t> closed;
+};
+
+struct SlotHeader {
+    std::atomic<uint64_t> sequence;   ///< Odd while the slot is being written
+    uint64_t atomCount;
+    uint64_t bondCount;
+    uint64_t step;
+    uint64_t frame;
+    double   time;
+    double   kineticEnergy;
+};
+
+size_t alignUp(size_t bytes) { return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; }
+
+/// Byte offsets of the arrays from the start of a slot
+struct SlotLayout {
+    size_t x, y, z, atomicNumber, bonds, bytes;
+
+    SlotLayout(uint64_t maxAtoms, uint64_t maxBonds) {
+        x = alignUp(sizeof(SlotHeader));
+        y = x + alignUp(maxAtoms * sizeof(float));
+        z = y + alignUp(maxAtoms * sizeof(float));
+        atomicNumber = z + alignUp(maxAtoms * sizeof(float));
+        bonds = atomicNumber + alignUp(maxAtoms);
+        bytes = bonds + alignUp(maxBonds * 2 * sizeof(uint32_t));
+    }
+};
+
+const size_t HEADER_BYTES = alignUp(sizeof(SegmentHeader));
+
+std::string segmentName(const std::string& name) {
+#ifdef _WIN32
+    return "Local\\atomica-" + name;
+#else
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+#endif
+}
+
+void unmapSegment(unsigned char*& base, size_t& size, void*& handle) {
+    if (!base) return;
+#ifdef _WIN32
+    UnmapViewOfFile(base);
+    if (handle) CloseHandle(static_cast<HANDLE>(handle));
+#else
+    munmap(base, size);
+#endif
+    base = nullptr;
+    size = 0;
+    handle = nullptr;
+}
+}
+
+// ─── Publisher ──────────────────────────────────────────────────────────────
+
+SnapshotPublisher::~SnapshotPublisher() {
+    close();
+}
+
+bool SnapshotPublisher::create(const std::string& name, size_t maxAtoms, size_t maxBonds) {
+    close();
+    m_error.clear();
+    SlotLayout layout(maxAtoms, maxBonds);
+    size_t size = HEADER_BYTES + SnapshotPublisher::SLOT_COUNT * layout.bytes;
+    std::string path = segmentName(name);
+
+#ifdef _WIN32
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(uint64_t(size) >> 32), static_cast<DWORD>(size),
+                                        path.c_str());
+    if (!mapping) {
+        m_error = "Cannot create shared memory " + path;
+        return false;
+    }
+    void* base = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!base) {
+        CloseHandle(mapping);
+        m_error = "Cannot map shared memory " + path;
+        return false;
+    }
+    m_handle = mapping;
+#else
+    // A stale segment from a crashed run is replaced; viewers still mapping it keep their copy
+    shm_unlink(path.c_str());
+    int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        m_error = "Cannot create shared memory " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        m_error = "Cannot size shared memory " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        shm_unlink(path.c_str());
+        return false;
+    }
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        m_error = "Cannot map shared memory " + path + ": " + std::strerror(errno);
+        shm_unlink(path.c_str());
+        return false;
+    }
+#endif
+    m_base = static_cast<unsigned char*>(base);
+    m_size = size;
+    m_name = path;
+
+    // Fresh pages are zeroed; the header is filled in before any viewer can validate it
+    auto* header = new (m_base) SegmentHeader();
+    header->maxAtoms = maxAtoms;
+    header->maxBonds = maxBonds;
+    header->slotBytes = layout.bytes;
+    header->slotCount = SLOT_COUNT;
+    header->published.store(0, std::memory_order_relaxed);
+    header->closed.store(0, std::memory_order_relaxed);
+    for (uint32_t k = 0; k < SLOT_COUNT; ++k) {
+        auto* slot = new (m_base + HEADER_BYTES + k * layout.bytes) SlotHeader();
+        slot->sequence.store(0, std::memory_order_relaxed);
+    }
+    header->layoutVersion = LAYOUT_VERSION;
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = MAGIC;
+    return true;
+}
+
+void SnapshotPublisher::close() {
+    if (!m_base) return;
+    reinterpret_cast<SegmentHeader*>(m_base)->closed.store(1, std::memory_order_release);
+    unmapSegment(m_base, m_size, m_handle);
+#ifndef _WIN32
+    // Attached viewers keep their mapping until they detach
+    shm_unlink(m_name.c_str());
+#endif
+    m_name.clear();
+}
+
+bool SnapshotPublisher::publish(const AtomArrays& atoms, double time, uint64_t step) {
+    if (!m_base) return false;
+    auto* header = reinterpret_cast<SegmentHeader*>(m_base);
+    const size_t count = atoms.size();
+    const bool hasBonds = atoms.bondOffsets.size() == count + 1;
+    size_t bondCount = 0;
+    if (hasBonds) {
+        for (size_t i = 0; i < count; ++i) {
+            for (uint32_t k = atoms.bondOffsets[i]; k < atoms.bondOffsets[i + 1]; ++k) {
+                bondCount += atoms.bondNeighbors[k] > i;
+            }
+        }
+    }
+    if (count > header->maxAtoms || bondCount > header->maxBonds) {
+        if (m_error.empty()) {
+            m_error = "Snapshot of " + std::to_string(count) + " atoms and " + std::to_string(bondCount) +
+                      " bonds exceeds the live-view capacity";
+            LOG_WARNING(m_error);
+        }
+        return false;
+    }
+
+    double kineticEnergy = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        double v2 = double(atoms.vx[i]) * atoms.vx[i] + double(atoms.vy[i]) * atoms.vy[i] +
+                    double(atoms.vz[i]) * atoms.vz[i];
+        kineticEnergy += 0.5 * atoms.mass[i] * v2;
+    }
+
+    // Write the slot after the latest, so readers of the latest are left alone
+    const uint64_t published = header->published.load(std::memory_order_relaxed);
+    const SlotLayout layout(header->maxAtoms, header->maxBonds);
+    unsigned char* slotBase = m_base + HEADER_BYTES + (published % SLOT_COUNT) * layout.bytes;
+    auto* slot = reinterpret_cast<SlotHeader*>(slotBase);
+    const uint64_t sequence = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(slotBase + layout.x, atoms.x.data(), count * sizeof(float));
+    std::memcpy(slotBase + layout.y, atoms.y.data(), count * sizeof(float));
+    std::memcpy(slotBase + layout.z, atoms.z.data(), count * sizeof(float));
+    std::memcpy(slotBase + layout.atomicNumber, atoms.atomicNumber.data(), count);
+    auto* bonds = reinterpret_cast<uint32_t*>(slotBase + layout.bonds);
+    if (hasBonds) {
+        for (size_t i = 0; i < count; ++i) {
+            for (uint32_t k = atoms.bondOffsets[i]; k < atoms.bondOffsets[i + 1]; ++k) {
+                if (atoms.bondNeighbors[k] <= i) continue;
+                *bonds++ = static_cast<uint32_t>(i);
+                *bonds++ = atoms.bondNeighbors[k];
+            }
+        }
+    }
+    slot->atomCount = count;
+    slot->bondCount = bondCount;
+    slot->step = step;
+    slot->frame = published + 1;
+    slot->time = time;
+    slot->kineticEnergy = kineticEnergy;
+
+    slot->sequence.store(sequence + 2, std::memory_order_release);
+    header->published.store(published + 1, std::memory_order_release);
+    return true;
+}
+
+// ─── Subscriber ─────────────────────────────────────────────────────────────
+
+SnapshotSubscriber::~SnapshotSubscriber() {
+    detach();
+}
+
+bool SnapshotSubscriber::attach(const std::string& name) {
+    detach();
+    std::string path = segmentName(name);
+
+#ifdef _WIN32
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, path.c_str());
+    if (!mapping) return false;
+    void* base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!base) {
+        CloseHandle(mapping);
+        return false;
+    }
+    MEMORY_BASIC_INFORMATION info;
+    size_t size = VirtualQuery(base, &info, sizeof(info)) ? info.RegionSize : 0;
+    m_handle = mapping;
+#else
+    int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(HEADER_BYTES)) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) return false;
+#endif
+    m_base = static_cast<unsigned char*>(base);
+    m_size = size;
+
+    // A publisher still initializing the header, or one built with another layout, is rejected
+    const auto* header = reinterpret_cast<const SegmentHeader*>(m_base);
+    bool valid = header->magic == MAGIC;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    valid = valid && header->layoutVersion == LAYOUT_VERSION && header->slotCount > 0 &&
+            header->slotBytes == SlotLayout(header->maxAtoms, header->maxBonds).bytes &&
+            HEADER_BYTES + header->slotCount * header->slotBytes <= m_size;
+    if (!valid) {
+        detach();
+        return false;
+    }
+    return true;
+}
+
+void SnapshotSubscriber::detach() {
+    unmapSegment(m_base, m_size, m_handle);
+}
+
+bool SnapshotSubscriber::isPublisherClosed() const {
+    if (!m_base) return true;
+    return reinterpret_cast<const SegmentHeader*>(m_base)->closed.load(std::memory_order_acquire) != 0;
+}
+
+bool SnapshotSubscriber::acquire(SnapshotView& view) const {
+    if (!m_base) return false;
+    const auto* header = reinterpret_cast<const SegmentHeader*>(m_base);
+    const uint64_t published = header->published.load(std::memory_order_acquire);
+    if (published == 0) return false;
+
+    const SlotLayout layout(header->maxAtoms, header->maxBonds);
+    const unsigned char* slotBase = m_base + HEADER_BYTES + ((published - 1) % header->slotCount) * layout.bytes;
+    const auto* slot = reinterpret_cast<const SlotHeader*>(slotBase);
+    const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+    if (sequence & 1) return false;
+
+    view.x = reinterpret_cast<const float*>(slotBase + layout.x);
+    view.y = reinterpret_cast<const float*>(slotBase + layout.y);
+    view.z = reinterpret_cast<const float*>(slotBase + layout.z);
+    view.atomicNumber = slotBase + layout.atomicNumber;
+    view.bonds = reinterpret_cast<const uint32_t*>(slotBase + layout.bonds);
+    view.atomCount = static_cast<size_t>(std::min<uint64_t>(slot->atomCount, header->maxAtoms));
+    view.bondCount = static_cast<size_t>(std::min<uint64_t>(slot->bondCount, header->maxBonds));
+    view.time = slot->time;
+    view.step = slot->step;
+    view.kineticEnergy = slot->kineticEnergy;
+    view.frame = slot->frame;
+    view.sequenceAddress = &slot->sequence;
+    view.sequence = sequence;
+    return view.isConsistent();
+}
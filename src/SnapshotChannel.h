@@ -0,0 +1,147 @@
+#ifndef SNAPSHOT_CHANNEL_H
+#define SNAPSHOT_CHANNEL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class AtomArrays;
+
+/**
+ * @brief Read-only view of one published snapshot, pointing into shared memory.
+ *
+ * The arrays are not copied: they stay valid only until the publisher reuses
+ * the slot. Read what you need, then call isConsistent(); if it returns false
+ * the slot was overwritten while you were reading and the data may be torn.
+ */
+struct SnapshotView {
+    const float*    x = nullptr;
+    const float*    y = nullptr;
+    const float*    z = nullptr;
+    const uint8_t*  atomicNumber = nullptr;
+    const uint32_t* bonds = nullptr;      ///< Pairs of atom indices, two entries per bond
+    size_t          atomCount = 0;
+    size_t          bondCount = 0;
+    double          time = 0.0;           ///< Simulation time
+    uint64_t        step = 0;             ///< Physics steps taken
+    double          kineticEnergy = 0.0;  ///< 1/2 m v^2 summed over atoms, engine units
+    uint64_t        frame = 0;            ///< Publish counter, increases by one per snapshot
+
+    /**
+     * @brief Checks that the slot has not been rewritten since acquire().
+     *
+     * @return True if everything read from the view so far is intact.
+     */
+    bool isConsistent() const {
+        if (!sequenceAddress) return false;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequenceAddress->load(std::memory_order_relaxed) == sequence;
+    }
+
+    const std::atomic<uint64_t>* sequenceAddress = nullptr;
+    uint64_t                     sequence = 0;
+};
+
+/**
+ * @brief Publishes simulation snapshots into a named shared-memory segment.
+ *
+ * The segment holds a ring of SLOT_COUNT fixed-capacity slots, each guarded
+ * by a sequence counter that is odd while the slot is being written (a
+ * seqlock). The publisher never waits for readers: it writes the slot after
+ * the latest one, so a reader has SLOT_COUNT - 1 publishes to finish with
+ * the latest snapshot before it is overwritten. Any number of viewers can
+ * attach and detach without the publisher noticing.
+ */
+class SnapshotPublisher {
+public:
+    static constexpr uint32_t SLOT_COUNT = 3;
+
+    SnapshotPublisher() = default;
+    ~SnapshotPublisher();
+    SnapshotPublisher(const SnapshotPublisher&) = delete;
+    SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+    /**
+     * @brief Creates (or replaces) the shared segment.
+     *
+     * @param name Segment name, without the leading slash.
+     * @param maxAtoms Atom capacity of each slot.
+     * @param maxBonds Bond capacity of each slot.
+     * @return False on failure; see getError().
+     */
+    bool create(const std::string& name, size_t maxAtoms, size_t maxBonds);
+
+    /**
+     * @brief Marks the segment closed for viewers and removes its name.
+     */
+    void close();
+
+    bool isOpen() const { return m_base != nullptr; }
+    const std::string& getError() const { return m_error; }
+
+    /**
+     * @brief Copies a snapshot into the next slot.
+     *
+     * @param atoms Positions, elements, velocities, masses and CSR bonds.
+     * @param time Simulation time.
+     * @param step Physics steps taken.
+     * @return False if the snapshot exceeds the slot capacity; nothing is published.
+     */
+    bool publish(const AtomArrays& atoms, double time, uint64_t step);
+
+private:
+    std::string m_name;
+    std::string m_error;
+    unsigned char* m_base = nullptr;
+    size_t m_size = 0;
+    void* m_handle = nullptr;
+};
+
+/**
+ * @brief Attaches to a publisher's segment and reads snapshots in place.
+ */
+class SnapshotSubscriber {
+public:
+    SnapshotSubscriber() = default;
+    ~SnapshotSubscriber();
+    SnapshotSubscriber(const SnapshotSubscriber&) = delete;
+    SnapshotSubscriber& operator=(const SnapshotSubscriber&) = delete;
+
+    /**
+     * @brief Maps a segment read-only.
+     *
+     * @param name Segment name, as given to SnapshotPublisher::create().
+     * @return False if no publisher has created it yet or the layout does not match.
+     */
+    bool attach(const std::string& name);
+
+    /**
+     * @brief Unmaps the segment; the publisher is unaffected.
+     */
+    void detach();
+
+    bool isAttached() const { return m_base != nullptr; }
+
+    /**
+     * @brief Checks whether the publisher has closed the segment.
+     *
+     * @return True once the simulation has shut down.
+     */
+    bool isPublisherClosed() const;
+
+    /**
+     * @brief Gets a view of the latest complete snapshot.
+     *
+     * @param view Receives the view.
+     * @return False if nothing has been published or the latest slot is being written.
+     */
+    bool acquire(SnapshotView& view) const;
+
+private:
+    unsigned char* m_base = nullptr;
+    size_t m_size = 0;
+    void* m_handle = nullptr;
+};
+
+#endif // SNAPSHOT_CHANNEL_H
@@ -0,0 +1,122 @@
+#include "SparseLU.h"
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+void SparseLU::analyze(size_t size, const std::vector<uint32_t>& rowStart, const std::vector<uint32_t>& columns) {
+    m_size = size;
+    m_matrixNonZeros = 0;
+
+    // Minimum degree on the symmetrized structure: eliminate the unknown with
+    // the fewest neighbours, then connect its neighbours to each other
+    std::vector<std::set<uint32_t>> neighbours(size);
+    for (size_t row = 0; row < size; ++row) {
+        for (uint32_t p = rowStart[row]; p < rowStart[row + 1]; ++p) {
+            uint32_t column = columns[p];
+            if (column == row) continue;
+            neighbours[row].insert(column);
+            neighbours[column].insert(static_cast<uint32_t>(row));
+        }
+    }
+    m_order.clear();
+    m_order.reserve(size);
+    std::vector<char> eliminated(size, 0);
+    for (size_t step = 0; step < size; ++step) {
+        size_t best = size;
+        for (size_t v = 0; v < size; ++v) {
+            if (!eliminated[v] && (best == size || neighbours[v].size() < neighbours[best].size())) best = v;
+        }
+        eliminated[best] = 1;
+        m_order.push_back(static_cast<uint32_t>(best));
+        for (uint32_t a : neighbours[best]) {
+            neighbours[a].erase(static_cast<uint32_t>(best));
+            for (uint32_t b : neighbours[best]) {
+                if (a != b) neighbours[a].insert(b);
+            }
+        }
+        neighbours[best].clear();
+    }
+    m_position.assign(size, 0);
+    for (size_t k = 0; k < size; ++k) m_position[m_order[k]] = static_cast<uint32_t>(k);
+
+    // Symbolic elimination in that order: row i gains the upper part of every row k < i it touches
+    std::vector<std::set<uint32_t>> pattern(size);
+    for (size_t row = 0; row < size; ++row) {
+        uint32_t i = m_position[row];
+        pattern[i].insert(i);
+        for (uint32_t p = rowStart[row]; p < rowStart[row + 1]; ++p) {
+            pattern[i].insert(m_position[columns[p]]);
+        }
+    }
+    for (size_t i = 0; i < size; ++i) m_matrixNonZeros += pattern[i].size();
+    for (size_t i = 0; i < size; ++i) {
+        for (auto it = pattern[i].begin(); it != pattern[i].end() && *it < i; ++it) {
+            uint32_t k = *it;
+            for (auto upper = pattern[k].upper_bound(k); upper != pattern[k].end(); ++upper) {
+                pattern[i].insert(*upper);
+            }
+        }
+    }
+
+    m_rowStart.assign(size + 1, 0);
+    m_columns.clear();
+    m_diagonal.assign(size, 0);
+    for (size_t i = 0; i < size; ++i) {
+        for (uint32_t column : pattern[i]) {
+            if (column == i) m_diagonal[i] = static_cast<uint32_t>(m_columns.size());
+            m_columns.push_back(column);
+        }
+        m_rowStart[i + 1] = static_cast<uint32_t>(m_columns.size());
+    }
+    m_values.assign(m_columns.size(), 0.0);
+    m_work.assign(size, 0.0);
+}
+
+size_t SparseLU::findEntry(uint32_t row, uint32_t column) const {
+    uint32_t i = m_position[row];
+    uint32_t j = m_position[column];
+    auto begin = m_columns.begin() + m_rowStart[i];
+    auto end = m_columns.begin() + m_rowStart[i + 1];
+    auto found = std::lower_bound(begin, end, j);
+    if (found == end || *found != j) return SIZE_MAX;
+    return static_cast<size_t>(found - m_columns.begin());
+}
+
+bool SparseLU::factor() {
+    // Row-by-row (IKJ) elimination through a dense scratch row; the pattern is closed under fill
+    double* work = m_work.data();
+    for (size_t i = 0; i < m_size; ++i) {
+        const uint32_t begin = m_rowStart[i], end = m_rowStart[i + 1], diagonal = m_diagonal[i];
+        for (uint32_t p = begin; p < end; ++p) work[m_columns[p]] = m_values[p];
+        for (uint32_t p = begin; p < diagonal; ++p) {
+            uint32_t k = m_columns[p];
+            double multiplier = work[k] / m_values[m_diagonal[k]];
+            work[k] = multiplier;
+            if (multiplier == 0.0) continue;
+            for (uint32_t q = m_diagonal[k] + 1; q < m_rowStart[k + 1]; ++q) {
+                work[m_columns[q]] -= multiplier * m_values[q];
+            }
+        }
+        for (uint32_t p = begin; p < end; ++p) m_values[p] = work[m_columns[p]];
+        double pivot = m_values[diagonal];
+        if (pivot == 0.0 || !std::isfinite(pivot)) return false;
+    }
+    return true;
+}
+
+void SparseLU::solve(double* b) const {
+    double* x = m_work.data();
+    for (size_t i = 0; i < m_size; ++i) x[i] = b[m_order[i]];
+    // L has a unit diagonal
+    for (size_t i = 0; i < m_size; ++i) {
+        double sum = x[i];
+        for (uint32_t p = m_rowStart[i]; p < m_diagonal[i]; ++p) sum -= m_values[p] * x[m_columns[p]];
+        x[i] = sum;
+    }
+    for (size_t i = m_size; i-- > 0;) {
+        double sum = x[i];
+        for (uint32_t p = m_diagonal[i] + 1; p < m_rowStart[i + 1]; ++p) sum -= m_values[p] * x[m_columns[p]];
+        x[i] = sum / m_values[m_diagonal[i]];
+    }
+    for (size_t i = 0; i < m_size; ++i) b[m_order[i]] = x[i];
+}
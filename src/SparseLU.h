@@ -0,0 +1,83 @@
+#ifndef SPARSE_LU_H
+#define SPARSE_LU_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief LU factorization of a sparse matrix whose structure is fixed.
+ *
+ * analyze() runs once per structure. It picks a minimum-degree elimination
+ * order and computes where fill-in appears. After that, factor() only does
+ * arithmetic on the precomputed pattern, so refactoring a matrix with new
+ * values (a new Jacobian each integrator step) costs about as much as the
+ * fill pattern has entries.
+ *
+ * There is no pivoting. The matrices this serves, I / (γh) - J from
+ * implicit integrators, are strongly diagonal for the step sizes those
+ * integrators take. A zero pivot makes factor() fail, and the caller
+ * should then shrink the step.
+ *
+ * Values live in the factor's permuted layout; findEntry() maps a
+ * (row, column) of the original matrix to its slot.
+ */
+class SparseLU {
+public:
+    SparseLU() = default;
+
+    /**
+     * @brief Orders the unknowns and computes the fill pattern.
+     *
+     * The diagonal is always part of the pattern.
+     *
+     * @param size Matrix dimension.
+     * @param rowStart CSR row offsets of the structure (size + 1 entries).
+     * @param columns CSR column indices of the structure.
+     */
+    void analyze(size_t size, const std::vector<uint32_t>& rowStart, const std::vector<uint32_t>& columns);
+
+    /**
+     * @brief Finds the slot of an entry in getValues().
+     *
+     * @return The slot, or SIZE_MAX if the entry is outside the pattern.
+     */
+    size_t findEntry(uint32_t row, uint32_t column) const;
+
+    /// Slot of a diagonal entry in getValues()
+    size_t findDiagonal(uint32_t row) const { return m_diagonal[m_position[row]]; }
+
+    std::vector<double>& getValues() { return m_values; }
+    const std::vector<double>& getValues() const { return m_values; }
+
+    /**
+     * @brief Factors the matrix held in getValues(), in place.
+     *
+     * @return False on a zero or non-finite pivot.
+     */
+    bool factor();
+
+    /**
+     * @brief Solves A x = b with the factors.
+     *
+     * @param b Right-hand side in, solution out (original ordering).
+     */
+    void solve(double* b) const;
+
+    size_t getSize() const { return m_size; }
+    size_t getMatrixNonZeros() const { return m_matrixNonZeros; }
+    size_t getFactorNonZeros() const { return m_columns.size(); }
+
+private:
+    size_t m_size = 0;
+    size_t m_matrixNonZeros = 0;
+    std::vector<uint32_t> m_order;     ///< Elimination position -> original index
+    std::vector<uint32_t> m_position;  ///< Original index -> elimination position
+    std::vector<uint32_t> m_rowStart;  ///< Factor pattern, permuted, sorted columns
+    std::vector<uint32_t> m_columns;
+    std::vector<uint32_t> m_diagonal;  ///< Slot of each row's diagonal
+    std::vector<double> m_values;
+    mutable std::vector<double> m_work;
+};
+
+#endif // SPARSE_LU_H
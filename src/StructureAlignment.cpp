@@ -0,0 +1,342 @@
+#include "StructureAlignment.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define ATOMICA_ALIGNMENT_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+// Atoms summed in single precision before folding into the double totals
+const size_t CHUNK_ATOMS = 256;
+// Conformations per side of an RMSD matrix tile
+const size_t TILE = 32;
+
+/**
+ * Horn's symmetric key matrix; its largest eigenvalue is the maximum of
+ * Σ a·(R b) over rotations, its eigenvector the optimal rotation quaternion.
+ */
+void keyMatrix(const double S[9], double N[4][4]) {
+    const double Sxx = S[0], Sxy = S[1], Sxz = S[2];
+    const double Syx = S[3], Syy = S[4], Syz = S[5];
+    const double Szx = S[6], Szy = S[7], Szz = S[8];
+    N[0][0] = Sxx + Syy + Szz;
+    N[0][1] = N[1][0] = Syz - Szy;
+    N[0][2] = N[2][0] = Szx - Sxz;
+    N[0][3] = N[3][0] = Sxy - Syx;
+    N[1][1] = Sxx - Syy - Szz;
+    N[1][2] = N[2][1] = Sxy + Syx;
+    N[1][3] = N[3][1] = Szx + Sxz;
+    N[2][2] = -Sxx + Syy - Szz;
+    N[2][3] = N[3][2] = Syz + Szy;
+    N[3][3] = -Sxx - Syy + Szz;
+}
+
+double determinant3(double a, double b, double c, double d, double e, double f, double g, double h, double i) {
+    return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+}
+
+double determinant4(const double N[4][4]) {
+    double det = 0.0;
+    for (int col = 0; col < 4; ++col) {
+        int c[3], k = 0;
+        for (int j = 0; j < 4; ++j) if (j != col) c[k++] = j;
+        double minor = determinant3(N[1][c[0]], N[1][c[1]], N[1][c[2]],
+                                    N[2][c[0]], N[2][c[1]], N[2][c[2]],
+                                    N[3][c[0]], N[3][c[1]], N[3][c[2]]);
+        det += (col % 2 == 0 ? 1.0 : -1.0) * N[0][col] * minor;
+    }
+    return det;
+}
+
+/**
+ * Largest eigenvalue of the traceless key matrix by Newton's method on its
+ * characteristic polynomial λ⁴ + c2·λ² + c1·λ + c0, starting from the upper
+ * bound (Ga + Gb) / 2.
+ */
+double largestEigenvalue(const double N[4][4], double upperBound) {
+    double trace2 = 0.0, trace3 = 0.0;
+    double N2[4][4];
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            double sum = 0.0;
+            for (int k = 0; k < 4; ++k) sum += N[i][k] * N[k][j];
+            N2[i][j] = sum;
+        }
+    }
+    for (int i = 0; i < 4; ++i) {
+        trace2 += N2[i][i];
+        for (int k = 0; k < 4; ++k) trace3 += N2[i][k] * N[k][i];
+    }
+    const double c2 = -0.5 * trace2;
+    const double c1 = -trace3 / 3.0;
+    const double c0 = determinant4(N);
+
+    double lambda = upperBound;
+    for (int iteration = 0; iteration < 50; ++iteration) {
+        double l2 = lambda * lambda;
+        double p = (l2 + c2) * l2 + c1 * lambda + c0;
+        double dp = 4.0 * l2 * lambda + 2.0 * c2 * lambda + c1;
+        if (dp == 0.0) break;
+        double delta = p / dp;
+        lambda -= delta;
+        if (std::fabs(delta) <= 1e-11 * std::fabs(lambda)) break;
+    }
+    return lambda;
+}
+
+// Eigenvector of the largest eigenvalue by cyclic Jacobi rotations
+void largestEigenvector(const double key[4][4], double q[4]) {
+    double A[4][4], V[4][4];
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            A[i][j] = key[i][j];
+            V[i][j] = i == j ? 1.0 : 0.0;
+        }
+    }
+    for (int sweep = 0; sweep < 50; ++sweep) {
+        double off = 0.0;
+        for (int p = 0; p < 4; ++p) for (int r = p + 1; r < 4; ++r) off += A[p][r] * A[p][r];
+        if (off < 1e-22) break;
+        for (int p = 0; p < 3; ++p) {
+            for (int r = p + 1; r < 4; ++r) {
+                if (std::fabs(A[p][r]) < 1e-300) continue;
+                double theta = (A[r][r] - A[p][p]) / (2.0 * A[p][r]);
+                double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                double c = 1.0 / std::sqrt(t * t + 1.0), s = t * c;
+                for (int k = 0; k < 4; ++k) {
+                    double akp = A[k][p], akr = A[k][r];
+                    A[k][p] = c * akp - s * akr;
+                    A[k][r] = s * akp + c * akr;
+                }
+                for (int k = 0; k < 4; ++k) {
+                    double apk = A[p][k], ark = A[r][k];
+                    A[p][k] = c * apk - s * ark;
+                    A[r][k] = s * apk + c * ark;
+                }
+                for (int k = 0; k < 4; ++k) {
+                    double vkp = V[k][p], vkr = V[k][r];
+                    V[k][p] = c * vkp - s * vkr;
+                    V[k][r] = s * vkp + c * vkr;
+                }
+            }
+        }
+    }
+    int best = 0;
+    for (int i = 1; i < 4; ++i) if (A[i][i] > A[best][best]) best = i;
+    for (int i = 0; i < 4; ++i) q[i] = V[i][best];
+}
+
+glm::dmat3 rotationFromQuaternion(const double q[4]) {
+    double w = q[0], x = q[1], y = q[2], z = q[3];
+    double norm = std::sqrt(w * w + x * x + y * y + z * z);
+    if (norm > 0.0) { w /= norm; x /= norm; y /= norm; z /= norm; }
+    // glm is column-major: m[column][row]
+    glm::dmat3 R;
+    R[0][0] = w * w + x * x - y * y - z * z;
+    R[1][0] = 2.0 * (x * y - w * z);
+    R[2][0] = 2.0 * (x * z + w * y);
+    R[0][1] = 2.0 * (x * y + w * z);
+    R[1][1] = w * w - x * x + y * y - z * z;
+    R[2][1] = 2.0 * (y * z - w * x);
+    R[0][2] = 2.0 * (x * z - w * y);
+    R[1][2] = 2.0 * (y * z + w * x);
+    R[2][2] = w * w - x * x - y * y + z * z;
+    return R;
+}
+
+inline double rmsdFromEigenvalue(const Conformation& a, const Conformation& b, double lambda) {
+    double e = a.innerProduct + b.innerProduct - 2.0 * lambda;
+    return a.atomCount > 0 ? std::sqrt(std::max(0.0, e / a.atomCount)) : 0.0;
+}
+}
+
+Conformation Conformation::fromAtoms(const float* px, const float* py, const float* pz,
+                                     const std::vector<uint32_t>& atoms) {
+    Conformation c;
+    c.atomCount = atoms.size();
+    size_t padded = (atoms.size() + 3) & ~size_t(3);
+    c.x.assign(padded, 0.0f);
+    c.y.assign(padded, 0.0f);
+    c.z.assign(padded, 0.0f);
+    if (atoms.empty()) return c;
+
+    glm::dvec3 sum(0.0);
+    for (uint32_t i : atoms) sum += glm::dvec3(px[i], py[i], pz[i]);
+    c.centroid = sum / static_cast<double>(atoms.size());
+
+    double g = 0.0;
+    for (size_t k = 0; k < atoms.size(); ++k) {
+        uint32_t i = atoms[k];
+        c.x[k] = static_cast<float>(px[i] - c.centroid.x);
+        c.y[k] = static_cast<float>(py[i] - c.centroid.y);
+        c.z[k] = static_cast<float>(pz[i] - c.centroid.z);
+        g += double(c.x[k]) * c.x[k] + double(c.y[k]) * c.y[k] + double(c.z[k]) * c.z[k];
+    }
+    c.innerProduct = g;
+    return c;
+}
+
+void StructureAlignment::innerProductMatrix(const Conformation& a, const Conformation& b, double S[9]) {
+    std::fill(S, S + 9, 0.0);
+    const size_t padded = std::min(a.x.size(), b.x.size());
+    const float* ax = a.x.data(); const float* ay = a.y.data(); const float* az = a.z.data();
+    const float* bx = b.x.data(); const float* by = b.y.data(); const float* bz = b.z.data();
+
+    for (size_t start = 0; start < padded; start += CHUNK_ATOMS) {
+        size_t end = std::min(padded, start + CHUNK_ATOMS);
+#if ATOMICA_ALIGNMENT_SSE2
+        __m128 acc[9];
+        for (int k = 0; k < 9; ++k) acc[k] = _mm_setzero_ps();
+        for (size_t i = start; i < end; i += 4) {
+            __m128 vax = _mm_loadu_ps(ax + i), vay = _mm_loadu_ps(ay + i), vaz = _mm_loadu_ps(az + i);
+            __m128 vbx = _mm_loadu_ps(bx + i), vby = _mm_loadu_ps(by + i), vbz = _mm_loadu_ps(bz + i);
+            acc[0] = _mm_add_ps(acc[0], _mm_mul_ps(vbx, vax));
+            acc[1] = _mm_add_ps(acc[1], _mm_mul_ps(vbx, vay));
+            acc[2] = _mm_add_ps(acc[2], _mm_mul_ps(vbx, vaz));
+            acc[3] = _mm_add_ps(acc[3], _mm_mul_ps(vby, vax));
+            acc[4] = _mm_add_ps(acc[4], _mm_mul_ps(vby, vay));
+            acc[5] = _mm_add_ps(acc[5], _mm_mul_ps(vby, vaz));
+            acc[6] = _mm_add_ps(acc[6], _mm_mul_ps(vbz, vax));
+            acc[7] = _mm_add_ps(acc[7], _mm_mul_ps(vbz, vay));
+            acc[8] = _mm_add_ps(acc[8], _mm_mul_ps(vbz, vaz));
+        }
+        for (int k = 0; k < 9; ++k) {
+            float lanes[4];
+            _mm_storeu_ps(lanes, acc[k]);
+            S[k] += double(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+        }
+#else
+        float acc[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+        for (size_t i = start; i < end; ++i) {
+            acc[0] += bx[i] * ax[i]; acc[1] += bx[i] * ay[i]; acc[2] += bx[i] * az[i];
+            acc[3] += by[i] * ax[i]; acc[4] += by[i] * ay[i]; acc[5] += by[i] * az[i];
+            acc[6] += bz[i] * ax[i]; acc[7] += bz[i] * ay[i]; acc[8] += bz[i] * az[i];
+        }
+        for (int k = 0; k < 9; ++k) S[k] += acc[k];
+#endif
+    }
+}
+
+double StructureAlignment::rmsd(const Conformation& a, const Conformation& b) {
+    double S[9], N[4][4];
+    innerProductMatrix(a, b, S);
+    keyMatrix(S, N);
+    double lambda = largestEigenvalue(N, 0.5 * (a.innerProduct + b.innerProduct));
+    return rmsdFromEigenvalue(a, b, lambda);
+}
+
+glm::dmat3 StructureAlignment::kabsch(const Conformation& a, const Conformation& b, double* rmsdOut) {
+    double S[9], N[4][4], q[4];
+    innerProductMatrix(a, b, S);
+    keyMatrix(S, N);
+    largestEigenvector(N, q);
+    glm::dmat3 R = rotationFromQuaternion(q);
+    if (rmsdOut) {
+        *rmsdOut = rmsdFromEigenvalue(a, b, largestEigenvalue(N, 0.5 * (a.innerProduct + b.innerProduct)));
+    }
+    return R;
+}
+
+void StructureAlignment::superpose(const Conformation& reference, std::vector<Conformation>& conformations,
+                                   std::vector<double>* rmsds) {
+    if (rmsds) rmsds->assign(conformations.size(), 0.0);
+    TaskScheduler::getInstance().parallelFor(0, conformations.size(), [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+            Conformation& conformation = conformations[c];
+            double value = 0.0;
+            glm::dmat3 R = kabsch(reference, conformation, &value);
+            glm::mat3 Rf(R);
+            for (size_t i = 0; i < conformation.atomCount; ++i) {
+                glm::vec3 p = Rf * glm::vec3(conformation.x[i], conformation.y[i], conformation.z[i]);
+                conformation.x[i] = p.x;
+                conformation.y[i] = p.y;
+                conformation.z[i] = p.z;
+            }
+            conformation.centroid = reference.centroid;
+            if (rmsds) (*rmsds)[c] = value;
+        }
+    }, 4);
+}
+
+// ─── RMSD matrix ──────────────────────────────────────────────────────
+
+void RmsdMatrix::compute(const std::vector<Conformation>& conformations) {
+    m_size = conformations.size();
+    m_values.assign(m_size > 1 ? m_size * (m_size - 1) / 2 : 0, 0.0f);
+    if (m_size < 2) return;
+
+    size_t tiles = (m_size + TILE - 1) / TILE;
+    std::vector<std::pair<uint32_t, uint32_t>> tileList;
+    tileList.reserve(tiles * (tiles + 1) / 2);
+    for (size_t I = 0; I < tiles; ++I) {
+        for (size_t J = I; J < tiles; ++J) {
+            tileList.emplace_back(static_cast<uint32_t>(I), static_cast<uint32_t>(J));
+        }
+    }
+
+    TaskScheduler::getInstance().parallelFor(0, tileList.size(), [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            size_t i0 = size_t(tileList[t].first) * TILE, j0 = size_t(tileList[t].second) * TILE;
+            size_t i1 = std::min(m_size, i0 + TILE), j1 = std::min(m_size, j0 + TILE);
+            for (size_t i = i0; i < i1; ++i) {
+                for (size_t j = std::max(j0, i + 1); j < j1; ++j) {
+                    m_values[condensedIndex(i, j)] =
+                        static_cast<float>(StructureAlignment::rmsd(conformations[i], conformations[j]));
+                }
+            }
+        }
+    }, 1);
+}
+
+float RmsdMatrix::get(size_t i, size_t j) const {
+    if (i == j) return 0.0f;
+    if (i > j) std::swap(i, j);
+    return m_values[condensedIndex(i, j)];
+}
+
+std::vector<int> RmsdMatrix::clusterGromos(float cutoff, std::vector<size_t>& centers) const {
+    std::vector<int> cluster(m_size, -1);
+    centers.clear();
+
+    // Neighbor counts (excluding self) among the not yet clustered conformations
+    std::vector<int64_t> neighbors(m_size, 0);
+    TaskScheduler::getInstance().parallelFor(0, m_size, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            int64_t count = 0;
+            for (size_t j = 0; j < m_size; ++j) {
+                if (j != i && get(i, j) <= cutoff) ++count;
+            }
+            neighbors[i] = count;
+        }
+    }, 16);
+
+    size_t remaining = m_size;
+    std::vector<size_t> members;
+    while (remaining > 0) {
+        size_t center = m_size;
+        for (size_t i = 0; i < m_size; ++i) {
+            if (cluster[i] < 0 && (center == m_size || neighbors[i] > neighbors[center])) center = i;
+        }
+        int id = static_cast<int>(centers.size());
+        centers.push_back(center);
+
+        members.clear();
+        members.push_back(center);
+        for (size_t j = 0; j < m_size; ++j) {
+            if (j != center && cluster[j] < 0 && get(center, j) <= cutoff) members.push_back(j);
+        }
+        for (size_t m : members) cluster[m] = id;
+        remaining -= members.size();
+
+        // Members leave the pool: the conformations near them lose a neighbor
+        for (size_t m : members) {
+            for (size_t j = 0; j < m_size; ++j) {
+                if (cluster[j] < 0 && get(m, j) <= cutoff) --neighbors[j];
+            }
+        }
+    }
+    return cluster;
+}
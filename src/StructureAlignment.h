@@ -0,0 +1,139 @@
+#ifndef STRUCTURE_ALIGNMENT_H
+#define STRUCTURE_ALIGNMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * @brief Centered coordinates of one conformation, ready for RMSD comparisons.
+ *
+ * Coordinates are stored as separate x/y/z arrays zero-padded to a multiple
+ * of four, so inner products run four atoms at a time without a scalar tail.
+ */
+struct Conformation {
+    std::vector<float> x, y, z;
+    size_t atomCount = 0;
+    glm::dvec3 centroid = glm::dvec3(0.0);
+    double innerProduct = 0.0;  ///< Sum of squared centered coordinates
+
+    /**
+     * @brief Builds a centered conformation from a subset of atoms.
+     *
+     * @param px Atom x coordinates.
+     * @param py Atom y coordinates.
+     * @param pz Atom z coordinates.
+     * @param atoms The atom indices to include, in comparison order.
+     * @return The conformation.
+     */
+    static Conformation fromAtoms(const float* px, const float* py, const float* pz,
+                                  const std::vector<uint32_t>& atoms);
+};
+
+/**
+ * @brief Optimal superposition and RMSD between conformations.
+ *
+ * rmsd() uses the quaternion characteristic polynomial (QCP) method: the
+ * minimum RMSD follows from the largest eigenvalue of Horn's 4x4 key matrix,
+ * found by Newton iteration on its characteristic polynomial, so no rotation
+ * or eigenvector is ever formed. kabsch() returns the optimal rotation
+ * itself (as Horn's quaternion eigenvector) for superposing coordinates.
+ * Both start from the same 3x3 inner-product matrix, which is the only part
+ * that scales with the atom count and is computed with SIMD.
+ */
+class StructureAlignment {
+public:
+    /**
+     * @brief Computes the minimum RMSD over all rotations.
+     *
+     * @param a First conformation.
+     * @param b Second conformation (same atom count).
+     * @return The RMSD after optimal superposition.
+     */
+    static double rmsd(const Conformation& a, const Conformation& b);
+
+    /**
+     * @brief Computes the rotation that best superposes b onto a.
+     *
+     * @param a Reference conformation.
+     * @param b Moving conformation.
+     * @param rmsdOut Optional: receives the RMSD after superposition.
+     * @return R such that R·(p_b - centroid_b) + centroid_a best matches p_a.
+     */
+    static glm::dmat3 kabsch(const Conformation& a, const Conformation& b, double* rmsdOut = nullptr);
+
+    /**
+     * @brief Superposes many conformations onto a reference in place.
+     *
+     * Each conformation is rotated into the reference frame (its coordinates
+     * stay centered), in parallel on the TaskScheduler.
+     *
+     * @param reference The reference conformation.
+     * @param conformations The conformations to rotate.
+     * @param rmsds Optional: receives the RMSD of each to the reference.
+     */
+    static void superpose(const Conformation& reference, std::vector<Conformation>& conformations,
+                          std::vector<double>* rmsds = nullptr);
+
+    /**
+     * @brief Computes the 3x3 inner-product matrix S_jk = Σ b_j a_k.
+     *
+     * @param a First conformation.
+     * @param b Second conformation.
+     * @param S Receives the nine sums, row-major.
+     */
+    static void innerProductMatrix(const Conformation& a, const Conformation& b, double S[9]);
+};
+
+/**
+ * @brief All-vs-all RMSD matrix over a set of conformations.
+ *
+ * Stored condensed (upper triangle, no diagonal) in single precision:
+ * 10⁴ conformations take 200 MB. Pairs are computed in square tiles of
+ * conformations so both sides of a tile stay in cache, with tiles spread
+ * over the TaskScheduler.
+ */
+class RmsdMatrix {
+public:
+    /**
+     * @brief Computes every pairwise RMSD.
+     *
+     * @param conformations The conformations (same atom count).
+     */
+    void compute(const std::vector<Conformation>& conformations);
+
+    size_t size() const { return m_size; }
+
+    /**
+     * @brief Gets the RMSD between two conformations.
+     *
+     * @param i First index.
+     * @param j Second index.
+     * @return The RMSD (0 when i == j).
+     */
+    float get(size_t i, size_t j) const;
+
+    /**
+     * @brief Clusters conformations with the GROMOS algorithm.
+     *
+     * Repeatedly takes the conformation with the most neighbors within the
+     * cutoff as a cluster center and removes it with its neighbors.
+     *
+     * @param cutoff RMSD cutoff.
+     * @param centers Receives the center of each cluster, largest cluster first.
+     * @return The cluster index of each conformation.
+     */
+    std::vector<int> clusterGromos(float cutoff, std::vector<size_t>& centers) const;
+
+private:
+    size_t m_size = 0;
+    std::vector<float> m_values;
+
+    size_t condensedIndex(size_t i, size_t j) const {
+        // Row i (i < j) starts after the rows above it: i*n - i*(i+1)/2
+        return i * m_size - i * (i + 1) / 2 + (j - i - 1);
+    }
+};
+
+#endif // STRUCTURE_ALIGNMENT_H
@@ -0,0 +1,163 @@
+#include "SurfaceArea.h"
+#include "CellGrid.h"
+#include "ElementTable.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define ATOMICA_SASA_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+const double PI = 3.14159265358979323846;
+// Atoms per parallelFor chunk; each atom costs points × neighbors tests
+const size_t ATOM_GRAIN = 256;
+
+struct Neighbor {
+    float distance2;
+    float x, y, z;
+    float radius2;
+};
+
+/**
+ * Neighbor spheres relative to the atom center, padded to a multiple of four
+ * with spheres that contain nothing.
+ */
+struct NeighborBlock {
+    std::vector<Neighbor> sorted;
+    std::vector<float> x, y, z, radius2;
+    size_t count = 0;
+
+    void pack() {
+        std::sort(sorted.begin(), sorted.end(),
+                  [](const Neighbor& a, const Neighbor& b) { return a.distance2 < b.distance2; });
+        count = sorted.size();
+        size_t padded = (count + 3) & ~size_t(3);
+        x.assign(padded, 0.0f);
+        y.assign(padded, 0.0f);
+        z.assign(padded, 0.0f);
+        radius2.assign(padded, -1.0f);
+        for (size_t k = 0; k < count; ++k) {
+            x[k] = sorted[k].x;
+            y[k] = sorted[k].y;
+            z[k] = sorted[k].z;
+            radius2[k] = sorted[k].radius2;
+        }
+    }
+
+    bool contains(size_t k, float px, float py, float pz) const {
+        float dx = px - x[k], dy = py - y[k], dz = pz - z[k];
+        return dx * dx + dy * dy + dz * dz < radius2[k];
+    }
+
+    /// Index of a neighbor containing the point, or -1
+    long findOccluder(float px, float py, float pz) const {
+        size_t padded = x.size();
+#ifdef ATOMICA_SASA_SSE2
+        const __m128 vx = _mm_set1_ps(px), vy = _mm_set1_ps(py), vz = _mm_set1_ps(pz);
+        for (size_t k = 0; k < padded; k += 4) {
+            __m128 dx = _mm_sub_ps(vx, _mm_loadu_ps(&x[k]));
+            __m128 dy = _mm_sub_ps(vy, _mm_loadu_ps(&y[k]));
+            __m128 dz = _mm_sub_ps(vz, _mm_loadu_ps(&z[k]));
+            __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            int mask = _mm_movemask_ps(_mm_cmplt_ps(d2, _mm_loadu_ps(&radius2[k])));
+            if (mask) {
+                int lane = (mask & 1) ? 0 : (mask & 2) ? 1 : (mask & 4) ? 2 : 3;
+                return static_cast<long>(k) + lane;
+            }
+        }
+#else
+        for (size_t k = 0; k < padded; ++k) {
+            if (contains(k, px, py, pz)) return static_cast<long>(k);
+        }
+#endif
+        return -1;
+    }
+};
+}
+
+SurfaceArea::SurfaceArea(int pointsPerAtom, float probeRadius)
+    : m_pointCount(static_cast<size_t>(std::max(4, pointsPerAtom))),
+      m_probeRadius(std::max(0.0f, probeRadius)) {
+    // Golden-section spiral: near-uniform points of equal area
+    const double goldenAngle = PI * (3.0 - std::sqrt(5.0));
+    m_px.resize(m_pointCount);
+    m_py.resize(m_pointCount);
+    m_pz.resize(m_pointCount);
+    for (size_t k = 0; k < m_pointCount; ++k) {
+        double z = 1.0 - (2.0 * k + 1.0) / m_pointCount;
+        double r = std::sqrt(std::max(0.0, 1.0 - z * z));
+        double phi = goldenAngle * k;
+        m_px[k] = static_cast<float>(r * std::cos(phi));
+        m_py[k] = static_cast<float>(r * std::sin(phi));
+        m_pz[k] = static_cast<float>(z);
+    }
+}
+
+double SurfaceArea::compute(const float* x, const float* y, const float* z, const uint8_t* atomicNumber,
+                            size_t count, std::vector<float>& areas, std::vector<float>* exposure) const {
+    areas.assign(count, 0.0f);
+    if (exposure) exposure->assign(count, 0.0f);
+    if (count == 0) return 0.0;
+
+    std::vector<float> radius(count);
+    float maxRadius = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        radius[i] = ElementTable::getVdwRadius(atomicNumber[i]) + m_probeRadius;
+        maxRadius = std::max(maxRadius, radius[i]);
+    }
+
+    CellGrid grid;
+    grid.build(x, y, z, count, 2.0f * maxRadius);
+    // Cell order keeps each chunk's neighborhoods in cache
+    const std::vector<uint32_t>& order = grid.getOrderedPoints();
+
+    std::mutex totalMutex;
+    double total = 0.0;
+    const double inversePoints = 1.0 / m_pointCount;
+
+    TaskScheduler::getInstance().parallelFor(0, order.size(), [&](size_t begin, size_t end) {
+        NeighborBlock neighbors;
+        double local = 0.0;
+        for (size_t n = begin; n < end; ++n) {
+            uint32_t i = order[n];
+            const float ri = radius[i];
+            const glm::vec3 center(x[i], y[i], z[i]);
+
+            neighbors.sorted.clear();
+            grid.forEachCandidate(center, ri + maxRadius, [&](uint32_t j) {
+                if (j == i) return;
+                glm::vec3 d = glm::vec3(x[j], y[j], z[j]) - center;
+                float d2 = glm::dot(d, d);
+                float reach = ri + radius[j];
+                if (d2 < reach * reach) {
+                    neighbors.sorted.push_back({d2, d.x, d.y, d.z, radius[j] * radius[j]});
+                }
+            });
+            neighbors.pack();
+
+            size_t exposed = 0;
+            long lastOccluder = -1;
+            for (size_t k = 0; k < m_pointCount; ++k) {
+                float px = ri * m_px[k], py = ri * m_py[k], pz = ri * m_pz[k];
+                // Consecutive spiral points are close, so the last occluder often buries this one too
+                if (lastOccluder >= 0 && neighbors.contains(static_cast<size_t>(lastOccluder), px, py, pz)) continue;
+                lastOccluder = neighbors.findOccluder(px, py, pz);
+                if (lastOccluder < 0) ++exposed;
+            }
+
+            double fraction = exposed * inversePoints;
+            double area = 4.0 * PI * double(ri) * ri * fraction;
+            areas[i] = static_cast<float>(area);
+            if (exposure) (*exposure)[i] = static_cast<float>(fraction);
+            local += area;
+        }
+        std::lock_guard<std::mutex> lock(totalMutex);
+        total += local;
+    }, ATOM_GRAIN);
+
+    return total;
+}
@@ -0,0 +1,51 @@
+#ifndef SURFACE_AREA_H
+#define SURFACE_AREA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Solvent-accessible surface area by the Shrake–Rupley method.
+ *
+ * Each atom is inflated to its van der Waals radius plus the probe radius
+ * and sampled with a fixed set of test points; a point counts as exposed if
+ * no neighboring inflated sphere contains it. The unit-sphere points are
+ * generated once per instance, neighbors come from a CellGrid sorted nearest
+ * first, and each point is tested against four neighbors at a time with
+ * SSE2, starting from the neighbor that buried the previous point. Atoms are
+ * processed in parallel on the TaskScheduler, in cell order.
+ */
+class SurfaceArea {
+public:
+    /**
+     * @param pointsPerAtom Test points per sphere.
+     * @param probeRadius Solvent probe radius in Ångström.
+     */
+    explicit SurfaceArea(int pointsPerAtom = 96, float probeRadius = 1.4f);
+
+    /**
+     * @brief Computes the accessible area of every atom.
+     *
+     * @param x Atom x coordinates (Ångström).
+     * @param y Atom y coordinates.
+     * @param z Atom z coordinates.
+     * @param atomicNumber Atomic numbers, for the van der Waals radii.
+     * @param count Number of atoms.
+     * @param areas Receives the area of each atom in Å².
+     * @param exposure Optional: receives the exposed fraction of each atom's sphere (0..1).
+     * @return The total area in Å².
+     */
+    double compute(const float* x, const float* y, const float* z, const uint8_t* atomicNumber, size_t count,
+                   std::vector<float>& areas, std::vector<float>* exposure = nullptr) const;
+
+    size_t getPointsPerAtom() const { return m_pointCount; }
+    float getProbeRadius() const { return m_probeRadius; }
+
+private:
+    size_t m_pointCount;
+    float m_probeRadius;
+    std::vector<float> m_px, m_py, m_pz;  ///< Unit-sphere test points
+};
+
+#endif // SURFACE_AREA_H
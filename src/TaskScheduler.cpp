@@ -0,0 +1,325 @@
+#include "TaskScheduler.h"
+#include "ConfigManager.h"
+#include <algorithm>
+#include <chrono>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+namespace {
+thread_local int t_workerIndex = -1;
+thread_local unsigned t_stealSeed = 0x9E3779B9u;
+
+unsigned nextStealVictim(unsigned count) {
+    // xorshift: cheap per-thread victim selection without shared state
+    t_stealSeed ^= t_stealSeed << 13;
+    t_stealSeed ^= t_stealSeed >> 17;
+    t_stealSeed ^= t_stealSeed << 5;
+    return t_stealSeed % count;
+}
+
+void lowerCurrentThreadPriority() {
+#if defined(_WIN32)
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#elif defined(__linux__)
+    // On Linux the nice value is per-thread when called with who = 0
+    setpriority(PRIO_PROCESS, 0, 10);
+#endif
+}
+}
+
+TaskScheduler& TaskScheduler::getInstance() {
+    static TaskScheduler instance;
+    return instance;
+}
+
+TaskScheduler::TaskScheduler() {
+    int configured = ConfigManager::getInstance().getInt("worker_threads", 0);
+    unsigned workerCount;
+    if (configured > 0) {
+        workerCount = static_cast<unsigned>(configured);
+    } else {
+        unsigned hardware = std::thread::hardware_concurrency();
+        // The thread that waits on work also executes tasks, so leave it a core
+        workerCount = hardware > 1 ? hardware - 1 : 1;
+    }
+
+    for (unsigned i = 0; i < workerCount; ++i) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (unsigned i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(&TaskScheduler::workerLoop, this, static_cast<int>(i));
+    }
+    m_ioThread = std::thread(&TaskScheduler::ioLoop, this);
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_sleepCondition.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(m_ioMutex);
+    }
+    m_ioCondition.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) worker.join();
+    }
+    if (m_ioThread.joinable()) m_ioThread.join();
+}
+
+TaskScheduler::TaskHandle TaskScheduler::submit(TaskFunction function, const std::vector<TaskHandle>& dependencies) {
+    return createTask(std::move(function), false, dependencies);
+}
+
+TaskScheduler::TaskHandle TaskScheduler::submitIO(TaskFunction function, const std::vector<TaskHandle>& dependencies) {
+    return createTask(std::move(function), true, dependencies);
+}
+
+TaskScheduler::TaskHandle TaskScheduler::createTask(TaskFunction function, bool ioLane,
+                                                    const std::vector<TaskHandle>& dependencies) {
+    auto task = std::make_shared<TaskNode>();
+    task->m_function = std::move(function);
+    task->m_ioLane = ioLane;
+
+    // m_pendingDependencies starts at 1 so the task cannot be released while
+    // dependencies are still being registered
+    for (const auto& dependency : dependencies) {
+        if (!dependency) continue;
+        std::lock_guard<std::mutex> lock(dependency->m_mutex);
+        if (!dependency->isDone()) {
+            task->m_pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+            dependency->m_dependents.push_back(task);
+        }
+    }
+
+    if (task->m_pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        schedule(task);
+    }
+    return task;
+}
+
+void TaskScheduler::schedule(const TaskHandle& task) {
+    if (task->m_ioLane) {
+        {
+            std::lock_guard<std::mutex> lock(m_ioMutex);
+            m_ioQueue.push_back(task);
+        }
+        m_ioCondition.notify_one();
+        return;
+    }
+
+    WorkerQueue& queue = t_workerIndex >= 0 ? *m_queues[t_workerIndex] : m_injectionQueue;
+    m_queuedTasks.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(task);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_sleepCondition.notify_one();
+    m_completionCondition.notify_all();
+}
+
+void TaskScheduler::execute(const TaskHandle& task) {
+    if (task->m_function) {
+        task->m_function();
+        task->m_function = nullptr;
+    }
+
+    std::vector<TaskHandle> dependents;
+    {
+        std::lock_guard<std::mutex> lock(task->m_mutex);
+        task->m_done.store(true, std::memory_order_release);
+        dependents.swap(task->m_dependents);
+    }
+    for (const auto& dependent : dependents) {
+        if (dependent->m_pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            schedule(dependent);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_completionCondition.notify_all();
+}
+
+TaskScheduler::TaskHandle TaskScheduler::popTask(int workerIndex) {
+    if (m_queuedTasks.load(std::memory_order_acquire) == 0) {
+        return nullptr;
+    }
+
+    // Own deque first, newest task: it is the one most likely to be in cache
+    if (workerIndex >= 0) {
+        WorkerQueue& own = *m_queues[workerIndex];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            TaskHandle task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            m_queuedTasks.fetch_sub(1, std::memory_order_acq_rel);
+            return task;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_injectionQueue.mutex);
+        if (!m_injectionQueue.tasks.empty()) {
+            TaskHandle task = std::move(m_injectionQueue.tasks.front());
+            m_injectionQueue.tasks.pop_front();
+            m_queuedTasks.fetch_sub(1, std::memory_order_acq_rel);
+            return task;
+        }
+    }
+
+    // Steal the oldest task from another worker: it is usually the largest
+    // remaining piece of a recursively split range
+    unsigned count = static_cast<unsigned>(m_queues.size());
+    unsigned start = nextStealVictim(count);
+    for (unsigned i = 0; i < count; ++i) {
+        unsigned victim = (start + i) % count;
+        if (static_cast<int>(victim) == workerIndex) continue;
+        WorkerQueue& other = *m_queues[victim];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            TaskHandle task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            m_queuedTasks.fetch_sub(1, std::memory_order_acq_rel);
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+bool TaskScheduler::runPendingTask() {
+    TaskHandle task = popTask(t_workerIndex);
+    if (!task) return false;
+    execute(task);
+    return true;
+}
+
+void TaskScheduler::wait(const TaskHandle& handle) {
+    if (!handle) return;
+    while (!handle->isDone()) {
+        if (runPendingTask()) continue;
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_completionCondition.wait_for(lock, std::chrono::milliseconds(1), [&] {
+            return handle->isDone() || m_queuedTasks.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+void TaskScheduler::waitAll(const std::vector<TaskHandle>& handles) {
+    for (const auto& handle : handles) {
+        wait(handle);
+    }
+}
+
+void TaskScheduler::postToMainThread(TaskFunction function) {
+    std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+    m_mainThreadQueue.push_back(std::move(function));
+}
+
+TaskScheduler::TaskHandle TaskScheduler::continueOnMainThread(TaskFunction function,
+                                                              const std::vector<TaskHandle>& dependencies) {
+    auto shared = std::make_shared<TaskFunction>(std::move(function));
+    return submit([this, shared] { postToMainThread(std::move(*shared)); }, dependencies);
+}
+
+void TaskScheduler::pumpMainThread() {
+    std::vector<TaskFunction> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+        pending.swap(m_mainThreadQueue);
+    }
+    for (auto& function : pending) {
+        function();
+    }
+}
+
+void TaskScheduler::parallelFor(size_t begin, size_t end,
+                                const std::function<void(size_t, size_t)>& body,
+                                size_t minGrain) {
+    if (end <= begin) return;
+    size_t count = end - begin;
+    size_t threads = m_workers.size() + 1;
+
+    // Aim for ~8 chunks per thread so stealing can even out uneven chunks
+    size_t grain = std::max<size_t>(std::max<size_t>(minGrain, 1), count / (threads * 8));
+    if (count <= grain || threads == 1) {
+        body(begin, end);
+        return;
+    }
+
+    auto remaining = std::make_shared<std::atomic<size_t>>(count);
+    const auto* bodyPtr = &body;
+
+    // Split off the upper half as a stealable task until the range fits one
+    // grain, then run the rest inline
+    std::shared_ptr<std::function<void(size_t, size_t)>> runRange =
+        std::make_shared<std::function<void(size_t, size_t)>>();
+    std::weak_ptr<std::function<void(size_t, size_t)>> weakRunRange = runRange;
+    *runRange = [this, grain, remaining, bodyPtr, weakRunRange](size_t first, size_t last) {
+        auto self = weakRunRange.lock();
+        while (last - first > grain) {
+            size_t mid = first + (last - first) / 2;
+            createTask([self, mid, last] { (*self)(mid, last); }, false, {});
+            last = mid;
+        }
+        (*bodyPtr)(first, last);
+        remaining->fetch_sub(last - first, std::memory_order_acq_rel);
+    };
+
+    (*runRange)(begin, end);
+
+    while (remaining->load(std::memory_order_acquire) > 0) {
+        if (runPendingTask()) continue;
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_completionCondition.wait_for(lock, std::chrono::milliseconds(1), [&] {
+            return remaining->load(std::memory_order_acquire) == 0 ||
+                   m_queuedTasks.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+int TaskScheduler::getCurrentWorkerIndex() const {
+    return t_workerIndex;
+}
+
+void TaskScheduler::workerLoop(int workerIndex) {
+    t_workerIndex = workerIndex;
+    t_stealSeed ^= static_cast<unsigned>(workerIndex + 1) * 0x85EBCA6Bu;
+
+    while (true) {
+        if (runPendingTask()) continue;
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.wait(lock, [this] {
+            return m_stopping || m_queuedTasks.load(std::memory_order_acquire) > 0;
+        });
+        if (m_stopping) return;
+    }
+}
+
+void TaskScheduler::ioLoop() {
+    lowerCurrentThreadPriority();
+
+    while (true) {
+        TaskHandle task;
+        {
+            std::unique_lock<std::mutex> lock(m_ioMutex);
+            m_ioCondition.wait(lock, [this] { return m_stopping || !m_ioQueue.empty(); });
+            if (m_ioQueue.empty()) return;
+            task = std::move(m_ioQueue.front());
+            m_ioQueue.pop_front();
+        }
+        execute(task);
+    }
+}
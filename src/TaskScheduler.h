@@ -0,0 +1,192 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Process-wide work-stealing task system.
+ *
+ * Every parallel subsystem (physics, analysis, trajectory output, render
+ * preparation) submits work here instead of owning threads, so the machine is
+ * never oversubscribed. Each worker owns a deque: it pushes and pops its own
+ * tasks at the back, idle workers steal from the front of other deques.
+ * Threads blocked in wait() or parallelFor() execute pending tasks while they
+ * wait, which makes nested parallelism safe. Blocking I/O runs on a separate
+ * low-priority lane so it never occupies a compute worker.
+ */
+class TaskScheduler {
+public:
+    using TaskFunction = std::function<void()>;
+
+    /**
+     * @brief A unit of scheduled work and its dependency bookkeeping.
+     */
+    class TaskNode {
+    public:
+        /**
+         * @brief Checks whether the task has finished running.
+         *
+         * @return True once the task function has returned.
+         */
+        bool isDone() const { return m_done.load(std::memory_order_acquire); }
+
+    private:
+        friend class TaskScheduler;
+
+        TaskFunction m_function;
+        bool m_ioLane = false;
+        std::atomic<int> m_pendingDependencies{1};
+        std::atomic<bool> m_done{false};
+        std::mutex m_mutex;
+        std::vector<std::shared_ptr<TaskNode>> m_dependents;
+    };
+
+    using TaskHandle = std::shared_ptr<TaskNode>;
+
+    /**
+     * @brief Gets the singleton instance of the TaskScheduler.
+     *
+     * The worker count is taken from the "worker_threads" configuration key
+     * (0 selects one worker per hardware thread, minus the calling thread).
+     *
+     * @return Reference to the TaskScheduler instance.
+     */
+    static TaskScheduler& getInstance();
+
+    /**
+     * @brief Submits a compute task.
+     *
+     * @param function The work to run.
+     * @param dependencies Tasks that must finish before this one may start.
+     * @return A handle that can be waited on or used as a dependency.
+     */
+    TaskHandle submit(TaskFunction function, const std::vector<TaskHandle>& dependencies = {});
+
+    /**
+     * @brief Submits a task to the low-priority I/O lane.
+     *
+     * I/O tasks run one at a time, in submission order, on a dedicated thread.
+     *
+     * @param function The work to run.
+     * @param dependencies Tasks that must finish before this one may start.
+     * @return A handle that can be waited on or used as a dependency.
+     */
+    TaskHandle submitIO(TaskFunction function, const std::vector<TaskHandle>& dependencies = {});
+
+    /**
+     * @brief Blocks until a task has finished, running other tasks meanwhile.
+     *
+     * @param handle The task to wait for. Null handles return immediately.
+     */
+    void wait(const TaskHandle& handle);
+
+    /**
+     * @brief Blocks until all given tasks have finished.
+     *
+     * @param handles The tasks to wait for.
+     */
+    void waitAll(const std::vector<TaskHandle>& handles);
+
+    /**
+     * @brief Queues a function to run on the main (GL) thread.
+     *
+     * Background work that must touch OpenGL, the window or engine state
+     * owned by the frame loop hands its final step over through this queue.
+     *
+     * @param function The work to run during the next pumpMainThread().
+     */
+    void postToMainThread(TaskFunction function);
+
+    /**
+     * @brief Schedules a main-thread continuation of other tasks.
+     *
+     * @param function The work to run on the main thread.
+     * @param dependencies Tasks that must finish first.
+     * @return A handle that completes once the function has been queued.
+     */
+    TaskHandle continueOnMainThread(TaskFunction function, const std::vector<TaskHandle>& dependencies);
+
+    /**
+     * @brief Runs every function posted with postToMainThread().
+     *
+     * Called once per frame by the frame loop.
+     */
+    void pumpMainThread();
+
+    /**
+     * @brief Runs body over [begin, end) split into chunks across the workers.
+     *
+     * The range is split recursively in halves; the grain size adapts to the
+     * range length and worker count so small loops stay on the calling thread
+     * and large ones produce enough chunks to balance by stealing.
+     *
+     * @param begin First index.
+     * @param end One past the last index.
+     * @param body Called with a sub-range [chunkBegin, chunkEnd).
+     * @param minGrain Smallest chunk worth scheduling as a separate task.
+     */
+    void parallelFor(size_t begin, size_t end,
+                     const std::function<void(size_t, size_t)>& body,
+                     size_t minGrain = 1);
+
+    /**
+     * @brief Gets the number of compute worker threads.
+     *
+     * @return The worker count (the calling thread is not included).
+     */
+    unsigned getWorkerCount() const { return static_cast<unsigned>(m_workers.size()); }
+
+    /**
+     * @brief Gets the index of the calling worker thread.
+     *
+     * @return The worker index, or -1 if called from a non-worker thread.
+     */
+    int getCurrentWorkerIndex() const;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<TaskHandle> tasks;
+    };
+
+    TaskScheduler();
+    ~TaskScheduler();
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    std::vector<std::thread> m_workers;
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    WorkerQueue m_injectionQueue;
+
+    std::vector<TaskFunction> m_mainThreadQueue;
+    std::mutex m_mainThreadMutex;
+
+    std::thread m_ioThread;
+    std::deque<TaskHandle> m_ioQueue;
+    std::mutex m_ioMutex;
+    std::condition_variable m_ioCondition;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+    std::condition_variable m_completionCondition;
+    std::atomic<size_t> m_queuedTasks{0};
+    std::atomic<bool> m_stopping{false};
+
+    TaskHandle createTask(TaskFunction function, bool ioLane, const std::vector<TaskHandle>& dependencies);
+    void schedule(const TaskHandle& task);
+    void execute(const TaskHandle& task);
+    bool runPendingTask();
+    TaskHandle popTask(int workerIndex);
+    void workerLoop(int workerIndex);
+    void ioLoop();
+};
+
+#endif // TASK_SCHEDULER_H
@@ -0,0 +1,516 @@
+#include "TrajectoryCodec.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+namespace {
+const uint32_t FRAME_MAGIC = 0x46525441;  // "ATRF"
+const uint8_t FRAME_KEY = 0;
+const uint8_t FRAME_DELTA = 1;
+const uint8_t PREDICT_NONE = 0;
+const uint8_t PREDICT_PREVIOUS = 1;
+const uint8_t PREDICT_LINEAR = 2;
+const size_t HEADER_SIZE = 32;
+
+// Keeps quantized values and every residual inside 32 bits
+const int32_t MAX_QUANTIZED = (1 << 28) - 1;
+
+// ─── Byte helpers (little-endian, as written by the x86/x64 targets) ───
+
+template <typename T>
+void append(std::vector<uint8_t>& out, T value) {
+    uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+T readAt(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+inline uint32_t zigzag(int64_t v) { return static_cast<uint32_t>((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63)); }
+inline int64_t unzigzag(uint32_t u) { return static_cast<int64_t>(u >> 1) ^ -static_cast<int64_t>(u & 1); }
+
+inline int bitLength(uint32_t u) {
+    int n = 0;
+    if (u >= 1u << 16) { n += 16; u >>= 16; }
+    if (u >= 1u << 8)  { n += 8;  u >>= 8; }
+    if (u >= 1u << 4)  { n += 4;  u >>= 4; }
+    if (u >= 1u << 2)  { n += 2;  u >>= 2; }
+    if (u >= 1u << 1)  { n += 1;  u >>= 1; }
+    return n + static_cast<int>(u);
+}
+
+inline int32_t quantize(float value, float inverseStep) {
+    float q = std::nearbyint(value * inverseStep);
+    if (!(q > -MAX_QUANTIZED)) q = -static_cast<float>(MAX_QUANTIZED);  // also catches NaN
+    if (q > MAX_QUANTIZED) q = static_cast<float>(MAX_QUANTIZED);
+    return static_cast<int32_t>(q);
+}
+
+// ─── Adaptive binary range coder (LZMA style) ─────────────────────────
+
+const int PROBABILITY_BITS = 11;
+const uint16_t PROBABILITY_INIT = 1 << (PROBABILITY_BITS - 1);
+const int ADAPT_SHIFT = 5;
+const uint32_t TOP = 1u << 24;
+
+class RangeEncoder {
+public:
+    explicit RangeEncoder(std::vector<uint8_t>& out) : m_out(out) {}
+
+    void encodeBit(uint16_t& probability, int bit) {
+        uint32_t bound = (m_range >> PROBABILITY_BITS) * probability;
+        if (bit == 0) {
+            m_range = bound;
+            probability += ((1 << PROBABILITY_BITS) - probability) >> ADAPT_SHIFT;
+        } else {
+            m_low += bound;
+            m_range -= bound;
+            probability -= probability >> ADAPT_SHIFT;
+        }
+        normalize();
+    }
+
+    void encodeDirectBits(uint32_t value, int count) {
+        while (count-- > 0) {
+            m_range >>= 1;
+            if ((value >> count) & 1) m_low += m_range;
+            normalize();
+        }
+    }
+
+    void flush() {
+        for (int i = 0; i < 5; ++i) shiftLow();
+    }
+
+private:
+    std::vector<uint8_t>& m_out;
+    uint64_t m_low = 0;
+    uint32_t m_range = 0xFFFFFFFFu;
+    uint8_t  m_cache = 0;
+    uint64_t m_cacheSize = 1;
+
+    void normalize() {
+        while (m_range < TOP) {
+            m_range <<= 8;
+            shiftLow();
+        }
+    }
+
+    void shiftLow() {
+        if (static_cast<uint32_t>(m_low) < 0xFF000000u || (m_low >> 32) != 0) {
+            uint8_t carry = static_cast<uint8_t>(m_low >> 32);
+            uint8_t pending = m_cache;
+            do {
+                m_out.push_back(static_cast<uint8_t>(pending + carry));
+                pending = 0xFF;
+            } while (--m_cacheSize != 0);
+            m_cache = static_cast<uint8_t>(m_low >> 24);
+        }
+        ++m_cacheSize;
+        m_low = (m_low & 0x00FFFFFFu) << 8;
+    }
+};
+
+class RangeDecoder {
+public:
+    RangeDecoder(const uint8_t* data, size_t size) : m_data(data), m_end(data + size) {
+        for (int i = 0; i < 5; ++i) m_code = (m_code << 8) | nextByte();
+    }
+
+    int decodeBit(uint16_t& probability) {
+        uint32_t bound = (m_range >> PROBABILITY_BITS) * probability;
+        int bit;
+        if (m_code < bound) {
+            m_range = bound;
+            probability += ((1 << PROBABILITY_BITS) - probability) >> ADAPT_SHIFT;
+            bit = 0;
+        } else {
+            m_code -= bound;
+            m_range -= bound;
+            probability -= probability >> ADAPT_SHIFT;
+            bit = 1;
+        }
+        normalize();
+        return bit;
+    }
+
+    uint32_t decodeDirectBits(int count) {
+        uint32_t value = 0;
+        while (count-- > 0) {
+            m_range >>= 1;
+            uint32_t bit = m_code >= m_range ? 1u : 0u;
+            if (bit) m_code -= m_range;
+            value = (value << 1) | bit;
+            normalize();
+        }
+        return value;
+    }
+
+    /// True if the decoder had to read past the end of its input
+    bool overran() const { return m_overrun > 4; }
+
+private:
+    const uint8_t* m_data;
+    const uint8_t* m_end;
+    uint32_t m_code = 0;
+    uint32_t m_range = 0xFFFFFFFFu;
+    int m_overrun = 0;
+
+    uint8_t nextByte() {
+        if (m_data < m_end) return *m_data++;
+        ++m_overrun;
+        return 0;
+    }
+
+    void normalize() {
+        while (m_range < TOP) {
+            m_range <<= 8;
+            m_code = (m_code << 8) | nextByte();
+        }
+    }
+};
+
+/**
+ * Residuals are coded as a bit length (0..32) through a 6-level binary tree
+ * of adaptive probabilities, followed by the bits below the leading one sent
+ * raw. The bit-length model is conditioned on the stream (x, y, z or atom
+ * index) and on the previous bit length of that stream, which captures how
+ * residual magnitudes cluster in space and time.
+ */
+struct ResidualModel {
+    static const int STREAMS = 4;
+    static const int LENGTHS = 33;
+    static const int TREE = 64;
+
+    uint16_t probabilities[STREAMS][LENGTHS][TREE];
+    int previousLength[STREAMS] = {0, 0, 0, 0};
+
+    ResidualModel() {
+        std::fill(&probabilities[0][0][0], &probabilities[0][0][0] + STREAMS * LENGTHS * TREE, PROBABILITY_INIT);
+    }
+
+    void encode(RangeEncoder& coder, int stream, int64_t residual) {
+        uint32_t u = zigzag(residual);
+        int length = bitLength(u);
+        uint16_t* tree = probabilities[stream][previousLength[stream]];
+        int node = 1;
+        for (int i = 5; i >= 0; --i) {
+            int bit = (length >> i) & 1;
+            coder.encodeBit(tree[node], bit);
+            node = (node << 1) | bit;
+        }
+        if (length > 1) coder.encodeDirectBits(u, length - 1);
+        previousLength[stream] = length;
+    }
+
+    int64_t decode(RangeDecoder& coder, int stream) {
+        uint16_t* tree = probabilities[stream][previousLength[stream]];
+        int node = 1;
+        for (int i = 0; i < 6; ++i) {
+            node = (node << 1) | coder.decodeBit(tree[node]);
+        }
+        int length = std::min(node - TREE, 32);
+        uint32_t u = 0;
+        if (length > 0) {
+            u = (length > 1 ? coder.decodeDirectBits(length - 1) : 0u) | (1u << (length - 1));
+        }
+        previousLength[stream] = length;
+        return unzigzag(u);
+    }
+};
+
+// Spreads the low 21 bits of v so there are two zero bits between each
+inline uint64_t spreadBits(uint64_t v) {
+    v &= 0x1FFFFF;
+    v = (v | v << 32) & 0x1F00000000FFFFull;
+    v = (v | v << 16) & 0x1F0000FF0000FFull;
+    v = (v | v << 8)  & 0x100F00F00F00F00Full;
+    v = (v | v << 4)  & 0x10C30C30C30C30C3ull;
+    v = (v | v << 2)  & 0x1249249249249249ull;
+    return v;
+}
+
+// Atom order along a Morton curve over the quantized positions
+std::vector<uint32_t> mortonOrder(const std::vector<int32_t>& q, size_t count) {
+    int32_t lo[3] = {MAX_QUANTIZED, MAX_QUANTIZED, MAX_QUANTIZED};
+    int32_t hi[3] = {-MAX_QUANTIZED, -MAX_QUANTIZED, -MAX_QUANTIZED};
+    for (size_t i = 0; i < count; ++i) {
+        for (int a = 0; a < 3; ++a) {
+            lo[a] = std::min(lo[a], q[i * 3 + a]);
+            hi[a] = std::max(hi[a], q[i * 3 + a]);
+        }
+    }
+    int shift = 0;
+    int64_t extent = 0;
+    for (int a = 0; a < 3; ++a) extent = std::max<int64_t>(extent, int64_t(hi[a]) - lo[a]);
+    while ((extent >> shift) >= (1 << 21)) ++shift;
+
+    std::vector<std::pair<uint64_t, uint32_t>> keys(count);
+    TaskScheduler::getInstance().parallelFor(0, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            uint64_t code = 0;
+            for (int a = 0; a < 3; ++a) {
+                code |= spreadBits(static_cast<uint64_t>(int64_t(q[i * 3 + a]) - lo[a]) >> shift) << a;
+            }
+            keys[i] = {code, static_cast<uint32_t>(i)};
+        }
+    }, 16384);
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<uint32_t> order(count);
+    for (size_t i = 0; i < count; ++i) order[i] = keys[i].second;
+    return order;
+}
+
+// Predicted value of coordinate k given the predictor and the previous frames
+inline int64_t predict(uint8_t predictor, const std::vector<int32_t>& previous,
+                       const std::vector<int32_t>& older, size_t k) {
+    if (predictor == PREDICT_LINEAR) return 2 * int64_t(previous[k]) - older[k];
+    return previous[k];
+}
+}
+
+// ─── Encoder ──────────────────────────────────────────────────────────
+
+TrajectoryEncoder::TrajectoryEncoder(float precision, int keyframeInterval, size_t blockSize)
+    : m_precision(precision > 0.0f ? precision : 0.001f),
+      m_keyframeInterval(std::max(1, keyframeInterval)),
+      m_blockSize(std::max<size_t>(256, blockSize)) {}
+
+void TrajectoryEncoder::reset() {
+    m_order.clear();
+    m_previous.clear();
+    m_older.clear();
+    m_framesSinceKeyframe = 0;
+}
+
+void TrajectoryEncoder::encode(const TrajectoryFrame& frame, std::vector<uint8_t>& out) {
+    auto& scheduler = TaskScheduler::getInstance();
+    const size_t count = frame.size();
+    const float inverseStep = 1.0f / m_precision;
+
+    bool keyframe = m_previous.size() != count * 3 || m_framesSinceKeyframe >= m_keyframeInterval;
+    std::vector<int32_t> current(count * 3);
+    if (keyframe) {
+        std::vector<int32_t> byAtom(count * 3);
+        scheduler.parallelFor(0, count, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                byAtom[i * 3 + 0] = quantize(frame.x[i], inverseStep);
+                byAtom[i * 3 + 1] = quantize(frame.y[i], inverseStep);
+                byAtom[i * 3 + 2] = quantize(frame.z[i], inverseStep);
+            }
+        }, 16384);
+        m_order = mortonOrder(byAtom, count);
+        for (size_t s = 0; s < count; ++s) {
+            std::memcpy(&current[s * 3], &byAtom[size_t(m_order[s]) * 3], 3 * sizeof(int32_t));
+        }
+        m_older.clear();
+        m_framesSinceKeyframe = 0;
+    } else {
+        scheduler.parallelFor(0, count, [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; ++s) {
+                uint32_t i = m_order[s];
+                current[s * 3 + 0] = quantize(frame.x[i], inverseStep);
+                current[s * 3 + 1] = quantize(frame.y[i], inverseStep);
+                current[s * 3 + 2] = quantize(frame.z[i], inverseStep);
+            }
+        }, 16384);
+    }
+
+    // Pick the cheaper temporal predictor from a sample of the coordinates
+    uint8_t predictor = PREDICT_NONE;
+    if (!keyframe) {
+        predictor = PREDICT_PREVIOUS;
+        if (m_older.size() == current.size()) {
+            uint64_t costPrevious = 0, costLinear = 0;
+            for (size_t k = 0; k < current.size(); k += 61) {
+                costPrevious += bitLength(zigzag(int64_t(current[k]) - predict(PREDICT_PREVIOUS, m_previous, m_older, k)));
+                costLinear   += bitLength(zigzag(int64_t(current[k]) - predict(PREDICT_LINEAR, m_previous, m_older, k)));
+            }
+            if (costLinear < costPrevious) predictor = PREDICT_LINEAR;
+        }
+    }
+
+    const size_t blockCount = (count + m_blockSize - 1) / m_blockSize;
+    std::vector<std::vector<uint8_t>> blocks(blockCount);
+    scheduler.parallelFor(0, blockCount, [&](size_t firstBlock, size_t lastBlock) {
+        auto model = std::make_unique<ResidualModel>();
+        for (size_t b = firstBlock; b < lastBlock; ++b) {
+            *model = ResidualModel();
+            std::vector<uint8_t>& bytes = blocks[b];
+            bytes.reserve(m_blockSize * 6);
+            RangeEncoder coder(bytes);
+            size_t begin = b * m_blockSize;
+            size_t end = std::min(count, begin + m_blockSize);
+            for (size_t s = begin; s < end; ++s) {
+                if (keyframe) {
+                    // Slot -> atom mapping, then the position relative to the spatial predecessor
+                    int64_t previousIndex = s > begin ? m_order[s - 1] : 0;
+                    model->encode(coder, 3, int64_t(m_order[s]) - previousIndex);
+                    for (int a = 0; a < 3; ++a) {
+                        int64_t reference = s > begin ? current[(s - 1) * 3 + a] : 0;
+                        model->encode(coder, a, current[s * 3 + a] - reference);
+                    }
+                } else {
+                    for (int a = 0; a < 3; ++a) {
+                        size_t k = s * 3 + a;
+                        model->encode(coder, a, current[k] - predict(predictor, m_previous, m_older, k));
+                    }
+                }
+            }
+            coder.flush();
+        }
+    }, 1);
+
+    out.clear();
+    append<uint32_t>(out, FRAME_MAGIC);
+    append<uint8_t>(out, keyframe ? FRAME_KEY : FRAME_DELTA);
+    append<uint8_t>(out, predictor);
+    append<uint16_t>(out, 0);
+    append<uint32_t>(out, static_cast<uint32_t>(count));
+    append<float>(out, m_precision);
+    append<double>(out, frame.time);
+    append<uint32_t>(out, static_cast<uint32_t>(m_blockSize));
+    append<uint32_t>(out, static_cast<uint32_t>(blockCount));
+    for (const auto& bytes : blocks) append<uint32_t>(out, static_cast<uint32_t>(bytes.size()));
+    for (const auto& bytes : blocks) out.insert(out.end(), bytes.begin(), bytes.end());
+
+    if (keyframe) {
+        m_previous.swap(current);
+    } else {
+        m_older.swap(m_previous);
+        m_previous.swap(current);
+    }
+    ++m_framesSinceKeyframe;
+}
+
+// ─── Decoder ──────────────────────────────────────────────────────────
+
+void TrajectoryDecoder::reset() {
+    m_order.clear();
+    m_previous.clear();
+    m_older.clear();
+    m_error.clear();
+}
+
+bool TrajectoryDecoder::decode(const uint8_t* data, size_t size, TrajectoryFrame& frame) {
+    if (size < HEADER_SIZE || readAt<uint32_t>(data) != FRAME_MAGIC) {
+        return fail("not a trajectory frame");
+    }
+    uint8_t type = data[4];
+    uint8_t predictor = data[5];
+    uint32_t count = readAt<uint32_t>(data + 8);
+    float precision = readAt<float>(data + 12);
+    double time = readAt<double>(data + 16);
+    uint32_t blockSize = readAt<uint32_t>(data + 24);
+    uint32_t blockCount = readAt<uint32_t>(data + 28);
+
+    if (type > FRAME_DELTA || predictor > PREDICT_LINEAR || !(precision > 0.0f) || blockSize == 0 ||
+        blockCount != (uint64_t(count) + blockSize - 1) / blockSize ||
+        size < HEADER_SIZE + size_t(blockCount) * 4) {
+        return fail("corrupt frame header");
+    }
+    bool keyframe = type == FRAME_KEY;
+    if (!keyframe) {
+        if (m_previous.size() != size_t(count) * 3) return fail("delta frame without a matching keyframe");
+        if (predictor == PREDICT_LINEAR && m_older.size() != m_previous.size()) {
+            return fail("delta frame needs two previous frames");
+        }
+    }
+
+    std::vector<size_t> offsets(blockCount + 1);
+    offsets[0] = HEADER_SIZE + size_t(blockCount) * 4;
+    for (uint32_t b = 0; b < blockCount; ++b) {
+        offsets[b + 1] = offsets[b] + readAt<uint32_t>(data + HEADER_SIZE + b * 4);
+    }
+    if (offsets[blockCount] > size) return fail("truncated frame");
+
+    if (keyframe) m_order.assign(count, 0);
+    std::vector<int32_t> current(size_t(count) * 3);
+    std::atomic<bool> corrupt(false);
+
+    TaskScheduler::getInstance().parallelFor(0, blockCount, [&](size_t firstBlock, size_t lastBlock) {
+        auto model = std::make_unique<ResidualModel>();
+        for (size_t b = firstBlock; b < lastBlock; ++b) {
+            *model = ResidualModel();
+            RangeDecoder coder(data + offsets[b], offsets[b + 1] - offsets[b]);
+            size_t begin = b * blockSize;
+            size_t end = std::min<size_t>(count, begin + blockSize);
+            for (size_t s = begin; s < end; ++s) {
+                if (keyframe) {
+                    int64_t index = model->decode(coder, 3) + (s > begin ? int64_t(m_order[s - 1]) : 0);
+                    if (index < 0 || index >= int64_t(count)) {
+                        corrupt.store(true, std::memory_order_relaxed);
+                        return;
+                    }
+                    m_order[s] = static_cast<uint32_t>(index);
+                    for (int a = 0; a < 3; ++a) {
+                        int64_t reference = s > begin ? current[(s - 1) * 3 + a] : 0;
+                        current[s * 3 + a] = static_cast<int32_t>(model->decode(coder, a) + reference);
+                    }
+                } else {
+                    for (int a = 0; a < 3; ++a) {
+                        size_t k = s * 3 + a;
+                        current[k] = static_cast<int32_t>(model->decode(coder, a) + predict(predictor, m_previous, m_older, k));
+                    }
+                }
+            }
+            if (coder.overran()) {
+                corrupt.store(true, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }, 1);
+
+    // Each index is in range, but only a permutation writes every atom
+    if (keyframe && !corrupt.load()) {
+        std::vector<char> seen(count, 0);
+        for (uint32_t index : m_order) {
+            if (seen[index]) {
+                corrupt.store(true, std::memory_order_relaxed);
+                break;
+            }
+            seen[index] = 1;
+        }
+    }
+    if (corrupt.load()) {
+        reset();
+        return fail("corrupt frame data");
+    }
+
+    frame.x.resize(count);
+    frame.y.resize(count);
+    frame.z.resize(count);
+    frame.time = time;
+    TaskScheduler::getInstance().parallelFor(0, count, [&](size_t begin, size_t end) {
+        for (size_t s = begin; s < end; ++s) {
+            uint32_t i = m_order[s];
+            frame.x[i] = current[s * 3 + 0] * precision;
+            frame.y[i] = current[s * 3 + 1] * precision;
+            frame.z[i] = current[s * 3 + 2] * precision;
+        }
+    }, 16384);
+
+    if (keyframe) {
+        m_older.clear();
+        m_previous.swap(current);
+    } else {
+        m_older.swap(m_previous);
+        m_previous.swap(current);
+    }
+    m_error.clear();
+    return true;
+}
+
+bool TrajectoryDecoder::fail(const std::string& message) {
+    m_error = message;
+    return false;
+}
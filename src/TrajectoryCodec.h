@@ -0,0 +1,106 @@
+#ifndef TRAJECTORY_CODEC_H
+#define TRAJECTORY_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One trajectory frame: atom positions in structure-of-arrays layout.
+ */
+struct TrajectoryFrame {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    double time = 0.0;
+
+    size_t size() const { return x.size(); }
+};
+
+/**
+ * @brief Lossy compressor for position trajectories.
+ *
+ * Positions are quantized to a fixed-point grid of the requested precision
+ * (the only lossy step: the error per coordinate is at most precision / 2).
+ * Keyframes sort atoms along a Morton curve and code each atom as a delta
+ * from its spatial predecessor; the frames in between code each atom as a
+ * delta from its motion predicted from the previous one or two frames. The
+ * residuals go through a built-in adaptive binary range coder.
+ *
+ * Atoms are split into fixed-size blocks with independent coder state, so
+ * both encoding and decoding run in parallel on the TaskScheduler. Frames
+ * must be encoded and decoded in order, since delta frames depend on the
+ * frames before them.
+ */
+class TrajectoryEncoder {
+public:
+    /**
+     * @brief Constructs an encoder.
+     *
+     * @param precision Quantization step in simulation length units.
+     * @param keyframeInterval Frames between keyframes (a keyframe is also
+     *                         forced whenever the atom count changes).
+     * @param blockSize Atoms per independently coded block.
+     */
+    explicit TrajectoryEncoder(float precision = 0.001f, int keyframeInterval = 100, size_t blockSize = 16384);
+
+    /**
+     * @brief Encodes the next frame.
+     *
+     * @param frame The positions to encode.
+     * @param out Receives the encoded frame (replacing its contents).
+     */
+    void encode(const TrajectoryFrame& frame, std::vector<uint8_t>& out);
+
+    /**
+     * @brief Forgets the previous frames, so the next frame is a keyframe.
+     */
+    void reset();
+
+    float getPrecision() const { return m_precision; }
+
+private:
+    float  m_precision;
+    int    m_keyframeInterval;
+    size_t m_blockSize;
+    int    m_framesSinceKeyframe = 0;
+
+    std::vector<uint32_t> m_order;     ///< Slot -> atom index, fixed between keyframes
+    std::vector<int32_t>  m_previous;  ///< Quantized xyz per slot, last frame
+    std::vector<int32_t>  m_older;     ///< Quantized xyz per slot, the frame before
+};
+
+/**
+ * @brief Decoder for frames produced by TrajectoryEncoder.
+ */
+class TrajectoryDecoder {
+public:
+    /**
+     * @brief Decodes the next frame.
+     *
+     * @param data The encoded frame.
+     * @param size Size of the encoded frame in bytes.
+     * @param frame Receives the positions and time.
+     * @return True on success; otherwise getError() describes the problem.
+     */
+    bool decode(const uint8_t* data, size_t size, TrajectoryFrame& frame);
+
+    /**
+     * @brief Forgets the previous frames; decoding must restart at a keyframe.
+     */
+    void reset();
+
+    const std::string& getError() const { return m_error; }
+
+private:
+    std::string m_error;
+
+    std::vector<uint32_t> m_order;
+    std::vector<int32_t>  m_previous;
+    std::vector<int32_t>  m_older;
+
+    bool fail(const std::string& message);
+};
+
+#endif // TRAJECTORY_CODEC_H
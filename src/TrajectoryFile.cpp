@@ -0,0 +1,130 @@
+#include "TrajectoryFile.h"
+#include "Logger.h"
+#include <memory>
+
+namespace {
+const char FILE_MAGIC[4] = {'A', 'T', 'R', 'J'};
+const uint32_t FILE_VERSION = 1;
+// Sanity limit for a single encoded frame
+const uint32_t MAX_FRAME_BYTES = 1u << 30;
+}
+
+// ─── Writer ───────────────────────────────────────────────────────────
+
+TrajectoryWriter::~TrajectoryWriter() {
+    close();
+}
+
+bool TrajectoryWriter::open(const std::string& path, float precision, int keyframeInterval) {
+    close();
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        LOG_ERROR("Failed to open trajectory file: " + path);
+        return false;
+    }
+    m_file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    m_file.write(reinterpret_cast<const char*>(&FILE_VERSION), sizeof(FILE_VERSION));
+
+    m_encoder = TrajectoryEncoder(precision, keyframeInterval);
+    m_framesWritten = 0;
+    m_rawBytes = 0;
+    m_encodedBytes = 0;
+    m_open = true;
+    LOG_INFO("Writing trajectory to " + path);
+    return true;
+}
+
+void TrajectoryWriter::writeFrame(const AtomArrays& atoms, double time) {
+    if (!m_open) return;
+    auto& scheduler = TaskScheduler::getInstance();
+
+    while (m_inFlight.size() >= MAX_FRAMES_IN_FLIGHT) {
+        scheduler.wait(m_inFlight.front());
+        m_inFlight.pop_front();
+    }
+
+    auto frame = std::make_shared<TrajectoryFrame>();
+    frame->x = atoms.x;
+    frame->y = atoms.y;
+    frame->z = atoms.z;
+    frame->time = time;
+    auto bytes = std::make_shared<std::vector<uint8_t>>();
+
+    // Frames are encoded strictly in order: each one is a delta against the last
+    m_lastEncode = scheduler.submit([this, frame, bytes]() {
+        m_encoder.encode(*frame, *bytes);
+    }, {m_lastEncode});
+
+    m_lastWrite = scheduler.submitIO([this, frame, bytes]() {
+        uint32_t size = static_cast<uint32_t>(bytes->size());
+        m_file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        m_file.write(reinterpret_cast<const char*>(bytes->data()), bytes->size());
+        m_rawBytes += frame->size() * 3 * sizeof(float);
+        m_encodedBytes += bytes->size() + sizeof(size);
+        ++m_framesWritten;
+    }, {m_lastEncode, m_lastWrite});
+
+    m_inFlight.push_back(m_lastWrite);
+}
+
+void TrajectoryWriter::close() {
+    if (!m_open) return;
+    TaskScheduler::getInstance().wait(m_lastWrite);
+    m_inFlight.clear();
+    m_lastEncode.reset();
+    m_lastWrite.reset();
+
+    m_file.close();
+    m_open = false;
+    LOG_INFO("Trajectory closed after " + std::to_string(getFramesWritten()) + " frames (" +
+             std::to_string(getCompressionRatio()) + "x compression)");
+}
+
+double TrajectoryWriter::getCompressionRatio() const {
+    uint64_t encoded = m_encodedBytes.load(std::memory_order_relaxed);
+    return encoded > 0 ? double(m_rawBytes.load(std::memory_order_relaxed)) / encoded : 0.0;
+}
+
+// ─── Reader ───────────────────────────────────────────────────────────
+
+bool TrajectoryReader::open(const std::string& path) {
+    m_file.close();
+    m_decoder.reset();
+    m_error.clear();
+
+    m_file.open(path, std::ios::binary);
+    if (!m_file.is_open()) {
+        m_error = "cannot open " + path;
+        return false;
+    }
+    char magic[4] = {};
+    uint32_t version = 0;
+    m_file.read(magic, sizeof(magic));
+    m_file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (!m_file || std::string(magic, 4) != std::string(FILE_MAGIC, 4) || version != FILE_VERSION) {
+        m_error = path + " is not an Atomica trajectory";
+        return false;
+    }
+    return true;
+}
+
+bool TrajectoryReader::readFrame(TrajectoryFrame& frame) {
+    uint32_t size = 0;
+    if (!m_file.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+        return false;  // clean end of file
+    }
+    if (size > MAX_FRAME_BYTES) {
+        m_error = "corrupt frame length";
+        return false;
+    }
+    m_buffer.resize(size);
+    if (!m_file.read(reinterpret_cast<char*>(m_buffer.data()), size)) {
+        m_error = "truncated frame";
+        return false;
+    }
+    if (!m_decoder.decode(m_buffer.data(), m_buffer.size(), frame)) {
+        m_error = m_decoder.getError();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,113 @@
+#ifndef TRAJECTORY_FILE_H
+#define TRAJECTORY_FILE_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <string>
+#include "AtomArrays.h"
+#include "TaskScheduler.h"
+#include "TrajectoryCodec.h"
+
+/**
+ * @brief Streams compressed trajectory frames to disk without stalling the frame loop.
+ *
+ * writeFrame() only copies positions; encoding runs as a chain of scheduler
+ * tasks (each frame depends on the previous one, the blocks inside a frame
+ * are encoded in parallel) and the encoded bytes are written on the I/O lane.
+ * If the disk or the encoder falls behind by more than a few frames,
+ * writeFrame() waits for the oldest one rather than queueing without bound.
+ *
+ * File layout: "ATRJ", uint32 version, then per frame a uint32 byte count
+ * followed by a TrajectoryEncoder frame.
+ */
+class TrajectoryWriter {
+public:
+    TrajectoryWriter() = default;
+
+    /**
+     * @brief Flushes pending frames and closes the file.
+     */
+    ~TrajectoryWriter();
+
+    /**
+     * @brief Creates a trajectory file.
+     *
+     * @param path The output file path.
+     * @param precision Quantization step in simulation length units.
+     * @param keyframeInterval Frames between keyframes.
+     * @return True if the file was opened.
+     */
+    bool open(const std::string& path, float precision, int keyframeInterval);
+
+    /**
+     * @brief Queues a frame for encoding and writing.
+     *
+     * @param atoms Snapshot of the atom positions.
+     * @param time Simulation time of the frame.
+     */
+    void writeFrame(const AtomArrays& atoms, double time);
+
+    /**
+     * @brief Waits for pending frames and closes the file.
+     */
+    void close();
+
+    bool isOpen() const { return m_open; }
+    size_t getFramesWritten() const { return m_framesWritten.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Gets the ratio of raw float position size to encoded size so far.
+     *
+     * @return The compression ratio, 0 before the first frame is written.
+     */
+    double getCompressionRatio() const;
+
+private:
+    static const size_t MAX_FRAMES_IN_FLIGHT = 4;
+
+    std::ofstream m_file;
+    bool m_open = false;
+    TrajectoryEncoder m_encoder;
+    TaskScheduler::TaskHandle m_lastEncode;
+    TaskScheduler::TaskHandle m_lastWrite;
+    std::deque<TaskScheduler::TaskHandle> m_inFlight;
+
+    std::atomic<size_t>   m_framesWritten{0};
+    std::atomic<uint64_t> m_rawBytes{0};
+    std::atomic<uint64_t> m_encodedBytes{0};
+};
+
+/**
+ * @brief Sequential reader for files written by TrajectoryWriter.
+ */
+class TrajectoryReader {
+public:
+    /**
+     * @brief Opens a trajectory file.
+     *
+     * @param path The file path.
+     * @return True if the file exists and has a valid header.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Reads and decodes the next frame.
+     *
+     * @param frame Receives the frame.
+     * @return True on success; false at the end of the file or on error
+     *         (getError() is empty at a clean end of file).
+     */
+    bool readFrame(TrajectoryFrame& frame);
+
+    const std::string& getError() const { return m_error; }
+
+private:
+    std::ifstream m_file;
+    TrajectoryDecoder m_decoder;
+    std::vector<uint8_t> m_buffer;
+    std::string m_error;
+};
+
+#endif // TRAJECTORY_FILE_H
@@ -0,0 +1,89 @@
+// atomica-analyze: runs the analysis pipeline over a recorded trajectory.
+//
+//   atomica-analyze <trajectory.atrj> [--stages rdf,msd,hbonds,energy,sasa,rmsd]
+//                   [--topology scene.xyz] [--config config.ini]
+//                   [--output results.txt] [--frames-in-flight N] [--read-ahead N]
+
+#include "AnalysisPipeline.h"
+#include "ConfigManager.h"
+#include "Logger.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+void printUsage() {
+    std::cerr << "Usage: atomica-analyze <trajectory> [--stages rdf,msd,hbonds,energy,sasa,rmsd]\n"
+                 "                        [--topology file.xyz] [--config file.ini]\n"
+                 "                        [--output file] [--frames-in-flight N] [--read-ahead N]\n";
+}
+}
+
+int main(int argc, char** argv) {
+    std::string trajectoryPath;
+    std::string stages = "rdf,msd,hbonds,energy";
+    std::string topologyPath;
+    std::string configPath = "config/config.ini";
+    std::string outputPath;
+    int framesInFlight = 4;
+    int readAhead = 2;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--stages" && hasValue)                stages = argv[++i];
+        else if (arg == "--topology" && hasValue)         topologyPath = argv[++i];
+        else if (arg == "--config" && hasValue)           configPath = argv[++i];
+        else if (arg == "--output" && hasValue)           outputPath = argv[++i];
+        else if (arg == "--frames-in-flight" && hasValue) framesInFlight = std::atoi(argv[++i]);
+        else if (arg == "--read-ahead" && hasValue)       readAhead = std::atoi(argv[++i]);
+        else if (arg == "--help" || arg == "-h")          { printUsage(); return 0; }
+        else if (trajectoryPath.empty() && arg[0] != '-') trajectoryPath = arg;
+        else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+    if (trajectoryPath.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    // Results may go to stdout, which the logger also writes to
+    Logger::getInstance().setLogLevel(Logger::Level::ERROR);
+    if (std::ifstream(configPath).good()) {
+        ConfigManager::getInstance().loadFromFile(configPath);
+    }
+
+    AnalysisPipeline pipeline(framesInFlight > 0 ? framesInFlight : 1);
+    if (!addAnalysisStages(pipeline, stages) || !pipeline.hasStages()) {
+        std::cerr << "Invalid --stages list: " << stages << "\n";
+        return 1;
+    }
+
+    if (!topologyPath.empty()) {
+        AnalysisTopology topology;
+        if (!AnalysisTopology::loadXYZ(topologyPath, topology)) return 1;
+        pipeline.begin(std::move(topology));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = pipeline.processFile(trajectoryPath, readAhead > 0 ? readAhead : 1);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (outputPath.empty()) {
+        pipeline.writeResults(std::cout);
+    } else {
+        std::ofstream out(outputPath);
+        if (!out.is_open()) {
+            std::cerr << "Cannot write " << outputPath << "\n";
+            return 1;
+        }
+        pipeline.writeResults(out);
+    }
+    std::cerr << "Analysed " << pipeline.getFramesProcessed() << " frames in " << seconds << " s\n";
+    return ok ? 0 : 1;
+}
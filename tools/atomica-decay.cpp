@@ -0,0 +1,197 @@
+// atomica-decay: checks the decay-chain solver against closed forms and
+// compares the Bateman and matrix-exponential paths.
+//
+//   atomica-decay [--points N] [--years Y]
+//
+// 1. A parent–daughter pair against the two-member Bateman closed form.
+// 2. The uranium-238 series after Y years: activities relative to U-238
+//    (secular equilibrium), and the largest difference between methods.
+//    Both are accurate to roughly 1e-16 of the inventory.
+// 3. N log-spaced time points out to Y years with both methods.
+// 4. A two-nuclide cycle (decay one way, transmutation back), which only
+//    the matrix exponential handles, against its closed form.
+// 5. Fission products booked by NuclearReactor, one day and one year on,
+//    then the mass balance after booking more U-235 than is left: U-235 plus
+//    the Ba-141 chain equals the initial U-235, and both product chains hold
+//    exactly the moles fissioned.
+
+#include "DecayChain.h"
+#include "NuclearReactor.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+void printUsage() {
+    std::cerr << "Usage: atomica-decay [--points N] [--years Y]\n";
+}
+
+const char* methodName(DecayMethod method) {
+    return method == DecayMethod::Bateman ? "Bateman" : "matrix exponential";
+}
+
+void pairTest() {
+    DecayChain chain;
+    uint32_t parent = chain.addNuclide("P", 10.0);
+    uint32_t daughter = chain.addNuclide("D", 3.0);
+    chain.addDecay(parent, static_cast<int>(daughter));
+    chain.setAmount(parent, 1.0);
+    const double a = chain.getDecayConstant(parent), b = chain.getDecayConstant(daughter);
+
+    std::vector<double> times = {0.0, 1.0, 5.0, 20.0, 60.0}, amounts;
+    double worst[2] = {0.0, 0.0};
+    const DecayMethod methods[2] = {DecayMethod::Bateman, DecayMethod::MatrixExponential};
+    for (int m = 0; m < 2; ++m) {
+        chain.setMethod(methods[m]);
+        chain.evaluate(times, amounts);
+        for (size_t k = 0; k < times.size(); ++k) {
+            double exact[2] = {std::exp(-a * times[k]),
+                               a / (b - a) * (std::exp(-a * times[k]) - std::exp(-b * times[k]))};
+            for (int i = 0; i < 2; ++i) worst[m] = std::max(worst[m], std::fabs(amounts[k * 2 + i] - exact[i]));
+        }
+    }
+    std::printf("Parent-daughter pair (half-lives 10 s and 3 s), largest error over %zu times:\n", times.size());
+    std::printf("  Bateman %.2e, matrix exponential %.2e mol\n", worst[0], worst[1]);
+}
+
+void uraniumTest(double years) {
+    DecayChain chain;
+    chain.addUraniumSeries();
+    chain.setAmount(static_cast<uint32_t>(chain.findNuclide("U-238")), 1.0);
+    const size_t n = chain.getNuclideCount();
+    std::vector<double> bateman, matrix;
+    chain.setMethod(DecayMethod::Bateman);
+    bool ok = chain.evaluate({years * DecayChain::SECONDS_PER_YEAR}, bateman);
+    chain.setMethod(DecayMethod::MatrixExponential);
+    ok = chain.evaluate({years * DecayChain::SECONDS_PER_YEAR}, matrix) && ok;
+
+    std::printf("Uranium-238 series (%zu nuclides) after %.3g years: %s\n", n, years, ok ? "ok" : "FAILED");
+    double reference = chain.getDecayConstant(0) * bateman[0];
+    double difference = 0.0;
+    for (uint32_t i = 0; i < n; ++i) {
+        double activity = chain.getDecayConstant(i) * bateman[i];
+        if (activity > 0.0) {
+            std::printf("  %-8s %.4e mol, activity / U-238 %.5f\n", chain.getNuclideName(i).c_str(), bateman[i],
+                        activity / reference);
+        } else {
+            std::printf("  %-8s %.4e mol\n", chain.getNuclideName(i).c_str(), bateman[i]);
+        }
+        difference = std::max(difference, std::fabs(matrix[i] - bateman[i]));
+    }
+    std::printf("  Largest difference between methods: %.2e mol\n", difference);
+}
+
+void batchTest(size_t points, double years) {
+    DecayChain chain;
+    chain.addUraniumSeries();
+    chain.setAmount(static_cast<uint32_t>(chain.findNuclide("U-238")), 1.0);
+    std::vector<double> times(points), amounts;
+    for (size_t k = 0; k < points; ++k) {
+        double fraction = points > 1 ? double(k) / double(points - 1) : 1.0;
+        times[k] = std::pow(10.0, std::log10(years) * fraction) * DecayChain::SECONDS_PER_YEAR;
+    }
+    std::printf("Batch of %zu log-spaced times from 1 to %.3g years:\n", points, years);
+    for (DecayMethod method : {DecayMethod::Bateman, DecayMethod::MatrixExponential}) {
+        chain.setMethod(method);
+        auto start = std::chrono::steady_clock::now();
+        chain.evaluate(times, amounts);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("  %-18s %.3f ms (%.2f us per time)\n", methodName(method), elapsed * 1e3,
+                    elapsed * 1e6 / double(points));
+    }
+}
+
+void cycleTest() {
+    DecayChain chain;
+    uint32_t a = chain.addNuclide("A", 100.0);
+    uint32_t b = chain.addNuclide("B", 0.0);
+    const double forward = chain.getDecayConstant(a), back = 0.002;
+    chain.addDecay(a, static_cast<int>(b));
+    chain.addTransmutation(b, static_cast<int>(a), back);
+    chain.setAmount(a, 1.0);
+
+    std::vector<double> times = {30.0, 300.0, 3000.0}, amounts;
+    chain.setMethod(DecayMethod::Bateman);
+    bool batemanRefused = !chain.evaluate(times, amounts);
+    chain.setMethod(DecayMethod::Automatic);
+    chain.evaluate(times, amounts);
+    std::printf("Cycle A -> B (decay) -> A (transmutation): Bateman %s, automatic used %s\n",
+                batemanRefused ? "refused" : "ACCEPTED", methodName(chain.getLastMethod()));
+    for (size_t k = 0; k < times.size(); ++k) {
+        double total = forward + back;
+        double exact = (back + forward * std::exp(-total * times[k])) / total;
+        std::printf("  t = %-6.0f A = %.10f (exact %.10f), A + B = %.12f\n", times[k], amounts[k * 2], exact,
+                    amounts[k * 2] + amounts[k * 2 + 1]);
+    }
+}
+
+void fissionTest() {
+    DecayChain inventory;
+    NuclearReactor reactor;
+    inventory.setAmount(inventory.addNuclide("U-235", 7.04e8 * DecayChain::SECONDS_PER_YEAR), 1.0);
+    reactor.recordFissions(inventory, 1e-3);
+    std::printf("1 mmol of U-235 fissions booked into the inventory (%zu nuclides):\n", inventory.getNuclideCount());
+    std::vector<double> amounts;
+    inventory.evaluate({86400.0, DecayChain::SECONDS_PER_YEAR}, amounts);
+    const size_t n = inventory.getNuclideCount();
+    std::printf("  %-8s %-12s %-12s %-12s\n", "", "now", "1 day", "1 year");
+    for (uint32_t i = 0; i < n; ++i) {
+        std::printf("  %-8s %-12.4e %-12.4e %-12.4e\n", inventory.getNuclideName(i).c_str(), inventory.getAmounts()[i],
+                    amounts[i], amounts[n + i]);
+    }
+    std::printf("  (%s)\n", methodName(inventory.getLastMethod()));
+
+    // Asking for more than is left fissions only the rest; every fission
+    // books one atom into each product chain, which decay conserves
+    double booked = 1e-3 + reactor.recordFissions(inventory, 2.0);
+    auto chainTotal = [&](const std::vector<const char*>& names, const double* values) {
+        double total = 0.0;
+        for (const char* name : names) total += values[inventory.findNuclide(name)];
+        return total;
+    };
+    const std::vector<const char*> barium = {"Ba-141", "La-141", "Ce-141", "Pr-141"};
+    const std::vector<const char*> krypton = {"Kr-92", "Rb-92", "Sr-92", "Y-92", "Zr-92"};
+    double uranium = inventory.getAmounts()[inventory.findNuclide("U-235")];
+    inventory.evaluate({DecayChain::SECONDS_PER_YEAR}, amounts);
+    double balance = std::max({std::fabs(uranium + chainTotal(barium, inventory.getAmounts().data()) - 1.0),
+                               std::fabs(chainTotal(krypton, inventory.getAmounts().data()) - booked),
+                               std::fabs(chainTotal(barium, amounts.data()) - booked),
+                               std::fabs(chainTotal(krypton, amounts.data()) - booked)});
+    std::printf("Requesting 2 mol more fissioned %.6f mol in total, U-235 left %.3e mol\n", booked, uranium);
+    std::printf("  U-235 + Ba-141 chain vs initial U-235, each chain vs fissions now and after 1 year: "
+                "largest error %.2e mol (%s)\n", balance, balance < 1e-12 ? "ok" : "FAILED");
+}
+}
+
+int main(int argc, char** argv) {
+    size_t points = 100;
+    double years = 1e7;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--points" && hasValue)      points = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--years" && hasValue)  years = std::atof(argv[++i]);
+        else if (arg == "--help" || arg == "-h") { printUsage(); return 0; }
+        else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+    if (points == 0 || !(years > 1.0)) {
+        printUsage();
+        return 1;
+    }
+
+    pairTest();
+    uraniumTest(years);
+    batchTest(points, years);
+    cycleTest();
+    fissionTest();
+    return 0;
+}
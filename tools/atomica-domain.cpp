@@ -0,0 +1,350 @@
+// atomica-domain: runs a Lennard-Jones fluid split across processes by spatial
+// domain decomposition, reporting energy conservation, load balance and traffic.
+//
+//   atomica-domain [--ranks N] [--mpi] [--atoms N] [--steps N] [--dt DT]
+//                  [--rebalance EVERY] [--grid XxYxZ] [--threads N] [--report EVERY]
+//
+// --ranks forks N processes on this machine that talk through shared memory;
+// --mpi runs one rank per MPI process instead (under mpirun, when built with
+// ATOMICA_WITH_MPI). Each rank runs --threads threads (default: its share of
+// the hardware threads). Reduced units: sigma = epsilon = mass = 1.
+
+#include "BrickDecomposition.h"
+#include "CellGrid.h"
+#include "Communicator.h"
+#include "ConfigManager.h"
+#include "DomainDecomposition.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifdef ATOMICA_WITH_MPI
+#include <mpi.h>
+#endif
+
+namespace {
+const float CUTOFF = 2.5f;
+const float LATTICE_SPACING = 1.12f;
+
+struct RunSettings {
+    size_t atoms = 20000;
+    int steps = 200;
+    float dt = 0.002f;
+    int rebalanceInterval = 20;
+    int reportInterval = 20;
+    std::array<int, 3> grid = {0, 0, 0};
+};
+
+void printUsage() {
+    std::cerr << "Usage: atomica-domain [--ranks N] [--mpi] [--atoms N] [--steps N] [--dt DT]\n"
+                 "                      [--rebalance EVERY] [--grid XxYxZ] [--threads N] [--report EVERY]\n";
+}
+
+/// Deterministic per-atom noise in [0, 1), identical on every rank
+float hashUnit(uint64_t id, uint32_t salt) {
+    uint64_t h = id * 0x9E3779B97F4A7C15ull + salt * 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 31;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 29;
+    return static_cast<float>(h >> 40) / static_cast<float>(1ull << 24);
+}
+
+/**
+ * Lattice sites kept with a probability that falls from 1 to 0.1 along x, so
+ * an even split leaves the low-x ranks with most of the work.
+ */
+void buildSystem(size_t target, glm::vec3& boxLo, glm::vec3& boxHi, DomainParticles& all) {
+    // Mean occupancy is 0.55, so the lattice needs target / 0.55 sites
+    int side = static_cast<int>(std::ceil(std::cbrt(target / 0.55)));
+    boxLo = glm::vec3(0.0f);
+    boxHi = glm::vec3(side * LATTICE_SPACING);
+    all = DomainParticles();
+    for (int k = 0; k < side && all.size() < target; ++k) {
+        for (int j = 0; j < side && all.size() < target; ++j) {
+            for (int i = 0; i < side && all.size() < target; ++i) {
+                uint64_t site = (uint64_t(k) * side + j) * side + i;
+                float keep = 1.0f - 0.9f * float(i) / side;
+                if (hashUnit(site, 0) >= keep) continue;
+                uint64_t id = all.size();
+                all.id.push_back(id);
+                all.x.push_back((i + 0.5f) * LATTICE_SPACING);
+                all.y.push_back((j + 0.5f) * LATTICE_SPACING);
+                all.z.push_back((k + 0.5f) * LATTICE_SPACING);
+                all.vx.push_back(hashUnit(id, 1) - 0.5f);
+                all.vy.push_back(hashUnit(id, 2) - 0.5f);
+                all.vz.push_back(hashUnit(id, 3) - 0.5f);
+                all.mass.push_back(1.0f);
+                all.atomicNumber.push_back(18);
+            }
+        }
+    }
+    all.ownedCount = all.size();
+}
+
+/**
+ * Forces on owned atoms from owned and halo atoms; returns this rank's share of
+ * the potential energy. Threads own bricks of the grid and give each of their
+ * atoms its full neighbour list, so they only ever write their own atoms' entries.
+ */
+double computeForces(const DomainParticles& local, std::vector<glm::vec3>& force, std::vector<double>& energy,
+                     CellGrid& grid, BrickDecomposition& bricks) {
+    const size_t owned = local.getOwnedCount();
+    force.assign(owned, glm::vec3(0.0f));
+    energy.assign(owned, 0.0);
+    grid.build(local.x.data(), local.y.data(), local.z.data(), local.size(), CUTOFF);
+    const std::vector<uint32_t>& order = grid.getOrderedPoints();
+    const float cutoff2 = CUTOFF * CUTOFF;
+    const float shift = 4.0f * (std::pow(cutoff2, -6.0f) - std::pow(cutoff2, -3.0f));
+    bricks.run(grid, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            uint32_t i = order[k];
+            if (i >= owned) continue;
+            glm::vec3 p = local.position(i);
+            glm::vec3 total(0.0f);
+            double potential = 0.0;
+            grid.forEachCandidate(p, CUTOFF, [&](uint32_t j) {
+                if (j == i) return;
+                glm::vec3 d = p - local.position(j);
+                float r2 = glm::dot(d, d);
+                if (r2 >= cutoff2) return;
+                float inv2 = 1.0f / r2;
+                float inv6 = inv2 * inv2 * inv2;
+                total += d * (24.0f * inv6 * (2.0f * inv6 - 1.0f) * inv2);
+                // Each pair is seen from both sides, possibly on different ranks
+                potential += 0.5 * (4.0f * inv6 * (inv6 - 1.0f) - shift);
+            });
+            force[i] = total;
+            energy[i] = potential;
+        }
+    });
+    double potential = 0.0;
+    for (double e : energy) potential += e;
+    return potential;
+}
+
+/// Reflecting walls keep atoms in the (non-periodic) box
+void reflect(DomainParticles& local, const glm::vec3& lo, const glm::vec3& hi) {
+    std::vector<float>* position[3] = {&local.x, &local.y, &local.z};
+    std::vector<float>* velocity[3] = {&local.vx, &local.vy, &local.vz};
+    for (size_t i = 0; i < local.getOwnedCount(); ++i) {
+        for (int a = 0; a < 3; ++a) {
+            float& x = (*position[a])[i];
+            float& v = (*velocity[a])[i];
+            if (x < lo[a]) { x = 2.0f * lo[a] - x; v = std::fabs(v); }
+            if (x > hi[a]) { x = 2.0f * hi[a] - x; v = -std::fabs(v); }
+        }
+    }
+}
+
+double seconds(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+}
+
+int runRank(Communicator& comm, const RunSettings& settings) {
+    const bool root = comm.getRank() == 0;
+    glm::vec3 boxLo, boxHi;
+    DomainParticles all, local;
+    buildSystem(settings.atoms, boxLo, boxHi, all);
+
+    DomainDecomposition domain(comm);
+    if (!domain.setup(boxLo, boxHi, CUTOFF, settings.grid)) {
+        if (root) std::cerr << "Cannot split the box across " << comm.getSize() << " ranks\n";
+        return 1;
+    }
+    domain.claim(all, local);
+    all = DomainParticles();
+
+    if (root) {
+        const auto& g = domain.getGrid();
+        std::printf("%zu atoms, %d ranks as %dx%dx%d, box %.1f\n", settings.atoms, comm.getSize(), g[0], g[1], g[2],
+                    boxHi.x - boxLo.x);
+        std::printf("%6s %14s %14s %10s %10s %10s\n", "step", "kinetic", "total", "ranks", "threads", "atoms");
+    }
+
+    CellGrid grid;
+    BrickDecomposition bricks;
+    std::vector<glm::vec3> force;
+    std::vector<double> energy;
+    if (!domain.exchangeHalos(local)) return 1;
+    double potential = computeForces(local, force, energy, grid, bricks);
+    double forceTime = 0.0, communicationTime = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    const float dt = settings.dt;
+
+    for (int step = 1; step <= settings.steps; ++step) {
+        for (size_t i = 0; i < local.getOwnedCount(); ++i) {
+            float h = 0.5f * dt / local.mass[i];
+            local.vx[i] += h * force[i].x;
+            local.vy[i] += h * force[i].y;
+            local.vz[i] += h * force[i].z;
+            local.x[i] += dt * local.vx[i];
+            local.y[i] += dt * local.vy[i];
+            local.z[i] += dt * local.vz[i];
+        }
+        reflect(local, boxLo, boxHi);
+
+        // Atoms are reordered here, before the new forces are computed, so force[] stays aligned
+        auto exchangeStart = std::chrono::steady_clock::now();
+        bool ok = settings.rebalanceInterval > 0 && step % settings.rebalanceInterval == 0
+                      ? domain.rebalance(local, forceTime)
+                      : domain.migrate(local);
+        if (!ok || !domain.exchangeHalos(local)) return 1;
+        communicationTime += seconds(exchangeStart);
+        if (settings.rebalanceInterval > 0 && step % settings.rebalanceInterval == 0) forceTime = 0.0;
+
+        // CPU time rather than wall time, so ranks sharing a core still measure their own work
+        std::clock_t forceStart = std::clock();
+        potential = computeForces(local, force, energy, grid, bricks);
+        double stepForceTime = double(std::clock() - forceStart) / CLOCKS_PER_SEC;
+        forceTime += stepForceTime;
+
+        double kinetic = 0.0;
+        for (size_t i = 0; i < local.getOwnedCount(); ++i) {
+            float h = 0.5f * dt / local.mass[i];
+            local.vx[i] += h * force[i].x;
+            local.vy[i] += h * force[i].y;
+            local.vz[i] += h * force[i].z;
+            kinetic += 0.5 * local.mass[i] *
+                       (local.vx[i] * local.vx[i] + local.vy[i] * local.vy[i] + local.vz[i] * local.vz[i]);
+        }
+
+        if (step % settings.reportInterval == 0 || step == settings.steps) {
+            double sums[3] = {kinetic, potential, double(local.getOwnedCount())};
+            comm.allReduceSum(sums, 3);
+            double times[3] = {stepForceTime, bricks.getImbalance(), stepForceTime};
+            comm.allReduceMax(times, 2);
+            comm.allReduceSum(times + 2, 1);
+            double imbalance = times[2] > 0.0 ? times[0] / (times[2] / comm.getSize()) : 1.0;
+            if (root) {
+                std::printf("%6d %14.6f %14.6f %10.2f %10.2f %10.0f\n", step, sums[0], sums[0] + sums[1], imbalance,
+                            times[1], sums[2]);
+            }
+        }
+    }
+
+    double totals[3] = {seconds(start), communicationTime, double(domain.getBytesSent())};
+    comm.allReduceMax(totals, 2);
+    comm.allReduceSum(totals + 2, 1);
+    if (root) {
+        std::printf("%.3f s wall, %.3f s in migration and halo exchange (slowest rank), %.1f MB sent\n", totals[0],
+                    totals[1], totals[2] / (1 << 20));
+    }
+    for (int r = 0; r < comm.getSize(); ++r) {
+        comm.barrier();
+        if (r != comm.getRank()) continue;
+        glm::vec3 lo = domain.getSubdomainLo(), hi = domain.getSubdomainHi();
+        std::printf("  rank %d: %zu atoms, x [%.1f, %.1f] y [%.1f, %.1f] z [%.1f, %.1f]\n", r,
+                    local.getOwnedCount(), lo.x, hi.x, lo.y, hi.y, lo.z, hi.z);
+        std::fflush(stdout);
+    }
+    return 0;
+}
+}
+
+int main(int argc, char** argv) {
+    RunSettings settings;
+    int ranks = 1;
+    int threads = 0;
+    bool useMpi = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--ranks" && hasValue)          ranks = std::atoi(argv[++i]);
+        else if (arg == "--mpi")                   useMpi = true;
+        else if (arg == "--atoms" && hasValue)     settings.atoms = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--steps" && hasValue)     settings.steps = std::atoi(argv[++i]);
+        else if (arg == "--dt" && hasValue)        settings.dt = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--rebalance" && hasValue) settings.rebalanceInterval = std::atoi(argv[++i]);
+        else if (arg == "--threads" && hasValue)   threads = std::atoi(argv[++i]);
+        else if (arg == "--report" && hasValue)    settings.reportInterval = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--grid" && hasValue)
+            std::sscanf(argv[++i], "%dx%dx%d", &settings.grid[0], &settings.grid[1], &settings.grid[2]);
+        else if (arg == "--help" || arg == "-h")   { printUsage(); return 0; }
+        else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+    if (ranks < 1 || settings.atoms == 0) {
+        printUsage();
+        return 1;
+    }
+
+    // Set before any rank touches the scheduler; forked ranks start their own workers
+    if (threads <= 0) threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / ranks);
+    ConfigManager::getInstance().setInt("worker_threads", std::max(1, threads - 1));
+
+    if (useMpi) {
+#ifdef ATOMICA_WITH_MPI
+        MPI_Init(&argc, &argv);
+        int result;
+        {
+            MpiCommunicator comm;
+            result = runRank(comm, settings);
+        }
+        MPI_Finalize();
+        return result;
+#else
+        std::cerr << "This build has no MPI support (configure with -DATOMICA_WITH_MPI=ON)\n";
+        return 1;
+#endif
+    }
+
+    if (ranks == 1) {
+        SerialCommunicator comm;
+        return runRank(comm, settings);
+    }
+
+#if !defined(_WIN32)
+    std::string name = "/atomica-domain-" + std::to_string(getpid());
+    std::string error;
+    if (!SharedMemoryCommunicator::create(name, ranks, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    std::fflush(stdout);
+    std::vector<pid_t> children;
+    for (int r = 0; r < ranks; ++r) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            SharedMemoryCommunicator comm;
+            int result = comm.attach(name, r) ? runRank(comm, settings) : 1;
+            std::fflush(stdout);
+            _exit(result);
+        }
+        if (pid < 0) {
+            std::cerr << "fork failed\n";
+            break;
+        }
+        children.push_back(pid);
+    }
+    // A rank that could not start leaves the others blocked in the first exchange
+    if (static_cast<int>(children.size()) != ranks) {
+        for (pid_t pid : children) kill(pid, SIGTERM);
+    }
+    int failures = 0;
+    for (pid_t pid : children) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) ++failures;
+    }
+    SharedMemoryCommunicator::remove(name);
+    return failures == 0 && static_cast<int>(children.size()) == ranks ? 0 : 1;
+#else
+    std::cerr << "--ranks needs a POSIX system; use --mpi under mpiexec instead\n";
+    return 1;
+#endif
+}
@@ -0,0 +1,215 @@
+// atomica-fields: checks the Boris integrator in applied fields and measures
+// its throughput.
+//
+//   atomica-fields [--particles N] [--steps N] [--field B]
+//
+// 1. An electron gyrating in a uniform B for a range of ω_c·dt, integrated
+//    with explicit Euler and with Boris: energy and orbit radius after the run.
+// 2. A proton in a Penning trap (uniform B plus a quadrupole), comparing the
+//    measured axial frequency with sqrt(2 q V / m d²).
+// 3. Field evaluation and push rate for many particles in a uniform field plus
+//    a magnetic dipole.
+
+#include "BorisPusher.h"
+#include "ExternalField.h"
+#include "MathUtils.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+const double PI = 3.14159265358979323846;
+
+void printUsage() {
+    std::cerr << "Usage: atomica-fields [--particles N] [--steps N] [--field B]\n";
+}
+
+/// Advances one particle with the batch pusher
+void pushOne(glm::vec3& position, glm::vec3& velocity, const glm::vec3& acceleration, const glm::vec3& gyration,
+             float velocityStep, float positionStep) {
+    BorisBatch batch;
+    batch.count = 1;
+    batch.x = &position.x;
+    batch.y = &position.y;
+    batch.z = &position.z;
+    batch.vx = &velocity.x;
+    batch.vy = &velocity.y;
+    batch.vz = &velocity.z;
+    batch.ax = &acceleration.x;
+    batch.ay = &acceleration.y;
+    batch.az = &acceleration.z;
+    batch.wx = &gyration.x;
+    batch.wy = &gyration.y;
+    batch.wz = &gyration.z;
+    BorisPusher::push(batch, velocityStep, positionStep);
+}
+
+void gyrationTest(float field, int steps) {
+    const float qm = -MathUtils::ELEMENTARY_CHARGE / MathUtils::ELECTRON_MASS;
+    const float omega = std::fabs(qm) * field;
+    const glm::vec3 b(0.0f, 0.0f, field), gyration = qm * b;
+    const float speed = 1e5f;
+    const float radius = speed / omega;
+    std::printf("Electron in %.3g T (w_c = %.3e rad/s), %d steps\n", field, omega, steps);
+    std::printf("  %-8s %-22s %-18s %s\n", "w_c*dt", "Euler |v|/v0, r/r0", "Boris |v|/v0", "Boris r/r0 (theory)");
+    for (float omegaDt : {0.1f, 1.0f, 10.0f, 100.0f}) {
+        float dt = omegaDt / omega;
+        glm::vec3 eulerPosition(radius, 0.0f, 0.0f), eulerVelocity(0.0f, -speed, 0.0f);
+        glm::vec3 borisPosition = eulerPosition, borisVelocity = eulerVelocity;
+        // Leapfrog wants the velocity half a step back
+        pushOne(borisPosition, borisVelocity, glm::vec3(0.0f), gyration, -0.5f * dt, 0.0f);
+        float lo = borisPosition.x, hi = borisPosition.x;
+        for (int s = 0; s < steps; ++s) {
+            glm::vec3 acceleration = glm::cross(eulerVelocity, gyration);
+            eulerPosition += eulerVelocity * dt;
+            eulerVelocity += acceleration * dt;
+            pushOne(borisPosition, borisVelocity, glm::vec3(0.0f), gyration, dt, dt);
+            lo = std::min(lo, borisPosition.x);
+            hi = std::max(hi, borisPosition.x);
+        }
+        // Boris orbits are polygons with vertices on a circle of radius r0 sqrt(1 + (ω_c·dt / 2)²)
+        double euler = glm::length(eulerVelocity) / speed;
+        char eulerText[32];
+        if (std::isfinite(euler)) {
+            std::snprintf(eulerText, sizeof(eulerText), "%.3e, %.3e", euler,
+                          glm::length(glm::vec2(eulerPosition)) / radius);
+        } else {
+            std::snprintf(eulerText, sizeof(eulerText), "overflow");
+        }
+        std::printf("  %-8.1f %-22s %-18.6f %.4f (%.4f)\n", omegaDt, eulerText, glm::length(borisVelocity) / speed,
+                    0.5f * (hi - lo) / radius, std::sqrt(1.0 + 0.25 * double(omegaDt) * omegaDt));
+    }
+}
+
+void penningTest(int steps) {
+    const float qm = MathUtils::ELEMENTARY_CHARGE / MathUtils::PROTON_MASS;
+    const float field = 1.0f, voltage = 10.0f, size = 1e-3f;
+    ExternalField trap;
+    trap.setUniform(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, field));
+    trap.addQuadrupoleTrap(glm::vec3(0.0f), voltage, size);
+
+    const double axial = std::sqrt(2.0 * qm * voltage / (double(size) * size));
+    const double cyclotron = qm * field;
+    const float dt = static_cast<float>(0.05 / cyclotron);
+    glm::vec3 position(1e-4f, 0.0f, 2e-4f), velocity(0.0f, 500.0f, 0.0f);
+    float maxRadius = 0.0f, maxHeight = 0.0f;
+    int crossings = 0;
+    double firstCrossing = 0.0, lastCrossing = 0.0;
+    for (int s = 0; s < steps * 20; ++s) {
+        glm::vec3 e, b;
+        trap.evaluate(position, e, b);
+        float previousZ = position.z;
+        pushOne(position, velocity, qm * e, qm * b, dt, dt);
+        maxRadius = std::max(maxRadius, glm::length(glm::vec2(position)));
+        maxHeight = std::max(maxHeight, std::fabs(position.z));
+        if ((previousZ < 0.0f) != (position.z < 0.0f)) {
+            // Interpolate the crossing time within the step
+            double t = (s + previousZ / (previousZ - position.z)) * dt;
+            if (crossings == 0) firstCrossing = t;
+            lastCrossing = t;
+            ++crossings;
+        }
+    }
+    std::printf("Proton in a Penning trap (B %.1f T, V %.1f V, d %.1f mm), %d steps\n", field, voltage, size * 1e3f,
+                steps * 20);
+    if (crossings >= 3) {
+        double measured = PI * (crossings - 1) / (lastCrossing - firstCrossing);
+        std::printf("  axial frequency %.4e rad/s (theory %.4e)\n", measured, axial);
+    }
+    std::printf("  stayed within r %.3f mm, |z| %.3f mm\n", maxRadius * 1e3f, maxHeight * 1e3f);
+}
+
+void throughputTest(size_t particles, int steps, float field) {
+    ExternalField sources;
+    sources.setUniform(glm::vec3(1e3f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, field));
+    sources.addMagneticDipole(glm::vec3(0.0f, 0.0f, -0.1f), glm::vec3(0.0f, 0.0f, 1e3f));
+
+    std::vector<float> x(particles), y(particles), z(particles), vx(particles), vy(particles), vz(particles);
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> box(-0.05f, 0.05f);
+    std::normal_distribution<float> thermal(0.0f, 1e5f);
+    for (size_t i = 0; i < particles; ++i) {
+        x[i] = box(random);
+        y[i] = box(random);
+        z[i] = box(random);
+        vx[i] = thermal(random);
+        vy[i] = thermal(random);
+        vz[i] = thermal(random);
+    }
+    const float qm = -MathUtils::ELEMENTARY_CHARGE / MathUtils::ELECTRON_MASS;
+    const float dt = 1.0f / (std::fabs(qm) * field);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int s = 0; s < steps; ++s) {
+        TaskScheduler::getInstance().parallelFor(0, particles, [&](size_t begin, size_t end) {
+            const size_t CHUNK = BorisPusher::CHUNK;
+            float ax[CHUNK], ay[CHUNK], az[CHUNK], wx[CHUNK], wy[CHUNK], wz[CHUNK];
+            for (size_t first = begin; first < end; first += CHUNK) {
+                size_t count = std::min(CHUNK, end - first);
+                sources.evaluate(count, &x[first], &y[first], &z[first], ax, ay, az, wx, wy, wz);
+                for (size_t k = 0; k < count; ++k) {
+                    ax[k] *= qm;
+                    ay[k] *= qm;
+                    az[k] *= qm;
+                    wx[k] *= qm;
+                    wy[k] *= qm;
+                    wz[k] *= qm;
+                }
+                BorisBatch batch;
+                batch.count = count;
+                batch.x = &x[first];
+                batch.y = &y[first];
+                batch.z = &z[first];
+                batch.vx = &vx[first];
+                batch.vy = &vy[first];
+                batch.vz = &vz[first];
+                batch.ax = ax;
+                batch.ay = ay;
+                batch.az = az;
+                batch.wx = wx;
+                batch.wy = wy;
+                batch.wz = wz;
+                BorisPusher::push(batch, dt, dt);
+            }
+        }, 4096);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%zu electrons in a uniform field plus a dipole, %d steps: %.3f s, %.1f M particle-steps/s\n",
+                particles, steps, elapsed, particles * double(steps) / elapsed * 1e-6);
+}
+}
+
+int main(int argc, char** argv) {
+    size_t particles = 1 << 20;
+    int steps = 1000;
+    float field = 1.0f;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--particles" && hasValue)   particles = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--steps" && hasValue)  steps = std::atoi(argv[++i]);
+        else if (arg == "--field" && hasValue)  field = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--help" || arg == "-h") { printUsage(); return 0; }
+        else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+    if (steps < 1 || !(field > 0.0f)) {
+        printUsage();
+        return 1;
+    }
+
+    gyrationTest(field, steps);
+    penningTest(steps);
+    throughputTest(particles, std::max(1, steps / 50), field);
+    return 0;
+}
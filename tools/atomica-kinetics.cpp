@@ -0,0 +1,168 @@
+// atomica-kinetics: checks the stiff reaction-network integrator and measures
+// its cost per step on large networks.
+//
+//   atomica-kinetics [--species N] [--reactions N] [--temperature T] [--seed S]
+//
+// 1. Robertson's problem, the standard stiff test (rate constants spanning
+//    nine orders of magnitude), against the reference solution at t = 40.
+// 2. The built-in hydrogen–oxygen mechanism, with activation energies from
+//    BondCalculator's bond energies, run to completion at a fixed temperature.
+// 3. A random network shaped like a real combustion mechanism: a few hub
+//    radicals, and species that break down into slightly smaller ones.
+//    Jacobian and factor sizes and the time per step.
+
+#include "ReactionNetwork.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+void printUsage() {
+    std::cerr << "Usage: atomica-kinetics [--species N] [--reactions N] [--temperature T] [--seed S]\n";
+}
+
+void robertsonTest() {
+    ReactionNetwork network;
+    network.addSpecies("A", 1.0);
+    network.addReaction("A -> B", 0.04, 0.0, 0.0);
+    network.addReaction("2 B -> B + C", 3e7, 0.0, 0.0);
+    network.addReaction("B + C -> A + C", 1e4, 0.0, 0.0);
+    network.setTolerances(1e-6, 1e-10);
+    network.setTemperature(300.0);
+    const double reference[3] = {0.7158270687, 9.185534764e-6, 0.2841637457};
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = network.integrate(40.0);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("Robertson problem to t = 40 (rtol 1e-6): %s, %zu steps (%zu rejected), %.3f ms\n",
+                ok ? "ok" : "FAILED", network.getAcceptedSteps(), network.getRejectedSteps(), elapsed * 1e3);
+    for (uint32_t s = 0; s < 3; ++s) {
+        double value = network.getConcentrations()[s];
+        std::printf("  %s = %.10e (reference %.10e, relative error %.1e)\n", network.getSpeciesName(s).c_str(),
+                    value, reference[s], std::fabs(value - reference[s]) / reference[s]);
+    }
+}
+
+void combustionTest(double temperature) {
+    BondCalculator bonds;
+    ReactionNetwork network;
+    network.addHydrogenOxygenMechanism(bonds);
+    network.setConcentration(static_cast<uint32_t>(network.findSpecies("H2")), 2e-3);
+    network.setConcentration(static_cast<uint32_t>(network.findSpecies("O2")), 1e-3);
+    network.setTemperature(temperature);
+    network.setTolerances(1e-5, 1e-14);
+
+    std::printf("H2/O2 mechanism at %.0f K (%zu species, %zu reactions):\n", temperature,
+                network.getSpeciesCount(), network.getReactionCount());
+    for (uint32_t r = 0; r < network.getReactionCount(); ++r) {
+        if (r == 0 || r == 2) std::printf("  k[%u] = %.3e\n", r, network.getRateConstant(r));
+    }
+    std::printf("  %-10s", "t (s)");
+    for (uint32_t s = 0; s < network.getSpeciesCount(); ++s) {
+        std::printf(" %-10s", network.getSpeciesName(s).c_str());
+    }
+    std::printf("\n");
+    double time = 0.0;
+    for (double end : {1e-6, 1e-5, 1e-4, 1e-3, 1e-2, 1e-1, 1.0}) {
+        if (!network.integrate(end - time)) {
+            std::printf("  integration failed at t = %.1e\n", time);
+            return;
+        }
+        time = end;
+        std::printf("  %-10.0e", time);
+        for (double c : network.getConcentrations()) std::printf(" %-10.3e", c);
+        std::printf("\n");
+    }
+    const std::vector<double>& c = network.getConcentrations();
+    auto at = [&](const char* name) { return c[static_cast<uint32_t>(network.findSpecies(name))]; };
+    double hydrogen = 2.0 * at("H2") + at("H") + at("OH") + 2.0 * at("H2O");
+    double oxygen = 2.0 * at("O2") + at("O") + at("OH") + at("H2O");
+    std::printf("  H atoms %.6e (start 4e-3), O atoms %.6e (start 2e-3), %zu steps\n", hydrogen, oxygen,
+                network.getAcceptedSteps());
+}
+
+void largeNetworkTest(size_t species, size_t reactions, uint64_t seed) {
+    std::mt19937 random(static_cast<unsigned>(seed));
+    const size_t hubs = std::max<size_t>(2, std::min<size_t>(20, species / 20));
+    std::uniform_int_distribution<size_t> anySpecies(0, species - 1), anyHub(0, hubs - 1);
+    std::uniform_real_distribution<double> logRate(0.0, 1.0);
+    std::uniform_int_distribution<int> kind(0, 9);
+    std::uniform_int_distribution<int> anyStep(0, 9);
+
+    ReactionNetwork network;
+    for (size_t s = 0; s < species; ++s) {
+        network.addSpecies((s < hubs ? "R" : "S") + std::to_string(s), s < hubs ? 1e-6 : 1e-3);
+    }
+    for (size_t r = 0; r < reactions; ++r) {
+        // Products are a little smaller than the reactant, as when fuels break down step by step
+        uint32_t a = static_cast<uint32_t>(anySpecies(random));
+        uint32_t b = static_cast<uint32_t>(std::max<long>(long(hubs), long(a) - 1 - long(anyStep(random))));
+        uint32_t h = static_cast<uint32_t>(anyHub(random)), g = static_cast<uint32_t>(anyHub(random));
+        int type = kind(random);
+        if (type < 6) {
+            // Radical attack: R + A -> B + R', rate constants 1e3 to 1e11 L/(mol s)
+            network.addReaction({{h, 1}, {a, 1}}, {{b, 1}, {g, 1}}, std::pow(10.0, 3.0 + 8.0 * logRate(random)),
+                                0.0, 0.0);
+        } else if (type < 9) {
+            // Decomposition: A -> B + R, 1e-2 to 1e6 /s
+            network.addReaction({{a, 1}}, {{b, 1}, {h, 1}}, std::pow(10.0, -2.0 + 8.0 * logRate(random)), 0.0,
+                                0.0);
+        } else {
+            // Recombination: R + R' -> A, 1e9 to 1e11 L/(mol s)
+            network.addReaction({{h, 1}, {g, 1}}, {{a, 1}}, std::pow(10.0, 9.0 + 2.0 * logRate(random)), 0.0,
+                                0.0);
+        }
+    }
+    network.setTemperature(1000.0);
+    network.setTolerances(1e-4, 1e-14);
+
+    auto start = std::chrono::steady_clock::now();
+    network.computeDerivatives(network.getConcentrations().data(), std::vector<double>(species).data());
+    double analysis = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    bool ok = network.integrate(1e-2);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t steps = network.getAcceptedSteps() + network.getRejectedSteps();
+    std::printf("Random network: %zu species (%zu hubs), %zu reactions, to t = 1e-2 s: %s\n", species, hubs,
+                reactions, ok ? "ok" : "FAILED");
+    std::printf("  Jacobian %zu non-zeros, factor %zu (dense would be %zu); analysis %.1f ms\n",
+                network.getJacobianNonZeros(), network.getFactorNonZeros(), species * species, analysis * 1e3);
+    std::printf("  %zu steps (%zu rejected) in %.1f ms: %.3f ms per step\n", network.getAcceptedSteps(),
+                network.getRejectedSteps(), elapsed * 1e3, elapsed * 1e3 / double(std::max<size_t>(1, steps)));
+}
+}
+
+int main(int argc, char** argv) {
+    size_t species = 1000;
+    size_t reactions = 5000;
+    double temperature = 3000.0;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--species" && hasValue)           species = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--reactions" && hasValue)    reactions = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--temperature" && hasValue)  temperature = std::atof(argv[++i]);
+        else if (arg == "--seed" && hasValue)         seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--help" || arg == "-h") { printUsage(); return 0; }
+        else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+    if (species < 2 || !(temperature > 0.0)) {
+        printUsage();
+        return 1;
+    }
+
+    robertsonTest();
+    combustionTest(temperature);
+    largeNetworkTest(species, reactions, seed);
+    return 0;
+}
@@ -0,0 +1,123 @@
+// atomica-photons: checks radiation trapping in a uniform sphere of gas and
+// measures the packet tracing rate.
+//
+//   atomica-photons [--atoms N] [--packets N] [--radius R] [--seed S]
+//
+// Hydrogen atoms in the ground state fill a sphere, with an equal number of
+// He+ ions mixed in. Lyman-alpha packets start at the centre. Each absorption
+// is re-emitted at once in a random direction until the packet escapes. For
+// optical depths τ from the centre, the mean number of scatterings should
+// approach τ²/2, the random-walk estimate. The ions absorb only at 40.8 eV,
+// so they should neither trap the photons nor slow the tracing.
+
+#include "PhotonTransport.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+const double PI = 3.14159265358979323846;
+const float RYDBERG_CONSTANT_EV = 13.605693f;
+
+void printUsage() {
+    std::cerr << "Usage: atomica-photons [--atoms N] [--packets N] [--radius R] [--seed S]\n";
+}
+
+float lineEnergy(int atomicNumber, int lower, int upper) {
+    return RYDBERG_CONSTANT_EV * atomicNumber * atomicNumber *
+           (1.0f / float(lower * lower) - 1.0f / float(upper * upper));
+}
+}
+
+int main(int argc, char** argv) {
+    size_t atoms = 200000;
+    size_t packets = 10000;
+    float radius = 100.0f;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--atoms" && hasValue)         atoms = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--packets" && hasValue)  packets = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--radius" && hasValue)   radius = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--seed" && hasValue)     seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--help" || arg == "-h") { printUsage(); return 0; }
+        else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+    if (atoms < 2 || packets < 1 || !(radius > 0.0f)) {
+        printUsage();
+        return 1;
+    }
+
+    // Uniform sphere; even indices are hydrogen, odd ones He+
+    std::vector<float> x(atoms), y(atoms), z(atoms);
+    std::mt19937 random(static_cast<unsigned>(seed));
+    std::uniform_real_distribution<float> cube(-radius, radius);
+    for (size_t i = 0; i < atoms; ++i) {
+        do {
+            x[i] = cube(random);
+            y[i] = cube(random);
+            z[i] = cube(random);
+        } while (x[i] * x[i] + y[i] * y[i] + z[i] * z[i] > radius * radius);
+    }
+    std::vector<AbsorptionLine> lines;
+    for (size_t i = 0; i < atoms; ++i) {
+        int atomicNumber = i % 2 == 0 ? 1 : 2;
+        for (int upper = 2; upper <= 4; ++upper) {
+            lines.push_back({lineEnergy(atomicNumber, 1, upper), static_cast<uint32_t>(i), 1,
+                             static_cast<uint16_t>(upper)});
+        }
+    }
+    const float lymanAlpha = lineEnergy(1, 1, 2);
+    const double hydrogenDensity = (atoms + 1) / 2 / (4.0 / 3.0 * PI * double(radius) * radius * radius);
+    std::printf("%zu absorbers (half H, half He+) in a sphere of radius %.1f, %zu Lyman-alpha packets (%.2f eV)\n",
+                atoms, radius, packets, lymanAlpha);
+    std::printf("  %-6s %-12s %-16s %-12s %s\n", "tau", "disc radius", "scatterings", "tau^2/2", "flights/s");
+
+    for (double tau : {1.0, 3.0, 10.0, 30.0}) {
+        // τ = n π r² R from the centre
+        float discRadius = static_cast<float>(std::sqrt(tau / (hydrogenDensity * PI * radius)));
+        PhotonTransport transport;
+        transport.setSeed(seed);
+        transport.setCrossSectionRadius(discRadius);
+        transport.setAbsorbers(x.data(), y.data(), z.data(), atoms);
+        transport.setLines(lines);
+        for (size_t p = 0; p < packets; ++p) {
+            transport.emit(glm::vec3(0.0f), lymanAlpha);
+        }
+
+        std::vector<PhotonAbsorption> absorptions;
+        std::vector<PhotonPacket> escaped;
+        size_t flights = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (transport.getPendingCount() > 0) {
+            flights += transport.getPendingCount();
+            transport.propagate(absorptions, &escaped);
+            // Resonance scattering: the absorber re-emits the same photon at once
+            for (const PhotonAbsorption& absorption : absorptions) {
+                transport.emit(absorption.packet.position, absorption.packet.energy, absorption.line.absorber,
+                               absorption.packet.scatterings + 1);
+            }
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double scatterings = 0.0;
+        for (const PhotonPacket& packet : escaped) scatterings += packet.scatterings;
+        scatterings /= double(escaped.size());
+        std::printf("  %-6.0f %-12.3f %-16.2f %-12.1f %.3g\n", tau, discRadius, scatterings, 0.5 * tau * tau,
+                    flights / elapsed);
+        if (tau == 1.0) {
+            std::printf("  (%zu lines in %zu energy groups)\n", transport.getLineCount(), transport.getGroupCount());
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+// atomica-plasma: benchmarks the particle-in-cell solver on a cold Langmuir
+// oscillation, checking the measured plasma frequency against theory.
+//
+//   atomica-plasma [--particles N] [--grid N] [--steps N] [--dt DT]
+//                  [--amplitude A] [--thermal V] [--sort EVERY]
+//
+// Reduced units: ε0 = 1, electron charge -1 and mass 1, unit box. The
+// electrons' macro-particle weight is chosen so ω_p = 1; the ions are the
+// solver's uniform neutralizing background. The field energy then peaks
+// every π / ω_p.
+
+#include "PlasmaSolver.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+const double PI = 3.14159265358979323846;
+
+void printUsage() {
+    std::cerr << "Usage: atomica-plasma [--particles N] [--grid N] [--steps N] [--dt DT]\n"
+                 "                      [--amplitude A] [--thermal V] [--sort EVERY]\n";
+}
+}
+
+int main(int argc, char** argv) {
+    size_t particles = 1 << 21;
+    int grid = 32;
+    int steps = 200;
+    float dt = 0.1f;
+    float amplitude = 0.01f;
+    float thermal = 0.0f;
+    int sortInterval = 20;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--particles" && hasValue)      particles = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--grid" && hasValue)      grid = std::atoi(argv[++i]);
+        else if (arg == "--steps" && hasValue)     steps = std::atoi(argv[++i]);
+        else if (arg == "--dt" && hasValue)        dt = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--amplitude" && hasValue) amplitude = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--thermal" && hasValue)   thermal = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--sort" && hasValue)      sortInterval = std::atoi(argv[++i]);
+        else if (arg == "--help" || arg == "-h")   { printUsage(); return 0; }
+        else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    PlasmaSolver solver;
+    if (!solver.configure(glm::vec3(0.0f), glm::vec3(1.0f), grid, grid, grid, 1.0f)) {
+        std::cerr << "Grid size must be a power of two\n";
+        return 1;
+    }
+    solver.setSortInterval(sortInterval);
+
+    // Quiet start: a lattice of electrons displaced by one sine wave along x
+    const int side = std::max(1, static_cast<int>(std::round(std::cbrt(double(particles)))));
+    const size_t count = size_t(side) * side * side;
+    const int electrons = solver.addSpecies(-1.0f, 1.0f, 1.0f / count);
+    solver.reserve(count);
+    std::mt19937 random(12345);
+    std::normal_distribution<float> maxwell(0.0f, thermal);
+    for (int k = 0; k < side; ++k) {
+        for (int j = 0; j < side; ++j) {
+            for (int i = 0; i < side; ++i) {
+                glm::vec3 p((i + 0.5f) / side, (j + 0.5f) / side, (k + 0.5f) / side);
+                p.x += amplitude * static_cast<float>(std::sin(2.0 * PI * p.x));
+                glm::vec3 v(0.0f);
+                if (thermal > 0.0f) v = glm::vec3(maxwell(random), maxwell(random), maxwell(random));
+                solver.addParticle(electrons, p, v);
+            }
+        }
+    }
+    std::printf("%zu macro-particles, %d^3 grid, dt %.3f\n", count, grid, dt);
+
+    std::vector<double> fieldEnergy;
+    PlasmaTimings total;
+    double initialEnergy = 0.0, maxDrift = 0.0, elapsed = 0.0;
+    double kineticBefore = solver.getKineticEnergy();
+    for (int s = 0; s < steps; ++s) {
+        auto start = std::chrono::steady_clock::now();
+        solver.step(dt);
+        elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const PlasmaTimings& t = solver.getTimings();
+        total.sort += t.sort;
+        total.deposit += t.deposit;
+        total.solve += t.solve;
+        total.push += t.push;
+
+        // The field is at step s and velocities straddle it; average the two half steps
+        double field = solver.getFieldEnergy();
+        double kineticAfter = solver.getKineticEnergy();
+        double energy = field + 0.5 * (kineticBefore + kineticAfter);
+        kineticBefore = kineticAfter;
+        if (s == 0) initialEnergy = energy;
+        maxDrift = std::max(maxDrift, std::fabs(energy - initialEnergy));
+        fieldEnergy.push_back(field);
+    }
+
+    // Field energy maxima, refined with a parabola through the neighbours
+    std::vector<double> peaks;
+    for (size_t s = 1; s + 1 < fieldEnergy.size(); ++s) {
+        double a = fieldEnergy[s - 1], b = fieldEnergy[s], c = fieldEnergy[s + 1];
+        if (b > a && b >= c) {
+            double denominator = a - 2.0 * b + c;
+            double offset = denominator != 0.0 ? 0.5 * (a - c) / denominator : 0.0;
+            peaks.push_back((s + offset) * dt);
+        }
+    }
+    if (peaks.size() >= 2) {
+        double spacing = (peaks.back() - peaks.front()) / (peaks.size() - 1);
+        // Leapfrog shifts the frequency to (2/dt) asin(ω dt / 2)
+        double expected = 2.0 / dt * std::asin(0.5 * dt);
+        std::printf("plasma frequency %.4f (leapfrog theory %.4f, continuum 1), %zu peaks\n", PI / spacing, expected,
+                    peaks.size());
+    } else {
+        std::printf("too few oscillations to measure the plasma frequency; run more steps\n");
+    }
+    std::printf("energy drift %.3e of %.3e\n", maxDrift, initialEnergy);
+    std::printf("%.3f s, %.1f M particle-steps/s (sort %.3f, deposit %.3f, solve %.3f, push %.3f s)\n", elapsed,
+                count * double(steps) / elapsed * 1e-6, total.sort, total.deposit, total.solve, total.push);
+    return 0;
+}
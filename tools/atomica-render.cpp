@@ -0,0 +1,173 @@
+// atomica-render: ray traces frames of a recorded trajectory on the CPU.
+//
+//   atomica-render <trajectory.atrj> [--topology scene.xyz] [--frames first:last:stride]
+//                  [--size 3840x2160] [--spp N] [--ao N] [--shadows N] [--view x,y,z]
+//                  [--radius-scale S] [--bond-cutoff D] [--bond-radius R]
+//                  [--output frame_%05d.ppm]
+
+#include "AnalysisPipeline.h"
+#include "CellGrid.h"
+#include "Logger.h"
+#include "RayTracer.h"
+#include "TrajectoryFile.h"
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+void printUsage() {
+    std::cerr << "Usage: atomica-render <trajectory> [--topology file.xyz] [--frames first:last:stride]\n"
+                 "                       [--size WxH] [--spp N] [--ao N] [--shadows N] [--view x,y,z]\n"
+                 "                       [--radius-scale S] [--bond-cutoff D] [--bond-radius R]\n"
+                 "                       [--output pattern.ppm]\n";
+}
+
+/// Bonds every pair of atoms closer than the cutoff, as CSR
+void inferBonds(const TrajectoryFrame& frame, float cutoff,
+                std::vector<uint32_t>& offsets, std::vector<uint32_t>& neighbors) {
+    size_t count = frame.size();
+    CellGrid grid;
+    grid.build(frame.x.data(), frame.y.data(), frame.z.data(), count, cutoff);
+    offsets.assign(count + 1, 0);
+    neighbors.clear();
+    const float cutoff2 = cutoff * cutoff;
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3 p(frame.x[i], frame.y[i], frame.z[i]);
+        grid.forEachCandidate(p, cutoff, [&](uint32_t j) {
+            if (j == i) return;
+            glm::vec3 d = glm::vec3(frame.x[j], frame.y[j], frame.z[j]) - p;
+            if (glm::dot(d, d) < cutoff2) neighbors.push_back(j);
+        });
+        offsets[i + 1] = static_cast<uint32_t>(neighbors.size());
+    }
+}
+
+/// True if the pattern has exactly one %d (or %i) conversion, optionally with flags,
+/// width and precision, and no other conversions except %%
+bool isFramePattern(const std::string& pattern) {
+    int conversions = 0;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        if (pattern[i] != '%') continue;
+        if (++i < pattern.size() && pattern[i] == '%') continue;
+        while (i < pattern.size() && std::string("-+ #0").find(pattern[i]) != std::string::npos) ++i;
+        while (i < pattern.size() && std::isdigit(static_cast<unsigned char>(pattern[i]))) ++i;
+        if (i < pattern.size() && pattern[i] == '.') {
+            ++i;
+            while (i < pattern.size() && std::isdigit(static_cast<unsigned char>(pattern[i]))) ++i;
+        }
+        if (i >= pattern.size() || (pattern[i] != 'd' && pattern[i] != 'i')) return false;
+        ++conversions;
+    }
+    return conversions == 1;
+}
+}
+
+int main(int argc, char** argv) {
+    std::string trajectoryPath;
+    std::string topologyPath;
+    std::string outputPattern = "frame_%05d.ppm";
+    long first = 0, last = -1, stride = 1;
+    RayTracerSettings settings;
+    settings.width = 3840;
+    settings.height = 2160;
+    glm::vec3 view(0.0f, 0.0f, 1.0f);
+    float radiusScale = 1.0f;
+    float bondCutoff = 0.0f;
+    float bondRadius = 0.12f;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--topology" && hasValue)          topologyPath = argv[++i];
+        else if (arg == "--output" && hasValue)       outputPattern = argv[++i];
+        else if (arg == "--frames" && hasValue)       std::sscanf(argv[++i], "%ld:%ld:%ld", &first, &last, &stride);
+        else if (arg == "--size" && hasValue)         std::sscanf(argv[++i], "%dx%d", &settings.width, &settings.height);
+        else if (arg == "--spp" && hasValue)          settings.samplesPerPixel = std::atoi(argv[++i]);
+        else if (arg == "--ao" && hasValue)           settings.aoSamples = std::atoi(argv[++i]);
+        else if (arg == "--shadows" && hasValue)      settings.shadowSamples = std::atoi(argv[++i]);
+        else if (arg == "--view" && hasValue)         std::sscanf(argv[++i], "%f,%f,%f", &view.x, &view.y, &view.z);
+        else if (arg == "--radius-scale" && hasValue) radiusScale = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--bond-cutoff" && hasValue)  bondCutoff = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--bond-radius" && hasValue)  bondRadius = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--help" || arg == "-h")      { printUsage(); return 0; }
+        else if (trajectoryPath.empty() && arg[0] != '-') trajectoryPath = arg;
+        else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+    if (trajectoryPath.empty() || settings.width <= 0 || settings.height <= 0) {
+        printUsage();
+        return 1;
+    }
+    if (!isFramePattern(outputPattern)) {
+        std::cerr << "--output needs exactly one integer conversion for the frame number, e.g. frame_%05d.ppm\n";
+        return 1;
+    }
+    stride = std::max(1L, stride);
+
+    Logger::getInstance().setLogLevel(Logger::Level::ERROR);
+    AnalysisTopology topology;
+    if (!topologyPath.empty() && !AnalysisTopology::loadXYZ(topologyPath, topology)) return 1;
+
+    TrajectoryReader reader;
+    if (!reader.open(trajectoryPath)) {
+        std::cerr << reader.getError() << "\n";
+        return 1;
+    }
+
+    // Occlusion reaches about two atom diameters at the chosen scale
+    settings.aoDistance = 2.0f * radiusScale;
+    const float aspect = float(settings.width) / settings.height;
+
+    TrajectoryFrame frame;
+    RayTracer tracer;
+    std::vector<uint8_t> rgb;
+    Camera camera;
+    bool framed = false;
+    for (long index = 0; reader.readFrame(frame); ++index) {
+        if (last >= 0 && index > last) break;
+        if (index < first || (index - first) % stride != 0) continue;
+        if (topology.size() != frame.size()) topology = AnalysisTopology::anonymous(frame.size());
+
+        auto start = std::chrono::steady_clock::now();
+        RayScene scene;
+        scene.addAtoms(frame.x.data(), frame.y.data(), frame.z.data(), topology.atomicNumber.data(), frame.size(),
+                       radiusScale);
+        if (bondCutoff > 0.0f) {
+            std::vector<uint32_t> offsets, neighbors;
+            inferBonds(frame, bondCutoff, offsets, neighbors);
+            scene.addBonds(offsets, neighbors, bondRadius * radiusScale);
+        } else {
+            scene.addBonds(topology.bondOffsets, topology.bondNeighbors, bondRadius * radiusScale);
+        }
+        // The camera is placed on the first frame and stays put, so movies do not jitter
+        if (!framed) {
+            camera = RayTracer::frameScene(scene, view, camera.getFov(), aspect);
+            framed = true;
+        }
+        tracer.build(scene);
+        auto built = std::chrono::steady_clock::now();
+        tracer.render(camera, settings, rgb);
+        auto rendered = std::chrono::steady_clock::now();
+
+        char path[1024];
+        std::snprintf(path, sizeof(path), outputPattern.c_str(), static_cast<int>(index));
+        if (!RayTracer::writePPM(path, settings.width, settings.height, rgb)) {
+            std::cerr << "Cannot write " << path << "\n";
+            return 1;
+        }
+        std::cerr << path << ": " << tracer.getPrimitiveCount() << " primitives, BVH "
+                  << std::chrono::duration<double>(built - start).count() << " s, render "
+                  << std::chrono::duration<double>(rendered - built).count() << " s\n";
+    }
+    if (!reader.getError().empty()) {
+        std::cerr << reader.getError() << "\n";
+        return 1;
+    }
+    return 0;
+}